@@ -0,0 +1,157 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__ALLOCATION_AUDIT_H_
+#define RCL__ALLOCATION_AUDIT_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rcl/allocator.h"
+#include "rcl/macros.h"
+#include "rcl/visibility_control.h"
+
+/// rcl function in which an audited allocation was made.
+typedef enum rcl_allocation_audit_api_t
+{
+  /// Allocations outside of the audited functions, or with tagging compiled out.
+  RCL_ALLOCATION_AUDIT_OTHER = 0,
+  RCL_ALLOCATION_AUDIT_WAIT,
+  RCL_ALLOCATION_AUDIT_TAKE,
+  RCL_ALLOCATION_AUDIT_PUBLISH,
+  RCL_ALLOCATION_AUDIT_TIMER_CALL,
+  RCL_ALLOCATION_AUDIT_SEND_RESPONSE,
+  RCL_ALLOCATION_AUDIT_API_COUNT
+} rcl_allocation_audit_api_t;
+
+/// Return `true` if rcl was built with `RCL_ENABLE_ALLOCATION_AUDIT`.
+/**
+ * Only then are allocations tagged with the rcl function making them,
+ * otherwise all of them are counted as `RCL_ALLOCATION_AUDIT_OTHER`.
+ * Counting and real-time sections work either way.
+ */
+RCL_PUBLIC
+bool
+rcl_allocation_audit_is_available(void);
+
+/// Return an allocator which counts the allocations made through `allocator`.
+/**
+ * Each call to `allocate`, `zero_allocate` or `reallocate` of the returned
+ * allocator is counted against the rcl function the calling thread is in,
+ * see rcl_allocation_audit_get_count(), and then forwarded to `allocator`.
+ * Give it to the entities and wait sets under audit, e.g. in their options.
+ *
+ * Only allocations made through the returned allocator are seen, memory
+ * the rmw implementation allocates on its own is not.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] allocator allocator to forward to, which must outlive the returned one
+ * \return the counting allocator.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_allocator_t
+rcl_allocation_audit_get_allocator(const rcl_allocator_t * allocator);
+
+/// Return the number of audited allocations made in an rcl function so far.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] api the rcl function
+ * \return the number of allocations, or 0 if `api` is out of range.
+ */
+RCL_PUBLIC
+uint64_t
+rcl_allocation_audit_get_count(rcl_allocation_audit_api_t api);
+
+/// Return the number of audited allocations made inside real-time sections so far.
+RCL_PUBLIC
+uint64_t
+rcl_allocation_audit_get_real_time_count(void);
+
+/// Return the name of the rcl function, e.g. `"rcl_wait"`, or `"other"`.
+RCL_PUBLIC
+const char *
+rcl_allocation_audit_get_api_name(rcl_allocation_audit_api_t api);
+
+/// Reset all counts to 0.
+RCL_PUBLIC
+void
+rcl_allocation_audit_reset_counts(void);
+
+/// Abort the process on any audited allocation inside a real-time section.
+/**
+ * Before aborting, the rcl function making the allocation is written to
+ * stderr, so that a debugger or core dump shows the offending call stack.
+ * Aborting is disabled by default, the allocations are only counted.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] enabled whether or not to abort
+ */
+RCL_PUBLIC
+void
+rcl_allocation_audit_set_abort_in_real_time_section(bool enabled);
+
+/// Declare that the calling thread enters a real-time section.
+/**
+ * Sections nest, the thread stays in a real-time section until each call
+ * was matched by rcl_allocation_audit_exit_real_time_section().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ */
+RCL_PUBLIC
+void
+rcl_allocation_audit_enter_real_time_section(void);
+
+/// Declare that the calling thread leaves a real-time section.
+RCL_PUBLIC
+void
+rcl_allocation_audit_exit_real_time_section(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__ALLOCATION_AUDIT_H_
@@ -40,6 +40,7 @@ typedef struct rcl_arguments_t
 #define RCL_LOG_DISABLE_ROSOUT_ARG_RULE "__log_disable_rosout:="
 #define RCL_LOG_DISABLE_EXT_LIB_ARG_RULE "__log_disable_external_lib:="
 #define RCL_PARAM_FILE_ARG_RULE "__params:="
+#define RCL_REMAP_FILE_ARG_RULE "__remap_file:="
 
 /// Return a rcl_node_t struct with members initialized to `NULL`.
 RCL_PUBLIC
@@ -65,6 +66,14 @@ rcl_get_zero_initialized_arguments(void);
  * `warn`, not case sensitive.
  * If multiple of these rules are found, the last one parsed will be used.
  *
+ * Remap rules can also be read from a file given as `__remap_file:=path`, and are stored in
+ * place of the argument.
+ * The file is either text, with one remap rule per line and `#` starting a comment line, or
+ * compiled with rcl_arguments_write_remap_file().
+ * A compiled file is memory mapped and its rules are used without being parsed, so processes
+ * given the same file share its pages.
+ * If any rule in a file is invalid then none of its rules are used.
+ *
  * \sa rcl_remap_topic_name()
  * \sa rcl_remap_service_name()
  * \sa rcl_remap_node_name()
@@ -117,6 +126,36 @@ int
 rcl_arguments_get_count_unparsed(
   const rcl_arguments_t * args);
 
+/// Write the remap rules of parsed arguments to a file, to be given with `__remap_file:=`.
+/**
+ * The rules are compiled: each distinct string is stored once, and loading the file needs no
+ * parsing.
+ * The file is only valid on hosts with the byte order of the one which wrote it.
+ * It must not be written over while processes are using it; write a new file and rename it
+ * instead.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] args An arguments structure that has been parsed.
+ * \param[in] file_path The path of the file to create or truncate.
+ * \return `RCL_RET_OK` if the file was written, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any function arguments are invalid, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if the file could not be written.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_arguments_write_remap_file(
+  const rcl_arguments_t * args,
+  const char * file_path);
+
 /// Return a list of indexes that weren't successfully parsed.
 /**
  * Some arguments may not have been successfully parsed, or were not intended as ROS arguments.
@@ -238,16 +277,21 @@ rcl_remove_ros_arguments(
 
 /// Copy one arguments structure into another.
 /**
+ * Parsed arguments are immutable, so the copy shares them with `args` and
+ * only a reference count is incremented.
+ * This makes copying the arguments into the options of many nodes cheap.
+ * Each copy must still be passed to rcl_arguments_fini(), the shared
+ * arguments are freed with the last one.
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
- * Allocates Memory   | Yes
- * Thread-Safe        | No
- * Uses Atomics       | No
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
  * Lock-Free          | Yes
  *
  * \param[in] args The structure to be copied.
- *  Its allocator is used to copy memory into the new structure.
  * \param[out] args_out A zero-initialized arguments structure to be copied into.
  * \return `RCL_RET_OK` if the structure was copied successfully, or
  * \return `RCL_RET_INVALID_ARGUMENT` if any function arguments are invalid, or
@@ -263,12 +307,15 @@ rcl_arguments_copy(
 
 /// Reclaim resources held inside rcl_arguments_t structure.
 /**
+ * Arguments still shared by a copy, see rcl_arguments_copy(), are only freed
+ * when the last copy is finalized.
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
  * Allocates Memory   | No
  * Thread-Safe        | Yes
- * Uses Atomics       | No
+ * Uses Atomics       | Yes
  * Lock-Free          | Yes
  *
  * \param[in] args The structure to be deallocated.
@@ -20,8 +20,10 @@ extern "C"
 {
 #endif
 
+#include "rosidl_generator_c/message_type_support_struct.h"
 #include "rosidl_generator_c/service_type_support_struct.h"
 
+#include "rcl/entity_statistics.h"
 #include "rcl/macros.h"
 #include "rcl/node.h"
 #include "rcl/visibility_control.h"
@@ -43,6 +45,30 @@ typedef struct rcl_client_options_t
   /// Custom allocator for the client, used for incidental allocations.
   /** For default behavior (malloc/free), use: rcl_get_default_allocator() */
   rcl_allocator_t allocator;
+  /// Maximum number of requests waiting for a response which rcl keeps track of.
+  /**
+   * If not 0, rcl records every sent request until its response is taken or
+   * its deadline passes, see rcl_send_request_with_timeout().
+   * Space for this many requests is allocated when the client is initialized.
+   */
+  size_t pending_request_capacity;
+  /// Type support of the service's request message, enables request coalescing if not `NULL`.
+  /**
+   * With coalescing, a request whose serialized form is identical to a
+   * request still in flight is not sent again, but attached to the one in
+   * flight and given its sequence number.
+   * When the response is taken, the user data of the attached requests can be
+   * retrieved with rcl_client_take_coalesced_waiter() to fan the response out.
+   * Requires a non zero `pending_request_capacity`.
+   *
+   * Room is allocated for `pending_request_capacity` requests in flight plus
+   * as many completed requests whose attached requests were not all taken
+   * yet. When it is used up, requests are sent without being coalesced.
+   *
+   * For C, the type support can be obtained with a macro, e.g.
+   * `ROSIDL_GET_MSG_TYPE_SUPPORT(example_interfaces, srv, AddTwoInts_Request)`.
+   */
+  const rosidl_message_type_support_t * coalescing_type_support;
 } rcl_client_options_t;
 
 /// Return a rcl_client_t struct with members set to `NULL`.
@@ -145,6 +171,7 @@ rcl_get_zero_initialized_client(void);
  * \return `RCL_RET_NODE_INVALID` if the node is invalid, or
  * \return `RCL_RET_ALREADY_INIT` if the client is already initialized, or
  * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_ENTITY_POOL_EXHAUSTED` if the client pool of the context is full, or
  * \return `RCL_RET_BAD_ALLOC` if allocating memory fails, or
  * \return `RCL_RET_SERVICE_NAME_INVALID` if the given service name is invalid, or
  * \return `RCL_RET_ERROR` if an unspecified error occurs.
@@ -191,6 +218,8 @@ rcl_client_fini(rcl_client_t * client, rcl_node_t * node);
  *
  * - qos = rmw_qos_profile_services_default
  * - allocator = rcl_get_default_allocator()
+ * - pending_request_capacity = 0
+ * - coalescing_type_support = NULL
  */
 RCL_PUBLIC
 RCL_WARN_UNUSED
@@ -211,12 +240,15 @@ rcl_client_get_default_options(void);
  * The ROS request message given by the `ros_request` void pointer is always
  * owned by the calling code, but should remain constant during `send_request`.
  *
- * This function is thread safe so long as access to both the client and the
- * `ros_request` is synchronized.
- * That means that calling rcl_send_request() from multiple threads is allowed,
- * but calling rcl_send_request() at the same time as non-thread safe client
- * functions is not, e.g. calling rcl_send_request() and rcl_client_fini()
- * concurrently is not allowed.
+ * rcl keeps no state which concurrent calls on the same client could corrupt,
+ * each of them gets the sequence number assigned to its own request by the
+ * middleware.
+ * Whether multiple threads may send requests through one client without any
+ * external synchronization however depends on the rmw implementation, which
+ * has to allow concurrent calls to `rmw_send_request()` on the same client.
+ * Calling rcl_send_request() at the same time as non-thread safe client
+ * functions is not allowed, e.g. calling rcl_send_request() and
+ * rcl_client_fini() concurrently is not allowed.
  * Before calling rcl_send_request() the message can change and after calling
  * rcl_send_request() the message can change, but it cannot be changed during
  * the `send_request` call.
@@ -224,14 +256,22 @@ rcl_client_get_default_options(void);
  * rcl_send_request() simultaneously, even if the clients differ.
  * The `ros_request` is unmodified by rcl_send_request().
  *
+ * If the client coalesces requests, see `coalescing_type_support`, the
+ * request is serialized first and, if an identical request is in flight, it
+ * is not sent but the sequence number of the request in flight is returned.
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
- * Allocates Memory   | No
- * Thread-Safe        | Yes [1]
- * Uses Atomics       | No
- * Lock-Free          | Yes
- * <i>[1] for unique pairs of clients and requests, see above for more</i>
+ * Allocates Memory   | Maybe [3]
+ * Thread-Safe        | Maybe [1]
+ * Uses Atomics       | Yes
+ * Lock-Free          | Maybe [2]
+ * <i>[1] rmw implementation defined for concurrent calls on the same client, and only
+ *    as long as the `ros_request` is not modified during the call, see above for more</i>
+ * <i>[2] no if pending requests are tracked, their table is guarded by a mutex which is
+ *    held while the request is sent, so tracked sends on one client are serialized</i>
+ * <i>[3] only if requests are coalesced, to serialize the request</i>
  *
  * \param[in] client handle to the client which will make the response
  * \param[in] ros_request type-erased pointer to the ROS request message
@@ -239,6 +279,8 @@ rcl_client_get_default_options(void);
  * \return `RCL_RET_OK` if the request was sent successfully, or
  * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
  * \return `RCL_RET_CLIENT_INVALID` if the client is invalid, or
+ * \return `RCL_RET_CLIENT_PENDING_REQUESTS_FULL` if pending requests are
+ *         tracked and `pending_request_capacity` requests are waiting already, or
  * \return `RCL_RET_ERROR` if an unspecified error occurs.
  */
 RCL_PUBLIC
@@ -246,6 +288,61 @@ RCL_WARN_UNUSED
 rcl_ret_t
 rcl_send_request(const rcl_client_t * client, const void * ros_request, int64_t * sequence_number);
 
+/// Send a ROS request which expires if no response is taken before the timeout.
+/**
+ * This function behaves like rcl_send_request(), but requires the client to
+ * be initialized with a non zero `pending_request_capacity`.
+ * The request is recorded in the client's pending request table together
+ * with its deadline and the given `user_data`, which rcl does not touch.
+ *
+ * The request stays pending until either:
+ *   - its response is taken with rcl_take_response_with_user_data() or
+ *     rcl_take_response(), which looks it up by sequence number in constant
+ *     time and hands back the `user_data`, or
+ *   - its deadline passes, after which the client is reported as ready by
+ *     rcl_wait() and the request can be taken with
+ *     rcl_client_take_expired_request().
+ *
+ * A response arriving after its request expired is discarded.
+ * The deadline is measured with the steady clock.
+ * A request coalesced with one in flight shares that request's deadline, its
+ * own `timeout` is ignored.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Maybe [3]
+ * Thread-Safe        | Maybe [1]
+ * Uses Atomics       | Yes
+ * Lock-Free          | No [2]
+ * <i>[1] like rcl_send_request(), rmw implementation defined for the same client</i>
+ * <i>[2] the pending request table is guarded by a mutex, see rcl_send_request()</i>
+ * <i>[3] only if requests are coalesced, to serialize the request</i>
+ *
+ * \param[in] client handle to the client which will make the request
+ * \param[in] ros_request type-erased pointer to the ROS request message
+ * \param[in] timeout nanoseconds until the request expires, or a negative
+ *   value for a request which never expires
+ * \param[in] user_data opaque pointer returned with the response or expiry
+ * \param[out] sequence_number the sequence number
+ * \return `RCL_RET_OK` if the request was sent successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid or the
+ *         client does not track pending requests, or
+ * \return `RCL_RET_CLIENT_INVALID` if the client is invalid, or
+ * \return `RCL_RET_CLIENT_PENDING_REQUESTS_FULL` if `pending_request_capacity`
+ *         requests are waiting already, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_send_request_with_timeout(
+  const rcl_client_t * client,
+  const void * ros_request,
+  int64_t timeout,
+  void * user_data,
+  int64_t * sequence_number);
+
 
 /// Take a ROS response using a client
 /**
@@ -263,14 +360,21 @@ rcl_send_request(const rcl_client_t * client, const void * ros_request, int64_t
  * struct of the correct type, into which the response from the service will be
  * copied.
  *
+ * If the client tracks pending requests, see `pending_request_capacity`,
+ * the response is matched against the pending requests and removed from them.
+ * Responses to requests which are not pending, e.g. because they expired,
+ * are discarded and `RCL_RET_CLIENT_TAKE_FAILED` is returned.
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
  * Allocates Memory   | Maybe [1]
  * Thread-Safe        | No
  * Uses Atomics       | No
- * Lock-Free          | Yes
+ * Lock-Free          | Maybe [2]
  * <i>[1] only if required when filling the message, avoided for fixed sizes</i>
+ * <i>[2] no if pending requests are tracked, the response waits for a concurrent
+ *    send on the same client to store its request</i>
  *
  * \param[in] client handle to the client which will take the response
  * \param[inout] request_header pointer to the request header
@@ -290,6 +394,165 @@ rcl_take_response(
   rmw_request_id_t * request_header,
   void * ros_response);
 
+/// Take a ROS response and the user data given when its request was sent.
+/**
+ * This function behaves like rcl_take_response(), and additionally returns
+ * the `user_data` passed to rcl_send_request_with_timeout() for the matched
+ * request.
+ * The `user_data` is `NULL` for requests sent with rcl_send_request() and for
+ * clients which do not track pending requests.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Maybe [1]
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ * <i>[1] only if required when filling the message, avoided for fixed sizes</i>
+ *
+ * \param[in] client handle to the client which will take the response
+ * \param[inout] request_header pointer to the request header
+ * \param[inout] ros_response type-erased pointer to the ROS response message
+ * \param[out] user_data the request's user data, may be `NULL` if not needed
+ * \return `RCL_RET_OK` if the response was taken successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_CLIENT_INVALID` if the client is invalid, or
+ * \return `RCL_RET_CLIENT_TAKE_FAILED` if take failed but no error occurred
+ *         in the middleware, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_take_response_with_user_data(
+  const rcl_client_t * client,
+  rmw_request_id_t * request_header,
+  void * ros_response,
+  void ** user_data);
+
+/// Take the user data of the next request which was coalesced with a completed one.
+/**
+ * After a response was taken, or a request was taken as expired, with the
+ * given sequence number, the user data of each request which was attached to
+ * it by coalescing is returned by one call of this function, in the order
+ * the requests were made.
+ * The user data of the request which was actually sent is returned by
+ * rcl_take_response_with_user_data() or rcl_client_take_expired_request()
+ * and is not repeated here.
+ *
+ * The user data is kept until it is taken, also while other responses are
+ * taken, and the room of the completed request is reused once all of it was
+ * taken.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | No
+ *
+ * \param[in] client handle to the client
+ * \param[in] sequence_number the sequence number of the completed request
+ * \param[out] user_data the user data of the next coalesced request
+ * \return `RCL_RET_OK` if the user data of a coalesced request was taken, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_CLIENT_INVALID` if the client is invalid, or
+ * \return `RCL_RET_CLIENT_TAKE_FAILED` if no coalesced request is left.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_client_take_coalesced_waiter(
+  const rcl_client_t * client,
+  int64_t sequence_number,
+  void ** user_data);
+
+/// Take a pending request whose deadline passed without a response.
+/**
+ * Requests are taken in order of their deadlines, one per call.
+ * A client with an expired request is reported as ready by rcl_wait(), and
+ * this function should be called until it returns
+ * `RCL_RET_CLIENT_TAKE_FAILED`.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ *
+ * \param[in] client handle to the client
+ * \param[out] sequence_number the sequence number of the expired request
+ * \param[out] user_data the user data given when the request was sent
+ * \return `RCL_RET_OK` if an expired request was taken, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_CLIENT_INVALID` if the client is invalid, or
+ * \return `RCL_RET_CLIENT_TAKE_FAILED` if no request expired, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_client_take_expired_request(
+  const rcl_client_t * client,
+  int64_t * sequence_number,
+  void ** user_data);
+
+/// Calculate the time until the earliest deadline of the client's pending requests.
+/**
+ * The result is negative if a request already expired, and `INT64_MAX` if no
+ * pending request has a deadline or the client does not track pending
+ * requests.
+ * This is used by rcl_wait() to bound the time it blocks.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ *
+ * \param[in] client handle to the client
+ * \param[out] time_until_next_deadline nanoseconds until the earliest deadline
+ * \return `RCL_RET_OK` if the time was calculated, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_CLIENT_INVALID` if the client is invalid, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_client_get_time_until_next_request_deadline(
+  const rcl_client_t * client,
+  int64_t * time_until_next_deadline);
+
+/// Get the number of requests of the client which are waiting for a response.
+/**
+ * The count is always 0 for clients which do not track pending requests.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ *
+ * \param[in] client handle to the client
+ * \param[out] count the number of pending requests
+ * \return `RCL_RET_OK` if the count was retrieved, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_CLIENT_INVALID` if the client is invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_client_get_pending_request_count(const rcl_client_t * client, size_t * count);
+
 /// Get the name of the service that this client will request a response from.
 /**
  * This function returns the client's internal service name string.
@@ -397,6 +660,35 @@ RCL_PUBLIC
 bool
 rcl_client_is_valid(const rcl_client_t * client);
 
+/// Get the traffic statistics of a client.
+/**
+ * The statistics count the responses taken by this client since it was
+ * initialized, see rcl_entity_statistics_t for details.
+ * The counters are updated concurrently with this call, so the returned
+ * values are not guaranteed to be a consistent snapshot.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] client pointer to the rcl client
+ * \param[out] statistics the statistics of the client
+ * \return `RCL_RET_OK` if the statistics were retrieved, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_CLIENT_INVALID` if the client is invalid, or
+ * \return `RCL_RET_ERROR` if rcl was built without entity statistics.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_client_get_statistics(
+  const rcl_client_t * client,
+  rcl_entity_statistics_t * statistics);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,73 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__ENTITY_STATISTICS_H_
+#define RCL__ENTITY_STATISTICS_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rcl/visibility_control.h"
+#include "rcutils/time.h"
+
+/// Traffic statistics collected by rcl for a publisher, subscription, client or service.
+/**
+ * What counts as a message depends on the kind of entity:
+ *
+ * - publishers count messages passed to the middleware by rcl_publish() and
+ *   rcl_publish_serialized_message()
+ * - subscriptions count messages taken by rcl_take() and
+ *   rcl_take_serialized_message()
+ * - clients count responses taken by rcl_take_response()
+ * - services count requests taken by rcl_take_request()
+ *
+ * The statistics are only collected if rcl was built with the CMake option
+ * `RCL_ENABLE_ENTITY_STATISTICS` turned on, which is the default.
+ */
+typedef struct rcl_entity_statistics_t
+{
+  /// Number of messages published or taken.
+  uint64_t message_count;
+  /// Number of bytes published or taken, only counted for serialized messages.
+  uint64_t byte_count;
+  /// Number of calls which did not result in a message.
+  /**
+   * For subscriptions, clients and services these are the takes which
+   * returned one of the `*_TAKE_FAILED` return codes, for publishers these
+   * are publishes which were rejected by the middleware.
+   */
+  uint64_t failure_count;
+  /// Smallest time between two consecutive messages in nanoseconds, or 0.
+  rcutils_duration_value_t inter_arrival_min;
+  /// Average time between two consecutive messages in nanoseconds, or 0.
+  rcutils_duration_value_t inter_arrival_mean;
+  /// Largest time between two consecutive messages in nanoseconds, or 0.
+  rcutils_duration_value_t inter_arrival_max;
+} rcl_entity_statistics_t;
+
+/// Return `true` if rcl was built with `RCL_ENABLE_ENTITY_STATISTICS` on.
+RCL_PUBLIC
+bool
+rcl_entity_statistics_is_available(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__ENTITY_STATISTICS_H_
@@ -29,13 +29,64 @@ extern "C"
 
 #include "rcl/macros.h"
 #include "rcl/client.h"
+#include "rcl/guard_condition.h"
 #include "rcl/node.h"
+#include "rcl/time.h"
 #include "rcl/visibility_control.h"
 
 typedef rmw_names_and_types_t rcl_names_and_types_t;
 
 #define rcl_get_zero_initialized_names_and_types rmw_get_zero_initialized_names_and_types
 
+/// Kind of an entity in the ROS graph.
+typedef enum rcl_graph_entity_kind_t
+{
+  RCL_GRAPH_ENTITY_NODE = 0,
+  RCL_GRAPH_ENTITY_PUBLISHER,
+  RCL_GRAPH_ENTITY_SUBSCRIPTION,
+  RCL_GRAPH_ENTITY_SERVICE
+} rcl_graph_entity_kind_t;
+
+/// A node, or a publisher, subscription or service of a node, in the ROS graph.
+typedef struct rcl_graph_entity_t
+{
+  rcl_graph_entity_kind_t kind;
+  /// Name of the node, or of the node the endpoint belongs to.
+  char * node_name;
+  char * node_namespace;
+  /// Topic or service name, `NULL` for nodes.
+  char * name;
+  /// Type name, `NULL` for nodes.
+  char * type;
+} rcl_graph_entity_t;
+
+/// An entity which was added to or removed from the ROS graph.
+typedef struct rcl_graph_change_t
+{
+  /// `true` if the entity was added, `false` if it was removed.
+  bool added;
+  rcl_graph_entity_t entity;
+} rcl_graph_change_t;
+
+/// Changes of the ROS graph, as returned by rcl_get_graph_changes().
+typedef struct rcl_graph_changes_t
+{
+  rcl_graph_change_t * changes;
+  size_t size;
+  /// `true` if the changes list the whole graph as added, see rcl_get_graph_changes().
+  bool is_full_state;
+  rcl_allocator_t allocator;
+} rcl_graph_changes_t;
+
+/// Position in the changes of the ROS graph, see rcl_get_graph_changes().
+typedef uint64_t rcl_graph_cursor_t;
+
+/// Cursor of a caller which has not seen the graph yet.
+#define RCL_GRAPH_CURSOR_INITIAL 0
+
+/// Number of graph changes kept per context for rcl_get_graph_changes().
+#define RCL_GRAPH_CHANGE_LOG_CAPACITY 4096
+
 /// Return a list of publisher topic names and their types per node.
 /**
  * This function returns a list of topic names in the ROS graph for param node_name and their types.
@@ -514,6 +565,263 @@ rcl_service_server_is_available(
   const rcl_client_t * client,
   bool * is_available);
 
+/// Return a guard condition which is triggered when the ROS graph changes, for all nodes.
+/**
+ * Unlike the guard condition returned by rcl_node_get_graph_guard_condition(),
+ * there is one per context, so a process with many nodes can wait for changes
+ * of the graph with a single guard condition in its wait set, instead of one
+ * per node.
+ *
+ * The guard condition is ready whenever the graph guard condition of any node
+ * of the context would be, and when a node of the context is created or
+ * finalized.
+ * To achieve this, rcl_wait() waits on the middleware's graph guard
+ * conditions of all nodes of the context besides this guard condition, as
+ * the middleware only reports changes through those, and need not report a
+ * change to every node; the rcl wait set holds one guard condition, but the
+ * middleware wait set still holds one per node.
+ * Therefore, do not add it to the same wait set as a node's graph guard
+ * condition, or wait on both in different threads, as the middleware may
+ * report a change of the graph to only one of them.
+ * This includes rcl_wait_for_service(), rcl_wait_for_publishers() and
+ * rcl_wait_for_subscribers(), which wait on this guard condition.
+ *
+ * Finalizing a node of the context wakes up the waits on this guard
+ * condition, and blocks until they returned.
+ *
+ * The returned handle is made invalid when the context is finalized.
+ * It must not be triggered by the user.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] context the context whose graph guard condition is returned
+ * \return rcl guard condition handle if successful, otherwise `NULL`
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+const rcl_guard_condition_t *
+rcl_context_get_graph_guard_condition(rcl_context_t * context);
+
+/// Wait until a server is available for the given client's service.
+/**
+ * Instead of polling rcl_service_server_is_available(), this function waits
+ * on the graph guard condition of the node's context, see
+ * rcl_context_get_graph_guard_condition(), and only checks the service again
+ * when the graph changed, or when the timeout expires.
+ *
+ * The timeout is given in nanoseconds.
+ * A negative timeout waits until the service is available, and a timeout of
+ * 0 only checks once without waiting.
+ *
+ * The given allocator is used for the wait set used internally, which is
+ * created and destroyed on each call.
+ * Neither the context's graph guard condition nor the graph guard condition
+ * of any of its nodes should be waited on in another thread at the same time,
+ * such as by an executor, as the middleware may report a change of the graph
+ * to only one of the waits.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Maybe [1]
+ * <i>[1] implementation may need to protect the data structure with a lock</i>
+ *
+ * \param[in] node the handle to the node being used to query the ROS graph
+ * \param[in] allocator to be used for the wait set
+ * \param[in] client the handle to the service client being queried
+ * \param[in] timeout maximum time to wait in nanoseconds, or negative to wait forever
+ * \param[out] success `true` if the service is available, otherwise `false`
+ * \return `RCL_RET_OK` if the service became available, or
+ * \return `RCL_RET_TIMEOUT` if the service was not available before the timeout, or
+ * \return `RCL_RET_NODE_INVALID` if the node is invalid, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_for_service(
+  const rcl_node_t * node,
+  rcl_allocator_t * allocator,
+  const rcl_client_t * client,
+  rcl_duration_value_t timeout,
+  bool * success);
+
+/// Wait until a topic has at least the given number of publishers.
+/**
+ * Like rcl_wait_for_service(), this function waits on the graph guard
+ * condition of the node's context and only counts the publishers again when
+ * the graph changed.
+ * The timeout, allocator and restrictions on other waits are as in
+ * rcl_wait_for_service().
+ *
+ * The topic name is not automatically remapped, see rcl_count_publishers().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Maybe [1]
+ * <i>[1] implementation may need to protect the data structure with a lock</i>
+ *
+ * \param[in] node the handle to the node being used to query the ROS graph
+ * \param[in] allocator to be used for the wait set
+ * \param[in] topic_name the name of the topic in question
+ * \param[in] count number of publishers to wait for
+ * \param[in] timeout maximum time to wait in nanoseconds, or negative to wait forever
+ * \param[out] success `true` if the number of publishers was reached, otherwise `false`
+ * \return `RCL_RET_OK` if the number of publishers was reached, or
+ * \return `RCL_RET_TIMEOUT` if it was not reached before the timeout, or
+ * \return `RCL_RET_NODE_INVALID` if the node is invalid, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_for_publishers(
+  const rcl_node_t * node,
+  rcl_allocator_t * allocator,
+  const char * topic_name,
+  size_t count,
+  rcl_duration_value_t timeout,
+  bool * success);
+
+/// Wait until a topic has at least the given number of subscribers.
+/**
+ * See rcl_wait_for_publishers(), which this function mirrors for subscribers.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Maybe [1]
+ * <i>[1] implementation may need to protect the data structure with a lock</i>
+ *
+ * \param[in] node the handle to the node being used to query the ROS graph
+ * \param[in] allocator to be used for the wait set
+ * \param[in] topic_name the name of the topic in question
+ * \param[in] count number of subscribers to wait for
+ * \param[in] timeout maximum time to wait in nanoseconds, or negative to wait forever
+ * \param[out] success `true` if the number of subscribers was reached, otherwise `false`
+ * \return `RCL_RET_OK` if the number of subscribers was reached, or
+ * \return `RCL_RET_TIMEOUT` if it was not reached before the timeout, or
+ * \return `RCL_RET_NODE_INVALID` if the node is invalid, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_for_subscribers(
+  const rcl_node_t * node,
+  rcl_allocator_t * allocator,
+  const char * topic_name,
+  size_t count,
+  rcl_duration_value_t timeout,
+  bool * success);
+
+/// Return a rcl_graph_changes_t struct with members set to `NULL` or 0.
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_graph_changes_t
+rcl_get_zero_initialized_graph_changes(void);
+
+/// Return the changes of the ROS graph since the given cursor.
+/**
+ * Instead of enumerating the whole graph and comparing it with a previous
+ * enumeration, a watcher keeps a cursor and asks for the nodes, publishers,
+ * subscriptions and services which were added or removed since then, so it
+ * processes discovery in proportion to the number of changes.
+ *
+ * A watcher starts with `RCL_GRAPH_CURSOR_INITIAL`.
+ * The first call then returns every entity currently in the graph as added,
+ * with `is_full_state` set to `true`.
+ * Each call advances the cursor past the returned changes, so the next call
+ * with the same cursor variable only returns newer changes.
+ * The changes are kept per context in a log of limited length,
+ * `RCL_GRAPH_CHANGE_LOG_CAPACITY`.
+ * If the cursor is older than the log, the whole graph is returned as for the
+ * initial cursor, with `is_full_state` set to `true`, and the watcher should
+ * replace its view of the graph rather than apply the changes.
+ *
+ * The changes are computed by rcl, comparing the graph reported by the
+ * middleware each time the context's graph snapshot is rebuilt, see
+ * rcl_init_options_set_graph_cache_max_age().
+ * Therefore changes are only seen after the node's graph guard condition was
+ * waited on, or after entities of the context were created or destroyed, or
+ * after the snapshot's max age passed.
+ * If the graph cache is disabled, the graph is compared on every call.
+ * The first use of this function in a context makes every later rebuild of
+ * the snapshot query the endpoints of each node, which costs three middleware
+ * queries per node and rebuild.
+ *
+ * The changes parameter must be zero initialized and should be passed to
+ * rcl_graph_changes_fini() when it is no longer needed.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No [1]
+ * <i>[1] waits for other threads using the graph snapshot</i>
+ *
+ * \param[in] node the handle to the node being used to query the ROS graph
+ * \param[inout] cursor position of the caller in the changes, advanced on success
+ * \param[in] allocator allocator to be used when allocating space for the changes
+ * \param[out] changes the changes since the cursor
+ * \return `RCL_RET_OK` if the query was successful, or
+ * \return `RCL_RET_NODE_INVALID` if the node is invalid, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_get_graph_changes(
+  const rcl_node_t * node,
+  rcl_graph_cursor_t * cursor,
+  rcl_allocator_t * allocator,
+  rcl_graph_changes_t * changes);
+
+/// Finalize a rcl_graph_changes_t object.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] changes struct to be finalized
+ * \return `RCL_RET_OK` if successful, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_graph_changes_fini(rcl_graph_changes_t * changes);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,262 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__GRAPH_EXPORT_H_
+#define RCL__GRAPH_EXPORT_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcl/allocator.h"
+#include "rcl/graph.h"
+#include "rcl/macros.h"
+#include "rcl/node.h"
+#include "rcl/types.h"
+#include "rcl/visibility_control.h"
+
+/// Version of the binary graph export format written by rcl_graph_export().
+#define RCL_GRAPH_EXPORT_VERSION 1
+
+/// A snapshot of the whole ROS graph in one contiguous buffer.
+/**
+ * The buffer has the following layout, where every integer is an unsigned
+ * 32 bit little endian integer and every offset is relative to the start of
+ * the buffer:
+ *
+ * Offset | Content
+ * ------ | -------
+ * 0      | magic bytes `RCLG`
+ * 4      | format version, RCL_GRAPH_EXPORT_VERSION
+ * 8      | total size of the buffer in bytes
+ * 12     | number of strings
+ * 16     | number of nodes
+ * 20     | number of endpoints
+ * 24     | offset of the string table, one offset per string
+ * 28     | offset of the node table, four integers per node: name, namespace,
+ *        | index of the first endpoint and number of endpoints
+ * 32     | offset of the endpoint table, four integers per endpoint: kind,
+ *        | topic or service name, type and index of the node
+ * 36     | offset of the string data, null terminated strings
+ *
+ * Names, namespaces and types are indices into the string table, each string
+ * is stored once.
+ * The endpoints of a node are stored consecutively, ordered by kind, see
+ * rcl_graph_entity_kind_t.
+ */
+typedef struct rcl_graph_export_t
+{
+  uint8_t * buffer;
+  size_t size;
+  rcl_allocator_t allocator;
+} rcl_graph_export_t;
+
+/// A node read from a graph export, see rcl_graph_reader_get_node().
+typedef struct rcl_graph_export_node_t
+{
+  const char * name;
+  const char * namespace_;
+  size_t first_endpoint;
+  size_t endpoint_count;
+} rcl_graph_export_node_t;
+
+/// An endpoint read from a graph export, see rcl_graph_reader_get_endpoint().
+typedef struct rcl_graph_export_endpoint_t
+{
+  /// Publisher, subscription or service.
+  rcl_graph_entity_kind_t kind;
+  /// Topic or service name.
+  const char * name;
+  const char * type;
+  /// Index of the node the endpoint belongs to.
+  size_t node_index;
+} rcl_graph_export_endpoint_t;
+
+/// Reads a graph export in place, without allocating memory.
+typedef struct rcl_graph_reader_t
+{
+  const uint8_t * buffer;
+  size_t size;
+  size_t string_count;
+  size_t node_count;
+  size_t endpoint_count;
+  size_t string_table_offset;
+  size_t node_table_offset;
+  size_t endpoint_table_offset;
+  size_t string_data_offset;
+} rcl_graph_reader_t;
+
+/// Return a rcl_graph_export_t struct with members set to `NULL` or 0.
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_graph_export_t
+rcl_get_zero_initialized_graph_export(void);
+
+/// Export the whole ROS graph into a single buffer.
+/**
+ * The nodes and their publishers, subscriptions and services are written in
+ * the format described at rcl_graph_export_t, which needs a single
+ * allocation regardless of the size of the graph.
+ * The buffer may be shipped or written to a file as is and read with
+ * rcl_graph_reader_init(), also on hosts of a different byte order.
+ *
+ * The graph is taken from the context's graph snapshot, like the changes
+ * returned by rcl_get_graph_changes(), so the first export enables querying
+ * the endpoints of each node whenever the snapshot is rebuilt.
+ *
+ * The graph_export parameter must be zero initialized and should be passed to
+ * rcl_graph_export_fini() when it is no longer needed.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No [1]
+ * <i>[1] waits for other threads using the graph snapshot</i>
+ *
+ * \param[in] node the handle to the node being used to query the ROS graph
+ * \param[in] allocator allocator to be used for the buffer
+ * \param[out] graph_export the exported graph
+ * \return `RCL_RET_OK` if the graph was exported, or
+ * \return `RCL_RET_NODE_INVALID` if the node is invalid, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_graph_export(
+  const rcl_node_t * node,
+  rcl_allocator_t * allocator,
+  rcl_graph_export_t * graph_export);
+
+/// Free the buffer of a graph export.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] graph_export the export to be finalized
+ * \return `RCL_RET_OK` if successful, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_graph_export_fini(rcl_graph_export_t * graph_export);
+
+/// Validate a graph export and prepare reading it in place.
+/**
+ * The whole buffer is validated once, so the getters need no further checks
+ * than the index: all tables and strings must lie within the buffer, every
+ * string must be null terminated and every index must be in range.
+ * The buffer need not be aligned and must outlive the reader, the strings
+ * returned by the getters point into it.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[out] reader the reader to be initialized
+ * \param[in] buffer the exported graph
+ * \param[in] size the size of the buffer in bytes
+ * \return `RCL_RET_OK` if the buffer holds a valid graph export, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_ERROR` if the buffer is not a valid graph export.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_graph_reader_init(rcl_graph_reader_t * reader, const void * buffer, size_t size);
+
+/// Return the number of nodes in the graph export, 0 if the reader is invalid.
+RCL_PUBLIC
+RCL_WARN_UNUSED
+size_t
+rcl_graph_reader_get_node_count(const rcl_graph_reader_t * reader);
+
+/// Get a node of the graph export.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] reader an initialized reader
+ * \param[in] index index of the node, less than the node count
+ * \param[out] node the node, its strings point into the buffer
+ * \return `RCL_RET_OK` if successful, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_graph_reader_get_node(
+  const rcl_graph_reader_t * reader,
+  size_t index,
+  rcl_graph_export_node_t * node);
+
+/// Return the number of endpoints in the graph export, 0 if the reader is invalid.
+RCL_PUBLIC
+RCL_WARN_UNUSED
+size_t
+rcl_graph_reader_get_endpoint_count(const rcl_graph_reader_t * reader);
+
+/// Get an endpoint of the graph export.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] reader an initialized reader
+ * \param[in] index index of the endpoint, less than the endpoint count
+ * \param[out] endpoint the endpoint, its strings point into the buffer
+ * \return `RCL_RET_OK` if successful, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_graph_reader_get_endpoint(
+  const rcl_graph_reader_t * reader,
+  size_t index,
+  rcl_graph_export_endpoint_t * endpoint);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__GRAPH_EXPORT_H_
@@ -87,6 +87,7 @@ rcl_get_zero_initialized_guard_condition(void);
  * \return `RCL_RET_ALREADY_INIT` if the guard condition is already initialized, or
  * \return `RCL_RET_NOT_INIT` if the given context is invalid, or
  * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_ENTITY_POOL_EXHAUSTED` if the guard condition pool of the context is full, or
  * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
  * \return `RCL_RET_ERROR` if an unspecified error occurs.
  */
@@ -129,6 +130,7 @@ rcl_guard_condition_init(
  * \return `RCL_RET_OK` if guard_condition was initialized successfully, or
  * \return `RCL_RET_ALREADY_INIT` if the guard condition is already initialized, or
  * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_ENTITY_POOL_EXHAUSTED` if the guard condition pool of the context is full, or
  * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
  * \return `RCL_RET_ERROR` if an unspecified error occurs.
  */
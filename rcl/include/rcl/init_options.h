@@ -29,6 +29,23 @@ extern "C"
 
 struct rcl_init_options_impl_t;
 
+/// Number of slots of each entity pool, see rcl_init_options_set_entity_pool_capacities().
+typedef struct rcl_entity_pool_capacities_t
+{
+  size_t publishers;
+  size_t subscriptions;
+  size_t clients;
+  size_t services;
+  /// Timers, those using ROS time also take a guard condition.
+  size_t timers;
+  /// Guard conditions, including those of nodes, timers and the context itself.
+  size_t guard_conditions;
+  /// Wait sets initialized with rcl_wait_set_init_with_context().
+  size_t wait_sets;
+  /// Entities of all kinds which fit in one pooled wait set.
+  size_t wait_set_entries;
+} rcl_entity_pool_capacities_t;
+
 /// Encapsulation of init options and implementation defined init options.
 typedef struct rcl_init_options_t
 {
@@ -152,6 +169,192 @@ RCL_WARN_UNUSED
 rmw_init_options_t *
 rcl_init_options_get_rmw_init_options(rcl_init_options_t * init_options);
 
+/// Enable the graph cache of contexts initialized with these options.
+/**
+ * With the graph cache enabled, the graph queries of graph.h, e.g.
+ * rcl_count_publishers(), are answered from a snapshot of the graph which is
+ * shared by all nodes of the context, instead of asking the middleware on
+ * every call.
+ * The snapshot is rebuilt on the first query after:
+ *   - `rcl_wait()` returned a node's graph guard condition as ready,
+ *   - a node, publisher, subscription, client or service was created or
+ *     destroyed in the context, or
+ *   - the snapshot got older than `max_age`.
+ *
+ * The middleware does not allow to check a graph guard condition without
+ * waiting on it, so changes made by other processes are only seen once a
+ * graph guard condition was waited on or `max_age` expired.
+ * Applications which poll the graph without waiting on a graph guard
+ * condition should therefore choose a `max_age` they can tolerate as delay.
+ *
+ * The cache is disabled by default.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] init_options object to be modified
+ * \param[in] max_age maximum age of the snapshot in nanoseconds, 0 disables the cache
+ * \return `RCL_RET_OK` if the max age was set, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_init_options_set_graph_cache_max_age(rcl_init_options_t * init_options, int64_t max_age);
+
+/// Get the graph cache max age, see rcl_init_options_set_graph_cache_max_age().
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] init_options object to be queried
+ * \param[out] max_age maximum age of the snapshot in nanoseconds, 0 if disabled
+ * \return `RCL_RET_OK` if the max age was retrieved, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_init_options_get_graph_cache_max_age(
+  const rcl_init_options_t * init_options,
+  int64_t * max_age);
+
+/// Allocate the implementation structs of entities from an arena of the context.
+/**
+ * With the arena enabled, the publishers, subscriptions, clients, services
+ * and timers of contexts initialized with these options get their
+ * implementation structs from blocks of `block_size` bytes owned by the
+ * context, instead of one allocation each from the allocator of their
+ * options.
+ * This keeps the structs of a context close to each other in memory, and
+ * structs of finalized entities are reused by new entities of similar size.
+ * Structs larger than the blocks, or than 4096 bytes, still come from the
+ * allocator of the entity.
+ *
+ * The blocks are only freed by rcl_context_fini(), all at once, so
+ * entities must be finalized before the context, and a burst of entities
+ * keeps its memory until then.
+ *
+ * The arena is disabled by default.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] init_options object to be modified
+ * \param[in] block_size size of the blocks in bytes, 0 disables the arena
+ * \return `RCL_RET_OK` if the block size was set, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_init_options_set_entity_arena_block_size(
+  rcl_init_options_t * init_options,
+  size_t block_size);
+
+/// Get the entity arena block size, see rcl_init_options_set_entity_arena_block_size().
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] init_options object to be queried
+ * \param[out] block_size size of the blocks in bytes, 0 if disabled
+ * \return `RCL_RET_OK` if the block size was retrieved, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_init_options_get_entity_arena_block_size(
+  const rcl_init_options_t * init_options,
+  size_t * block_size);
+
+/// Draw the implementation structs of entities from fixed-capacity pools of the context.
+/**
+ * With pools, rcl_init() allocates a fixed number of slots for each kind of
+ * entity with a non-zero capacity, and the entities of that kind take their
+ * implementation structs from those slots instead of from the allocator of
+ * their options.
+ * When all slots of a pool are in use, initializing one more entity of that
+ * kind fails with `RCL_RET_ENTITY_POOL_EXHAUSTED` instead of allocating.
+ * Kinds with a capacity of 0 are not pooled and allocate as before, from the
+ * entity arena if it is enabled.
+ *
+ * A pooled wait set, see rcl_wait_set_init_with_context(), also keeps its
+ * arrays in its slot, so it can be resized without allocating as long as it
+ * holds at most `wait_set_entries` entities in total.
+ *
+ * rcl does not allocate memory for pooled entities after rcl_init(), but the
+ * rmw implementation may still do so when creating their middleware handles.
+ *
+ * The slots are only freed by rcl_context_fini(), so entities must be
+ * finalized before the context.
+ *
+ * The pools are disabled by default.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] init_options object to be modified
+ * \param[in] capacities number of slots of each pool, all 0 disables the pools
+ * \return `RCL_RET_OK` if the capacities were set, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, including
+ *   pooled wait sets without wait set entries.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_init_options_set_entity_pool_capacities(
+  rcl_init_options_t * init_options,
+  const rcl_entity_pool_capacities_t * capacities);
+
+/// Get the entity pool capacities, see rcl_init_options_set_entity_pool_capacities().
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] init_options object to be queried
+ * \param[out] capacities number of slots of each pool, all 0 if disabled
+ * \return `RCL_RET_OK` if the capacities were retrieved, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_init_options_get_entity_pool_capacities(
+  const rcl_init_options_t * init_options,
+  rcl_entity_pool_capacities_t * capacities);
+
 #ifdef __cplusplus
 }
 #endif
@@ -126,6 +126,10 @@ rcl_get_zero_initialized_node(void);
  * Similarly, the namespace ``""`` will implicitly become ``"/"`` which is a
  * valid namespace.
  *
+ * The environment variables ROS_DOMAIN_ID, ROS_SECURITY_ENABLE and
+ * ROS_SECURITY_STRATEGY are read once by rcl_init(), changing them afterwards
+ * does not affect the nodes of the context.
+ *
  * \todo TODO(wjwwood):
  *   Parameter infrastructure is currently initialized in the language specific
  *   client library, e.g. rclcpp for C++, but will be initialized here in the
@@ -193,6 +197,64 @@ rcl_node_init(
   rcl_context_t * context,
   const rcl_node_options_t * options);
 
+/// Initialize several ROS nodes with the same options.
+/**
+ * This is equivalent to calling rcl_node_init() for each node, with the same
+ * context and options, but work which is the same for all nodes is only done
+ * once:
+ *   - the arguments and context are checked once,
+ *   - a namespace is only validated again if it differs from the one of the
+ *     previous node, so nodes sharing a namespace should be passed in a row,
+ *   - the node name and namespace remap passes are skipped for all nodes
+ *     unless the node options' or the global arguments contain rules which
+ *     remap node names or namespaces.
+ *
+ * Like for every node, the configuration derived from the environment, e.g.
+ * the domain id and security settings, is the one read by rcl_init().
+ *
+ * Either all nodes are initialized, or none: if one fails, the nodes
+ * initialized before it are finalized again and the error of the failing node
+ * is returned.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes [1]
+ * <i>[1] if `atomic_is_lock_free()` returns true for `atomic_uint_least64_t`</i>
+ *
+ * \pre the node handles must be allocated, zero initialized, and invalid
+ * \post the node handles are valid, or all still zero initialized on failure
+ *
+ * \param[inout] nodes array of `count` preallocated rcl_node_t
+ * \param[in] count number of nodes to initialize
+ * \param[in] names array of `count` node names
+ * \param[in] namespaces array of `count` node namespaces
+ * \param[in] context the context instance with which the nodes should be
+ *   associated
+ * \param[in] options the node options, deep copied into each node
+ * \return `RCL_RET_OK` if all nodes were initialized successfully, or
+ * \return `RCL_RET_ALREADY_INIT` if a node has already be initialized, or
+ * \return `RCL_RET_NOT_INIT` if the context is not valid, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_NODE_INVALID_NAME` if a name is invalid, or
+ * \return `RCL_RET_NODE_INVALID_NAMESPACE` if a namespace is invalid, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_node_init_many(
+  rcl_node_t * nodes,
+  size_t count,
+  const char * const * names,
+  const char * const * namespaces,
+  rcl_context_t * context,
+  const rcl_node_options_t * options);
+
 /// Finalize a rcl_node_t.
 /**
  * Destroys any automatically created infrastructure and deallocates memory.
@@ -201,14 +263,18 @@ rcl_node_init(
  * Any middleware primitives created by the user, e.g. publishers, services, etc.,
  * are invalid after deinitialization.
  *
+ * If another thread waits on the graph guard condition of the node's context,
+ * see rcl_context_get_graph_guard_condition(), that wait is woken up and this
+ * function blocks until it returned.
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
  * Allocates Memory   | Yes
  * Thread-Safe        | No
  * Uses Atomics       | Yes
- * Lock-Free          | Yes [1]
- * <i>[1] if `atomic_is_lock_free()` returns true for `atomic_uint_least64_t`</i>
+ * Lock-Free          | No [1]
+ * <i>[1] the graph guard conditions of the context's nodes are guarded by a mutex</i>
  *
  * \param[in] node rcl_node_t to be finalized
  * \param[in] context the context originally used to init the node
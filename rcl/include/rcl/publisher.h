@@ -22,6 +22,7 @@ extern "C"
 
 #include "rosidl_generator_c/message_type_support_struct.h"
 
+#include "rcl/entity_statistics.h"
 #include "rcl/macros.h"
 #include "rcl/node.h"
 #include "rcl/visibility_control.h"
@@ -43,6 +44,16 @@ typedef struct rcl_publisher_options_t
   /// Custom allocator for the publisher, used for incidental allocations.
   /** For default behavior (malloc/free), use: rcl_get_default_allocator() */
   rcl_allocator_t allocator;
+  /// Maximum rate, in Hz, at which messages are passed on to the middleware.
+  /**
+   * Messages published more often than this are dropped by rcl_publish() and
+   * rcl_publish_serialized_message() before any middleware work is done.
+   * A value of `0` disables rate limiting.
+   */
+  double max_publish_rate;
+  /// Pass only every Nth message on to the middleware.
+  /** A value of `0` or `1` disables decimation. */
+  size_t publish_decimation;
 } rcl_publisher_options_t;
 
 /// Return a rcl_publisher_t struct with members set to `NULL`.
@@ -98,6 +109,8 @@ rcl_get_zero_initialized_publisher(void);
  * The options struct allows the user to set the quality of service settings as
  * well as a custom allocator which is used when initializing/finalizing the
  * publisher to allocate space for incidentals, e.g. the topic name string.
+ * It can also limit how often messages are actually handed to the middleware,
+ * see `max_publish_rate` and `publish_decimation`, which must not be negative.
  *
  * Expected usage (for C messages):
  *
@@ -138,6 +151,7 @@ rcl_get_zero_initialized_publisher(void);
  * \return `RCL_RET_NODE_INVALID` if the node is invalid, or
  * \return `RCL_RET_ALREADY_INIT` if the publisher is already initialized, or
  * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_ENTITY_POOL_EXHAUSTED` if the publisher pool of the context is full, or
  * \return `RCL_RET_BAD_ALLOC` if allocating memory fails, or
  * \return `RCL_RET_TOPIC_NAME_INVALID` if the given topic name is invalid, or
  * \return `RCL_RET_ERROR` if an unspecified error occurs.
@@ -187,6 +201,8 @@ rcl_publisher_fini(rcl_publisher_t * publisher, rcl_node_t * node);
  *
  * - qos = rmw_qos_profile_default
  * - allocator = rcl_get_default_allocator()
+ * - max_publish_rate = 0 (unlimited)
+ * - publish_decimation = 0 (every message is published)
  */
 RCL_PUBLIC
 RCL_WARN_UNUSED
@@ -233,12 +249,16 @@ rcl_publisher_get_default_options(void);
  * rcl_publish() simultaneously, even if the publishers differ.
  * The `ros_message` is unmodified by rcl_publish().
  *
+ * If the publisher was created with a `publish_decimation` or a
+ * `max_publish_rate` in its options, messages which exceed them are dropped
+ * before being passed to the middleware, and `RCL_RET_OK` is still returned.
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
  * Allocates Memory   | No
  * Thread-Safe        | Yes [1]
- * Uses Atomics       | No
+ * Uses Atomics       | Yes
  * Lock-Free          | Yes
  * <i>[1] for unique pairs of publishers and messages, see above for more</i>
  *
@@ -267,13 +287,14 @@ rcl_publish(const rcl_publisher_t * publisher, const void * ros_message);
  *
  * Apart from this, the `publish_serialized` function has the same behavior as `rcl_publish`
  * expect that no serialization step is done.
+ * Rate limiting and decimation are applied in the same way as in rcl_publish().
  *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
  * Allocates Memory   | No
  * Thread-Safe        | Yes [1]
- * Uses Atomics       | No
+ * Uses Atomics       | Yes
  * Lock-Free          | Yes
  * <i>[1] for unique pairs of publishers and messages, see above for more</i>
  *
@@ -465,6 +486,35 @@ rcl_publisher_get_subscription_count(
   const rcl_publisher_t * publisher,
   size_t * subscription_count);
 
+/// Get the traffic statistics of a publisher.
+/**
+ * The statistics count the messages published by this publisher since it was
+ * initialized, see rcl_entity_statistics_t for details.
+ * The counters are updated concurrently with this call, so the returned
+ * values are not guaranteed to be a consistent snapshot.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] publisher pointer to the rcl publisher
+ * \param[out] statistics the statistics of the publisher
+ * \return `RCL_RET_OK` if the statistics were retrieved, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_PUBLISHER_INVALID` if the publisher is invalid, or
+ * \return `RCL_RET_ERROR` if rcl was built without entity statistics.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_publisher_get_statistics(
+  const rcl_publisher_t * publisher,
+  rcl_entity_statistics_t * statistics);
+
 #ifdef __cplusplus
 }
 #endif
@@ -61,6 +61,10 @@
  *   - rcl/macros.h
  * - Return code types
  *   - rcl/types.h
+ * - Per entity traffic statistics
+ *   - rcl/entity_statistics.h
+ * - Static tracepoints and trace file dumps
+ *   - rcl/tracing.h
  * - Macros for controlling symbol visibility on the library
  *   - rcl/visibility_control.h
  */
@@ -65,6 +65,12 @@ extern "C"
  * Given `foo:=bar alice:foo:=baz` and topic name `foo` the remapped topic name will always be
  * `bar` regardless of the node name given.
  *
+ * The match may contain wildcards: `*` matches exactly one token and `**` matches zero or more
+ * tokens, as few as possible.
+ * The replacement may refer to what the N-th wildcard matched with `\N`, N being 1 to 9.
+ * Given rule `*:=bar/\1` and namespace `/` the topic `/foo` is remapped to `/bar/foo`.
+ * A reference to a wildcard which matched nothing is dropped together with its separator.
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
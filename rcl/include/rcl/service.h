@@ -22,6 +22,7 @@ extern "C"
 
 #include "rosidl_generator_c/service_type_support_struct.h"
 
+#include "rcl/entity_statistics.h"
 #include "rcl/macros.h"
 #include "rcl/node.h"
 #include "rcl/visibility_control.h"
@@ -140,6 +141,7 @@ rcl_get_zero_initialized_service(void);
  * \return `RCL_RET_OK` if service was initialized successfully, or
  * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
  * \return `RCL_RET_NODE_INVALID` if the node is invalid, or
+ * \return `RCL_RET_ENTITY_POOL_EXHAUSTED` if the service pool of the context is full, or
  * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
  * \return `RCL_RET_SERVICE_NAME_INVALID` if the given service name is invalid, or
  * \return `RCL_RET_ERROR` if an unspecified error occurs.
@@ -303,6 +305,92 @@ rcl_send_response(
   rmw_request_id_t * response_header,
   void * ros_response);
 
+/// Take up to `capacity` pending ROS requests using a rcl service.
+/**
+ * This function behaves like calling rcl_take_request() repeatedly until no
+ * request is available or `capacity` requests were taken, but the service
+ * and the arguments are validated only once for the whole batch.
+ *
+ * `request_headers` must point to an array of at least `capacity` headers
+ * and `ros_requests` to an array of at least `capacity` pointers to allocated
+ * ROS request messages of the service's type.
+ * The first `taken_count` headers and requests are filled, the remaining ones
+ * are unmodified.
+ * If an error occurs part way through, the requests taken before it are
+ * still reported in `taken_count`.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Maybe [1]
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ * <i>[1] only if required when filling the requests, avoided for fixed sizes</i>
+ *
+ * \param[in] service the handle to the service from which to take
+ * \param[inout] request_headers array of headers receiving the requests' metadata
+ * \param[inout] ros_requests array of type-erased ptrs to allocated ROS request messages
+ * \param[in] capacity the maximum number of requests to take
+ * \param[out] taken_count the number of requests which were taken
+ * \return `RCL_RET_OK` if at least one request was taken, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_SERVICE_INVALID` if the service is invalid, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_SERVICE_TAKE_FAILED` if no request was available, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_take_request_batch(
+  const rcl_service_t * service,
+  rmw_request_id_t * request_headers,
+  void * const * ros_requests,
+  size_t capacity,
+  size_t * taken_count);
+
+/// Send `count` ROS responses to clients using a service.
+/**
+ * This function behaves like calling rcl_send_response() for each pair of
+ * header and response, but the service and the arguments are validated only
+ * once for the whole batch.
+ * It is typically given the headers filled by rcl_take_request_batch().
+ *
+ * The responses are sent in order and sending stops at the first error, in
+ * which case `sent_count` tells how many responses were sent.
+ * The same thread-safety rules as for rcl_send_response() apply to every
+ * response in the batch.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes [1]
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ * <i>[1] for unique pairs of services and responses, see rcl_send_response()</i>
+ *
+ * \param[in] service handle to the service which will make the responses
+ * \param[inout] response_headers array of `count` headers of the answered requests
+ * \param[in] ros_responses array of `count` type-erased ptrs to ROS response messages
+ * \param[in] count the number of responses to send
+ * \param[out] sent_count the number of responses which were sent
+ * \return `RCL_RET_OK` if all responses were sent successfully, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_SERVICE_INVALID` if the service is invalid, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_send_response_batch(
+  const rcl_service_t * service,
+  rmw_request_id_t * response_headers,
+  void * const * ros_responses,
+  size_t count,
+  size_t * sent_count);
+
 /// Get the topic name for the service.
 /**
  * This function returns the service's internal topic name string.
@@ -410,6 +498,35 @@ RCL_PUBLIC
 bool
 rcl_service_is_valid(const rcl_service_t * service);
 
+/// Get the traffic statistics of a service.
+/**
+ * The statistics count the requests taken by this service since it was
+ * initialized, see rcl_entity_statistics_t for details.
+ * The counters are updated concurrently with this call, so the returned
+ * values are not guaranteed to be a consistent snapshot.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] service pointer to the rcl service
+ * \param[out] statistics the statistics of the service
+ * \return `RCL_RET_OK` if the statistics were retrieved, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_SERVICE_INVALID` if the service is invalid, or
+ * \return `RCL_RET_ERROR` if rcl was built without entity statistics.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_service_get_statistics(
+  const rcl_service_t * service,
+  rcl_entity_statistics_t * statistics);
+
 #ifdef __cplusplus
 }
 #endif
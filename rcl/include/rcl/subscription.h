@@ -22,6 +22,7 @@ extern "C"
 
 #include "rosidl_generator_c/message_type_support_struct.h"
 
+#include "rcl/entity_statistics.h"
 #include "rcl/macros.h"
 #include "rcl/node.h"
 #include "rcl/visibility_control.h"
@@ -141,6 +142,7 @@ rcl_get_zero_initialized_subscription(void);
  * \return `RCL_RET_OK` if subscription was initialized successfully, or
  * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
  * \return `RCL_RET_NODE_INVALID` if the node is invalid, or
+ * \return `RCL_RET_ENTITY_POOL_EXHAUSTED` if the subscription pool of the context is full, or
  * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
  * \return `RCL_RET_TOPIC_NAME_INVALID` if the given topic name is invalid, or
  * \return `RCL_RET_ERROR` if an unspecified error occurs.
@@ -439,6 +441,35 @@ rcl_subscription_get_publisher_count(
   const rcl_subscription_t * subscription,
   size_t * publisher_count);
 
+/// Get the traffic statistics of a subscription.
+/**
+ * The statistics count the messages taken by this subscription since it was
+ * initialized, see rcl_entity_statistics_t for details.
+ * The counters are updated concurrently with this call, so the returned
+ * values are not guaranteed to be a consistent snapshot.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] subscription pointer to the rcl subscription
+ * \param[out] statistics the statistics of the subscription
+ * \return `RCL_RET_OK` if the statistics were retrieved, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_SUBSCRIPTION_INVALID` if the subscription is invalid, or
+ * \return `RCL_RET_ERROR` if rcl was built without entity statistics.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_subscription_get_statistics(
+  const rcl_subscription_t * subscription,
+  rcl_entity_statistics_t * statistics);
+
 #ifdef __cplusplus
 }
 #endif
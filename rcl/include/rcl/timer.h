@@ -144,6 +144,7 @@ rcl_get_zero_initialized_timer(void);
  * \return `RCL_RET_OK` if the timer was initialized successfully, or
  * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
  * \return `RCL_RET_ALREADY_INIT` if the timer was already initialized, or
+ * \return `RCL_RET_ENTITY_POOL_EXHAUSTED` if the timer pool of the context is full, or
  * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
  * \return `RCL_RET_ERROR` an unspecified error occur.
  */
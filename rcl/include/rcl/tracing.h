@@ -0,0 +1,158 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__TRACING_H_
+#define RCL__TRACING_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rcl/macros.h"
+#include "rcl/types.h"
+#include "rcl/visibility_control.h"
+
+/// Number of trace events kept per thread before the oldest ones are overwritten.
+#define RCL_TRACE_BUFFER_CAPACITY 4096
+
+/// Magic bytes at the start of a trace file written by rcl_tracing_dump().
+#define RCL_TRACE_FILE_MAGIC "RCLTRACE"
+/// Version of the trace file format written by rcl_tracing_dump().
+#define RCL_TRACE_FILE_VERSION 1
+
+/// Kind of a static tracepoint.
+typedef enum rcl_trace_event_type_t
+{
+  RCL_TRACE_NODE_INIT = 1,
+  RCL_TRACE_PUBLISHER_INIT = 2,
+  RCL_TRACE_SUBSCRIPTION_INIT = 3,
+  RCL_TRACE_CLIENT_INIT = 4,
+  RCL_TRACE_SERVICE_INIT = 5,
+  RCL_TRACE_TIMER_INIT = 6,
+  /// A message is passed to the middleware, the argument is the serialized size or 0.
+  RCL_TRACE_PUBLISH = 10,
+  /// A take returned, the argument is 1 if a message was taken, 0 otherwise.
+  RCL_TRACE_TAKE = 11,
+  /// A request was sent, the argument is its sequence number.
+  RCL_TRACE_SEND_REQUEST = 12,
+  /// A take_response returned, the argument is the sequence number or -1.
+  RCL_TRACE_TAKE_RESPONSE = 13,
+  /// A take_request returned, the argument is the sequence number or -1.
+  RCL_TRACE_TAKE_REQUEST = 14,
+  /// A response was sent, the argument is its sequence number.
+  RCL_TRACE_SEND_RESPONSE = 15,
+  /// rcl_wait() is about to block, the argument is the timeout in nanoseconds.
+  RCL_TRACE_WAIT_ENTER = 20,
+  /// rcl_wait() woke up, the argument is the rmw return code.
+  RCL_TRACE_WAIT_EXIT = 21,
+  /// A timer was called, the argument is the time since its last call in nanoseconds.
+  RCL_TRACE_TIMER_CALL = 22,
+} rcl_trace_event_type_t;
+
+/// One trace event, as stored in memory and in trace files.
+typedef struct rcl_trace_event_t
+{
+  /// Steady clock time of the event in nanoseconds.
+  int64_t timestamp;
+  /// One of rcl_trace_event_type_t.
+  uint32_t type;
+  /// Index of the thread which recorded the event, in order of first use.
+  uint32_t thread_index;
+  /// Address of the rcl entity the event is about, for correlating events.
+  uint64_t handle;
+  /// Event specific argument, see rcl_trace_event_type_t.
+  int64_t argument;
+} rcl_trace_event_t;
+
+/// Header at the start of a trace file, followed by `event_count` rcl_trace_event_t.
+/**
+ * All fields are written in the byte order of the host which recorded them.
+ * Events are grouped by thread and ordered by time within each thread, so
+ * sort by timestamp to get a process wide timeline.
+ */
+typedef struct rcl_trace_file_header_t
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t event_size;
+  uint64_t event_count;
+} rcl_trace_file_header_t;
+
+/// Return `true` if rcl was built with tracepoints, i.e. `RCL_ENABLE_TRACING` was on.
+RCL_PUBLIC
+bool
+rcl_tracing_is_available(void);
+
+/// Enable or disable the recording of trace events at runtime.
+/**
+ * Tracepoints are compiled in only when rcl is built with the CMake option
+ * `RCL_ENABLE_TRACING`, otherwise they cost nothing and this call has no
+ * effect.
+ * When compiled in, recording is enabled by default.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] enabled whether or not trace events should be recorded
+ */
+RCL_PUBLIC
+void
+rcl_tracing_set_enabled(bool enabled);
+
+/// Write the trace events recorded so far by all threads to a binary file.
+/**
+ * Each thread records into its own lock-free ring buffer of
+ * `RCL_TRACE_BUFFER_CAPACITY` events, so only the most recent events of each
+ * thread are available.
+ * The file starts with a rcl_trace_file_header_t followed by the events.
+ *
+ * Threads may keep recording while the buffers are dumped, in which case the
+ * events written concurrently may or may not be part of the file, but no
+ * event is written to the file partially overwritten.
+ * The events of threads which exited are kept until a new thread takes over
+ * their buffer.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] file_path path of the file to create or overwrite
+ * \return `RCL_RET_OK` if the file was written, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_ERROR` if the file could not be written or rcl was built
+ *   without tracing.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_tracing_dump(const char * file_path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__TRACING_H_
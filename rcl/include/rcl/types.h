@@ -44,6 +44,8 @@ typedef rmw_ret_t rcl_ret_t;
 #define RCL_RET_UNKNOWN_SUBSTITUTION 105
 /// rcl_shutdown() already called return code.
 #define RCL_RET_ALREADY_SHUTDOWN 106
+/// All slots of an entity pool of the context are in use return code.
+#define RCL_RET_ENTITY_POOL_EXHAUSTED 107
 
 // rcl node specific ret codes in 2XX
 /// Invalid rcl_node_t given return code.
@@ -66,6 +68,8 @@ typedef rmw_ret_t rcl_ret_t;
 #define RCL_RET_CLIENT_INVALID 500
 /// Failed to take a response from the client return code.
 #define RCL_RET_CLIENT_TAKE_FAILED 501
+/// Too many requests of the client are waiting for a response return code.
+#define RCL_RET_CLIENT_PENDING_REQUESTS_FULL 502
 
 // rcl service server specific ret codes in 6XX
 /// Invalid rcl_service_t given return code.
@@ -110,6 +110,41 @@ rcl_validate_topic_name_with_size(
   int * validation_result,
   size_t * invalid_index);
 
+/// Validate an array of topic names.
+/**
+ * Each name is validated as with rcl_validate_topic_name(), and the results
+ * are stored at the same position in validation_results and, if not NULL,
+ * in invalid_indices.
+ * As for a single name, the invalid index of a valid name is not set.
+ *
+ * Validation stops at the first name which is NULL, in which case the
+ * results of the names before it have been stored.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] topic_names the null terminated topic names to be validated
+ * \param[in] topic_name_count the number of names in topic_names
+ * \param[out] validation_results the reason for validation failure of each name, if any
+ * \param[out] invalid_indices index of violation of each invalid name, or NULL
+ * \return `RCL_RET_OK` if all the names were validated, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_validate_topic_names(
+  const char * const * topic_names,
+  size_t topic_name_count,
+  int * validation_results,
+  size_t * invalid_indices);
+
 /// Return a validation result description, or NULL if unknown or RCL_TOPIC_NAME_VALID.
 RCL_PUBLIC
 RCL_WARN_UNUSED
@@ -24,6 +24,7 @@ extern "C"
 #include <stddef.h>
 
 #include "rcl/client.h"
+#include "rcl/context.h"
 #include "rcl/guard_condition.h"
 #include "rcl/macros.h"
 #include "rcl/service.h"
@@ -124,6 +125,60 @@ rcl_wait_set_init(
   size_t number_of_services,
   rcl_allocator_t allocator);
 
+/// Initialize a rcl wait set which may draw its memory from the entity pools of a context.
+/**
+ * This function behaves like rcl_wait_set_init(), except when the context
+ * was initialized with pooled wait sets, see
+ * rcl_init_options_set_entity_pool_capacities().
+ * A pooled wait set takes one slot of the wait set pool of the context, which
+ * holds its implementation struct and its arrays, so neither initializing it
+ * nor calling rcl_wait_set_resize() on it allocates memory in rcl.
+ * The rmw implementation may still allocate when creating its own wait set.
+ *
+ * A pooled wait set holds at most as many entities of all kinds as the
+ * `wait_set_entries` capacity of the pools.
+ *
+ * The wait set must be finalized before the context.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes [1]
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ * <i>[1] rcl allocates no memory if wait sets are pooled</i>
+ *
+ * \param[inout] wait_set the wait set struct to be initialized
+ * \param[in] number_of_subscriptions non-zero size of the subscriptions set
+ * \param[in] number_of_guard_conditions non-zero size of the guard conditions set
+ * \param[in] number_of_timers non-zero size of the timers set
+ * \param[in] number_of_clients non-zero size of the clients set
+ * \param[in] number_of_services non-zero size of the services set
+ * \param[in] context the context whose pools are used
+ * \param[in] allocator the allocator to use when wait sets are not pooled
+ * \return `RCL_RET_OK` if the wait set is initialized successfully, or
+ * \return `RCL_RET_ALREADY_INIT` if the wait set is not zero initialized, or
+ * \return `RCL_RET_NOT_INIT` if the given context is invalid, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_ENTITY_POOL_EXHAUSTED` if all slots of the wait set pool are in use, or
+ *   if the sets do not fit in a slot, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_PUBLIC
+RCL_WARN_UNUSED
+rcl_ret_t
+rcl_wait_set_init_with_context(
+  rcl_wait_set_t * wait_set,
+  size_t number_of_subscriptions,
+  size_t number_of_guard_conditions,
+  size_t number_of_timers,
+  size_t number_of_clients,
+  size_t number_of_services,
+  rcl_context_t * context,
+  rcl_allocator_t allocator);
+
 /// Finalize a rcl wait set.
 /**
  * Deallocates any memory in the wait set that was allocated in
@@ -248,6 +303,8 @@ rcl_wait_set_clear(rcl_wait_set_t * wait_set);
  *
  * Allocation and deallocation is done with the allocator given during the
  * wait set's initialization.
+ * A pooled wait set, see rcl_wait_set_init_with_context(), instead lays the
+ * sets out in its pool slot, and fails if they do not fit in it.
  *
  * After calling this function all values in the set will be set to `NULL`,
  * effectively the same as calling rcl_wait_set_clear().
@@ -274,6 +331,7 @@ rcl_wait_set_clear(rcl_wait_set_t * wait_set);
  * \param[in] services_size a size for the new services set
  * \return `RCL_RET_OK` if resized successfully, or
  * \return `RCL_RET_INVALID_ARGUMENT` if any arguments are invalid, or
+ * \return `RCL_RET_ENTITY_POOL_EXHAUSTED` if the sets do not fit in the pool slot, or
  * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
  * \return `RCL_RET_ERROR` if an unspecified error occurs.
  */
@@ -353,6 +411,9 @@ rcl_wait_set_add_service(
  * perhaps that the state of the subscriptions has changed, in which case
  * rcl_take may succeed but return with taken == false.
  * For guard conditions this means the guard condition was triggered.
+ * For clients this means a response may be taken, or one of the client's
+ * pending requests expired, see rcl_send_request_with_timeout(); the wait
+ * does not block past the earliest deadline of the clients in the set.
  *
  * Expected usage:
  *
@@ -0,0 +1,190 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./allocation_audit_impl.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rcutils/error_handling.h"
+#include "rcutils/macros.h"
+#include "rcutils/stdatomic_helper.h"
+
+static const char * const __rcl_allocation_audit_api_names[RCL_ALLOCATION_AUDIT_API_COUNT] = {
+  "other",
+  "rcl_wait",
+  "rcl_take",
+  "rcl_publish",
+  "rcl_timer_call",
+  "rcl_send_response",
+};
+
+static atomic_uint_least64_t __rcl_allocation_audit_counts[RCL_ALLOCATION_AUDIT_API_COUNT];
+static atomic_uint_least64_t __rcl_allocation_audit_real_time_count = ATOMIC_VAR_INIT(0);
+static atomic_bool __rcl_allocation_audit_abort = ATOMIC_VAR_INIT(false);
+/// rcl function the calling thread is in.
+static RCUTILS_THREAD_LOCAL rcl_allocation_audit_api_t __rcl_allocation_audit_thread_api =
+  RCL_ALLOCATION_AUDIT_OTHER;
+/// Number of real-time sections the calling thread is in.
+static RCUTILS_THREAD_LOCAL unsigned int __rcl_allocation_audit_thread_real_time_depth = 0;
+
+rcl_allocation_audit_api_t
+rcl_allocation_audit_enter_api(rcl_allocation_audit_api_t api)
+{
+  rcl_allocation_audit_api_t previous_api = __rcl_allocation_audit_thread_api;
+  __rcl_allocation_audit_thread_api = api;
+  return previous_api;
+}
+
+void
+rcl_allocation_audit_exit_api(rcl_allocation_audit_api_t previous_api)
+{
+  __rcl_allocation_audit_thread_api = previous_api;
+}
+
+static void
+_rcl_allocation_audit_record(void)
+{
+  rcl_allocation_audit_api_t api = __rcl_allocation_audit_thread_api;
+  rcutils_atomic_fetch_add_uint64_t(&__rcl_allocation_audit_counts[api], 1);
+  if (0 == __rcl_allocation_audit_thread_real_time_depth) {
+    return;
+  }
+  rcutils_atomic_fetch_add_uint64_t(&__rcl_allocation_audit_real_time_count, 1);
+  if (rcutils_atomic_load_bool(&__rcl_allocation_audit_abort)) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR(
+      "[rcl|allocation_audit.c:" RCUTILS_STRINGIFY(__LINE__)
+      "] memory allocated inside a real-time section, in: ");
+    RCUTILS_SAFE_FWRITE_TO_STDERR(__rcl_allocation_audit_api_names[api]);
+    RCUTILS_SAFE_FWRITE_TO_STDERR("\n");
+    abort();
+  }
+}
+
+static void *
+_rcl_allocation_audit_allocate(size_t size, void * state)
+{
+  const rcl_allocator_t * allocator = (const rcl_allocator_t *)state;
+  _rcl_allocation_audit_record();
+  return allocator->allocate(size, allocator->state);
+}
+
+static void
+_rcl_allocation_audit_deallocate(void * pointer, void * state)
+{
+  const rcl_allocator_t * allocator = (const rcl_allocator_t *)state;
+  allocator->deallocate(pointer, allocator->state);
+}
+
+static void *
+_rcl_allocation_audit_reallocate(void * pointer, size_t size, void * state)
+{
+  const rcl_allocator_t * allocator = (const rcl_allocator_t *)state;
+  _rcl_allocation_audit_record();
+  return allocator->reallocate(pointer, size, allocator->state);
+}
+
+static void *
+_rcl_allocation_audit_zero_allocate(size_t number_of_elements, size_t size, void * state)
+{
+  const rcl_allocator_t * allocator = (const rcl_allocator_t *)state;
+  _rcl_allocation_audit_record();
+  return allocator->zero_allocate(number_of_elements, size, allocator->state);
+}
+
+bool
+rcl_allocation_audit_is_available(void)
+{
+#ifdef RCL_ENABLE_ALLOCATION_AUDIT
+  return true;
+#else
+  return false;
+#endif
+}
+
+rcl_allocator_t
+rcl_allocation_audit_get_allocator(const rcl_allocator_t * allocator)
+{
+  rcl_allocator_t audit_allocator = {
+    .allocate = _rcl_allocation_audit_allocate,
+    .deallocate = _rcl_allocation_audit_deallocate,
+    .reallocate = _rcl_allocation_audit_reallocate,
+    .zero_allocate = _rcl_allocation_audit_zero_allocate,
+    .state = (void *)allocator,
+  };
+  return audit_allocator;
+}
+
+uint64_t
+rcl_allocation_audit_get_count(rcl_allocation_audit_api_t api)
+{
+  if ((size_t)api >= RCL_ALLOCATION_AUDIT_API_COUNT) {
+    return 0;
+  }
+  return rcutils_atomic_load_uint64_t(&__rcl_allocation_audit_counts[api]);
+}
+
+uint64_t
+rcl_allocation_audit_get_real_time_count(void)
+{
+  return rcutils_atomic_load_uint64_t(&__rcl_allocation_audit_real_time_count);
+}
+
+const char *
+rcl_allocation_audit_get_api_name(rcl_allocation_audit_api_t api)
+{
+  if ((size_t)api >= RCL_ALLOCATION_AUDIT_API_COUNT) {
+    return __rcl_allocation_audit_api_names[RCL_ALLOCATION_AUDIT_OTHER];
+  }
+  return __rcl_allocation_audit_api_names[api];
+}
+
+void
+rcl_allocation_audit_reset_counts(void)
+{
+  for (size_t i = 0; i < RCL_ALLOCATION_AUDIT_API_COUNT; ++i) {
+    rcutils_atomic_store(&__rcl_allocation_audit_counts[i], 0);
+  }
+  rcutils_atomic_store(&__rcl_allocation_audit_real_time_count, 0);
+}
+
+void
+rcl_allocation_audit_set_abort_in_real_time_section(bool enabled)
+{
+  rcutils_atomic_store(&__rcl_allocation_audit_abort, enabled);
+}
+
+void
+rcl_allocation_audit_enter_real_time_section(void)
+{
+  ++__rcl_allocation_audit_thread_real_time_depth;
+}
+
+void
+rcl_allocation_audit_exit_real_time_section(void)
+{
+  if (__rcl_allocation_audit_thread_real_time_depth > 0) {
+    --__rcl_allocation_audit_thread_real_time_depth;
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
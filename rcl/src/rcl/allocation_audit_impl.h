@@ -0,0 +1,48 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__ALLOCATION_AUDIT_IMPL_H_
+#define RCL__ALLOCATION_AUDIT_IMPL_H_
+
+#include "rcl/allocation_audit.h"
+#include "rcl/visibility_control.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// Tag the allocations of the calling thread with `api`, returning the previous tag.
+RCL_LOCAL
+rcl_allocation_audit_api_t
+rcl_allocation_audit_enter_api(rcl_allocation_audit_api_t api);
+
+/// Restore the tag returned by rcl_allocation_audit_enter_api().
+RCL_LOCAL
+void
+rcl_allocation_audit_exit_api(rcl_allocation_audit_api_t previous_api);
+
+#ifdef RCL_ENABLE_ALLOCATION_AUDIT
+# define RCL_ALLOCATION_AUDIT_ENTER(api) rcl_allocation_audit_enter_api(api)
+# define RCL_ALLOCATION_AUDIT_EXIT(previous_api) rcl_allocation_audit_exit_api(previous_api)
+#else
+# define RCL_ALLOCATION_AUDIT_ENTER(api) RCL_ALLOCATION_AUDIT_OTHER
+# define RCL_ALLOCATION_AUDIT_EXIT(previous_api) ((void)(previous_api))
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__ALLOCATION_AUDIT_IMPL_H_
@@ -16,6 +16,7 @@
 
 #include "rcl/arguments.h"
 
+#include <limits.h>
 #include <string.h>
 
 #include "./arguments_impl.h"
@@ -28,6 +29,7 @@
 #include "rcutils/format_string.h"
 #include "rcutils/logging.h"
 #include "rcutils/logging_macros.h"
+#include "rcutils/stdatomic_helper.h"
 #include "rcutils/strdup.h"
 #include "rmw/validate_namespace.h"
 #include "rmw/validate_node_name.h"
@@ -182,6 +184,298 @@ _atob(
   const char * str,
   bool * val);
 
+/// Kind of a ROS argument, told by its prefix before it is parsed.
+typedef enum rcl_argument_kind_t
+{
+  RCL_ARGUMENT_UNKNOWN = 0,
+  RCL_ARGUMENT_REMAP,
+  RCL_ARGUMENT_PARAM_FILE,
+  RCL_ARGUMENT_LOG_LEVEL,
+  RCL_ARGUMENT_LOG_CONFIG_FILE,
+  RCL_ARGUMENT_LOG_DISABLE_STDOUT,
+  RCL_ARGUMENT_LOG_DISABLE_ROSOUT,
+  RCL_ARGUMENT_LOG_DISABLE_EXT_LIB,
+  RCL_ARGUMENT_REMAP_FILE
+} rcl_argument_kind_t;
+
+typedef struct rcl_argument_prefix_t
+{
+  const char * prefix;
+  size_t length;
+  rcl_argument_kind_t kind;
+  /// Name of the rule in debug messages.
+  const char * name;
+} rcl_argument_prefix_t;
+
+#define RCL_ARGUMENT_PREFIX(prefix, kind, name) {prefix, sizeof(prefix) - 1, kind, name}
+
+/// Prefixes of all the arguments but remap rules, which all start with a double underscore.
+static const rcl_argument_prefix_t g_argument_prefixes[] = {
+  RCL_ARGUMENT_PREFIX(RCL_PARAM_FILE_ARG_RULE, RCL_ARGUMENT_PARAM_FILE, "parameter file"),
+  RCL_ARGUMENT_PREFIX(RCL_LOG_LEVEL_ARG_RULE, RCL_ARGUMENT_LOG_LEVEL, "log level"),
+  RCL_ARGUMENT_PREFIX(
+    RCL_EXTERNAL_LOG_CONFIG_ARG_RULE, RCL_ARGUMENT_LOG_CONFIG_FILE, "log config"),
+  RCL_ARGUMENT_PREFIX(
+    RCL_LOG_DISABLE_STDOUT_ARG_RULE, RCL_ARGUMENT_LOG_DISABLE_STDOUT, "log_stdout_disabled"),
+  RCL_ARGUMENT_PREFIX(
+    RCL_LOG_DISABLE_ROSOUT_ARG_RULE, RCL_ARGUMENT_LOG_DISABLE_ROSOUT, "log_rosout_disabled"),
+  RCL_ARGUMENT_PREFIX(
+    RCL_LOG_DISABLE_EXT_LIB_ARG_RULE, RCL_ARGUMENT_LOG_DISABLE_EXT_LIB, "log_ext_lib_disabled"),
+  RCL_ARGUMENT_PREFIX(RCL_REMAP_FILE_ARG_RULE, RCL_ARGUMENT_REMAP_FILE, "remap file"),
+};
+
+/// Tell which rule an argument can be, without parsing it or setting an error.
+/**
+ * Every rule has a `:=`, and no remap rule starts with any of the prefixes of
+ * the other rules, so at most one parser needs to be tried.
+ *
+ * \param[in] arg the argument, may be `NULL`
+ * \param[out] name the name of the rule, set unless RCL_ARGUMENT_UNKNOWN is returned
+ * \return the only kind of rule the argument can be, or
+ * \return RCL_ARGUMENT_UNKNOWN if it can not be a rule.
+ */
+static rcl_argument_kind_t
+_rcl_get_argument_kind(const char * arg, const char ** name)
+{
+  if (NULL == arg) {
+    return RCL_ARGUMENT_UNKNOWN;
+  }
+  if ('_' == arg[0] && '_' == arg[1]) {
+    size_t i;
+    for (i = 0; i < sizeof(g_argument_prefixes) / sizeof(g_argument_prefixes[0]); ++i) {
+      if (0 == strncmp(g_argument_prefixes[i].prefix, arg, g_argument_prefixes[i].length)) {
+        *name = g_argument_prefixes[i].name;
+        return g_argument_prefixes[i].kind;
+      }
+    }
+  }
+  if (NULL == strstr(arg, ":=")) {
+    return RCL_ARGUMENT_UNKNOWN;
+  }
+  *name = "remap";
+  return RCL_ARGUMENT_REMAP;
+}
+
+/// Make room for the rules of an argument, keeping a slot for each argument left to parse.
+static rcl_ret_t
+_rcl_reserve_remap_rules(
+  rcl_arguments_impl_t * args_impl,
+  size_t rule_count,
+  int * remap_rules_capacity)
+{
+  // The argument being parsed already has a slot.
+  if (rule_count <= 1) {
+    return RCL_RET_OK;
+  }
+  if (rule_count - 1 > (size_t)(INT_MAX - *remap_rules_capacity)) {
+    RCL_SET_ERROR_MSG("too many remap rules");
+    return RCL_RET_INVALID_REMAP_RULE;
+  }
+  int capacity = *remap_rules_capacity + (int)(rule_count - 1);
+  rcl_allocator_t allocator = args_impl->allocator;
+  rcl_remap_t * remap_rules = allocator.reallocate(
+    args_impl->remap_rules, sizeof(rcl_remap_t) * capacity, allocator.state);
+  if (NULL == remap_rules) {
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    return RCL_RET_BAD_ALLOC;
+  }
+  args_impl->remap_rules = remap_rules;
+  *remap_rules_capacity = capacity;
+  return RCL_RET_OK;
+}
+
+/// Parse the remap rules of a text file, one per line, appending all or none of them.
+static rcl_ret_t
+_rcl_parse_remap_text_file(
+  rcl_arguments_impl_t * args_impl,
+  const rcl_remap_file_t * file,
+  size_t rule_count,
+  const char * file_path)
+{
+  rcl_allocator_t allocator = args_impl->allocator;
+  rcl_remap_t * rules = &(args_impl->remap_rules[args_impl->num_remap_rules]);
+  rcl_ret_t ret = RCL_RET_OK;
+  // The lexer needs null terminated rules.
+  char * line_buffer = NULL;
+  size_t line_buffer_size = 0;
+  size_t position = 0;
+  size_t num_parsed = 0;
+  const char * line;
+  size_t line_length;
+  while (
+    num_parsed < rule_count && rcl_remap_file_next_line(file, &position, &line, &line_length))
+  {
+    if (line_length >= line_buffer_size) {
+      char * new_buffer = allocator.reallocate(line_buffer, line_length + 1, allocator.state);
+      if (NULL == new_buffer) {
+        RCL_SET_ERROR_MSG("allocating memory failed");
+        ret = RCL_RET_BAD_ALLOC;
+        break;
+      }
+      line_buffer = new_buffer;
+      line_buffer_size = line_length + 1;
+    }
+    memcpy(line_buffer, line, line_length);
+    line_buffer[line_length] = '\0';
+    rules[num_parsed] = rcl_remap_get_zero_initialized();
+    ret = _rcl_parse_remap_rule(line_buffer, allocator, &(rules[num_parsed]));
+    if (RCL_RET_OK != ret) {
+      if (RCL_RET_BAD_ALLOC != ret) {
+        rcl_reset_error();
+        RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
+          "rule %zu of remap file '%s' is invalid: %.*s",
+          num_parsed + 1, file_path, (int)line_length, line);
+        ret = RCL_RET_INVALID_REMAP_RULE;
+      }
+      break;
+    }
+    ++num_parsed;
+  }
+  if (NULL != line_buffer) {
+    allocator.deallocate(line_buffer, allocator.state);
+  }
+  if (RCL_RET_OK != ret) {
+    for (size_t i = 0; i < num_parsed; ++i) {
+      if (RCL_RET_OK != rcl_remap_fini(&(rules[i]))) {
+        RCUTILS_LOG_ERROR_NAMED(ROS_PACKAGE_NAME, "Failed to fini remap rule after error occurred");
+      }
+    }
+    return ret;
+  }
+  args_impl->num_remap_rules += (int)num_parsed;
+  return RCL_RET_OK;
+}
+
+/// Parse an argument that is a remap file rule, appending the rules of the file.
+/**
+ * A compiled file stays mapped until the arguments are finalized, since its
+ * rules point into it; a text file is unmapped once its rules are parsed.
+ */
+static rcl_ret_t
+_rcl_parse_remap_file_rule(
+  rcl_arguments_impl_t * args_impl,
+  const char * arg,
+  int * remap_rules_capacity)
+{
+  const char * file_path = arg + strlen(RCL_REMAP_FILE_ARG_RULE);
+  rcl_remap_file_t file = rcl_get_zero_initialized_remap_file();
+  rcl_ret_t ret = rcl_remap_file_map(file_path, &file);
+  if (RCL_RET_OK != ret) {
+    return ret;  // error already set
+  }
+  rcl_allocator_t allocator = args_impl->allocator;
+  bool is_compiled = rcl_remap_file_is_compiled(&file);
+  size_t rule_count = 0;
+  if (is_compiled) {
+    ret = rcl_remap_file_get_rule_count(&file, &rule_count);
+  } else {
+    size_t position = 0;
+    const char * line;
+    size_t line_length;
+    while (rcl_remap_file_next_line(&file, &position, &line, &line_length)) {
+      ++rule_count;
+    }
+  }
+  if (RCL_RET_OK == ret) {
+    ret = _rcl_reserve_remap_rules(args_impl, rule_count, remap_rules_capacity);
+  }
+  if (RCL_RET_OK == ret && is_compiled && rule_count > 0) {
+    rcl_remap_file_t * remap_files = allocator.reallocate(
+      args_impl->remap_files, sizeof(rcl_remap_file_t) * (args_impl->num_remap_files + 1),
+      allocator.state);
+    if (NULL == remap_files) {
+      RCL_SET_ERROR_MSG("allocating memory failed");
+      ret = RCL_RET_BAD_ALLOC;
+    } else {
+      args_impl->remap_files = remap_files;
+      ret = rcl_remap_file_load_rules(
+        &file, allocator, &(args_impl->remap_rules[args_impl->num_remap_rules]));
+    }
+    if (RCL_RET_OK == ret) {
+      args_impl->remap_files[args_impl->num_remap_files] = file;
+      ++(args_impl->num_remap_files);
+      args_impl->num_remap_rules += (int)rule_count;
+      RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME,
+        "mapped %zu remap rules from %s", rule_count, file_path);
+      return RCL_RET_OK;
+    }
+  } else if (RCL_RET_OK == ret && !is_compiled) {
+    ret = _rcl_parse_remap_text_file(args_impl, &file, rule_count, file_path);
+  }
+  if (RCL_RET_OK != rcl_remap_file_unmap(&file)) {
+    RCUTILS_LOG_ERROR_NAMED(ROS_PACKAGE_NAME, "Failed to unmap remap file %s", file_path);
+  }
+  return ret;
+}
+
+/// Parse an argument as the kind of rule it was identified as, and store it.
+static rcl_ret_t
+_rcl_parse_argument(
+  rcl_arguments_impl_t * args_impl,
+  rcl_argument_kind_t kind,
+  const char * arg,
+  int * remap_rules_capacity)
+{
+  rcl_allocator_t allocator = args_impl->allocator;
+  rcl_ret_t ret = RCL_RET_ERROR;
+  switch (kind) {
+    case RCL_ARGUMENT_PARAM_FILE:
+      args_impl->parameter_files[args_impl->num_param_files_args] = NULL;
+      ret = _rcl_parse_param_file_rule(
+        arg, allocator, &(args_impl->parameter_files[args_impl->num_param_files_args]));
+      if (RCL_RET_OK == ret) {
+        ++(args_impl->num_param_files_args);
+        RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME,
+          "params rule : %s\n total num param rules %d",
+          args_impl->parameter_files[args_impl->num_param_files_args - 1],
+          args_impl->num_param_files_args);
+      }
+      break;
+    case RCL_ARGUMENT_REMAP:
+      {
+        rcl_remap_t * rule = &(args_impl->remap_rules[args_impl->num_remap_rules]);
+        *rule = rcl_remap_get_zero_initialized();
+        ret = _rcl_parse_remap_rule(arg, allocator, rule);
+        if (RCL_RET_OK == ret) {
+          ++(args_impl->num_remap_rules);
+        }
+      }
+      break;
+    case RCL_ARGUMENT_LOG_LEVEL:
+      {
+        int log_level;
+        ret = _rcl_parse_log_level_rule(arg, allocator, &log_level);
+        if (RCL_RET_OK == ret) {
+          args_impl->log_level = log_level;
+        }
+      }
+      break;
+    case RCL_ARGUMENT_LOG_CONFIG_FILE:
+      ret = _rcl_parse_external_log_config_file(
+        arg, allocator, &args_impl->external_log_config_file);
+      break;
+    case RCL_ARGUMENT_LOG_DISABLE_STDOUT:
+      ret = _rcl_parse_bool_arg(
+        arg, RCL_LOG_DISABLE_STDOUT_ARG_RULE, &args_impl->log_stdout_disabled);
+      break;
+    case RCL_ARGUMENT_LOG_DISABLE_ROSOUT:
+      ret = _rcl_parse_bool_arg(
+        arg, RCL_LOG_DISABLE_ROSOUT_ARG_RULE, &args_impl->log_rosout_disabled);
+      break;
+    case RCL_ARGUMENT_LOG_DISABLE_EXT_LIB:
+      ret = _rcl_parse_bool_arg(
+        arg, RCL_LOG_DISABLE_EXT_LIB_ARG_RULE, &args_impl->log_ext_lib_disabled);
+      break;
+    case RCL_ARGUMENT_REMAP_FILE:
+      ret = _rcl_parse_remap_file_rule(args_impl, arg, remap_rules_capacity);
+      break;
+    default:
+      RCL_SET_ERROR_MSG("Argument is not a rule");
+      break;
+  }
+  return ret;
+}
+
 rcl_ret_t
 rcl_parse_arguments(
   int argc,
@@ -211,8 +505,11 @@ rcl_parse_arguments(
     return RCL_RET_BAD_ALLOC;
   }
   rcl_arguments_impl_t * args_impl = args_output->impl;
+  atomic_init(&(args_impl->ref_count), 1);
   args_impl->num_remap_rules = 0;
   args_impl->remap_rules = NULL;
+  args_impl->remap_files = NULL;
+  args_impl->num_remap_files = 0;
   args_impl->log_level = -1;
   args_impl->external_log_config_file = NULL;
   args_impl->unparsed_args = NULL;
@@ -229,7 +526,8 @@ rcl_parse_arguments(
     return RCL_RET_OK;
   }
 
-  // over-allocate arrays to match the number of arguments
+  // over-allocate arrays to match the number of arguments, remap files may grow remap_rules
+  int remap_rules_capacity = argc;
   args_impl->remap_rules = allocator.allocate(sizeof(rcl_remap_t) * argc, allocator.state);
   if (NULL == args_impl->remap_rules) {
     ret = RCL_RET_BAD_ALLOC;
@@ -247,91 +545,22 @@ rcl_parse_arguments(
   }
 
   for (int i = 0; i < argc; ++i) {
-    // Attempt to parse argument as parameter file rule
-    args_impl->parameter_files[args_impl->num_param_files_args] = NULL;
-    if (
-      RCL_RET_OK == _rcl_parse_param_file_rule(
-        argv[i], allocator, &(args_impl->parameter_files[args_impl->num_param_files_args])))
-    {
-      ++(args_impl->num_param_files_args);
+    // Only the parser of the rule the argument looks like is tried
+    const char * rule_name = NULL;
+    rcl_argument_kind_t kind = _rcl_get_argument_kind(argv[i], &rule_name);
+    if (RCL_ARGUMENT_UNKNOWN != kind) {
+      ret = _rcl_parse_argument(args_impl, kind, argv[i], &remap_rules_capacity);
+      if (RCL_RET_OK == ret) {
+        continue;
+      }
+      if (RCL_RET_BAD_ALLOC == ret) {
+        goto fail;
+      }
       RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME,
-        "params rule : %s\n total num param rules %d",
-        args_impl->parameter_files[args_impl->num_param_files_args - 1],
-        args_impl->num_param_files_args);
-      continue;
-    }
-    RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME,
-      "Couldn't parse arg %d (%s) as parameter file rule. Error: %s", i, argv[i],
-      rcl_get_error_string().str);
-    rcl_reset_error();
-
-    // Attempt to parse argument as remap rule
-    rcl_remap_t * rule = &(args_impl->remap_rules[args_impl->num_remap_rules]);
-    *rule = rcl_remap_get_zero_initialized();
-    if (RCL_RET_OK == _rcl_parse_remap_rule(argv[i], allocator, rule)) {
-      ++(args_impl->num_remap_rules);
-      continue;
-    }
-    RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME,
-      "Couldn't parse arg %d (%s) as remap rule. Error: %s", i, argv[i],
-      rcl_get_error_string().str);
-    rcl_reset_error();
-
-    // Attempt to parse argument as log level configuration
-    int log_level;
-    if (RCL_RET_OK == _rcl_parse_log_level_rule(argv[i], allocator, &log_level)) {
-      args_impl->log_level = log_level;
-      continue;
-    }
-    RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME,
-      "Couldn't parse arg %d (%s) as log level rule. Error: %s", i, argv[i],
-      rcl_get_error_string().str);
-    rcl_reset_error();
-
-    // Attempt to parse argument as log configuration file
-    rcl_ret_t ret = _rcl_parse_external_log_config_file(
-      argv[i], allocator, &args_impl->external_log_config_file);
-    if (RCL_RET_OK == ret) {
-      continue;
-    }
-    RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME,
-      "Couldn't parse arg %d (%s) as log config rule. Error: %s", i, argv[i],
-      rcl_get_error_string().str);
-    rcl_reset_error();
-
-    // Attempt to parse argument as log_stdout_disabled
-    ret = _rcl_parse_bool_arg(
-      argv[i], RCL_LOG_DISABLE_STDOUT_ARG_RULE, &args_impl->log_stdout_disabled);
-    if (RCL_RET_OK == ret) {
-      continue;
-    }
-    RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME,
-      "Couldn't parse arg %d (%s) as log_stdout_disabled rule. Error: %s", i, argv[i],
-      rcl_get_error_string().str);
-    rcl_reset_error();
-
-    // Attempt to parse argument as log_rosout_disabled
-    ret = _rcl_parse_bool_arg(
-      argv[i], RCL_LOG_DISABLE_ROSOUT_ARG_RULE, &args_impl->log_rosout_disabled);
-    if (RCL_RET_OK == ret) {
-      continue;
-    }
-    RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME,
-      "Couldn't parse arg %d (%s) as log_rosout_disabled rule. Error: %s", i, argv[i],
-      rcl_get_error_string().str);
-    rcl_reset_error();
-
-    // Attempt to parse argument as log_ext_lib_disabled
-    ret = _rcl_parse_bool_arg(
-      argv[i], RCL_LOG_DISABLE_EXT_LIB_ARG_RULE, &args_impl->log_ext_lib_disabled);
-    if (RCL_RET_OK == ret) {
-      continue;
+        "Couldn't parse arg %d (%s) as %s rule. Error: %s", i, argv[i], rule_name,
+        rcl_get_error_string().str);
+      rcl_reset_error();
     }
-    RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME,
-      "Couldn't parse arg %d (%s) as log_ext_lib_disabled rule. Error: %s", i, argv[i],
-      rcl_get_error_string().str);
-    rcl_reset_error();
-
 
     // Argument wasn't parsed by any rule
     args_impl->unparsed_args[args_impl->num_unparsed_args] = i;
@@ -475,6 +704,19 @@ rcl_remove_ros_arguments(
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_arguments_write_remap_file(
+  const rcl_arguments_t * args,
+  const char * file_path)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(args, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(args->impl, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(file_path, RCL_RET_INVALID_ARGUMENT);
+  return rcl_remap_file_write(
+    args->impl->remap_rules, (size_t)args->impl->num_remap_rules, file_path,
+    args->impl->allocator);
+}
+
 rcl_ret_t
 rcl_arguments_copy(
   const rcl_arguments_t * args,
@@ -488,79 +730,11 @@ rcl_arguments_copy(
     return RCL_RET_INVALID_ARGUMENT;
   }
 
-  rcl_allocator_t allocator = args->impl->allocator;
-
-  args_out->impl = allocator.allocate(sizeof(rcl_arguments_impl_t), allocator.state);
-  if (NULL == args_out->impl) {
-    return RCL_RET_BAD_ALLOC;
-  }
-
-  args_out->impl->allocator = allocator;
-
-  // Zero so it's safe to call rcl_arguments_fini() if an error occurrs while copying.
-  args_out->impl->num_remap_rules = 0;
-  args_out->impl->num_unparsed_args = 0;
-  args_out->impl->num_param_files_args = 0;
-
-  // Copy unparsed args
-  args_out->impl->unparsed_args = allocator.allocate(
-    sizeof(int) * args->impl->num_unparsed_args, allocator.state);
-  if (NULL == args_out->impl->unparsed_args) {
-    if (RCL_RET_OK != rcl_arguments_fini(args_out)) {
-      RCL_SET_ERROR_MSG("Error while finalizing arguments due to another error");
-    }
-    return RCL_RET_BAD_ALLOC;
-  }
-  for (int i = 0; i < args->impl->num_unparsed_args; ++i) {
-    args_out->impl->unparsed_args[i] = args->impl->unparsed_args[i];
-  }
-  args_out->impl->num_unparsed_args = args->impl->num_unparsed_args;
-
-  // Copy remap rules
-  args_out->impl->remap_rules = allocator.allocate(
-    sizeof(rcl_remap_t) * args->impl->num_remap_rules, allocator.state);
-  if (NULL == args_out->impl->remap_rules) {
-    if (RCL_RET_OK != rcl_arguments_fini(args_out)) {
-      RCL_SET_ERROR_MSG("Error while finalizing arguments due to another error");
-    }
-    return RCL_RET_BAD_ALLOC;
-  }
-  args_out->impl->num_remap_rules = args->impl->num_remap_rules;
-  for (int i = 0; i < args->impl->num_remap_rules; ++i) {
-    args_out->impl->remap_rules[i] = rcl_remap_get_zero_initialized();
-    rcl_ret_t ret = rcl_remap_copy(
-      &(args->impl->remap_rules[i]), &(args_out->impl->remap_rules[i]));
-    if (RCL_RET_OK != ret) {
-      if (RCL_RET_OK != rcl_arguments_fini(args_out)) {
-        RCL_SET_ERROR_MSG("Error while finalizing arguments due to another error");
-      }
-      return ret;
-    }
-  }
-  // Copy parameter files
-  if (args->impl->num_param_files_args) {
-    args_out->impl->parameter_files = allocator.allocate(
-      sizeof(char *) * args->impl->num_param_files_args, allocator.state);
-    if (NULL == args_out->impl->parameter_files) {
-      if (RCL_RET_OK != rcl_arguments_fini(args_out)) {
-        RCL_SET_ERROR_MSG("Error while finalizing arguments due to another error");
-      }
-      return RCL_RET_BAD_ALLOC;
-    }
-    args_out->impl->num_param_files_args = args->impl->num_param_files_args;
-    for (int i = 0; i < args->impl->num_param_files_args; ++i) {
-      args_out->impl->parameter_files[i] =
-        rcutils_strdup(args->impl->parameter_files[i], allocator);
-      if (NULL == args_out->impl->parameter_files[i]) {
-        if (RCL_RET_OK != rcl_arguments_fini(args_out)) {
-          RCL_SET_ERROR_MSG("Error while finalizing arguments due to another error");
-        }
-        return RCL_RET_BAD_ALLOC;
-      }
-    }
-  } else {
-    args_out->impl->parameter_files = NULL;
-  }
+  // Parsed arguments are immutable, so the copy shares them.
+  int64_t previous_ref_count;
+  rcutils_atomic_fetch_add(&(args->impl->ref_count), previous_ref_count, 1);
+  (void)previous_ref_count;
+  args_out->impl = args->impl;
   return RCL_RET_OK;
 }
 
@@ -570,6 +744,13 @@ rcl_arguments_fini(
 {
   RCL_CHECK_ARGUMENT_FOR_NULL(args, RCL_RET_INVALID_ARGUMENT);
   if (args->impl) {
+    int64_t previous_ref_count;
+    rcutils_atomic_fetch_add(&(args->impl->ref_count), previous_ref_count, -1);
+    if (previous_ref_count > 1) {
+      // Still shared by a copy, which frees the arguments when finalized.
+      args->impl = NULL;
+      return RCL_RET_OK;
+    }
     rcl_ret_t ret = RCL_RET_OK;
     if (args->impl->remap_rules) {
       for (int i = 0; i < args->impl->num_remap_rules; ++i) {
@@ -585,6 +766,21 @@ rcl_arguments_fini(
       args->impl->remap_rules = NULL;
       args->impl->num_remap_rules = 0;
     }
+    // Only after the rules, whose strings may point into the files.
+    if (args->impl->remap_files) {
+      for (int i = 0; i < args->impl->num_remap_files; ++i) {
+        rcl_ret_t unmap_ret = rcl_remap_file_unmap(&(args->impl->remap_files[i]));
+        if (unmap_ret != RCL_RET_OK) {
+          ret = unmap_ret;
+          RCUTILS_LOG_ERROR_NAMED(
+            ROS_PACKAGE_NAME,
+            "Failed to unmap remap file while finalizing arguments. Continuing...");
+        }
+      }
+      args->impl->allocator.deallocate(args->impl->remap_files, args->impl->allocator.state);
+      args->impl->remap_files = NULL;
+      args->impl->num_remap_files = 0;
+    }
 
     args->impl->allocator.deallocate(args->impl->unparsed_args, args->impl->allocator.state);
     args->impl->num_unparsed_args = 0;
@@ -600,6 +796,12 @@ rcl_arguments_fini(
       args->impl->parameter_files = NULL;
     }
 
+    if (args->impl->external_log_config_file) {
+      args->impl->allocator.deallocate(
+        args->impl->external_log_config_file, args->impl->allocator.state);
+      args->impl->external_log_config_file = NULL;
+    }
+
     args->impl->allocator.deallocate(args->impl, args->impl->allocator.state);
     args->impl = NULL;
     return ret;
@@ -660,11 +862,9 @@ _rcl_parse_remap_replacement_token(rcl_lexer_lookahead2_t * lex_lookahead)
   if (
     RCL_LEXEME_BR1 == lexeme || RCL_LEXEME_BR2 == lexeme || RCL_LEXEME_BR3 == lexeme ||
     RCL_LEXEME_BR4 == lexeme || RCL_LEXEME_BR5 == lexeme || RCL_LEXEME_BR6 == lexeme ||
-    RCL_LEXEME_BR7 == lexeme || RCL_LEXEME_BR8 == lexeme || RCL_LEXEME_BR9 == lexeme)
+    RCL_LEXEME_BR7 == lexeme || RCL_LEXEME_BR8 == lexeme || RCL_LEXEME_BR9 == lexeme ||
+    RCL_LEXEME_TOKEN == lexeme)
   {
-    RCL_SET_ERROR_MSG("Backreferences are not implemented");
-    return RCL_RET_ERROR;
-  } else if (RCL_LEXEME_TOKEN == lexeme) {
     ret = rcl_lexer_lookahead2_accept(lex_lookahead, NULL, NULL);
   } else {
     ret = RCL_RET_INVALID_REMAP_RULE;
@@ -756,14 +956,11 @@ _rcl_parse_remap_match_token(rcl_lexer_lookahead2_t * lex_lookahead)
     return ret;
   }
 
-  if (RCL_LEXEME_TOKEN == lexeme) {
+  if (
+    RCL_LEXEME_TOKEN == lexeme || RCL_LEXEME_WILD_ONE == lexeme ||
+    RCL_LEXEME_WILD_MULTI == lexeme)
+  {
     ret = rcl_lexer_lookahead2_accept(lex_lookahead, NULL, NULL);
-  } else if (RCL_LEXEME_WILD_ONE == lexeme) {
-    RCL_SET_ERROR_MSG("Wildcard '*' is not implemented");
-    return RCL_RET_ERROR;
-  } else if (RCL_LEXEME_WILD_MULTI == lexeme) {
-    RCL_SET_ERROR_MSG("Wildcard '**' is not implemented");
-    return RCL_RET_ERROR;
   } else {
     RCL_SET_ERROR_MSG("Expecting token or wildcard");
     ret = RCL_RET_INVALID_REMAP_RULE;
@@ -883,6 +1080,20 @@ _rcl_parse_remap_name_remap(
     return ret;
   }
 
+  // A back-reference refers to the text matched by a wildcard (ex: `\2` to the second one)
+  int num_wildcards = 0;
+  for (const char * c = rule->match; '\0' != *c; ++c) {
+    if ('*' == *c && ('*' != c[1])) {
+      ++num_wildcards;
+    }
+  }
+  for (const char * c = rule->replacement; '\0' != *c; ++c) {
+    if ('\\' == *c && c[1] - '0' > num_wildcards) {
+      RCL_SET_ERROR_MSG("Backreference to a wildcard which is not in the match");
+      return RCL_RET_INVALID_REMAP_RULE;
+    }
+  }
+
   return RCL_RET_OK;
 }
 
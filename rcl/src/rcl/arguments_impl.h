@@ -16,6 +16,8 @@
 #define RCL__ARGUMENTS_IMPL_H_
 
 #include "rcl/arguments.h"
+#include "rcutils/stdatomic_helper.h"
+#include "./remap_file.h"
 #include "./remap_impl.h"
 
 #ifdef __cplusplus
@@ -24,8 +26,15 @@ extern "C"
 #endif
 
 /// \internal
+/**
+ * Parsed arguments are immutable and shared by their copies, see
+ * rcl_arguments_copy().
+ */
 typedef struct rcl_arguments_impl_t
 {
+  /// Number of rcl_arguments_t sharing this struct.
+  atomic_int_least64_t ref_count;
+
   /// Array of indices that were not valid ROS arguments.
   int * unparsed_args;
   /// Length of unparsed_args.
@@ -41,6 +50,10 @@ typedef struct rcl_arguments_impl_t
   rcl_remap_t * remap_rules;
   /// Length of remap_rules.
   int num_remap_rules;
+  /// Array of compiled remap files, which own the strings of the rules loaded from them.
+  rcl_remap_file_t * remap_files;
+  /// Length of remap_files.
+  int num_remap_files;
 
   /// Default log level (represented by `RCUTILS_LOG_SEVERITY` enum) or -1 if not specified.
   int log_level;
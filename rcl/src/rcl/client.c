@@ -19,27 +19,44 @@ extern "C"
 
 #include "rcl/client.h"
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 
 #include "rcl/error_handling.h"
-#include "rcl/expand_topic_name.h"
-#include "rcl/remap.h"
 #include "rcutils/logging_macros.h"
 #include "rcutils/stdatomic_helper.h"
+#include "rcutils/time.h"
 #include "rmw/error_handling.h"
 #include "rmw/rmw.h"
-#include "rmw/validate_full_topic_name.h"
+#include "rmw/serialized_message.h"
 
 #include "./common.h"
+#include "./entity_pool.h"
+#include "./entity_statistics_impl.h"
+#include "./graph_cache.h"
+#include "./name_resolver.h"
+#include "./pending_request_table.h"
+#include "./request_coalescer.h"
+#include "./tracing_impl.h"
 
 typedef struct rcl_client_impl_t
 {
   rcl_client_options_t options;
   rmw_client_t * rmw_handle;
+  rcl_entity_statistics_storage_t statistics;
+  /// Highest sequence number returned by rcl_send_request() so far.
   atomic_int_least64_t sequence_number;
+  /// Requests waiting for a response, disabled if pending_request_capacity is 0.
+  rcl_pending_request_table_t pending_requests;
+  /// Identical requests in flight, disabled if coalescing_type_support is `NULL`.
+  rcl_request_coalescer_t coalescer;
+  /// The struct came from the client pool of the context.
+  bool is_pooled;
 } rcl_client_impl_t;
 
+const size_t rcl_client_impl_size = sizeof(rcl_client_impl_t);
+
 rcl_client_t
 rcl_get_zero_initialized_client()
 {
@@ -67,101 +84,63 @@ rcl_client_init(
   }
   RCL_CHECK_ARGUMENT_FOR_NULL(type_support, RCL_RET_INVALID_ARGUMENT);
   RCL_CHECK_ARGUMENT_FOR_NULL(service_name, RCL_RET_INVALID_ARGUMENT);
+  if (NULL != options->coalescing_type_support && 0 == options->pending_request_capacity) {
+    RCL_SET_ERROR_MSG("request coalescing requires a non zero pending_request_capacity");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
   RCUTILS_LOG_DEBUG_NAMED(
     ROS_PACKAGE_NAME, "Initializing client for service name '%s'", service_name);
   if (client->impl) {
     RCL_SET_ERROR_MSG("client already initialized, or memory was unintialized");
     return RCL_RET_ALREADY_INIT;
   }
-  // Expand the given service name.
-  rcutils_allocator_t rcutils_allocator = *allocator;  // implicit conversion to rcutils version
-  rcutils_string_map_t substitutions_map = rcutils_get_zero_initialized_string_map();
-  rcutils_ret_t rcutils_ret = rcutils_string_map_init(&substitutions_map, 0, rcutils_allocator);
-  if (rcutils_ret != RCUTILS_RET_OK) {
-    RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
-    if (rcutils_ret == RCUTILS_RET_BAD_ALLOC) {
-      return RCL_RET_BAD_ALLOC;
-    }
-    return RCL_RET_ERROR;
-  }
-  rcl_ret_t ret = rcl_get_default_topic_name_substitutions(&substitutions_map);
-  if (ret != RCL_RET_OK) {
-    rcutils_ret = rcutils_string_map_fini(&substitutions_map);
-    if (rcutils_ret != RCUTILS_RET_OK) {
-      RCUTILS_LOG_ERROR_NAMED(
-        ROS_PACKAGE_NAME,
-        "failed to fini string_map (%d) during error handling: %s\n",
-        rcutils_ret,
-        rcutils_get_error_string().str);
-    }
-    if (ret == RCL_RET_BAD_ALLOC) {
-      return ret;
-    }
-    return RCL_RET_ERROR;
-  }
-  char * expanded_service_name = NULL;
-  char * remapped_service_name = NULL;
-  ret = rcl_expand_topic_name(
-    service_name,
-    rcl_node_get_name(node),
-    rcl_node_get_namespace(node),
-    &substitutions_map,
-    *allocator,
-    &expanded_service_name);
-  rcutils_ret = rcutils_string_map_fini(&substitutions_map);
-  if (rcutils_ret != RCUTILS_RET_OK) {
-    RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
-    allocator->deallocate(expanded_service_name, allocator->state);
-    return RCL_RET_ERROR;
+  // Expand, remap and validate the given service name.
+  const rcl_name_resolver_t * name_resolver = rcl_node_get_name_resolver(node);
+  if (NULL == name_resolver) {
+    return RCL_RET_ERROR;  // error already set
   }
+  char remapped_service_name[RCL_RESOLVED_NAME_BUFFER_SIZE];
+  rcl_ret_t ret = rcl_name_resolver_resolve(
+    name_resolver, RCL_SERVICE_REMAP, service_name,
+    remapped_service_name, sizeof(remapped_service_name));
   if (ret != RCL_RET_OK) {
     if (ret == RCL_RET_TOPIC_NAME_INVALID || ret == RCL_RET_UNKNOWN_SUBSTITUTION) {
-      ret = RCL_RET_SERVICE_NAME_INVALID;
-    } else {
-      ret = RCL_RET_ERROR;
+      return RCL_RET_SERVICE_NAME_INVALID;
     }
-    goto cleanup;
+    return RCL_RET_ERROR;
   }
-  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Expanded service name '%s'", expanded_service_name);
-
-  const rcl_node_options_t * node_options = rcl_node_get_options(node);
-  if (NULL == node_options) {
-    ret = RCL_RET_ERROR;
-    goto cleanup;
-  }
-  rcl_arguments_t * global_args = NULL;
-  if (node_options->use_global_arguments) {
-    global_args = &(node->context->global_arguments);
-  }
-  ret = rcl_remap_service_name(
-    &(node_options->arguments), global_args, expanded_service_name,
-    rcl_node_get_name(node), rcl_node_get_namespace(node), *allocator, &remapped_service_name);
+  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Resolved service name '%s'", remapped_service_name);
+  // Allocate space for the implementation struct.
+  void * impl = NULL;
+  bool is_pooled = false;
+  ret = rcl_context_allocate_entity(
+    node->context, RCL_ENTITY_POOL_CLIENT, sizeof(rcl_client_impl_t), allocator, &impl,
+    &is_pooled);
   if (RCL_RET_OK != ret) {
-    goto fail;
-  } else if (NULL == remapped_service_name) {
-    remapped_service_name = expanded_service_name;
-    expanded_service_name = NULL;
+    goto cleanup;  // error message already set
   }
-
-  // Validate the expanded service name.
-  int validation_result;
-  rmw_ret_t rmw_ret = rmw_validate_full_topic_name(remapped_service_name, &validation_result, NULL);
-  if (rmw_ret != RMW_RET_OK) {
-    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
-    ret = RCL_RET_ERROR;
-    goto cleanup;
+  client->impl = (rcl_client_impl_t *)impl;
+  client->impl->is_pooled = is_pooled;
+  // Fill out implementation struct.
+  client->impl->pending_requests = rcl_get_zero_initialized_pending_request_table();
+  client->impl->coalescer = rcl_get_zero_initialized_request_coalescer();
+  if (0 != options->pending_request_capacity) {
+    ret = rcl_pending_request_table_init(
+      &client->impl->pending_requests, options->pending_request_capacity, *allocator);
+    if (RCL_RET_OK != ret) {
+      fail_ret = ret;
+      goto fail;
+    }
   }
-  if (validation_result != RMW_TOPIC_VALID) {
-    RCL_SET_ERROR_MSG(rmw_full_topic_name_validation_result_string(validation_result));
-    ret = RCL_RET_SERVICE_NAME_INVALID;
-    goto cleanup;
+  if (NULL != options->coalescing_type_support) {
+    ret = rcl_request_coalescer_init(
+      &client->impl->coalescer, options->coalescing_type_support,
+      options->pending_request_capacity, *allocator);
+    if (RCL_RET_OK != ret) {
+      fail_ret = ret;
+      goto fail;
+    }
   }
-  // Allocate space for the implementation struct.
-  client->impl = (rcl_client_impl_t *)allocator->allocate(
-    sizeof(rcl_client_impl_t), allocator->state);
-  RCL_CHECK_FOR_NULL_WITH_MSG(
-    client->impl, "allocating memory failed", ret = RCL_RET_BAD_ALLOC; goto cleanup);
-  // Fill out implementation struct.
   // rmw handle (create rmw client)
   // TODO(wjwwood): pass along the allocator to rmw when it supports it
   client->impl->rmw_handle = rmw_create_client(
@@ -175,22 +154,24 @@ rcl_client_init(
   }
   // options
   client->impl->options = *options;
+  atomic_init(&client->impl->sequence_number, 0);
+  rcl_entity_statistics_storage_init(&client->impl->statistics);
   RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Client initialized");
+  RCL_TRACEPOINT(RCL_TRACE_CLIENT_INIT, client, 0);
+  rcl_graph_cache_invalidate_for_node(node);
   ret = RCL_RET_OK;
   goto cleanup;
 fail:
   if (client->impl) {
-    allocator->deallocate(client->impl, allocator->state);
+    rcl_pending_request_table_fini(&client->impl->pending_requests);
+    rcl_request_coalescer_fini(&client->impl->coalescer);
+    rcl_context_deallocate_entity(
+      node->context, RCL_ENTITY_POOL_CLIENT, client->impl,
+      sizeof(rcl_client_impl_t), allocator, client->impl->is_pooled);
   }
   ret = fail_ret;
   // Fall through to cleanup
 cleanup:
-  if (NULL != expanded_service_name) {
-    allocator->deallocate(expanded_service_name, allocator->state);
-  }
-  if (NULL != remapped_service_name) {
-    allocator->deallocate(remapped_service_name, allocator->state);
-  }
   return ret;
 }
 
@@ -214,7 +195,12 @@ rcl_client_fini(rcl_client_t * client, rcl_node_t * node)
       RCL_SET_ERROR_MSG(rmw_get_error_string().str);
       result = RCL_RET_ERROR;
     }
-    allocator.deallocate(client->impl, allocator.state);
+    rcl_pending_request_table_fini(&client->impl->pending_requests);
+    rcl_request_coalescer_fini(&client->impl->coalescer);
+    rcl_context_deallocate_entity(
+      node->context, RCL_ENTITY_POOL_CLIENT, client->impl,
+      sizeof(rcl_client_impl_t), &allocator, client->impl->is_pooled);
+    rcl_graph_cache_invalidate_for_node(node);
   }
   RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Client finalized");
   return result;
@@ -228,6 +214,8 @@ rcl_client_get_default_options()
   // Must set the allocator and qos after because they are not a compile time constant.
   default_options.qos = rmw_qos_profile_services_default;
   default_options.allocator = rcl_get_default_allocator();
+  default_options.pending_request_capacity = 0;
+  default_options.coalescing_type_support = NULL;
   return default_options;
 }
 
@@ -260,33 +248,143 @@ rcl_client_get_rmw_handle(const rcl_client_t * client)
   return client->impl->rmw_handle;
 }
 
+/// Raise the client's highest sequence number to the given one, if it is higher.
+/**
+ * Concurrent senders may finish in any order, so a plain store could move
+ * the sequence number backwards.
+ */
+static void
+_rcl_client_update_sequence_number(rcl_client_impl_t * impl, int64_t sequence_number)
+{
+  bool exchanged = false;
+  int64_t current = rcutils_atomic_load_int64_t(&impl->sequence_number);
+  while (sequence_number > current && !exchanged) {
+    // On failure current is updated with the latest value, so the loop re-checks it.
+    rcutils_atomic_compare_exchange_strong(
+      &impl->sequence_number, exchanged, &current, sequence_number);
+  }
+}
+
+/// Send a request, record it in the pending request table and coalesce it if enabled.
+static rcl_ret_t
+_rcl_send_request(
+  const rcl_client_t * client,
+  const void * ros_request,
+  rcutils_time_point_value_t deadline,
+  void * user_data,
+  int64_t * sequence_number)
+{
+  rcl_request_coalescer_t * coalescer = &client->impl->coalescer;
+  // Registered before sending, so a send which fails does not leave a request
+  // behind which identical requests would wait for.
+  size_t coalescer_entry = SIZE_MAX;
+  if (rcl_request_coalescer_is_enabled(coalescer)) {
+    rcl_serialized_message_t serialized_request = rmw_get_zero_initialized_serialized_message();
+    rcl_ret_t ret = rcl_request_coalescer_serialize(coalescer, ros_request, &serialized_request);
+    if (RCL_RET_OK != ret) {
+      return ret;  // error already set
+    }
+    bool attached = false;
+    ret = rcl_request_coalescer_begin_send(
+      coalescer, &serialized_request, user_data, &attached, sequence_number, &coalescer_entry);
+    if (RCL_RET_OK != ret || attached) {
+      RCL_HOT_PATH_LOG_DEBUG_EXPRESSION_NAMED(
+        attached, ROS_PACKAGE_NAME,
+        "Request coalesced with request %" PRId64 " in flight", *sequence_number);
+      return ret;
+    }
+  }
+  bool is_coalesced = SIZE_MAX != coalescer_entry;
+  rcl_pending_request_table_t * pending_requests = &client->impl->pending_requests;
+  bool is_tracked = rcl_pending_request_table_is_enabled(pending_requests);
+  // The table stays locked until the request is stored, so a response taken
+  // on another thread can not be looked up before its request is known.
+  if (is_tracked && !rcl_pending_request_table_begin_send(pending_requests)) {
+    if (is_coalesced) {
+      rcl_request_coalescer_cancel_send(coalescer, coalescer_entry);
+    }
+    RCL_SET_ERROR_MSG("too many requests are waiting for a response");
+    return RCL_RET_CLIENT_PENDING_REQUESTS_FULL;
+  }
+  // The middleware assigns the sequence number, so each caller gets its own
+  // storage for it and no shared state is read before the request is sent.
+  int64_t assigned_sequence_number = 0;
+  if (rmw_send_request(
+      client->impl->rmw_handle, ros_request, &assigned_sequence_number) != RMW_RET_OK)
+  {
+    if (is_tracked) {
+      rcl_pending_request_table_cancel_send(pending_requests);
+    }
+    if (is_coalesced) {
+      rcl_request_coalescer_cancel_send(coalescer, coalescer_entry);
+    }
+    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+    return RCL_RET_ERROR;
+  }
+  if (is_coalesced) {
+    rcl_request_coalescer_end_send(coalescer, coalescer_entry, assigned_sequence_number);
+  }
+  if (is_tracked) {
+    rcl_pending_request_table_end_send(
+      pending_requests, assigned_sequence_number, deadline, user_data);
+  }
+  _rcl_client_update_sequence_number(client->impl, assigned_sequence_number);
+  *sequence_number = assigned_sequence_number;
+  RCL_TRACEPOINT(RCL_TRACE_SEND_REQUEST, client, assigned_sequence_number);
+  return RCL_RET_OK;
+}
+
 rcl_ret_t
 rcl_send_request(const rcl_client_t * client, const void * ros_request, int64_t * sequence_number)
 {
-  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Client sending service request");
+  RCL_HOT_PATH_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Client sending service request");
   if (!rcl_client_is_valid(client)) {
     return RCL_RET_CLIENT_INVALID;  // error already set
   }
   RCL_CHECK_ARGUMENT_FOR_NULL(ros_request, RCL_RET_INVALID_ARGUMENT);
   RCL_CHECK_ARGUMENT_FOR_NULL(sequence_number, RCL_RET_INVALID_ARGUMENT);
-  *sequence_number = rcutils_atomic_load_int64_t(&client->impl->sequence_number);
-  if (rmw_send_request(
-      client->impl->rmw_handle, ros_request, sequence_number) != RMW_RET_OK)
-  {
-    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
-    return RCL_RET_ERROR;
+  return _rcl_send_request(
+    client, ros_request, RCL_PENDING_REQUEST_NO_DEADLINE, NULL, sequence_number);
+}
+
+rcl_ret_t
+rcl_send_request_with_timeout(
+  const rcl_client_t * client,
+  const void * ros_request,
+  int64_t timeout,
+  void * user_data,
+  int64_t * sequence_number)
+{
+  RCL_HOT_PATH_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Client sending service request with timeout");
+  if (!rcl_client_is_valid(client)) {
+    return RCL_RET_CLIENT_INVALID;  // error already set
   }
-  rcutils_atomic_exchange_int64_t(&client->impl->sequence_number, *sequence_number);
-  return RCL_RET_OK;
+  RCL_CHECK_ARGUMENT_FOR_NULL(ros_request, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(sequence_number, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_pending_request_table_is_enabled(&client->impl->pending_requests)) {
+    RCL_SET_ERROR_MSG("client was initialized with a pending_request_capacity of 0");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  rcutils_time_point_value_t deadline = RCL_PENDING_REQUEST_NO_DEADLINE;
+  if (timeout >= 0) {
+    rcutils_time_point_value_t now;
+    if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+      RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
+      return RCL_RET_ERROR;
+    }
+    deadline = timeout > INT64_MAX - now ? INT64_MAX : now + timeout;
+  }
+  return _rcl_send_request(client, ros_request, deadline, user_data, sequence_number);
 }
 
 rcl_ret_t
-rcl_take_response(
+rcl_take_response_with_user_data(
   const rcl_client_t * client,
   rmw_request_id_t * request_header,
-  void * ros_response)
+  void * ros_response,
+  void ** user_data)
 {
-  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Client taking service response");
+  RCL_HOT_PATH_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Client taking service response");
   if (!rcl_client_is_valid(client)) {
     return RCL_RET_CLIENT_INVALID;  // error already set
   }
@@ -301,11 +399,126 @@ rcl_take_response(
     RCL_SET_ERROR_MSG(rmw_get_error_string().str);
     return RCL_RET_ERROR;
   }
-  RCUTILS_LOG_DEBUG_NAMED(
+  RCL_HOT_PATH_LOG_DEBUG_NAMED(
     ROS_PACKAGE_NAME, "Client take response succeeded: %s", taken ? "true" : "false");
+  void * request_user_data = NULL;
+  if (taken && rcl_pending_request_table_is_enabled(&client->impl->pending_requests)) {
+    taken = rcl_pending_request_table_remove(
+      &client->impl->pending_requests, request_header->sequence_number, &request_user_data);
+    RCL_HOT_PATH_LOG_DEBUG_EXPRESSION_NAMED(
+      !taken, ROS_PACKAGE_NAME, "Discarding response to expired or unknown request");
+    if (taken && rcl_request_coalescer_is_enabled(&client->impl->coalescer)) {
+      rcl_request_coalescer_complete(&client->impl->coalescer, request_header->sequence_number);
+    }
+  }
+  RCL_TRACEPOINT(
+    RCL_TRACE_TAKE_RESPONSE, client, taken ? request_header->sequence_number : -1);
   if (!taken) {
+    RCL_ENTITY_STATISTICS_RECORD_FAILURE(&client->impl->statistics);
     return RCL_RET_CLIENT_TAKE_FAILED;
   }
+  RCL_ENTITY_STATISTICS_RECORD_MESSAGE(&client->impl->statistics, 0);
+  if (NULL != user_data) {
+    *user_data = request_user_data;
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_take_response(
+  const rcl_client_t * client,
+  rmw_request_id_t * request_header,
+  void * ros_response)
+{
+  return rcl_take_response_with_user_data(client, request_header, ros_response, NULL);
+}
+
+rcl_ret_t
+rcl_client_take_expired_request(
+  const rcl_client_t * client,
+  int64_t * sequence_number,
+  void ** user_data)
+{
+  if (!rcl_client_is_valid(client)) {
+    return RCL_RET_CLIENT_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(sequence_number, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(user_data, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_pending_request_table_is_enabled(&client->impl->pending_requests)) {
+    return RCL_RET_CLIENT_TAKE_FAILED;
+  }
+  rcutils_time_point_value_t now;
+  if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+    RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
+    return RCL_RET_ERROR;
+  }
+  if (!rcl_pending_request_table_take_expired(
+      &client->impl->pending_requests, now, sequence_number, user_data))
+  {
+    return RCL_RET_CLIENT_TAKE_FAILED;
+  }
+  if (rcl_request_coalescer_is_enabled(&client->impl->coalescer)) {
+    rcl_request_coalescer_complete(&client->impl->coalescer, *sequence_number);
+  }
+  RCL_HOT_PATH_LOG_DEBUG_NAMED(
+    ROS_PACKAGE_NAME, "Request %" PRId64 " expired without a response", *sequence_number);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_client_take_coalesced_waiter(
+  const rcl_client_t * client,
+  int64_t sequence_number,
+  void ** user_data)
+{
+  if (!rcl_client_is_valid(client)) {
+    return RCL_RET_CLIENT_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(user_data, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_request_coalescer_is_enabled(&client->impl->coalescer) ||
+    !rcl_request_coalescer_take_waiter(&client->impl->coalescer, sequence_number, user_data))
+  {
+    return RCL_RET_CLIENT_TAKE_FAILED;
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_client_get_time_until_next_request_deadline(
+  const rcl_client_t * client,
+  int64_t * time_until_next_deadline)
+{
+  if (!rcl_client_is_valid(client)) {
+    return RCL_RET_CLIENT_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(time_until_next_deadline, RCL_RET_INVALID_ARGUMENT);
+  rcutils_time_point_value_t deadline;
+  if (!rcl_pending_request_table_is_enabled(&client->impl->pending_requests) ||
+    !rcl_pending_request_table_get_next_deadline(&client->impl->pending_requests, &deadline))
+  {
+    *time_until_next_deadline = INT64_MAX;
+    return RCL_RET_OK;
+  }
+  rcutils_time_point_value_t now;
+  if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+    RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
+    return RCL_RET_ERROR;
+  }
+  *time_until_next_deadline = deadline - now;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_client_get_pending_request_count(const rcl_client_t * client, size_t * count)
+{
+  if (!rcl_client_is_valid(client)) {
+    return RCL_RET_CLIENT_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(count, RCL_RET_INVALID_ARGUMENT);
+  *count = 0;
+  if (rcl_pending_request_table_is_enabled(&client->impl->pending_requests)) {
+    *count = rcl_pending_request_table_get_size(&client->impl->pending_requests);
+  }
   return RCL_RET_OK;
 }
 
@@ -319,6 +532,18 @@ rcl_client_is_valid(const rcl_client_t * client)
     client->impl->rmw_handle, "client's rmw handle is invalid", return false);
   return true;
 }
+
+rcl_ret_t
+rcl_client_get_statistics(
+  const rcl_client_t * client,
+  rcl_entity_statistics_t * statistics)
+{
+  if (!rcl_client_is_valid(client)) {
+    return RCL_RET_CLIENT_INVALID;  // error already set
+  }
+  return rcl_entity_statistics_storage_get(&client->impl->statistics, statistics);
+}
+
 #ifdef __cplusplus
 }
 #endif
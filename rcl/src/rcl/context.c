@@ -20,8 +20,10 @@ extern "C"
 #include "rcl/context.h"
 
 #include <stdbool.h>
+#include <string.h>
 
 #include "./context_impl.h"
+#include "./guard_condition_impl.h"
 #include "rcutils/stdatomic_helper.h"
 
 rcl_context_t
@@ -84,6 +86,108 @@ rcl_context_is_valid(rcl_context_t * context)
   return 0 != rcl_context_get_instance_id(context);
 }
 
+/// Wake up waiters on the context's graph guard condition, failing only costs them a wake up.
+static void
+_rcl_context_trigger_graph_guard_condition(rcl_context_impl_t * impl)
+{
+  if (NULL != impl->graph_guard_condition.impl &&
+    RCL_RET_OK != rcl_trigger_guard_condition(&impl->graph_guard_condition))
+  {
+    rcl_reset_error();
+  }
+}
+
+rcl_ret_t
+rcl_context_add_node_graph_guard_condition(
+  rcl_context_t * context,
+  const rmw_guard_condition_t * graph_guard_condition)
+{
+  rcl_context_impl_t * impl = context->impl;
+  rcl_allocator_t allocator = impl->allocator;
+  rcl_ret_t ret = RCL_RET_OK;
+  rcl_mutex_lock(&impl->nodes_lock);
+  if (impl->node_count == impl->node_capacity) {
+    size_t new_capacity = impl->node_capacity ? 2 * impl->node_capacity : 8;
+    const rmw_guard_condition_t ** new_guard_conditions =
+      (const rmw_guard_condition_t **)allocator.reallocate(
+      (void *)impl->node_graph_guard_conditions,
+      sizeof(const rmw_guard_condition_t *) * new_capacity, allocator.state);
+    if (NULL == new_guard_conditions) {
+      ret = RCL_RET_BAD_ALLOC;
+    } else {
+      impl->node_graph_guard_conditions = new_guard_conditions;
+      impl->node_capacity = new_capacity;
+    }
+  }
+  if (RCL_RET_OK == ret) {
+    impl->node_graph_guard_conditions[impl->node_count++] = graph_guard_condition;
+  }
+  rcl_mutex_unlock(&impl->nodes_lock);
+  if (RCL_RET_OK != ret) {
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    return ret;
+  }
+  _rcl_context_trigger_graph_guard_condition(impl);
+  return RCL_RET_OK;
+}
+
+void
+rcl_context_remove_node_graph_guard_condition(
+  rcl_context_t * context,
+  const rmw_guard_condition_t * graph_guard_condition)
+{
+  rcl_context_impl_t * impl = context->impl;
+  rcl_mutex_lock(&impl->nodes_lock);
+  size_t i;
+  for (i = 0; i < impl->node_count; ++i) {
+    if (impl->node_graph_guard_conditions[i] == graph_guard_condition) {
+      impl->node_graph_guard_conditions[i] = impl->node_graph_guard_conditions[--impl->node_count];
+      break;
+    }
+  }
+  // Waits which started before the removal may still use the guard condition.
+  // Holding the lock keeps new ones from starting, and the ones in progress
+  // are woken up until they returned, as another wait set may take a trigger.
+  while (rcutils_atomic_load_int64_t(&impl->graph_waiters) > 0) {
+    _rcl_context_trigger_graph_guard_condition(impl);
+    rcl_thread_yield();
+  }
+  rcl_mutex_unlock(&impl->nodes_lock);
+  _rcl_context_trigger_graph_guard_condition(impl);
+}
+
+bool
+rcl_context_begin_graph_wait(
+  rcl_context_t * context,
+  void ** handles,
+  size_t capacity,
+  size_t * count)
+{
+  rcl_context_impl_t * impl = context->impl;
+  rcl_mutex_lock(&impl->nodes_lock);
+  *count = impl->node_count;
+  bool fits = impl->node_count <= capacity;
+  if (fits) {
+    size_t i;
+    for (i = 0; i < impl->node_count; ++i) {
+      handles[i] = impl->node_graph_guard_conditions[i]->data;
+    }
+    int64_t previous_graph_waiters;
+    rcutils_atomic_fetch_add(&impl->graph_waiters, previous_graph_waiters, 1);
+    (void)previous_graph_waiters;
+  }
+  rcl_mutex_unlock(&impl->nodes_lock);
+  return fits;
+}
+
+void
+rcl_context_end_graph_wait(rcl_context_t * context)
+{
+  int64_t previous_graph_waiters;
+  rcutils_atomic_fetch_add(&context->impl->graph_waiters, previous_graph_waiters, -1);
+  (void)previous_graph_waiters;
+}
+
 void
 __cleanup_context(rcl_context_t * context)
 {
@@ -113,6 +217,33 @@ __cleanup_context(rcl_context_t * context)
     // pull allocator out for use during deallocation
     rcl_allocator_t allocator = context->impl->allocator;
 
+    // free the graph snapshot, if any
+    rcl_graph_cache_fini(&(context->impl->graph_cache));
+
+    // free the secure root directories, if any
+    rcl_security_index_fini(&(context->impl->security_index));
+
+    // finalize the graph guard condition, nodes are expected to be finalized already
+    if (NULL != context->impl->graph_guard_condition.impl) {
+      rcl_mutex_fini(&(context->impl->nodes_lock));
+    }
+    if (RCL_RET_OK != rcl_guard_condition_fini(&(context->impl->graph_guard_condition))) {
+      RCUTILS_SAFE_FWRITE_TO_STDERR(
+        "[rcl|context.c:" RCUTILS_STRINGIFY(__LINE__)
+        "] failed to finalize graph guard condition while cleaning up context: ");
+      RCUTILS_SAFE_FWRITE_TO_STDERR(rcl_get_error_string().str);
+      RCUTILS_SAFE_FWRITE_TO_STDERR("\n");
+      rcl_reset_error();
+    }
+    if (NULL != context->impl->node_graph_guard_conditions) {
+      allocator.deallocate(
+        (void *)context->impl->node_graph_guard_conditions, allocator.state);
+    }
+
+    // free the implementation structs of the entities at once, no entity may be used after this
+    rcl_entity_arena_fini(&(context->impl->entity_arena));
+    rcl_entity_pools_fini(&(context->impl->entity_pools));
+
     // finalize init options if valid
     if (NULL != context->impl->init_options.impl) {
       rcl_ret_t ret = rcl_init_options_fini(&(context->impl->init_options));
@@ -17,14 +17,36 @@
 
 #include "rcl/context.h"
 #include "rcl/error_handling.h"
+#include "rcl/guard_condition.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rmw/types.h"
 
+#include "./entity_arena.h"
+#include "./entity_pool.h"
+#include "./graph_cache.h"
 #include "./init_options_impl.h"
+#include "./mutex.h"
+#include "./security_index.h"
 
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
+/// Configuration read from the environment once, by rcl_init().
+typedef struct rcl_context_env_t
+{
+  /// Domain id set by ROS_DOMAIN_ID, if has_domain_id is true.
+  size_t domain_id;
+  bool has_domain_id;
+  /// ROS_DOMAIN_ID is not a number, which fails the nodes using it.
+  bool invalid_domain_id;
+  /// ROS_SECURITY_ENABLE is "true".
+  bool use_security;
+  /// Enforcement requested by ROS_SECURITY_STRATEGY.
+  rmw_security_enforcement_policy_t enforce_security;
+} rcl_context_env_t;
+
 /// \internal
 typedef struct rcl_context_impl_t
 {
@@ -38,12 +60,87 @@ typedef struct rcl_context_impl_t
   char ** argv;
   /// rmw context.
   rmw_context_t rmw_context;
+  /// Environment configuration used by the nodes of this context.
+  rcl_context_env_t env;
+  /// Secure root directories of the nodes, only scanned if security is enabled.
+  rcl_security_index_t security_index;
+  /// Graph snapshot shared by the nodes of this context, disabled by default.
+  rcl_graph_cache_t graph_cache;
+  /// Implementation structs of the entities of this context, disabled by default.
+  rcl_entity_arena_t entity_arena;
+  /// Fixed-capacity pools of entity implementation structs, disabled by default.
+  rcl_entity_pools_t entity_pools;
+  /// Ready whenever the graph changed, see rcl_context_get_graph_guard_condition().
+  rcl_guard_condition_t graph_guard_condition;
+  /// Graph guard conditions of the middleware nodes of this context.
+  const rmw_guard_condition_t ** node_graph_guard_conditions;
+  size_t node_count;
+  size_t node_capacity;
+  /// Guards the node graph guard conditions, created along with graph_guard_condition.
+  rcl_mutex_t nodes_lock;
+  /// Number of rcl_wait() calls currently waiting on the node graph guard conditions.
+  atomic_int_least64_t graph_waiters;
 } rcl_context_impl_t;
 
 RCL_LOCAL
 void
 __cleanup_context(rcl_context_t * context);
 
+/// Register the graph guard condition of a new node with its context.
+/**
+ * Also triggers the context's graph guard condition, the node joined the graph.
+ *
+ * \return `RCL_RET_OK` if the guard condition was added, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed.
+ */
+RCL_LOCAL
+rcl_ret_t
+rcl_context_add_node_graph_guard_condition(
+  rcl_context_t * context,
+  const rmw_guard_condition_t * graph_guard_condition);
+
+/// Unregister the graph guard condition of a node which is being finalized.
+/**
+ * The middleware destroys the guard condition along with the node, so this
+ * blocks until no rcl_wait() waits on it anymore.
+ * Those waits are woken up with the context's graph guard condition, which
+ * they always wait on as well.
+ */
+RCL_LOCAL
+void
+rcl_context_remove_node_graph_guard_condition(
+  rcl_context_t * context,
+  const rmw_guard_condition_t * graph_guard_condition);
+
+/// Start waiting on the graph guard conditions of the nodes of the context.
+/**
+ * The middleware triggers the graph guard conditions of all nodes on every
+ * change of the graph, so rcl_wait() waits on them besides the context's own
+ * guard condition, which is only triggered by rcl.
+ *
+ * If the middleware handles of the node graph guard conditions fit into
+ * `handles`, they are stored there and the nodes can not be finalized until
+ * rcl_context_end_graph_wait() is called.
+ * Otherwise nothing is stored, and the wait has to be started again with room
+ * for `count` handles.
+ *
+ * \param[out] handles room for `capacity` middleware guard condition handles
+ * \param[out] count the number of node graph guard conditions of the context
+ * eturn `true` if the handles were stored and the wait started
+ */
+RCL_LOCAL
+bool
+rcl_context_begin_graph_wait(
+  rcl_context_t * context,
+  void ** handles,
+  size_t capacity,
+  size_t * count);
+
+/// Stop waiting on the graph guard conditions of the nodes of the context.
+RCL_LOCAL
+void
+rcl_context_end_graph_wait(rcl_context_t * context);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,157 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./entity_arena.h"
+
+#include "./context_impl.h"
+
+/// Objects start this far into a block, keeping them aligned to the smallest size class.
+#define RCL_ENTITY_ARENA_HEADER_SIZE RCL_ENTITY_ARENA_MIN_SIZE
+
+void
+rcl_entity_arena_init(rcl_entity_arena_t * arena, size_t block_size, rcl_allocator_t allocator)
+{
+  arena->block_size = block_size;
+  arena->blocks = NULL;
+  arena->next = NULL;
+  arena->end = NULL;
+  for (size_t i = 0; i < RCL_ENTITY_ARENA_SIZE_CLASS_COUNT; ++i) {
+    arena->free_lists[i] = NULL;
+  }
+  atomic_init(&arena->lock, false);
+  arena->allocator = allocator;
+}
+
+void
+rcl_entity_arena_fini(rcl_entity_arena_t * arena)
+{
+  rcl_entity_arena_block_t * block = arena->blocks;
+  while (NULL != block) {
+    rcl_entity_arena_block_t * next = block->next;
+    arena->allocator.deallocate(block, arena->allocator.state);
+    block = next;
+  }
+  rcl_entity_arena_init(arena, 0, arena->allocator);
+}
+
+/// Return the size class of an object, or -1 if it is not put in the arena.
+static int
+_rcl_entity_arena_get_size_class(const rcl_entity_arena_t * arena, size_t size)
+{
+  if (NULL == arena || arena->block_size <= RCL_ENTITY_ARENA_HEADER_SIZE) {
+    return -1;
+  }
+  int size_class = 0;
+  size_t class_size = RCL_ENTITY_ARENA_MIN_SIZE;
+  while (class_size < size) {
+    if (++size_class == RCL_ENTITY_ARENA_SIZE_CLASS_COUNT) {
+      return -1;
+    }
+    class_size <<= 1;
+  }
+  if (class_size > arena->block_size - RCL_ENTITY_ARENA_HEADER_SIZE) {
+    return -1;
+  }
+  return size_class;
+}
+
+static void
+_rcl_entity_arena_lock(rcl_entity_arena_t * arena)
+{
+  while (rcutils_atomic_exchange_bool(&arena->lock, true)) {
+    // Spin, the lock is only held to take or give back an object.
+  }
+}
+
+static void
+_rcl_entity_arena_unlock(rcl_entity_arena_t * arena)
+{
+  rcutils_atomic_store(&arena->lock, false);
+}
+
+void *
+rcl_entity_arena_allocate(
+  rcl_entity_arena_t * arena,
+  size_t size,
+  const rcl_allocator_t * allocator)
+{
+  int size_class = _rcl_entity_arena_get_size_class(arena, size);
+  if (size_class < 0) {
+    return allocator->allocate(size, allocator->state);
+  }
+  size_t class_size = (size_t)RCL_ENTITY_ARENA_MIN_SIZE << size_class;
+  void * object = NULL;
+  _rcl_entity_arena_lock(arena);
+  if (NULL != arena->free_lists[size_class]) {
+    object = arena->free_lists[size_class];
+    arena->free_lists[size_class] = *(void **)object;
+  } else {
+    if ((size_t)(arena->end - arena->next) < class_size) {
+      // The rest of the newest block is given up, objects never span blocks.
+      rcl_entity_arena_block_t * block =
+        arena->allocator.allocate(arena->block_size, arena->allocator.state);
+      if (NULL != block) {
+        block->next = arena->blocks;
+        arena->blocks = block;
+        arena->next = (char *)block + RCL_ENTITY_ARENA_HEADER_SIZE;
+        arena->end = (char *)block + arena->block_size;
+      }
+    }
+    if ((size_t)(arena->end - arena->next) >= class_size) {
+      object = arena->next;
+      arena->next += class_size;
+    }
+  }
+  _rcl_entity_arena_unlock(arena);
+  return object;
+}
+
+void
+rcl_entity_arena_deallocate(
+  rcl_entity_arena_t * arena,
+  void * object,
+  size_t size,
+  const rcl_allocator_t * allocator)
+{
+  if (NULL == object) {
+    return;
+  }
+  int size_class = _rcl_entity_arena_get_size_class(arena, size);
+  if (size_class < 0) {
+    allocator->deallocate(object, allocator->state);
+    return;
+  }
+  _rcl_entity_arena_lock(arena);
+  *(void **)object = arena->free_lists[size_class];
+  arena->free_lists[size_class] = object;
+  _rcl_entity_arena_unlock(arena);
+}
+
+rcl_entity_arena_t *
+rcl_context_get_entity_arena(const rcl_context_t * context)
+{
+  if (NULL == context || NULL == context->impl) {
+    return NULL;
+  }
+  return &(context->impl->entity_arena);
+}
+
+#ifdef __cplusplus
+}
+#endif
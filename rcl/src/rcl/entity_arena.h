@@ -0,0 +1,121 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__ENTITY_ARENA_H_
+#define RCL__ENTITY_ARENA_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rcl/allocator.h"
+#include "rcl/context.h"
+#include "rcl/types.h"
+#include "rcl/visibility_control.h"
+#include "rcutils/stdatomic_helper.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// Size of the smallest size class, also the alignment of the objects.
+#define RCL_ENTITY_ARENA_MIN_SIZE 64
+/// Number of size classes, each one twice as large as the previous one.
+#define RCL_ENTITY_ARENA_SIZE_CLASS_COUNT 7
+/// Size of the largest size class, larger objects are not put in the arena.
+#define RCL_ENTITY_ARENA_MAX_SIZE \
+  (RCL_ENTITY_ARENA_MIN_SIZE << (RCL_ENTITY_ARENA_SIZE_CLASS_COUNT - 1))
+
+/// A block of the arena, its objects follow the header.
+typedef struct rcl_entity_arena_block_t
+{
+  struct rcl_entity_arena_block_t * next;
+} rcl_entity_arena_block_t;
+
+/// Implementation structs of the entities of a context, see rcl_entity_arena_init().
+/**
+ * Objects are carved out of large blocks, so the entities of a context are
+ * close to each other in memory, and the blocks are only freed with the arena.
+ * Finalized objects are kept in a free list per size class, to be reused by
+ * entities of the same size class.
+ *
+ * The arena is guarded by a spin lock, which is only held to take or give
+ * back an object.
+ */
+typedef struct rcl_entity_arena_t
+{
+  /// Size of the blocks, 0 if the arena is disabled.
+  size_t block_size;
+  /// Blocks allocated so far, newest first.
+  rcl_entity_arena_block_t * blocks;
+  /// Free part of the newest block.
+  char * next;
+  char * end;
+  /// Finalized objects of each size class, linked through their first bytes.
+  void * free_lists[RCL_ENTITY_ARENA_SIZE_CLASS_COUNT];
+  atomic_bool lock;
+  rcl_allocator_t allocator;
+} rcl_entity_arena_t;
+
+/// Initialize an arena, which allocates no memory until it is used.
+/**
+ * \param[in] block_size size of the blocks in bytes, 0 disables the arena
+ * \param[in] allocator allocator of the blocks
+ */
+RCL_LOCAL
+void
+rcl_entity_arena_init(rcl_entity_arena_t * arena, size_t block_size, rcl_allocator_t allocator);
+
+/// Free all blocks at once, including objects which were not deallocated.
+RCL_LOCAL
+void
+rcl_entity_arena_fini(rcl_entity_arena_t * arena);
+
+/// Allocate the implementation struct of an entity.
+/**
+ * The object comes from the arena if it is enabled and the size fits in a
+ * size class, or from the allocator otherwise.
+ * Objects taken from a free list are not cleared.
+ *
+ * \param[in] arena arena of the context, or `NULL`
+ * \param[in] size size of the object
+ * \param[in] allocator allocator used if the object is not put in the arena
+ * \return the object, or `NULL` if allocating memory failed.
+ */
+RCL_LOCAL
+void *
+rcl_entity_arena_allocate(
+  rcl_entity_arena_t * arena,
+  size_t size,
+  const rcl_allocator_t * allocator);
+
+/// Deallocate an object from rcl_entity_arena_allocate(), given the same arguments.
+RCL_LOCAL
+void
+rcl_entity_arena_deallocate(
+  rcl_entity_arena_t * arena,
+  void * object,
+  size_t size,
+  const rcl_allocator_t * allocator);
+
+/// Return the entity arena of a context, or `NULL` if the context is not initialized.
+RCL_LOCAL
+rcl_entity_arena_t *
+rcl_context_get_entity_arena(const rcl_context_t * context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__ENTITY_ARENA_H_
@@ -0,0 +1,234 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./entity_pool.h"
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "rcl/error_handling.h"
+
+#include "./context_impl.h"
+#include "./entity_arena.h"
+#include "./guard_condition_impl.h"
+
+static const char * const _rcl_entity_pool_names[RCL_ENTITY_POOL_KIND_COUNT] = {
+  "publisher",
+  "subscription",
+  "client",
+  "service",
+  "timer",
+  "guard condition",
+  "wait set",
+};
+
+/// Return the arena used for a kind which is not pooled, or `NULL` to use the allocator.
+static rcl_entity_arena_t *
+_rcl_context_get_entity_arena(const rcl_context_t * context, rcl_entity_pool_kind_t kind)
+{
+  // Guard conditions and wait sets are often finalized after their context, so they are not
+  // put in its arena, which the context frees.
+  if (RCL_ENTITY_POOL_GUARD_CONDITION == kind || RCL_ENTITY_POOL_WAIT_SET == kind) {
+    return NULL;
+  }
+  return rcl_context_get_entity_arena(context);
+}
+
+static rcl_entity_pools_t *
+_rcl_context_get_entity_pools(const rcl_context_t * context)
+{
+  if (NULL == context || NULL == context->impl) {
+    return NULL;
+  }
+  return &(context->impl->entity_pools);
+}
+
+rcl_ret_t
+rcl_entity_pools_init(
+  rcl_entity_pools_t * pools,
+  const rcl_entity_pool_capacities_t * capacities,
+  rcl_allocator_t allocator)
+{
+  const size_t pool_capacities[RCL_ENTITY_POOL_KIND_COUNT] = {
+    capacities->publishers,
+    capacities->subscriptions,
+    capacities->clients,
+    capacities->services,
+    capacities->timers,
+    capacities->guard_conditions,
+    capacities->wait_sets,
+  };
+  size_t wait_set_entries = capacities->wait_sets > 0 ? capacities->wait_set_entries : 0;
+  // A pooled wait set holds one rcl and one rmw pointer per entity.
+  if (wait_set_entries > (SIZE_MAX / 2) / (2 * sizeof(void *))) {
+    RCL_SET_ERROR_MSG("entity pools are too large");
+    return RCL_RET_BAD_ALLOC;
+  }
+  size_t wait_set_array_size = 2 * sizeof(void *) * wait_set_entries;
+  const size_t slot_sizes[RCL_ENTITY_POOL_KIND_COUNT] = {
+    rcl_publisher_impl_size,
+    rcl_subscription_impl_size,
+    rcl_client_impl_size,
+    rcl_service_impl_size,
+    rcl_timer_impl_size,
+    sizeof(rcl_guard_condition_impl_t),
+    RCL_ENTITY_POOL_ROUND_UP(rcl_wait_set_impl_size) + wait_set_array_size,
+  };
+  size_t storage_size = 0;
+  for (size_t kind = 0; kind < RCL_ENTITY_POOL_KIND_COUNT; ++kind) {
+    rcl_entity_pool_t * pool = &(pools->pools[kind]);
+    pool->capacity = pool_capacities[kind];
+    pool->slot_size = RCL_ENTITY_POOL_ROUND_UP(slot_sizes[kind]);
+    pool->free_list = NULL;
+    if (pool->capacity > (SIZE_MAX - storage_size) / pool->slot_size) {
+      RCL_SET_ERROR_MSG("entity pools are too large");
+      return RCL_RET_BAD_ALLOC;
+    }
+    storage_size += pool->capacity * pool->slot_size;
+  }
+  pools->wait_set_entries = wait_set_entries;
+  pools->storage = NULL;
+  atomic_init(&pools->lock, false);
+  pools->allocator = allocator;
+  if (0 == storage_size) {
+    return RCL_RET_OK;
+  }
+  pools->storage = allocator.allocate(storage_size, allocator.state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    pools->storage, "allocating memory for the entity pools failed", return RCL_RET_BAD_ALLOC);
+  char * slot = pools->storage;
+  for (size_t kind = 0; kind < RCL_ENTITY_POOL_KIND_COUNT; ++kind) {
+    rcl_entity_pool_t * pool = &(pools->pools[kind]);
+    // Link backwards so the first slot is handed out first.
+    slot += pool->capacity * pool->slot_size;
+    for (size_t i = 0; i < pool->capacity; ++i) {
+      slot -= pool->slot_size;
+      *(void **)slot = pool->free_list;
+      pool->free_list = slot;
+    }
+    slot += pool->capacity * pool->slot_size;
+  }
+  return RCL_RET_OK;
+}
+
+void
+rcl_entity_pools_fini(rcl_entity_pools_t * pools)
+{
+  if (NULL != pools->storage) {
+    pools->allocator.deallocate(pools->storage, pools->allocator.state);
+    pools->storage = NULL;
+  }
+  for (size_t kind = 0; kind < RCL_ENTITY_POOL_KIND_COUNT; ++kind) {
+    pools->pools[kind].capacity = 0;
+    pools->pools[kind].free_list = NULL;
+  }
+  pools->wait_set_entries = 0;
+}
+
+static void
+_rcl_entity_pools_lock(rcl_entity_pools_t * pools)
+{
+  while (rcutils_atomic_exchange_bool(&pools->lock, true)) {
+    // Spin, the lock is only held to take or give back a slot.
+  }
+}
+
+static void
+_rcl_entity_pools_unlock(rcl_entity_pools_t * pools)
+{
+  rcutils_atomic_store(&pools->lock, false);
+}
+
+rcl_ret_t
+rcl_context_allocate_entity(
+  const rcl_context_t * context,
+  rcl_entity_pool_kind_t kind,
+  size_t size,
+  const rcl_allocator_t * allocator,
+  void ** object,
+  bool * is_pooled)
+{
+  rcl_entity_pools_t * pools = _rcl_context_get_entity_pools(context);
+  *is_pooled = NULL != pools && 0 != pools->pools[kind].capacity;
+  if (!*is_pooled) {
+    *object = rcl_entity_arena_allocate(
+      _rcl_context_get_entity_arena(context, kind), size, allocator);
+    RCL_CHECK_FOR_NULL_WITH_MSG(*object, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+    return RCL_RET_OK;
+  }
+  rcl_entity_pool_t * pool = &(pools->pools[kind]);
+  assert(size <= pool->slot_size);
+  (void)size;
+  _rcl_entity_pools_lock(pools);
+  *object = pool->free_list;
+  if (NULL != *object) {
+    pool->free_list = *(void **)*object;
+  }
+  _rcl_entity_pools_unlock(pools);
+  if (NULL == *object) {
+    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "the %s pool of the context is exhausted, all %zu slots are in use",
+      _rcl_entity_pool_names[kind], pool->capacity);
+    return RCL_RET_ENTITY_POOL_EXHAUSTED;
+  }
+  return RCL_RET_OK;
+}
+
+void
+rcl_context_deallocate_entity(
+  const rcl_context_t * context,
+  rcl_entity_pool_kind_t kind,
+  void * object,
+  size_t size,
+  const rcl_allocator_t * allocator,
+  bool is_pooled)
+{
+  if (NULL == object) {
+    return;
+  }
+  if (!is_pooled) {
+    rcl_entity_arena_deallocate(
+      _rcl_context_get_entity_arena(context, kind), object, size, allocator);
+    return;
+  }
+  rcl_entity_pools_t * pools = _rcl_context_get_entity_pools(context);
+  if (NULL == pools || NULL == pools->storage) {
+    // The context was finalized, which freed the slot along with the other slots.
+    return;
+  }
+  rcl_entity_pool_t * pool = &(pools->pools[kind]);
+  _rcl_entity_pools_lock(pools);
+  *(void **)object = pool->free_list;
+  pool->free_list = object;
+  _rcl_entity_pools_unlock(pools);
+}
+
+size_t
+rcl_context_get_wait_set_pool_entries(const rcl_context_t * context)
+{
+  rcl_entity_pools_t * pools = _rcl_context_get_entity_pools(context);
+  if (NULL == pools) {
+    return 0;
+  }
+  return pools->wait_set_entries;
+}
+
+#ifdef __cplusplus
+}
+#endif
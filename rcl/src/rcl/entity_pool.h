@@ -0,0 +1,167 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__ENTITY_POOL_H_
+#define RCL__ENTITY_POOL_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rcl/allocator.h"
+#include "rcl/context.h"
+#include "rcl/init_options.h"
+#include "rcl/types.h"
+#include "rcl/visibility_control.h"
+#include "rcutils/stdatomic_helper.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// Round a size up to the alignment of the slots.
+#define RCL_ENTITY_POOL_ROUND_UP(size) \
+  (((size) + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1))
+
+/// Kinds of entities which have a pool, in the order of rcl_entity_pool_capacities_t.
+typedef enum rcl_entity_pool_kind_t
+{
+  RCL_ENTITY_POOL_PUBLISHER,
+  RCL_ENTITY_POOL_SUBSCRIPTION,
+  RCL_ENTITY_POOL_CLIENT,
+  RCL_ENTITY_POOL_SERVICE,
+  RCL_ENTITY_POOL_TIMER,
+  RCL_ENTITY_POOL_GUARD_CONDITION,
+  RCL_ENTITY_POOL_WAIT_SET,
+  RCL_ENTITY_POOL_KIND_COUNT
+} rcl_entity_pool_kind_t;
+
+/// Sizes of the implementation structs, defined next to the structs.
+RCL_LOCAL extern const size_t rcl_publisher_impl_size;
+RCL_LOCAL extern const size_t rcl_subscription_impl_size;
+RCL_LOCAL extern const size_t rcl_client_impl_size;
+RCL_LOCAL extern const size_t rcl_service_impl_size;
+RCL_LOCAL extern const size_t rcl_timer_impl_size;
+RCL_LOCAL extern const size_t rcl_wait_set_impl_size;
+
+/// Fixed number of slots for the implementation structs of one kind of entity.
+typedef struct rcl_entity_pool_t
+{
+  /// Number of slots, 0 if the kind is not pooled.
+  size_t capacity;
+  size_t slot_size;
+  /// Slots not in use, linked through their first bytes.
+  void * free_list;
+} rcl_entity_pool_t;
+
+/// Entity pools of a context, see rcl_init_options_set_entity_pool_capacities().
+/**
+ * All slots are carved out of one allocation made by rcl_entity_pools_init(),
+ * and taking or giving back a slot never allocates.
+ * A wait set slot holds the implementation struct followed by the arrays of
+ * the wait set, see rcl_context_get_wait_set_pool_entries().
+ *
+ * The pools are guarded by a spin lock, which is only held to take or give
+ * back a slot.
+ */
+typedef struct rcl_entity_pools_t
+{
+  rcl_entity_pool_t pools[RCL_ENTITY_POOL_KIND_COUNT];
+  /// Entities of all kinds which fit in one pooled wait set.
+  size_t wait_set_entries;
+  /// Memory of all slots, `NULL` if no kind is pooled.
+  char * storage;
+  atomic_bool lock;
+  rcl_allocator_t allocator;
+} rcl_entity_pools_t;
+
+/// Allocate the slots of the pools and link them into their free lists.
+/**
+ * Linking the slots writes to all of them, so their pages are resident
+ * before the first entity is created.
+ *
+ * \param[out] pools zero initialized pools
+ * \param[in] capacities number of slots of each kind
+ * \param[in] allocator allocator of the slots
+ * \return `RCL_RET_OK` if the pools were initialized, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed.
+ */
+RCL_LOCAL
+rcl_ret_t
+rcl_entity_pools_init(
+  rcl_entity_pools_t * pools,
+  const rcl_entity_pool_capacities_t * capacities,
+  rcl_allocator_t allocator);
+
+/// Free all slots at once, safe to call on zero initialized pools.
+RCL_LOCAL
+void
+rcl_entity_pools_fini(rcl_entity_pools_t * pools);
+
+/// Allocate the implementation struct of an entity of a context.
+/**
+ * The struct comes from the pool of its kind if that kind is pooled, and
+ * from the entity arena of the context otherwise, except for guard
+ * conditions and wait sets which then come from the allocator.
+ * The error message is set on failure.
+ *
+ * \param[in] context context of the entity, or `NULL`
+ * \param[in] kind kind of the entity
+ * \param[in] size size of the struct
+ * \param[in] allocator allocator used if the struct is neither pooled nor in the arena
+ * \param[out] object the struct, `NULL` on failure
+ * \param[out] is_pooled whether the struct came from a pool, to be kept for
+ *   rcl_context_deallocate_entity()
+ * \return `RCL_RET_OK` if the struct was allocated, or
+ * \return `RCL_RET_ENTITY_POOL_EXHAUSTED` if all slots of the pool are in use, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed.
+ */
+RCL_LOCAL
+rcl_ret_t
+rcl_context_allocate_entity(
+  const rcl_context_t * context,
+  rcl_entity_pool_kind_t kind,
+  size_t size,
+  const rcl_allocator_t * allocator,
+  void ** object,
+  bool * is_pooled);
+
+/// Deallocate a struct from rcl_context_allocate_entity(), given the same arguments.
+/**
+ * Guard conditions and wait sets which are not pooled do not read the
+ * context, so they may be finalized after it.
+ * A pooled struct whose context was finalized already went with the pools.
+ *
+ * \param[in] is_pooled as returned by rcl_context_allocate_entity()
+ */
+RCL_LOCAL
+void
+rcl_context_deallocate_entity(
+  const rcl_context_t * context,
+  rcl_entity_pool_kind_t kind,
+  void * object,
+  size_t size,
+  const rcl_allocator_t * allocator,
+  bool is_pooled);
+
+/// Return the number of entities which fit in a pooled wait set, or 0 if wait sets are not pooled.
+RCL_LOCAL
+size_t
+rcl_context_get_wait_set_pool_entries(const rcl_context_t * context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__ENTITY_POOL_H_
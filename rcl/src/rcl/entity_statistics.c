@@ -0,0 +1,153 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./entity_statistics_impl.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "rcl/error_handling.h"
+#include "rcutils/time.h"
+
+void
+rcl_entity_statistics_storage_init(rcl_entity_statistics_storage_t * storage)
+{
+#ifdef RCL_ENABLE_ENTITY_STATISTICS
+  atomic_init(&storage->message_count, 0);
+  atomic_init(&storage->byte_count, 0);
+  atomic_init(&storage->failure_count, 0);
+  atomic_init(&storage->last_arrival, 0);
+  atomic_init(&storage->interval_count, 0);
+  atomic_init(&storage->interval_sum, 0);
+  atomic_init(&storage->interval_min, INT64_MAX);
+  atomic_init(&storage->interval_max, 0);
+#else
+  storage->unused = 0;
+#endif
+}
+
+#ifdef RCL_ENABLE_ENTITY_STATISTICS
+void
+rcl_entity_statistics_record_message(rcl_entity_statistics_storage_t * storage, size_t bytes)
+{
+  uint64_t previous_count;
+  rcutils_atomic_fetch_add(&storage->message_count, previous_count, 1);
+  (void)previous_count;
+  if (0 != bytes) {
+    uint64_t previous_bytes;
+    rcutils_atomic_fetch_add(&storage->byte_count, previous_bytes, bytes);
+    (void)previous_bytes;
+  }
+
+  rcutils_time_point_value_t now;
+  if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+    rcutils_reset_error();
+    return;
+  }
+  int64_t last = rcutils_atomic_exchange_int64_t(&storage->last_arrival, now);
+  if (0 == last) {
+    return;
+  }
+  // Concurrent recorders may swap their time stamps out of order.
+  int64_t interval = now > last ? now - last : 0;
+  int64_t previous_sum;
+  rcutils_atomic_fetch_add(&storage->interval_sum, previous_sum, interval);
+  (void)previous_sum;
+  uint64_t previous_interval_count;
+  rcutils_atomic_fetch_add(&storage->interval_count, previous_interval_count, 1);
+  (void)previous_interval_count;
+
+  bool exchanged = false;
+  int64_t current = rcutils_atomic_load_int64_t(&storage->interval_min);
+  while (interval < current && !exchanged) {
+    // On failure current is updated with the latest value, so the loop re-checks it.
+    rcutils_atomic_compare_exchange_strong(&storage->interval_min, exchanged, &current, interval);
+  }
+  exchanged = false;
+  current = rcutils_atomic_load_int64_t(&storage->interval_max);
+  while (interval > current && !exchanged) {
+    rcutils_atomic_compare_exchange_strong(&storage->interval_max, exchanged, &current, interval);
+  }
+}
+
+void
+rcl_entity_statistics_record_failure(rcl_entity_statistics_storage_t * storage)
+{
+  uint64_t previous_count;
+  rcutils_atomic_fetch_add(&storage->failure_count, previous_count, 1);
+  (void)previous_count;
+}
+#else
+void
+rcl_entity_statistics_record_message(rcl_entity_statistics_storage_t * storage, size_t bytes)
+{
+  (void)storage;
+  (void)bytes;
+}
+
+void
+rcl_entity_statistics_record_failure(rcl_entity_statistics_storage_t * storage)
+{
+  (void)storage;
+}
+#endif
+
+bool
+rcl_entity_statistics_is_available(void)
+{
+#ifdef RCL_ENABLE_ENTITY_STATISTICS
+  return true;
+#else
+  return false;
+#endif
+}
+
+rcl_ret_t
+rcl_entity_statistics_storage_get(
+  rcl_entity_statistics_storage_t * storage,
+  rcl_entity_statistics_t * statistics)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(statistics, RCL_RET_INVALID_ARGUMENT);
+#ifdef RCL_ENABLE_ENTITY_STATISTICS
+  statistics->message_count = rcutils_atomic_load_uint64_t(&storage->message_count);
+  statistics->byte_count = rcutils_atomic_load_uint64_t(&storage->byte_count);
+  statistics->failure_count = rcutils_atomic_load_uint64_t(&storage->failure_count);
+  uint64_t interval_count = rcutils_atomic_load_uint64_t(&storage->interval_count);
+  if (0 == interval_count) {
+    statistics->inter_arrival_min = 0;
+    statistics->inter_arrival_mean = 0;
+    statistics->inter_arrival_max = 0;
+    return RCL_RET_OK;
+  }
+  statistics->inter_arrival_min = rcutils_atomic_load_int64_t(&storage->interval_min);
+  statistics->inter_arrival_mean =
+    rcutils_atomic_load_int64_t(&storage->interval_sum) / (int64_t)interval_count;
+  statistics->inter_arrival_max = rcutils_atomic_load_int64_t(&storage->interval_max);
+  return RCL_RET_OK;
+#else
+  (void)storage;
+  memset(statistics, 0, sizeof(*statistics));
+  RCL_SET_ERROR_MSG("rcl was built without entity statistics");
+  return RCL_RET_ERROR;
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,90 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__ENTITY_STATISTICS_IMPL_H_
+#define RCL__ENTITY_STATISTICS_IMPL_H_
+
+#include "rcl/entity_statistics.h"
+#include "rcl/types.h"
+#include "rcl/visibility_control.h"
+#include "rcutils/stdatomic_helper.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// Lock-free counters backing rcl_entity_statistics_t, embedded in each entity impl.
+typedef struct rcl_entity_statistics_storage_t
+{
+#ifdef RCL_ENABLE_ENTITY_STATISTICS
+  atomic_uint_least64_t message_count;
+  atomic_uint_least64_t byte_count;
+  atomic_uint_least64_t failure_count;
+  /// Steady time of the last message, 0 if there was none yet.
+  atomic_int_least64_t last_arrival;
+  atomic_uint_least64_t interval_count;
+  atomic_int_least64_t interval_sum;
+  atomic_int_least64_t interval_min;
+  atomic_int_least64_t interval_max;
+#else
+  /// Placeholder, C does not allow empty structs.
+  uint8_t unused;
+#endif
+} rcl_entity_statistics_storage_t;
+
+/// Reset all counters, must be called before the storage is used.
+RCL_LOCAL
+void
+rcl_entity_statistics_storage_init(rcl_entity_statistics_storage_t * storage);
+
+/// Record one message of the given serialized size, use 0 for non serialized messages.
+RCL_LOCAL
+void
+rcl_entity_statistics_record_message(rcl_entity_statistics_storage_t * storage, size_t bytes);
+
+/// Record one call which did not produce a message.
+RCL_LOCAL
+void
+rcl_entity_statistics_record_failure(rcl_entity_statistics_storage_t * storage);
+
+/// Read the counters into the public statistics struct.
+/**
+ * The counters are read one at a time, so the result is not a consistent
+ * snapshot if messages are recorded concurrently.
+ *
+ * \return `RCL_RET_OK` if the statistics were read, or
+ * \return `RCL_RET_ERROR` if rcl was built without entity statistics.
+ */
+RCL_LOCAL
+rcl_ret_t
+rcl_entity_statistics_storage_get(
+  rcl_entity_statistics_storage_t * storage,
+  rcl_entity_statistics_t * statistics);
+
+#ifdef RCL_ENABLE_ENTITY_STATISTICS
+# define RCL_ENTITY_STATISTICS_RECORD_MESSAGE(storage, bytes) \
+  rcl_entity_statistics_record_message(storage, bytes)
+# define RCL_ENTITY_STATISTICS_RECORD_FAILURE(storage) \
+  rcl_entity_statistics_record_failure(storage)
+#else
+# define RCL_ENTITY_STATISTICS_RECORD_MESSAGE(storage, bytes) ((void)(storage), (void)(bytes))
+# define RCL_ENTITY_STATISTICS_RECORD_FAILURE(storage) ((void)(storage))
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__ENTITY_STATISTICS_IMPL_H_
@@ -20,6 +20,8 @@ extern "C"
 #include "rcl/graph.h"
 
 #include "rcl/error_handling.h"
+#include "rcl/guard_condition.h"
+#include "rcl/wait.h"
 #include "rcutils/allocator.h"
 #include "rcutils/types.h"
 #include "rmw/get_node_info_and_types.h"
@@ -29,6 +31,8 @@ extern "C"
 #include "rmw/rmw.h"
 
 #include "./common.h"
+#include "./context_impl.h"
+#include "./graph_cache.h"
 
 rcl_ret_t
 rcl_get_publisher_names_and_types_by_node(
@@ -159,6 +163,14 @@ rcl_get_topic_names_and_types(
   if (rmw_ret != RMW_RET_OK) {
     return rcl_convert_rmw_ret_to_rcl_ret(rmw_ret);
   }
+  rcl_graph_cache_t * cache = rcl_graph_cache_get_for_node(node);
+  // The snapshot holds demangled names only.
+  if (NULL != cache && !no_demangle && rcl_graph_cache_acquire(cache, node)) {
+    rcl_ret_t ret = rcl_graph_cache_copy_names_and_types(
+      &cache->topic_names_and_types, allocator, topic_names_and_types);
+    rcl_graph_cache_release(cache);
+    return ret;
+  }
   rcutils_allocator_t rcutils_allocator = *allocator;
   rmw_ret = rmw_get_topic_names_and_types(
     rcl_node_get_rmw_handle(node),
@@ -184,6 +196,13 @@ rcl_get_service_names_and_types(
   if (rmw_ret != RMW_RET_OK) {
     return rcl_convert_rmw_ret_to_rcl_ret(rmw_ret);
   }
+  rcl_graph_cache_t * cache = rcl_graph_cache_get_for_node(node);
+  if (NULL != cache && rcl_graph_cache_acquire(cache, node)) {
+    rcl_ret_t ret = rcl_graph_cache_copy_names_and_types(
+      &cache->service_names_and_types, allocator, service_names_and_types);
+    rcl_graph_cache_release(cache);
+    return ret;
+  }
   rcutils_allocator_t rcutils_allocator = *allocator;
   rmw_ret = rmw_get_service_names_and_types(
     rcl_node_get_rmw_handle(node),
@@ -229,7 +248,20 @@ rcl_get_node_names(
     RCL_SET_ERROR_MSG("node_namespaces is not null");
     return RCL_RET_INVALID_ARGUMENT;
   }
-  (void)allocator;  // to be used in rmw_get_node_names in the future
+  rcl_graph_cache_t * cache = rcl_graph_cache_get_for_node(node);
+  if (NULL != cache && rcl_graph_cache_acquire(cache, node)) {
+    rcl_ret_t ret = rcl_graph_cache_copy_string_array(&cache->node_names, allocator, node_names);
+    if (RCL_RET_OK == ret) {
+      ret = rcl_graph_cache_copy_string_array(
+        &cache->node_namespaces, allocator, node_namespaces);
+      if (RCL_RET_OK != ret && RCUTILS_RET_OK != rcutils_string_array_fini(node_names)) {
+        rcutils_reset_error();
+      }
+    }
+    rcl_graph_cache_release(cache);
+    return ret;
+  }
+  // The allocator is only used by the graph cache, the middleware uses its own.
   rmw_ret_t rmw_ret = rmw_get_node_names(
     rcl_node_get_rmw_handle(node),
     node_names,
@@ -237,6 +269,30 @@ rcl_get_node_names(
   return rcl_convert_rmw_ret_to_rcl_ret(rmw_ret);
 }
 
+/// Count the publishers or subscribers of a topic using the graph cache, if enabled.
+static bool
+_rcl_graph_cache_count(
+  const rcl_node_t * node,
+  const char * topic_name,
+  bool count_publishers,
+  size_t * count)
+{
+  rcl_graph_cache_t * cache = rcl_graph_cache_get_for_node(node);
+  if (NULL == cache || !rcl_graph_cache_acquire(cache, node)) {
+    return false;
+  }
+  size_t topic = rcl_graph_cache_index_find(
+    &cache->topic_index, &cache->topic_names_and_types.names, topic_name);
+  if (SIZE_MAX == topic) {
+    // Nobody publishes or subscribes to a topic which is not in the graph.
+    *count = 0;
+  } else {
+    *count = count_publishers ? cache->publisher_counts[topic] : cache->subscriber_counts[topic];
+  }
+  rcl_graph_cache_release(cache);
+  return true;
+}
+
 rcl_ret_t
 rcl_count_publishers(
   const rcl_node_t * node,
@@ -252,6 +308,9 @@ rcl_count_publishers(
   }
   RCL_CHECK_ARGUMENT_FOR_NULL(topic_name, RCL_RET_INVALID_ARGUMENT);
   RCL_CHECK_ARGUMENT_FOR_NULL(count, RCL_RET_INVALID_ARGUMENT);
+  if (_rcl_graph_cache_count(node, topic_name, true, count)) {
+    return RCL_RET_OK;
+  }
   rmw_ret_t rmw_ret = rmw_count_publishers(rcl_node_get_rmw_handle(node), topic_name, count);
   return rcl_convert_rmw_ret_to_rcl_ret(rmw_ret);
 }
@@ -271,6 +330,9 @@ rcl_count_subscribers(
   }
   RCL_CHECK_ARGUMENT_FOR_NULL(topic_name, RCL_RET_INVALID_ARGUMENT);
   RCL_CHECK_ARGUMENT_FOR_NULL(count, RCL_RET_INVALID_ARGUMENT);
+  if (_rcl_graph_cache_count(node, topic_name, false, count)) {
+    return RCL_RET_OK;
+  }
   rmw_ret_t rmw_ret = rmw_count_subscribers(rcl_node_get_rmw_handle(node), topic_name, count);
   return rcl_convert_rmw_ret_to_rcl_ret(rmw_ret);
 }
@@ -290,6 +352,34 @@ rcl_service_server_is_available(
   }
   RCL_CHECK_ARGUMENT_FOR_NULL(client, RCL_RET_INVALID_ARGUMENT);
   RCL_CHECK_ARGUMENT_FOR_NULL(is_available, RCL_RET_INVALID_ARGUMENT);
+  rcl_graph_cache_t * cache = rcl_graph_cache_get_for_node(node);
+  const char * service_name = rcl_client_get_service_name(client);
+  if (NULL != cache && NULL != service_name && rcl_graph_cache_acquire(cache, node)) {
+    size_t service = rcl_graph_cache_index_find(
+      &cache->service_index, &cache->service_names_and_types.names, service_name);
+    rmw_ret_t rmw_ret = RMW_RET_OK;
+    if (SIZE_MAX != service && cache->service_availability[service] < 0) {
+      // Ask the middleware once per snapshot, availability only changes with the graph.
+      bool available = false;
+      rmw_ret = rmw_service_server_is_available(
+        rcl_node_get_rmw_handle(node), rcl_client_get_rmw_handle(client), &available);
+      if (RMW_RET_OK == rmw_ret) {
+        cache->service_availability[service] = available ? 1 : 0;
+      }
+    }
+    bool is_cached = SIZE_MAX != service && cache->service_availability[service] >= 0;
+    if (is_cached) {
+      *is_available = 1 == cache->service_availability[service];
+    }
+    rcl_graph_cache_release(cache);
+    if (RMW_RET_OK != rmw_ret) {
+      return rcl_convert_rmw_ret_to_rcl_ret(rmw_ret);
+    }
+    if (is_cached) {
+      return RCL_RET_OK;
+    }
+    // Not yet discovered when the snapshot was built, ask the middleware directly.
+  }
   rmw_ret_t rmw_ret = rmw_service_server_is_available(
     rcl_node_get_rmw_handle(node),
     rcl_client_get_rmw_handle(client),
@@ -298,6 +388,298 @@ rcl_service_server_is_available(
   return rcl_convert_rmw_ret_to_rcl_ret(rmw_ret);
 }
 
+rcl_graph_changes_t
+rcl_get_zero_initialized_graph_changes(void)
+{
+  static rcl_graph_changes_t null_changes = {
+    .changes = NULL,
+    .size = 0,
+    .is_full_state = false,
+  };
+  return null_changes;
+}
+
+/// Check whether the graph condition a wait function waits for holds.
+typedef rcl_ret_t (* _rcl_graph_condition_check_t)(
+  const rcl_node_t * node,
+  const void * arg,
+  size_t count,
+  bool * holds);
+
+static rcl_ret_t
+_rcl_graph_service_is_available(
+  const rcl_node_t * node, const void * client, size_t count, bool * holds)
+{
+  (void)count;
+  return rcl_service_server_is_available(node, (const rcl_client_t *)client, holds);
+}
+
+static rcl_ret_t
+_rcl_graph_has_publishers(
+  const rcl_node_t * node, const void * topic_name, size_t count, bool * holds)
+{
+  size_t publisher_count = 0;
+  rcl_ret_t ret = rcl_count_publishers(node, (const char *)topic_name, &publisher_count);
+  *holds = publisher_count >= count;
+  return ret;
+}
+
+static rcl_ret_t
+_rcl_graph_has_subscribers(
+  const rcl_node_t * node, const void * topic_name, size_t count, bool * holds)
+{
+  size_t subscriber_count = 0;
+  rcl_ret_t ret = rcl_count_subscribers(node, (const char *)topic_name, &subscriber_count);
+  *holds = subscriber_count >= count;
+  return ret;
+}
+
+/// Wait on the context's graph guard condition until the check holds or the timeout expires.
+static rcl_ret_t
+_rcl_wait_for_graph_condition(
+  const rcl_node_t * node,
+  rcl_allocator_t * allocator,
+  _rcl_graph_condition_check_t check,
+  const void * arg,
+  size_t count,
+  rcl_duration_value_t timeout,
+  bool * success)
+{
+  *success = false;
+  rcl_ret_t ret = check(node, arg, count, success);
+  if (RCL_RET_OK != ret || *success) {
+    return ret;
+  }
+  if (0 == timeout) {
+    return RCL_RET_TIMEOUT;
+  }
+  rcutils_time_point_value_t end = 0;
+  if (timeout > 0) {
+    if (RCUTILS_RET_OK != rcutils_steady_time_now(&end)) {
+      RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
+      rcutils_reset_error();
+      return RCL_RET_ERROR;
+    }
+    end = end > INT64_MAX - timeout ? INT64_MAX : end + timeout;
+  }
+  // The context's guard condition, so finalizing another node of the context during the wait
+  // is handled like for any other wait on it.
+  const rcl_guard_condition_t * graph_guard_condition =
+    rcl_context_get_graph_guard_condition(node->context);
+  if (NULL == graph_guard_condition) {
+    return RCL_RET_ERROR;  // error already set
+  }
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  ret = rcl_wait_set_init(&wait_set, 0, 1, 0, 0, 0, *allocator);
+  if (RCL_RET_OK != ret) {
+    return ret;  // error already set
+  }
+  for (;;) {
+    rcl_duration_value_t time_to_wait = -1;
+    if (timeout > 0) {
+      rcutils_time_point_value_t now;
+      if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+        RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
+        rcutils_reset_error();
+        ret = RCL_RET_ERROR;
+        break;
+      }
+      if (now >= end) {
+        ret = RCL_RET_TIMEOUT;
+        break;
+      }
+      time_to_wait = end - now;
+    }
+    ret = rcl_wait_set_clear(&wait_set);
+    if (RCL_RET_OK != ret) {
+      break;
+    }
+    ret = rcl_wait_set_add_guard_condition(&wait_set, graph_guard_condition, NULL);
+    if (RCL_RET_OK != ret) {
+      break;
+    }
+    ret = rcl_wait(&wait_set, time_to_wait);
+    if (RCL_RET_TIMEOUT == ret) {
+      // Check once more, in case the graph changed without a guard condition trigger.
+      ret = check(node, arg, count, success);
+      if (RCL_RET_OK == ret && !*success) {
+        ret = RCL_RET_TIMEOUT;
+      }
+      break;
+    }
+    if (RCL_RET_OK != ret) {
+      break;
+    }
+    // The graph changed, which also invalidated the graph cache, if enabled.
+    ret = check(node, arg, count, success);
+    if (RCL_RET_OK != ret || *success) {
+      break;
+    }
+  }
+  rcl_ret_t fini_ret = rcl_wait_set_fini(&wait_set);
+  if (RCL_RET_OK == ret || RCL_RET_TIMEOUT == ret) {
+    if (RCL_RET_OK != fini_ret) {
+      return fini_ret;  // error already set
+    }
+  }
+  return ret;
+}
+
+rcl_ret_t
+rcl_wait_for_service(
+  const rcl_node_t * node,
+  rcl_allocator_t * allocator,
+  const rcl_client_t * client,
+  rcl_duration_value_t timeout,
+  bool * success)
+{
+  if (!rcl_node_is_valid(node)) {
+    return RCL_RET_NODE_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(allocator, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ALLOCATOR_WITH_MSG(allocator, "invalid allocator", return RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(client, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(success, RCL_RET_INVALID_ARGUMENT);
+  return _rcl_wait_for_graph_condition(
+    node, allocator, _rcl_graph_service_is_available, client, 0, timeout, success);
+}
+
+rcl_ret_t
+rcl_wait_for_publishers(
+  const rcl_node_t * node,
+  rcl_allocator_t * allocator,
+  const char * topic_name,
+  size_t count,
+  rcl_duration_value_t timeout,
+  bool * success)
+{
+  if (!rcl_node_is_valid(node)) {
+    return RCL_RET_NODE_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(allocator, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ALLOCATOR_WITH_MSG(allocator, "invalid allocator", return RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(topic_name, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(success, RCL_RET_INVALID_ARGUMENT);
+  return _rcl_wait_for_graph_condition(
+    node, allocator, _rcl_graph_has_publishers, topic_name, count, timeout, success);
+}
+
+rcl_ret_t
+rcl_wait_for_subscribers(
+  const rcl_node_t * node,
+  rcl_allocator_t * allocator,
+  const char * topic_name,
+  size_t count,
+  rcl_duration_value_t timeout,
+  bool * success)
+{
+  if (!rcl_node_is_valid(node)) {
+    return RCL_RET_NODE_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(allocator, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ALLOCATOR_WITH_MSG(allocator, "invalid allocator", return RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(topic_name, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(success, RCL_RET_INVALID_ARGUMENT);
+  return _rcl_wait_for_graph_condition(
+    node, allocator, _rcl_graph_has_subscribers, topic_name, count, timeout, success);
+}
+
+static void
+_rcl_graph_changes_clear(rcl_graph_changes_t * changes)
+{
+  if (NULL == changes->changes) {
+    return;
+  }
+  size_t i;
+  for (i = 0; i < changes->size; ++i) {
+    rcl_graph_entity_fini(&changes->changes[i].entity, &changes->allocator);
+  }
+  changes->allocator.deallocate(changes->changes, changes->allocator.state);
+  changes->changes = NULL;
+  changes->size = 0;
+}
+
+const rcl_guard_condition_t *
+rcl_context_get_graph_guard_condition(rcl_context_t * context)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(context, NULL);
+  RCL_CHECK_FOR_NULL_WITH_MSG(context->impl, "context is zero-initialized", return NULL);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    context->impl->graph_guard_condition.impl, "context is not initialized", return NULL);
+  return &context->impl->graph_guard_condition;
+}
+
+rcl_ret_t
+rcl_get_graph_changes(
+  const rcl_node_t * node,
+  rcl_graph_cursor_t * cursor,
+  rcl_allocator_t * allocator,
+  rcl_graph_changes_t * changes)
+{
+  if (!rcl_node_is_valid(node)) {
+    return RCL_RET_NODE_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(cursor, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(allocator, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ALLOCATOR_WITH_MSG(allocator, "invalid allocator", return RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(changes, RCL_RET_INVALID_ARGUMENT);
+  if (NULL != changes->changes) {
+    RCL_SET_ERROR_MSG("changes is not zero initialized");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  rcl_graph_cache_t * cache = &node->context->impl->graph_cache;
+  rcl_ret_t ret = rcl_graph_cache_acquire_changes(cache, node);
+  if (RCL_RET_OK != ret) {
+    return ret;  // error already set
+  }
+  bool is_full_state = *cursor < cache->oldest_cursor || *cursor > cache->next_cursor;
+  size_t size = is_full_state ? cache->entity_count : (size_t)(cache->next_cursor - *cursor);
+  changes->allocator = *allocator;
+  changes->is_full_state = is_full_state;
+  if (size > 0) {
+    changes->changes = (rcl_graph_change_t *)allocator->zero_allocate(
+      size, sizeof(rcl_graph_change_t), allocator->state);
+    if (NULL == changes->changes) {
+      rcl_graph_cache_release(cache);
+      RCL_SET_ERROR_MSG("allocating memory failed");
+      return RCL_RET_BAD_ALLOC;
+    }
+  }
+  for (changes->size = 0; RCL_RET_OK == ret && changes->size < size; ++changes->size) {
+    rcl_graph_change_t * change = &changes->changes[changes->size];
+    const rcl_graph_entity_t * entity;
+    if (is_full_state) {
+      change->added = true;
+      entity = &cache->entities[changes->size];
+    } else {
+      const rcl_graph_change_t * logged =
+        &cache->change_log[(*cursor + changes->size) % RCL_GRAPH_CHANGE_LOG_CAPACITY];
+      change->added = logged->added;
+      entity = &logged->entity;
+    }
+    ret = rcl_graph_entity_copy(entity, allocator, &change->entity);
+  }
+  if (RCL_RET_OK == ret) {
+    *cursor = cache->next_cursor;
+  }
+  rcl_graph_cache_release(cache);
+  if (RCL_RET_OK != ret) {
+    // The entity which failed to copy is already freed.
+    --changes->size;
+    _rcl_graph_changes_clear(changes);
+    changes->is_full_state = false;
+  }
+  return ret;
+}
+
+rcl_ret_t
+rcl_graph_changes_fini(rcl_graph_changes_t * changes)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(changes, RCL_RET_INVALID_ARGUMENT);
+  _rcl_graph_changes_clear(changes);
+  return RCL_RET_OK;
+}
+
 #ifdef __cplusplus
 }
 #endif
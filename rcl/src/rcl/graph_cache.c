@@ -0,0 +1,668 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./graph_cache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "rcl/error_handling.h"
+#include "rcutils/strdup.h"
+#include "rmw/error_handling.h"
+#include "rmw/get_node_info_and_types.h"
+#include "rmw/get_service_names_and_types.h"
+#include "rmw/get_topic_names_and_types.h"
+#include "rmw/names_and_types.h"
+#include "rmw/rmw.h"
+
+#include "./common.h"
+#include "./context_impl.h"
+
+static void
+_rcl_graph_cache_deallocate(rcl_allocator_t * allocator, void * pointer)
+{
+  if (NULL != pointer) {
+    allocator->deallocate(pointer, allocator->state);
+  }
+}
+
+static void
+_rcl_graph_cache_clear(rcl_graph_cache_t * cache)
+{
+  rcl_allocator_t * allocator = &cache->allocator;
+  if (NULL != cache->topic_names_and_types.names.data &&
+    RMW_RET_OK != rmw_names_and_types_fini(&cache->topic_names_and_types))
+  {
+    rmw_reset_error();
+  }
+  cache->topic_names_and_types = rmw_get_zero_initialized_names_and_types();
+  if (NULL != cache->service_names_and_types.names.data &&
+    RMW_RET_OK != rmw_names_and_types_fini(&cache->service_names_and_types))
+  {
+    rmw_reset_error();
+  }
+  cache->service_names_and_types = rmw_get_zero_initialized_names_and_types();
+  if (NULL != cache->node_names.data &&
+    RCUTILS_RET_OK != rcutils_string_array_fini(&cache->node_names))
+  {
+    rcutils_reset_error();
+  }
+  cache->node_names = rcutils_get_zero_initialized_string_array();
+  if (NULL != cache->node_namespaces.data &&
+    RCUTILS_RET_OK != rcutils_string_array_fini(&cache->node_namespaces))
+  {
+    rcutils_reset_error();
+  }
+  cache->node_namespaces = rcutils_get_zero_initialized_string_array();
+  _rcl_graph_cache_deallocate(allocator, cache->topic_index.slots);
+  cache->topic_index.slots = NULL;
+  _rcl_graph_cache_deallocate(allocator, cache->service_index.slots);
+  cache->service_index.slots = NULL;
+  _rcl_graph_cache_deallocate(allocator, cache->publisher_counts);
+  cache->publisher_counts = NULL;
+  _rcl_graph_cache_deallocate(allocator, cache->subscriber_counts);
+  cache->subscriber_counts = NULL;
+  _rcl_graph_cache_deallocate(allocator, cache->service_availability);
+  cache->service_availability = NULL;
+  cache->is_built = false;
+}
+
+void
+rcl_graph_entity_fini(rcl_graph_entity_t * entity, rcl_allocator_t * allocator)
+{
+  _rcl_graph_cache_deallocate(allocator, entity->node_name);
+  _rcl_graph_cache_deallocate(allocator, entity->node_namespace);
+  _rcl_graph_cache_deallocate(allocator, entity->name);
+  _rcl_graph_cache_deallocate(allocator, entity->type);
+  memset(entity, 0, sizeof(rcl_graph_entity_t));
+}
+
+static char *
+_rcl_graph_cache_strdup(const char * string, rcl_allocator_t * allocator, bool * ok)
+{
+  if (NULL == string) {
+    return NULL;
+  }
+  char * copy = rcutils_strdup(string, *allocator);
+  *ok = *ok && NULL != copy;
+  return copy;
+}
+
+rcl_ret_t
+rcl_graph_entity_copy(
+  const rcl_graph_entity_t * source,
+  rcl_allocator_t * allocator,
+  rcl_graph_entity_t * destination)
+{
+  bool ok = true;
+  destination->kind = source->kind;
+  destination->node_name = _rcl_graph_cache_strdup(source->node_name, allocator, &ok);
+  destination->node_namespace = _rcl_graph_cache_strdup(source->node_namespace, allocator, &ok);
+  destination->name = _rcl_graph_cache_strdup(source->name, allocator, &ok);
+  destination->type = _rcl_graph_cache_strdup(source->type, allocator, &ok);
+  if (!ok) {
+    rcl_graph_entity_fini(destination, allocator);
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    return RCL_RET_BAD_ALLOC;
+  }
+  return RCL_RET_OK;
+}
+
+static void
+_rcl_graph_cache_free_entities(
+  rcl_graph_cache_t * cache,
+  rcl_graph_entity_t * entities,
+  size_t entity_count)
+{
+  if (NULL == entities) {
+    return;
+  }
+  size_t i;
+  for (i = 0; i < entity_count; ++i) {
+    rcl_graph_entity_fini(&entities[i], &cache->allocator);
+  }
+  cache->allocator.deallocate(entities, cache->allocator.state);
+}
+
+void
+rcl_graph_cache_init(rcl_graph_cache_t * cache, int64_t max_age, rcl_allocator_t allocator)
+{
+  memset(cache, 0, sizeof(rcl_graph_cache_t));
+  atomic_init(&cache->generation, 0);
+  atomic_init(&cache->lock, false);
+  atomic_init(&cache->track_changes, false);
+  cache->max_age = max_age;
+  cache->next_cursor = RCL_GRAPH_CURSOR_INITIAL + 1;
+  cache->oldest_cursor = cache->next_cursor;
+  cache->allocator = allocator;
+  cache->topic_names_and_types = rmw_get_zero_initialized_names_and_types();
+  cache->service_names_and_types = rmw_get_zero_initialized_names_and_types();
+  cache->node_names = rcutils_get_zero_initialized_string_array();
+  cache->node_namespaces = rcutils_get_zero_initialized_string_array();
+}
+
+void
+rcl_graph_cache_fini(rcl_graph_cache_t * cache)
+{
+  // Also used by rcl_get_graph_changes() while the cache is disabled.
+  _rcl_graph_cache_clear(cache);
+  _rcl_graph_cache_free_entities(cache, cache->entities, cache->entity_count);
+  cache->entities = NULL;
+  cache->entity_count = 0;
+  cache->has_entities = false;
+  if (NULL != cache->change_log) {
+    size_t i;
+    for (i = 0; i < RCL_GRAPH_CHANGE_LOG_CAPACITY; ++i) {
+      rcl_graph_entity_fini(&cache->change_log[i].entity, &cache->allocator);
+    }
+    cache->allocator.deallocate(cache->change_log, cache->allocator.state);
+    cache->change_log = NULL;
+  }
+  cache->max_age = 0;
+}
+
+bool
+rcl_graph_cache_is_enabled(const rcl_graph_cache_t * cache)
+{
+  return cache->max_age > 0;
+}
+
+void
+rcl_graph_cache_invalidate(rcl_graph_cache_t * cache)
+{
+  uint64_t previous_generation;
+  rcutils_atomic_fetch_add(&cache->generation, previous_generation, 1);
+  (void)previous_generation;
+}
+
+rcl_graph_cache_t *
+rcl_graph_cache_get_for_node(const rcl_node_t * node)
+{
+  if (NULL == node || NULL == node->context || NULL == node->context->impl) {
+    return NULL;
+  }
+  rcl_graph_cache_t * cache = &node->context->impl->graph_cache;
+  return rcl_graph_cache_is_enabled(cache) ? cache : NULL;
+}
+
+void
+rcl_graph_cache_invalidate_for_node(const rcl_node_t * node)
+{
+  rcl_graph_cache_t * cache = rcl_graph_cache_get_for_node(node);
+  if (NULL != cache) {
+    rcl_graph_cache_invalidate(cache);
+  }
+}
+
+/// 64 bit FNV-1a hash of a name.
+static uint64_t
+_rcl_graph_cache_hash_name(const char * name)
+{
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (; '\0' != *name; ++name) {
+    hash ^= (uint8_t)*name;
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+static bool
+_rcl_graph_cache_index_build(
+  rcl_graph_cache_index_t * index,
+  const rcutils_string_array_t * names,
+  rcl_allocator_t * allocator)
+{
+  // Keep the load factor at or below one half, so every probe sequence ends in an empty slot.
+  size_t slot_count = 1;
+  while (slot_count < 2 * names->size) {
+    slot_count <<= 1;
+  }
+  index->slots = (size_t *)allocator->zero_allocate(slot_count, sizeof(size_t), allocator->state);
+  if (NULL == index->slots) {
+    return false;
+  }
+  index->slot_mask = slot_count - 1;
+  size_t i;
+  for (i = 0; i < names->size; ++i) {
+    size_t slot = (size_t)_rcl_graph_cache_hash_name(names->data[i]) & index->slot_mask;
+    while (0 != index->slots[slot]) {
+      slot = (slot + 1) & index->slot_mask;
+    }
+    index->slots[slot] = i + 1;
+  }
+  return true;
+}
+
+size_t
+rcl_graph_cache_index_find(
+  const rcl_graph_cache_index_t * index,
+  const rcutils_string_array_t * names,
+  const char * name)
+{
+  if (NULL == index->slots) {
+    return SIZE_MAX;
+  }
+  size_t slot = (size_t)_rcl_graph_cache_hash_name(name) & index->slot_mask;
+  while (0 != index->slots[slot]) {
+    size_t position = index->slots[slot] - 1;
+    if (0 == strcmp(names->data[position], name)) {
+      return position;
+    }
+    slot = (slot + 1) & index->slot_mask;
+  }
+  return SIZE_MAX;
+}
+
+/// Query the middleware for the whole graph, the previous snapshot must be cleared.
+static rcl_ret_t
+_rcl_graph_cache_rebuild(rcl_graph_cache_t * cache, const rcl_node_t * node)
+{
+  const rmw_node_t * rmw_node = rcl_node_get_rmw_handle(node);
+  rcl_allocator_t * allocator = &cache->allocator;
+  rmw_ret_t rmw_ret = rmw_get_topic_names_and_types(
+    rmw_node, allocator, false, &cache->topic_names_and_types);
+  if (RMW_RET_OK != rmw_ret) {
+    return rcl_convert_rmw_ret_to_rcl_ret(rmw_ret);
+  }
+  rmw_ret = rmw_get_service_names_and_types(rmw_node, allocator, &cache->service_names_and_types);
+  if (RMW_RET_OK != rmw_ret) {
+    return rcl_convert_rmw_ret_to_rcl_ret(rmw_ret);
+  }
+  rmw_ret = rmw_get_node_names(rmw_node, &cache->node_names, &cache->node_namespaces);
+  if (RMW_RET_OK != rmw_ret) {
+    return rcl_convert_rmw_ret_to_rcl_ret(rmw_ret);
+  }
+
+  size_t topic_count = cache->topic_names_and_types.names.size;
+  // Allocate at least one element, so NULL always means the allocation failed.
+  cache->publisher_counts = (size_t *)allocator->allocate(
+    sizeof(size_t) * (topic_count + 1), allocator->state);
+  cache->subscriber_counts = (size_t *)allocator->allocate(
+    sizeof(size_t) * (topic_count + 1), allocator->state);
+  size_t service_count = cache->service_names_and_types.names.size;
+  cache->service_availability = (int8_t *)allocator->allocate(
+    service_count + 1, allocator->state);
+  if (NULL == cache->publisher_counts || NULL == cache->subscriber_counts ||
+    NULL == cache->service_availability ||
+    !_rcl_graph_cache_index_build(
+      &cache->topic_index, &cache->topic_names_and_types.names, allocator) ||
+    !_rcl_graph_cache_index_build(
+      &cache->service_index, &cache->service_names_and_types.names, allocator))
+  {
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    return RCL_RET_BAD_ALLOC;
+  }
+  memset(cache->service_availability, -1, service_count + 1);
+
+  size_t i;
+  for (i = 0; i < topic_count; ++i) {
+    const char * topic_name = cache->topic_names_and_types.names.data[i];
+    rmw_ret = rmw_count_publishers(rmw_node, topic_name, &cache->publisher_counts[i]);
+    if (RMW_RET_OK != rmw_ret) {
+      return rcl_convert_rmw_ret_to_rcl_ret(rmw_ret);
+    }
+    rmw_ret = rmw_count_subscribers(rmw_node, topic_name, &cache->subscriber_counts[i]);
+    if (RMW_RET_OK != rmw_ret) {
+      return rcl_convert_rmw_ret_to_rcl_ret(rmw_ret);
+    }
+  }
+  return RCL_RET_OK;
+}
+
+/// Compare entities by kind, then namespace, node name, name and type.
+static int
+_rcl_graph_entity_compare(const void * lhs, const void * rhs)
+{
+  const rcl_graph_entity_t * a = (const rcl_graph_entity_t *)lhs;
+  const rcl_graph_entity_t * b = (const rcl_graph_entity_t *)rhs;
+  if (a->kind != b->kind) {
+    return a->kind < b->kind ? -1 : 1;
+  }
+  const char * a_strings[] = {a->node_namespace, a->node_name, a->name, a->type};
+  const char * b_strings[] = {b->node_namespace, b->node_name, b->name, b->type};
+  size_t i;
+  for (i = 0; i < sizeof(a_strings) / sizeof(a_strings[0]); ++i) {
+    int order = strcmp(a_strings[i] ? a_strings[i] : "", b_strings[i] ? b_strings[i] : "");
+    if (0 != order) {
+      return order;
+    }
+  }
+  return 0;
+}
+
+/// Growable array of entities collected during a rebuild.
+typedef struct rcl_graph_entity_array_t
+{
+  rcl_graph_entity_t * data;
+  size_t size;
+  size_t capacity;
+} rcl_graph_entity_array_t;
+
+static rcl_ret_t
+_rcl_graph_entity_array_append(
+  rcl_graph_entity_array_t * array,
+  const rcl_graph_entity_t * entity,
+  rcl_allocator_t * allocator)
+{
+  if (array->size == array->capacity) {
+    size_t new_capacity = array->capacity ? 2 * array->capacity : 64;
+    rcl_graph_entity_t * new_data = (rcl_graph_entity_t *)allocator->reallocate(
+      array->data, sizeof(rcl_graph_entity_t) * new_capacity, allocator->state);
+    if (NULL == new_data) {
+      RCL_SET_ERROR_MSG("allocating memory failed");
+      return RCL_RET_BAD_ALLOC;
+    }
+    array->data = new_data;
+    array->capacity = new_capacity;
+  }
+  rcl_ret_t ret = rcl_graph_entity_copy(entity, allocator, &array->data[array->size]);
+  if (RCL_RET_OK == ret) {
+    ++array->size;
+  }
+  return ret;
+}
+
+/// Append the endpoints of one kind of the given node.
+static rcl_ret_t
+_rcl_graph_cache_collect_endpoints(
+  rcl_graph_cache_t * cache,
+  const rmw_node_t * rmw_node,
+  rcl_graph_entity_t * node_entity,
+  rcl_graph_entity_kind_t kind,
+  rcl_graph_entity_array_t * entities)
+{
+  rcl_allocator_t * allocator = &cache->allocator;
+  rcl_names_and_types_t names_and_types = rmw_get_zero_initialized_names_and_types();
+  rmw_ret_t rmw_ret;
+  if (RCL_GRAPH_ENTITY_PUBLISHER == kind) {
+    rmw_ret = rmw_get_publisher_names_and_types_by_node(
+      rmw_node, allocator, node_entity->node_name, node_entity->node_namespace, false,
+      &names_and_types);
+  } else if (RCL_GRAPH_ENTITY_SUBSCRIPTION == kind) {
+    rmw_ret = rmw_get_subscriber_names_and_types_by_node(
+      rmw_node, allocator, node_entity->node_name, node_entity->node_namespace, false,
+      &names_and_types);
+  } else {
+    rmw_ret = rmw_get_service_names_and_types_by_node(
+      rmw_node, allocator, node_entity->node_name, node_entity->node_namespace,
+      &names_and_types);
+  }
+  if (RMW_RET_OK != rmw_ret) {
+    // The node may have left since the node names were queried, its departure
+    // changes the graph again, so its endpoints are compared on the next rebuild.
+    rmw_reset_error();
+    return RCL_RET_OK;
+  }
+  rcl_ret_t ret = RCL_RET_OK;
+  size_t i;
+  for (i = 0; RCL_RET_OK == ret && i < names_and_types.names.size; ++i) {
+    size_t j;
+    for (j = 0; RCL_RET_OK == ret && j < names_and_types.types[i].size; ++j) {
+      rcl_graph_entity_t endpoint = *node_entity;
+      endpoint.kind = kind;
+      endpoint.name = names_and_types.names.data[i];
+      endpoint.type = names_and_types.types[i].data[j];
+      ret = _rcl_graph_entity_array_append(entities, &endpoint, allocator);
+    }
+  }
+  if (RMW_RET_OK != rmw_names_and_types_fini(&names_and_types)) {
+    rmw_reset_error();
+  }
+  return ret;
+}
+
+/// Append a change to the log, taking ownership of the entity's strings.
+static void
+_rcl_graph_cache_log_change(rcl_graph_cache_t * cache, bool added, rcl_graph_entity_t * entity)
+{
+  rcl_graph_change_t * change =
+    &cache->change_log[cache->next_cursor % RCL_GRAPH_CHANGE_LOG_CAPACITY];
+  // Evict the change which was logged RCL_GRAPH_CHANGE_LOG_CAPACITY changes ago.
+  rcl_graph_entity_fini(&change->entity, &cache->allocator);
+  change->added = added;
+  change->entity = *entity;
+  memset(entity, 0, sizeof(rcl_graph_entity_t));
+  ++cache->next_cursor;
+  if (cache->next_cursor - cache->oldest_cursor > RCL_GRAPH_CHANGE_LOG_CAPACITY) {
+    cache->oldest_cursor = cache->next_cursor - RCL_GRAPH_CHANGE_LOG_CAPACITY;
+  }
+}
+
+/// Collect the entities of the rebuilt snapshot and log how they differ from the previous ones.
+static rcl_ret_t
+_rcl_graph_cache_update_entities(rcl_graph_cache_t * cache, const rcl_node_t * node)
+{
+  rcl_allocator_t * allocator = &cache->allocator;
+  if (NULL == cache->change_log) {
+    cache->change_log = (rcl_graph_change_t *)allocator->zero_allocate(
+      RCL_GRAPH_CHANGE_LOG_CAPACITY, sizeof(rcl_graph_change_t), allocator->state);
+    RCL_CHECK_FOR_NULL_WITH_MSG(
+      cache->change_log, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  }
+  const rmw_node_t * rmw_node = rcl_node_get_rmw_handle(node);
+  rcl_graph_entity_array_t entities = {NULL, 0, 0};
+  rcl_ret_t ret = RCL_RET_OK;
+  size_t i;
+  for (i = 0; RCL_RET_OK == ret && i < cache->node_names.size; ++i) {
+    rcl_graph_entity_t node_entity;
+    memset(&node_entity, 0, sizeof(node_entity));
+    node_entity.kind = RCL_GRAPH_ENTITY_NODE;
+    node_entity.node_name = cache->node_names.data[i];
+    node_entity.node_namespace = cache->node_namespaces.data[i];
+    if (NULL == node_entity.node_namespace || '\0' == node_entity.node_namespace[0]) {
+      node_entity.node_namespace = "/";
+    }
+    ret = _rcl_graph_entity_array_append(&entities, &node_entity, allocator);
+    rcl_graph_entity_kind_t kind;
+    for (kind = RCL_GRAPH_ENTITY_PUBLISHER;
+      RCL_RET_OK == ret && kind <= RCL_GRAPH_ENTITY_SERVICE;
+      kind = (rcl_graph_entity_kind_t)(kind + 1))
+    {
+      ret = _rcl_graph_cache_collect_endpoints(cache, rmw_node, &node_entity, kind, &entities);
+    }
+  }
+  if (RCL_RET_OK != ret) {
+    _rcl_graph_cache_free_entities(cache, entities.data, entities.size);
+    return ret;
+  }
+  if (entities.size > 1) {
+    qsort(entities.data, entities.size, sizeof(rcl_graph_entity_t), _rcl_graph_entity_compare);
+  }
+
+  if (cache->has_entities) {
+    // Merge the sorted entity lists, logging those only in one of them.
+    size_t previous = 0;
+    size_t current = 0;
+    while (previous < cache->entity_count || current < entities.size) {
+      int order = previous == cache->entity_count ? 1 :
+        current == entities.size ? -1 :
+        _rcl_graph_entity_compare(&cache->entities[previous], &entities.data[current]);
+      if (0 == order) {
+        ++previous;
+        ++current;
+      } else if (order < 0) {
+        _rcl_graph_cache_log_change(cache, false, &cache->entities[previous++]);
+      } else {
+        rcl_graph_entity_t added;
+        if (RCL_RET_OK != rcl_graph_entity_copy(&entities.data[current++], allocator, &added)) {
+          // Cursors from before this rebuild would miss changes, make them resynchronize.
+          rcl_reset_error();
+          cache->oldest_cursor = cache->next_cursor;
+          break;
+        }
+        _rcl_graph_cache_log_change(cache, true, &added);
+      }
+    }
+  }
+  _rcl_graph_cache_free_entities(cache, cache->entities, cache->entity_count);
+  cache->entities = entities.data;
+  cache->entity_count = entities.size;
+  cache->has_entities = true;
+  return RCL_RET_OK;
+}
+
+/// Rebuild the snapshot if it is outdated, the cache must be locked.
+static rcl_ret_t
+_rcl_graph_cache_refresh(rcl_graph_cache_t * cache, const rcl_node_t * node)
+{
+  rcutils_time_point_value_t now;
+  if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+    RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
+    rcutils_reset_error();
+    return RCL_RET_ERROR;
+  }
+  // Read the generation before querying the middleware, so a change during the
+  // rebuild leaves the new snapshot outdated rather than being missed.
+  uint64_t generation = rcutils_atomic_load_uint64_t(&cache->generation);
+  bool track_changes = rcutils_atomic_load_bool(&cache->track_changes);
+  if (rcl_graph_cache_is_enabled(cache) && cache->is_built &&
+    cache->built_generation == generation &&
+    now >= cache->built_time && now - cache->built_time <= cache->max_age &&
+    (!track_changes || cache->has_entities))
+  {
+    return RCL_RET_OK;
+  }
+  _rcl_graph_cache_clear(cache);
+  rcl_ret_t ret = _rcl_graph_cache_rebuild(cache, node);
+  if (RCL_RET_OK == ret && track_changes) {
+    ret = _rcl_graph_cache_update_entities(cache, node);
+  }
+  if (RCL_RET_OK != ret) {
+    _rcl_graph_cache_clear(cache);
+    return ret;
+  }
+  cache->built_generation = generation;
+  cache->built_time = now;
+  cache->is_built = true;
+  return RCL_RET_OK;
+}
+
+bool
+rcl_graph_cache_acquire(rcl_graph_cache_t * cache, const rcl_node_t * node)
+{
+  if (rcutils_atomic_exchange_bool(&cache->lock, true)) {
+    // Busy, most likely rebuilding, the caller is better off asking the middleware.
+    return false;
+  }
+  if (RCL_RET_OK != _rcl_graph_cache_refresh(cache, node)) {
+    // The direct query of the caller will report the error, if it persists.
+    rcl_reset_error();
+    rmw_reset_error();
+    rcl_graph_cache_release(cache);
+    return false;
+  }
+  return true;
+}
+
+rcl_ret_t
+rcl_graph_cache_acquire_changes(rcl_graph_cache_t * cache, const rcl_node_t * node)
+{
+  rcutils_atomic_store(&cache->track_changes, true);
+  while (rcutils_atomic_exchange_bool(&cache->lock, true)) {
+    // Spin, there is no other source of the changes than the cache.
+  }
+  rcl_ret_t ret = _rcl_graph_cache_refresh(cache, node);
+  if (RCL_RET_OK != ret) {
+    rcl_graph_cache_release(cache);
+  }
+  return ret;
+}
+
+void
+rcl_graph_cache_release(rcl_graph_cache_t * cache)
+{
+  rcutils_atomic_store(&cache->lock, false);
+}
+
+static rcl_ret_t
+_rcl_graph_cache_copy_strings(
+  const rcutils_string_array_t * source,
+  rcl_allocator_t * allocator,
+  rcutils_string_array_t * destination)
+{
+  size_t i;
+  for (i = 0; i < source->size; ++i) {
+    destination->data[i] = rcutils_strdup(source->data[i], *allocator);
+    if (NULL == destination->data[i]) {
+      RCL_SET_ERROR_MSG("allocating memory failed");
+      return RCL_RET_BAD_ALLOC;
+    }
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_graph_cache_copy_names_and_types(
+  const rcl_names_and_types_t * source,
+  rcl_allocator_t * allocator,
+  rcl_names_and_types_t * destination)
+{
+  if (0 == source->names.size) {
+    // Like the middleware, leave the output zero initialized for an empty graph.
+    return RCL_RET_OK;
+  }
+  rmw_ret_t rmw_ret = rmw_names_and_types_init(destination, source->names.size, allocator);
+  if (RMW_RET_OK != rmw_ret) {
+    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+    rmw_reset_error();
+    return rcl_convert_rmw_ret_to_rcl_ret(rmw_ret);
+  }
+  rcl_ret_t ret = _rcl_graph_cache_copy_strings(&source->names, allocator, &destination->names);
+  size_t i;
+  for (i = 0; RCL_RET_OK == ret && i < source->names.size; ++i) {
+    if (RCUTILS_RET_OK !=
+      rcutils_string_array_init(&destination->types[i], source->types[i].size, allocator))
+    {
+      RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
+      rcutils_reset_error();
+      ret = RCL_RET_BAD_ALLOC;
+      break;
+    }
+    ret = _rcl_graph_cache_copy_strings(&source->types[i], allocator, &destination->types[i]);
+  }
+  if (RCL_RET_OK != ret && RMW_RET_OK != rmw_names_and_types_fini(destination)) {
+    rmw_reset_error();
+  }
+  return ret;
+}
+
+rcl_ret_t
+rcl_graph_cache_copy_string_array(
+  const rcutils_string_array_t * source,
+  rcl_allocator_t allocator,
+  rcutils_string_array_t * destination)
+{
+  if (0 == source->size) {
+    return RCL_RET_OK;
+  }
+  if (RCUTILS_RET_OK != rcutils_string_array_init(destination, source->size, &allocator)) {
+    RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
+    rcutils_reset_error();
+    return RCL_RET_BAD_ALLOC;
+  }
+  rcl_ret_t ret = _rcl_graph_cache_copy_strings(source, &allocator, destination);
+  if (RCL_RET_OK != ret && RCUTILS_RET_OK != rcutils_string_array_fini(destination)) {
+    rcutils_reset_error();
+  }
+  return ret;
+}
+
+#ifdef __cplusplus
+}
+#endif
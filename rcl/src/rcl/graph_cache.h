@@ -0,0 +1,212 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__GRAPH_CACHE_H_
+#define RCL__GRAPH_CACHE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcl/allocator.h"
+#include "rcl/graph.h"
+#include "rcl/node.h"
+#include "rcl/types.h"
+#include "rcl/visibility_control.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/time.h"
+#include "rcutils/types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// Open addressing index from names to their position in a names array.
+typedef struct rcl_graph_cache_index_t
+{
+  /// Position of the name plus one, 0 for an empty slot.
+  size_t * slots;
+  /// Number of slots minus one, the number of slots is a power of two.
+  size_t slot_mask;
+} rcl_graph_cache_index_t;
+
+/// Snapshot of the ROS graph shared by all nodes of a context.
+/**
+ * The snapshot is rebuilt from the middleware on first use after it was
+ * invalidated, see rcl_graph_cache_invalidate(), or after it got older than
+ * the maximum age set in the init options.
+ * Topic and service names are indexed by hash, so counting the publishers of
+ * a topic is a lookup without allocation.
+ *
+ * The snapshot is guarded by a spin lock which is only ever tried: a caller
+ * which finds it taken, e.g. while another thread rebuilds the snapshot,
+ * queries the middleware directly instead of waiting.
+ */
+typedef struct rcl_graph_cache_t
+{
+  /// Incremented whenever the graph changed, see rcl_graph_cache_invalidate().
+  atomic_uint_least64_t generation;
+  atomic_bool lock;
+  /// Maximum age of the snapshot in nanoseconds, the cache is disabled if not positive.
+  int64_t max_age;
+  bool is_built;
+  /// Generation the snapshot was built for.
+  uint64_t built_generation;
+  /// Steady time the snapshot was built at.
+  rcutils_time_point_value_t built_time;
+  rcl_allocator_t allocator;
+  rcl_names_and_types_t topic_names_and_types;
+  rcl_graph_cache_index_t topic_index;
+  /// Number of publishers and subscribers of each topic, in topic order.
+  size_t * publisher_counts;
+  size_t * subscriber_counts;
+  rcl_names_and_types_t service_names_and_types;
+  rcl_graph_cache_index_t service_index;
+  /// Whether a server is available for each service, -1 until the middleware was asked.
+  int8_t * service_availability;
+  rcutils_string_array_t node_names;
+  rcutils_string_array_t node_namespaces;
+  /// Set by the first rcl_get_graph_changes(), makes rebuilds compare the entities.
+  atomic_bool track_changes;
+  /// Nodes and endpoints of the snapshot, sorted, only kept while changes are tracked.
+  rcl_graph_entity_t * entities;
+  size_t entity_count;
+  bool has_entities;
+  /// Ring buffer of the last RCL_GRAPH_CHANGE_LOG_CAPACITY changes, change n at n % capacity.
+  rcl_graph_change_t * change_log;
+  /// Cursor after the newest change, i.e. the number of changes logged plus one.
+  rcl_graph_cursor_t next_cursor;
+  /// Oldest cursor whose changes are all still in the log.
+  rcl_graph_cursor_t oldest_cursor;
+} rcl_graph_cache_t;
+
+/// Initialize a graph cache with no snapshot yet.
+/**
+ * \param[in] max_age maximum age of the snapshot in nanoseconds, or 0 to
+ *   disable the cache
+ */
+RCL_LOCAL
+void
+rcl_graph_cache_init(rcl_graph_cache_t * cache, int64_t max_age, rcl_allocator_t allocator);
+
+/// Free the snapshot.
+RCL_LOCAL
+void
+rcl_graph_cache_fini(rcl_graph_cache_t * cache);
+
+/// Return true if the cache was initialized with a positive maximum age.
+RCL_LOCAL
+bool
+rcl_graph_cache_is_enabled(const rcl_graph_cache_t * cache);
+
+/// Mark the snapshot as outdated, it is rebuilt on its next use.
+/**
+ * This function is lock-free and may be called from any thread.
+ */
+RCL_LOCAL
+void
+rcl_graph_cache_invalidate(rcl_graph_cache_t * cache);
+
+/// Return the graph cache of the node's context, or `NULL` if it is disabled.
+RCL_LOCAL
+rcl_graph_cache_t *
+rcl_graph_cache_get_for_node(const rcl_node_t * node);
+
+/// Invalidate the graph cache of the node's context, if it has one.
+/**
+ * Called when entities of the node are created or destroyed, so the change
+ * is seen without waiting for the middleware's graph guard condition.
+ */
+RCL_LOCAL
+void
+rcl_graph_cache_invalidate_for_node(const rcl_node_t * node);
+
+/// Lock the cache and make sure its snapshot is up to date.
+/**
+ * On success, the snapshot may be read until rcl_graph_cache_release() is
+ * called.
+ *
+ * \return `true` if the cache is locked and holds a current snapshot, or
+ *   `false` if the cache is busy or rebuilding it failed, in which case the
+ *   caller should query the middleware directly.
+ */
+RCL_LOCAL
+bool
+rcl_graph_cache_acquire(rcl_graph_cache_t * cache, const rcl_node_t * node);
+
+/// Lock the cache, waiting for it if needed, and update its snapshot and entities.
+/**
+ * Unlike rcl_graph_cache_acquire(), this also works with the cache disabled,
+ * in which case the snapshot is rebuilt on every call.
+ * The first call enables tracking the changes of the graph.
+ *
+ * \return `RCL_RET_OK` if the cache is locked and up to date, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if querying the middleware failed.
+ */
+RCL_LOCAL
+rcl_ret_t
+rcl_graph_cache_acquire_changes(rcl_graph_cache_t * cache, const rcl_node_t * node);
+
+/// Copy an entity, allocating its strings.
+RCL_LOCAL
+rcl_ret_t
+rcl_graph_entity_copy(
+  const rcl_graph_entity_t * source,
+  rcl_allocator_t * allocator,
+  rcl_graph_entity_t * destination);
+
+/// Free the strings of an entity, safe to call on a zero initialized entity.
+RCL_LOCAL
+void
+rcl_graph_entity_fini(rcl_graph_entity_t * entity, rcl_allocator_t * allocator);
+
+/// Unlock a cache locked by rcl_graph_cache_acquire().
+RCL_LOCAL
+void
+rcl_graph_cache_release(rcl_graph_cache_t * cache);
+
+/// Find a name in an index of the given names.
+/**
+ * \return the position of the name, or SIZE_MAX if it is not in the index.
+ */
+RCL_LOCAL
+size_t
+rcl_graph_cache_index_find(
+  const rcl_graph_cache_index_t * index,
+  const rcutils_string_array_t * names,
+  const char * name);
+
+/// Copy names and types from the snapshot into a zero initialized output.
+RCL_LOCAL
+rcl_ret_t
+rcl_graph_cache_copy_names_and_types(
+  const rcl_names_and_types_t * source,
+  rcl_allocator_t * allocator,
+  rcl_names_and_types_t * destination);
+
+/// Copy a string array from the snapshot into a zero initialized output.
+RCL_LOCAL
+rcl_ret_t
+rcl_graph_cache_copy_string_array(
+  const rcutils_string_array_t * source,
+  rcl_allocator_t allocator,
+  rcutils_string_array_t * destination);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__GRAPH_CACHE_H_
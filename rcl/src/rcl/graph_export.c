@@ -0,0 +1,517 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "rcl/graph_export.h"
+
+#include <string.h>
+
+#include "rcl/error_handling.h"
+
+#include "./context_impl.h"
+#include "./graph_cache.h"
+
+#define RCL_GRAPH_EXPORT_HEADER_SIZE 40
+#define RCL_GRAPH_EXPORT_ROW_SIZE 16
+
+// Position of each header field, in 32 bit integers.
+enum
+{
+  RCL_GRAPH_EXPORT_MAGIC = 0,
+  RCL_GRAPH_EXPORT_VERSION_FIELD,
+  RCL_GRAPH_EXPORT_TOTAL_SIZE,
+  RCL_GRAPH_EXPORT_STRING_COUNT,
+  RCL_GRAPH_EXPORT_NODE_COUNT,
+  RCL_GRAPH_EXPORT_ENDPOINT_COUNT,
+  RCL_GRAPH_EXPORT_STRING_TABLE,
+  RCL_GRAPH_EXPORT_NODE_TABLE,
+  RCL_GRAPH_EXPORT_ENDPOINT_TABLE,
+  RCL_GRAPH_EXPORT_STRING_DATA
+};
+
+static const uint8_t _rcl_graph_export_magic[4] = {'R', 'C', 'L', 'G'};
+
+static void
+_rcl_graph_export_write_u32(uint8_t * destination, uint32_t value)
+{
+  destination[0] = (uint8_t)value;
+  destination[1] = (uint8_t)(value >> 8);
+  destination[2] = (uint8_t)(value >> 16);
+  destination[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t
+_rcl_graph_export_read_u32(const uint8_t * source)
+{
+  return (uint32_t)source[0] | ((uint32_t)source[1] << 8) |
+         ((uint32_t)source[2] << 16) | ((uint32_t)source[3] << 24);
+}
+
+/// Strings of the export, deduplicated with an open addressing hash table.
+typedef struct rcl_graph_export_strings_t
+{
+  const char ** strings;
+  size_t count;
+  /// Index of the string plus one, 0 for an empty slot.
+  uint32_t * slots;
+  size_t slot_mask;
+  /// Size of the string data, including the terminating null characters.
+  size_t data_size;
+} rcl_graph_export_strings_t;
+
+static uint32_t
+_rcl_graph_export_intern(rcl_graph_export_strings_t * strings, const char * string)
+{
+  if (NULL == string) {
+    string = "";
+  }
+  // 64 bit FNV-1a, like the graph cache's index.
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  const char * c;
+  for (c = string; '\0' != *c; ++c) {
+    hash ^= (uint8_t)*c;
+    hash *= 0x100000001b3ULL;
+  }
+  size_t slot = (size_t)hash & strings->slot_mask;
+  while (0 != strings->slots[slot]) {
+    uint32_t index = strings->slots[slot] - 1;
+    if (0 == strcmp(strings->strings[index], string)) {
+      return index;
+    }
+    slot = (slot + 1) & strings->slot_mask;
+  }
+  // The table is sized for every string of the graph, so there is room.
+  uint32_t index = (uint32_t)strings->count++;
+  strings->strings[index] = string;
+  strings->slots[slot] = index + 1;
+  strings->data_size += (size_t)(c - string) + 1;
+  return index;
+}
+
+/// Compare nodes by namespace, then name, like the graph cache sorts them.
+static int
+_rcl_graph_export_compare_node(const rcl_graph_entity_t * node, const rcl_graph_entity_t * entity)
+{
+  int order = strcmp(
+    node->node_namespace ? node->node_namespace : "",
+    entity->node_namespace ? entity->node_namespace : "");
+  if (0 != order) {
+    return order;
+  }
+  return strcmp(node->node_name ? node->node_name : "", entity->node_name ? entity->node_name : "");
+}
+
+/// Find the node of an endpoint among the sorted nodes, SIZE_MAX if it is not there.
+static size_t
+_rcl_graph_export_find_node(
+  const rcl_graph_entity_t * nodes,
+  size_t node_count,
+  const rcl_graph_entity_t * endpoint)
+{
+  size_t low = 0;
+  size_t high = node_count;
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+    if (_rcl_graph_export_compare_node(&nodes[middle], endpoint) < 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  if (low < node_count && 0 == _rcl_graph_export_compare_node(&nodes[low], endpoint)) {
+    return low;
+  }
+  return SIZE_MAX;
+}
+
+rcl_graph_export_t
+rcl_get_zero_initialized_graph_export()
+{
+  static rcl_graph_export_t null_graph_export = {0};
+  return null_graph_export;
+}
+
+/// Write the entities of the graph cache, which must be acquired, into the export's buffer.
+static rcl_ret_t
+_rcl_graph_export_write(
+  const rcl_graph_cache_t * cache,
+  rcl_allocator_t * allocator,
+  rcl_graph_export_t * graph_export)
+{
+  const rcl_graph_entity_t * entities = cache->entities;
+  size_t entity_count = cache->entity_count;
+  // The entities are sorted by kind, so the nodes come first.
+  size_t node_count = 0;
+  while (node_count < entity_count && RCL_GRAPH_ENTITY_NODE == entities[node_count].kind) {
+    ++node_count;
+  }
+  if (entity_count > UINT32_MAX / 2) {
+    RCL_SET_ERROR_MSG("graph too large to export");
+    return RCL_RET_ERROR;
+  }
+
+  rcl_graph_export_strings_t strings;
+  memset(&strings, 0, sizeof(strings));
+  size_t slot_count = 16;
+  while (slot_count < 4 * entity_count) {
+    slot_count *= 2;
+  }
+  strings.slot_mask = slot_count - 1;
+  strings.strings = (const char **)allocator->allocate(
+    sizeof(const char *) * 2 * (entity_count + 1), allocator->state);
+  strings.slots = (uint32_t *)allocator->zero_allocate(
+    slot_count, sizeof(uint32_t), allocator->state);
+  // Per entity: the indices of its two strings, then the index of its node.
+  uint32_t * entity_fields = (uint32_t *)allocator->allocate(
+    sizeof(uint32_t) * 3 * (entity_count + 1), allocator->state);
+  // Per node: the index of its first endpoint, and the next free position while writing.
+  uint32_t * node_endpoints = (uint32_t *)allocator->zero_allocate(
+    2 * (node_count + 1), sizeof(uint32_t), allocator->state);
+  rcl_ret_t ret = RCL_RET_OK;
+  if (NULL == strings.strings || NULL == strings.slots || NULL == entity_fields ||
+    NULL == node_endpoints)
+  {
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    ret = RCL_RET_BAD_ALLOC;
+    goto cleanup;
+  }
+
+  size_t endpoint_count = 0;
+  size_t i;
+  for (i = 0; i < entity_count; ++i) {
+    const rcl_graph_entity_t * entity = &entities[i];
+    uint32_t * fields = &entity_fields[3 * i];
+    if (i < node_count) {
+      fields[0] = _rcl_graph_export_intern(&strings, entity->node_name);
+      fields[1] = _rcl_graph_export_intern(&strings, entity->node_namespace);
+      continue;
+    }
+    size_t node_index = _rcl_graph_export_find_node(entities, node_count, entity);
+    if (SIZE_MAX == node_index) {
+      // Endpoints are collected per node, so this cannot happen, skip it anyway.
+      fields[2] = UINT32_MAX;
+      continue;
+    }
+    fields[0] = _rcl_graph_export_intern(&strings, entity->name);
+    fields[1] = _rcl_graph_export_intern(&strings, entity->type);
+    fields[2] = (uint32_t)node_index;
+    ++node_endpoints[2 * node_index + 1];
+    ++endpoint_count;
+  }
+  // Turn the number of endpoints per node into the index of its first endpoint.
+  uint32_t first_endpoint = 0;
+  for (i = 0; i < node_count; ++i) {
+    uint32_t count = node_endpoints[2 * i + 1];
+    node_endpoints[2 * i] = first_endpoint;
+    node_endpoints[2 * i + 1] = first_endpoint;
+    first_endpoint += count;
+  }
+
+  size_t string_table = RCL_GRAPH_EXPORT_HEADER_SIZE;
+  size_t node_table = string_table + sizeof(uint32_t) * strings.count;
+  size_t endpoint_table = node_table + RCL_GRAPH_EXPORT_ROW_SIZE * node_count;
+  size_t string_data = endpoint_table + RCL_GRAPH_EXPORT_ROW_SIZE * endpoint_count;
+  size_t total_size = string_data + strings.data_size;
+  if (total_size > UINT32_MAX || total_size < string_data) {
+    RCL_SET_ERROR_MSG("graph too large to export");
+    ret = RCL_RET_ERROR;
+    goto cleanup;
+  }
+  uint8_t * buffer = (uint8_t *)allocator->allocate(total_size, allocator->state);
+  if (NULL == buffer) {
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    ret = RCL_RET_BAD_ALLOC;
+    goto cleanup;
+  }
+
+  const uint32_t header[] = {
+    0, RCL_GRAPH_EXPORT_VERSION, (uint32_t)total_size, (uint32_t)strings.count,
+    (uint32_t)node_count, (uint32_t)endpoint_count, (uint32_t)string_table,
+    (uint32_t)node_table, (uint32_t)endpoint_table, (uint32_t)string_data
+  };
+  for (i = 0; i < sizeof(header) / sizeof(header[0]); ++i) {
+    _rcl_graph_export_write_u32(&buffer[sizeof(uint32_t) * i], header[i]);
+  }
+  memcpy(buffer, _rcl_graph_export_magic, sizeof(_rcl_graph_export_magic));
+  size_t string_offset = 0;
+  for (i = 0; i < strings.count; ++i) {
+    _rcl_graph_export_write_u32(
+      &buffer[string_table + sizeof(uint32_t) * i], (uint32_t)string_offset);
+    size_t length = strlen(strings.strings[i]) + 1;
+    memcpy(&buffer[string_data + string_offset], strings.strings[i], length);
+    string_offset += length;
+  }
+  for (i = 0; i < entity_count; ++i) {
+    const uint32_t * fields = &entity_fields[3 * i];
+    uint32_t row[4];
+    uint8_t * destination;
+    if (i < node_count) {
+      uint32_t node_first_endpoint = node_endpoints[2 * i];
+      uint32_t node_endpoint_count =
+        (i + 1 < node_count ? node_endpoints[2 * i + 2] : first_endpoint) - node_first_endpoint;
+      row[0] = fields[0];
+      row[1] = fields[1];
+      row[2] = node_first_endpoint;
+      row[3] = node_endpoint_count;
+      destination = &buffer[node_table + RCL_GRAPH_EXPORT_ROW_SIZE * i];
+    } else if (UINT32_MAX != fields[2]) {
+      // Endpoints are visited in sorted order, so those of a node stay ordered by kind.
+      uint32_t position = node_endpoints[2 * fields[2] + 1]++;
+      row[0] = (uint32_t)entities[i].kind;
+      row[1] = fields[0];
+      row[2] = fields[1];
+      row[3] = fields[2];
+      destination = &buffer[endpoint_table + RCL_GRAPH_EXPORT_ROW_SIZE * position];
+    } else {
+      continue;
+    }
+    size_t j;
+    for (j = 0; j < 4; ++j) {
+      _rcl_graph_export_write_u32(&destination[sizeof(uint32_t) * j], row[j]);
+    }
+  }
+  graph_export->buffer = buffer;
+  graph_export->size = total_size;
+  graph_export->allocator = *allocator;
+
+cleanup:
+  allocator->deallocate((void *)strings.strings, allocator->state);
+  allocator->deallocate(strings.slots, allocator->state);
+  allocator->deallocate(entity_fields, allocator->state);
+  allocator->deallocate(node_endpoints, allocator->state);
+  return ret;
+}
+
+rcl_ret_t
+rcl_graph_export(
+  const rcl_node_t * node,
+  rcl_allocator_t * allocator,
+  rcl_graph_export_t * graph_export)
+{
+  if (!rcl_node_is_valid(node)) {
+    return RCL_RET_NODE_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(allocator, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ALLOCATOR_WITH_MSG(allocator, "invalid allocator", return RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(graph_export, RCL_RET_INVALID_ARGUMENT);
+  if (NULL != graph_export->buffer) {
+    RCL_SET_ERROR_MSG("graph_export is not zero initialized");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  rcl_graph_cache_t * cache = &node->context->impl->graph_cache;
+  rcl_ret_t ret = rcl_graph_cache_acquire_changes(cache, node);
+  if (RCL_RET_OK != ret) {
+    return ret;  // error already set
+  }
+  ret = _rcl_graph_export_write(cache, allocator, graph_export);
+  rcl_graph_cache_release(cache);
+  return ret;
+}
+
+rcl_ret_t
+rcl_graph_export_fini(rcl_graph_export_t * graph_export)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(graph_export, RCL_RET_INVALID_ARGUMENT);
+  if (NULL != graph_export->buffer) {
+    graph_export->allocator.deallocate(graph_export->buffer, graph_export->allocator.state);
+  }
+  *graph_export = rcl_get_zero_initialized_graph_export();
+  return RCL_RET_OK;
+}
+
+/// Return true if a table of `count` rows of `row_size` bytes at `offset` fits into `size` bytes.
+static bool
+_rcl_graph_reader_table_fits(size_t offset, size_t count, size_t row_size, size_t size)
+{
+  return offset >= RCL_GRAPH_EXPORT_HEADER_SIZE && offset <= size &&
+         count <= (size - offset) / row_size;
+}
+
+static uint32_t
+_rcl_graph_reader_row_field(const rcl_graph_reader_t * reader, size_t table, size_t row, int field)
+{
+  return _rcl_graph_export_read_u32(
+    &reader->buffer[table + RCL_GRAPH_EXPORT_ROW_SIZE * row + sizeof(uint32_t) * field]);
+}
+
+static const char *
+_rcl_graph_reader_string(const rcl_graph_reader_t * reader, uint32_t index)
+{
+  size_t offset = _rcl_graph_export_read_u32(
+    &reader->buffer[reader->string_table_offset + sizeof(uint32_t) * index]);
+  return (const char *)&reader->buffer[reader->string_data_offset + offset];
+}
+
+rcl_ret_t
+rcl_graph_reader_init(rcl_graph_reader_t * reader, const void * buffer, size_t size)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(reader, RCL_RET_INVALID_ARGUMENT);
+  memset(reader, 0, sizeof(rcl_graph_reader_t));
+  RCL_CHECK_ARGUMENT_FOR_NULL(buffer, RCL_RET_INVALID_ARGUMENT);
+  const uint8_t * bytes = (const uint8_t *)buffer;
+  if (size < RCL_GRAPH_EXPORT_HEADER_SIZE ||
+    0 != memcmp(bytes, _rcl_graph_export_magic, sizeof(_rcl_graph_export_magic)))
+  {
+    RCL_SET_ERROR_MSG("buffer is not a graph export");
+    return RCL_RET_ERROR;
+  }
+  uint32_t header[RCL_GRAPH_EXPORT_HEADER_SIZE / sizeof(uint32_t)];
+  size_t i;
+  for (i = 0; i < sizeof(header) / sizeof(header[0]); ++i) {
+    header[i] = _rcl_graph_export_read_u32(&bytes[sizeof(uint32_t) * i]);
+  }
+  if (RCL_GRAPH_EXPORT_VERSION != header[RCL_GRAPH_EXPORT_VERSION_FIELD]) {
+    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "unsupported graph export version %u", (unsigned)header[RCL_GRAPH_EXPORT_VERSION_FIELD]);
+    return RCL_RET_ERROR;
+  }
+  // Any data after the export, e.g. padding added for transport, is ignored.
+  size_t total_size = header[RCL_GRAPH_EXPORT_TOTAL_SIZE];
+  size_t string_count = header[RCL_GRAPH_EXPORT_STRING_COUNT];
+  size_t node_count = header[RCL_GRAPH_EXPORT_NODE_COUNT];
+  size_t endpoint_count = header[RCL_GRAPH_EXPORT_ENDPOINT_COUNT];
+  size_t string_table = header[RCL_GRAPH_EXPORT_STRING_TABLE];
+  size_t node_table = header[RCL_GRAPH_EXPORT_NODE_TABLE];
+  size_t endpoint_table = header[RCL_GRAPH_EXPORT_ENDPOINT_TABLE];
+  size_t string_data = header[RCL_GRAPH_EXPORT_STRING_DATA];
+  // The string data is last and ends with a null character, so every string
+  // starting within it is terminated.
+  if (total_size > size ||
+    !_rcl_graph_reader_table_fits(string_table, string_count, sizeof(uint32_t), total_size) ||
+    !_rcl_graph_reader_table_fits(node_table, node_count, RCL_GRAPH_EXPORT_ROW_SIZE, total_size) ||
+    !_rcl_graph_reader_table_fits(
+      endpoint_table, endpoint_count, RCL_GRAPH_EXPORT_ROW_SIZE, total_size) ||
+    string_data < RCL_GRAPH_EXPORT_HEADER_SIZE || string_data > total_size ||
+    (string_count > 0 && (string_data == total_size || '\0' != bytes[total_size - 1])))
+  {
+    RCL_SET_ERROR_MSG("graph export is truncated or corrupted");
+    return RCL_RET_ERROR;
+  }
+  rcl_graph_reader_t validated;
+  memset(&validated, 0, sizeof(validated));
+  validated.buffer = bytes;
+  validated.size = total_size;
+  validated.string_count = string_count;
+  validated.node_count = node_count;
+  validated.endpoint_count = endpoint_count;
+  validated.string_table_offset = string_table;
+  validated.node_table_offset = node_table;
+  validated.endpoint_table_offset = endpoint_table;
+  validated.string_data_offset = string_data;
+  for (i = 0; i < string_count; ++i) {
+    size_t offset = _rcl_graph_export_read_u32(&bytes[string_table + sizeof(uint32_t) * i]);
+    if (offset >= total_size - string_data) {
+      RCL_SET_ERROR_MSG("graph export has a string out of bounds");
+      return RCL_RET_ERROR;
+    }
+  }
+  for (i = 0; i < node_count; ++i) {
+    size_t first = _rcl_graph_reader_row_field(&validated, node_table, i, 2);
+    size_t count = _rcl_graph_reader_row_field(&validated, node_table, i, 3);
+    if (_rcl_graph_reader_row_field(&validated, node_table, i, 0) >= string_count ||
+      _rcl_graph_reader_row_field(&validated, node_table, i, 1) >= string_count ||
+      first > endpoint_count || count > endpoint_count - first)
+    {
+      RCL_SET_ERROR_MSG("graph export has a node out of bounds");
+      return RCL_RET_ERROR;
+    }
+  }
+  for (i = 0; i < endpoint_count; ++i) {
+    uint32_t kind = _rcl_graph_reader_row_field(&validated, endpoint_table, i, 0);
+    size_t node_index = _rcl_graph_reader_row_field(&validated, endpoint_table, i, 3);
+    if (kind < RCL_GRAPH_ENTITY_PUBLISHER || kind > RCL_GRAPH_ENTITY_SERVICE ||
+      _rcl_graph_reader_row_field(&validated, endpoint_table, i, 1) >= string_count ||
+      _rcl_graph_reader_row_field(&validated, endpoint_table, i, 2) >= string_count ||
+      node_index >= node_count)
+    {
+      RCL_SET_ERROR_MSG("graph export has an endpoint out of bounds");
+      return RCL_RET_ERROR;
+    }
+    // The endpoint must be within the endpoints of its node.
+    size_t first = _rcl_graph_reader_row_field(&validated, node_table, node_index, 2);
+    size_t count = _rcl_graph_reader_row_field(&validated, node_table, node_index, 3);
+    if (i < first || i - first >= count) {
+      RCL_SET_ERROR_MSG("graph export has an endpoint outside of its node");
+      return RCL_RET_ERROR;
+    }
+  }
+  *reader = validated;
+  return RCL_RET_OK;
+}
+
+size_t
+rcl_graph_reader_get_node_count(const rcl_graph_reader_t * reader)
+{
+  return NULL != reader && NULL != reader->buffer ? reader->node_count : 0;
+}
+
+rcl_ret_t
+rcl_graph_reader_get_node(
+  const rcl_graph_reader_t * reader,
+  size_t index,
+  rcl_graph_export_node_t * node)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(reader, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(reader->buffer, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(node, RCL_RET_INVALID_ARGUMENT);
+  if (index >= reader->node_count) {
+    RCL_SET_ERROR_MSG("node index out of range");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  size_t table = reader->node_table_offset;
+  node->name =
+    _rcl_graph_reader_string(reader, _rcl_graph_reader_row_field(reader, table, index, 0));
+  node->namespace_ =
+    _rcl_graph_reader_string(reader, _rcl_graph_reader_row_field(reader, table, index, 1));
+  node->first_endpoint = _rcl_graph_reader_row_field(reader, table, index, 2);
+  node->endpoint_count = _rcl_graph_reader_row_field(reader, table, index, 3);
+  return RCL_RET_OK;
+}
+
+size_t
+rcl_graph_reader_get_endpoint_count(const rcl_graph_reader_t * reader)
+{
+  return NULL != reader && NULL != reader->buffer ? reader->endpoint_count : 0;
+}
+
+rcl_ret_t
+rcl_graph_reader_get_endpoint(
+  const rcl_graph_reader_t * reader,
+  size_t index,
+  rcl_graph_export_endpoint_t * endpoint)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(reader, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(reader->buffer, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(endpoint, RCL_RET_INVALID_ARGUMENT);
+  if (index >= reader->endpoint_count) {
+    RCL_SET_ERROR_MSG("endpoint index out of range");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  size_t table = reader->endpoint_table_offset;
+  endpoint->kind = (rcl_graph_entity_kind_t)_rcl_graph_reader_row_field(reader, table, index, 0);
+  endpoint->name =
+    _rcl_graph_reader_string(reader, _rcl_graph_reader_row_field(reader, table, index, 1));
+  endpoint->type =
+    _rcl_graph_reader_string(reader, _rcl_graph_reader_row_field(reader, table, index, 2));
+  endpoint->node_index = _rcl_graph_reader_row_field(reader, table, index, 3);
+  return RCL_RET_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
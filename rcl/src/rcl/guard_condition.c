@@ -25,13 +25,8 @@ extern "C"
 #include "rmw/rmw.h"
 
 #include "./context_impl.h"
-
-typedef struct rcl_guard_condition_impl_t
-{
-  rmw_guard_condition_t * rmw_handle;
-  bool allocated_rmw_guard_condition;
-  rcl_guard_condition_options_t options;
-} rcl_guard_condition_impl_t;
+#include "./entity_pool.h"
+#include "./guard_condition_impl.h"
 
 rcl_guard_condition_t
 rcl_get_zero_initialized_guard_condition()
@@ -69,13 +64,17 @@ __rcl_guard_condition_init_from_rmw_impl(
       "either rcl_init() was not called or rcl_shutdown() was called.");
     return RCL_RET_NOT_INIT;
   }
-  // Allocate space for the guard condition impl.
-  guard_condition->impl = (rcl_guard_condition_impl_t *)allocator->allocate(
-    sizeof(rcl_guard_condition_impl_t), allocator->state);
-  if (!guard_condition->impl) {
-    RCL_SET_ERROR_MSG("allocating memory failed");
-    return RCL_RET_BAD_ALLOC;
+  // Allocate space for the guard condition impl, from the pool of the context if any.
+  void * impl = NULL;
+  bool is_pooled = false;
+  rcl_ret_t ret = rcl_context_allocate_entity(
+    context, RCL_ENTITY_POOL_GUARD_CONDITION, sizeof(rcl_guard_condition_impl_t), allocator,
+    &impl, &is_pooled);
+  if (RCL_RET_OK != ret) {
+    return ret;  // error message already set
   }
+  guard_condition->impl = (rcl_guard_condition_impl_t *)impl;
+  guard_condition->impl->is_pooled = is_pooled;
   // Create the rmw guard condition.
   if (rmw_guard_condition) {
     // If given, just assign (cast away const).
@@ -86,7 +85,10 @@ __rcl_guard_condition_init_from_rmw_impl(
     guard_condition->impl->rmw_handle = rmw_create_guard_condition(&(context->impl->rmw_context));
     if (!guard_condition->impl->rmw_handle) {
       // Deallocate impl and exit.
-      allocator->deallocate(guard_condition->impl, allocator->state);
+      rcl_context_deallocate_entity(
+        context, RCL_ENTITY_POOL_GUARD_CONDITION, guard_condition->impl,
+        sizeof(rcl_guard_condition_impl_t), allocator, is_pooled);
+      guard_condition->impl = NULL;
       RCL_SET_ERROR_MSG(rmw_get_error_string().str);
       return RCL_RET_ERROR;
     }
@@ -94,6 +96,9 @@ __rcl_guard_condition_init_from_rmw_impl(
   }
   // Copy options into impl.
   guard_condition->impl->options = options;
+  guard_condition->impl->is_graph_guard_condition = false;
+  guard_condition->impl->is_context_graph_guard_condition = false;
+  guard_condition->context = context;
   return RCL_RET_OK;
 }
 
@@ -133,7 +138,9 @@ rcl_guard_condition_fini(rcl_guard_condition_t * guard_condition)
         result = RCL_RET_ERROR;
       }
     }
-    allocator.deallocate(guard_condition->impl, allocator.state);
+    rcl_context_deallocate_entity(
+      guard_condition->context, RCL_ENTITY_POOL_GUARD_CONDITION, guard_condition->impl,
+      sizeof(rcl_guard_condition_impl_t), &allocator, guard_condition->impl->is_pooled);
     guard_condition->impl = NULL;
   }
   return result;
@@ -0,0 +1,46 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__GUARD_CONDITION_IMPL_H_
+#define RCL__GUARD_CONDITION_IMPL_H_
+
+#include <stdbool.h>
+
+#include "rcl/guard_condition.h"
+#include "rmw/types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// \internal
+typedef struct rcl_guard_condition_impl_t
+{
+  rmw_guard_condition_t * rmw_handle;
+  bool allocated_rmw_guard_condition;
+  rcl_guard_condition_options_t options;
+  /// True for the graph guard condition of a node, set by rcl_node_init().
+  bool is_graph_guard_condition;
+  /// True for the graph guard condition of a context, which rcl_wait() redirects to a node's.
+  bool is_context_graph_guard_condition;
+  /// The struct came from the guard condition pool of the context.
+  bool is_pooled;
+} rcl_guard_condition_impl_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__GUARD_CONDITION_IMPL_H_
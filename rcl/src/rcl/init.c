@@ -19,19 +19,68 @@ extern "C"
 
 #include "rcl/init.h"
 
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "./arguments_impl.h"
 #include "./common.h"
 #include "./context_impl.h"
+#include "./guard_condition_impl.h"
 #include "./init_options_impl.h"
 #include "rcl/arguments.h"
 #include "rcl/error_handling.h"
+#include "rcl/guard_condition.h"
 #include "rcl/logging.h"
+#include "rcutils/get_env.h"
 #include "rcutils/logging_macros.h"
+#include "rcutils/macros.h"
 #include "rcutils/stdatomic_helper.h"
 #include "rmw/error_handling.h"
 
+#define ROS_SECURITY_STRATEGY_VAR_NAME "ROS_SECURITY_STRATEGY"
+#define ROS_SECURITY_ENABLE_VAR_NAME "ROS_SECURITY_ENABLE"
+
 static atomic_uint_least64_t __rcl_next_unique_id = ATOMIC_VAR_INIT(1);
 
+/// Read the environment variables used by rcl_node_init(), once per context.
+static rcl_ret_t
+_rcl_init_read_env(rcl_context_env_t * env)
+{
+  const char * ros_domain_id = NULL;
+  rcl_ret_t ret = rcl_impl_getenv("ROS_DOMAIN_ID", &ros_domain_id);
+  if (RCL_RET_OK != ret) {
+    return ret;  // error already set
+  }
+  if (ros_domain_id) {
+    unsigned long number = strtoul(ros_domain_id, NULL, 0);  // NOLINT(runtime/int)
+    // Only reported by nodes which use the domain id, as it used to be read by each node.
+    env->invalid_domain_id = number == ULONG_MAX;
+    env->has_domain_id = !env->invalid_domain_id;
+    env->domain_id = (size_t)number;
+  }
+
+  const char * ros_security_enable = NULL;
+  if (rcutils_get_env(ROS_SECURITY_ENABLE_VAR_NAME, &ros_security_enable)) {
+    RCL_SET_ERROR_MSG(
+      "Environment variable " RCUTILS_STRINGIFY(ROS_SECURITY_ENABLE_VAR_NAME)
+      " could not be read");
+    return RCL_RET_ERROR;
+  }
+  env->use_security = (0 == strcmp(ros_security_enable, "true"));
+
+  const char * ros_enforce_security = NULL;
+  if (rcutils_get_env(ROS_SECURITY_STRATEGY_VAR_NAME, &ros_enforce_security)) {
+    RCL_SET_ERROR_MSG(
+      "Environment variable " RCUTILS_STRINGIFY(ROS_SECURITY_STRATEGY_VAR_NAME)
+      " could not be read");
+    return RCL_RET_ERROR;
+  }
+  env->enforce_security = (0 == strcmp(ros_enforce_security, "Enforce")) ?
+    RMW_SECURITY_ENFORCEMENT_ENFORCE : RMW_SECURITY_ENFORCEMENT_PERMISSIVE;
+  return RCL_RET_OK;
+}
+
 rcl_ret_t
 rcl_init(
   int argc,
@@ -82,6 +131,16 @@ rcl_init(
     fail_ret = ret;  // error message already set
     goto fail;
   }
+  rcl_graph_cache_init(
+    &context->impl->graph_cache, options->impl->graph_cache_max_age, allocator);
+  rcl_entity_arena_init(
+    &context->impl->entity_arena, options->impl->entity_arena_block_size, allocator);
+  ret = rcl_entity_pools_init(
+    &context->impl->entity_pools, &options->impl->entity_pool_capacities, allocator);
+  if (RCL_RET_OK != ret) {
+    fail_ret = ret;  // error message already set
+    goto fail;
+  }
 
   // Copy the argc and argv into the context, if argc >= 0.
   context->impl->argc = argc;
@@ -104,6 +163,20 @@ rcl_init(
     }
   }
 
+  // Read the environment once, instead of for every node.
+  ret = _rcl_init_read_env(&(context->impl->env));
+  if (RCL_RET_OK != ret) {
+    fail_ret = ret;  // error message already set
+    goto fail;
+  }
+  if (context->impl->env.use_security) {
+    ret = rcl_security_index_init(&(context->impl->security_index), allocator);
+    if (RCL_RET_OK != ret) {
+      fail_ret = ret;  // error message already set
+      goto fail;
+    }
+  }
+
   // Parse the ROS specific arguments.
   ret = rcl_parse_arguments(argc, argv, allocator, &context->global_arguments);
   if (RCL_RET_OK != ret) {
@@ -145,6 +218,30 @@ rcl_init(
   // Store the allocator.
   context->impl->allocator = allocator;
 
+  // Initialize the graph guard condition shared by the nodes of this context.
+  atomic_init(&(context->impl->graph_waiters), 0);
+  rcl_guard_condition_options_t graph_guard_condition_options =
+    rcl_guard_condition_get_default_options();
+  graph_guard_condition_options.allocator = allocator;
+  context->impl->graph_guard_condition = rcl_get_zero_initialized_guard_condition();
+  ret = rcl_mutex_init(&(context->impl->nodes_lock));
+  if (RCL_RET_OK == ret) {
+    ret = rcl_guard_condition_init(
+      &(context->impl->graph_guard_condition), context, graph_guard_condition_options);
+    if (RCL_RET_OK != ret) {
+      rcl_mutex_fini(&(context->impl->nodes_lock));
+    }
+  }
+  if (RCL_RET_OK != ret) {
+    fail_ret = ret;  // error message already set
+    if (RMW_RET_OK != rmw_shutdown(&(context->impl->rmw_context))) {
+      rmw_reset_error();
+    }
+    goto fail;
+  }
+  context->impl->graph_guard_condition.impl->is_graph_guard_condition = true;
+  context->impl->graph_guard_condition.impl->is_context_graph_guard_condition = true;
+
   return RCL_RET_OK;
 fail:
   __cleanup_context(context);
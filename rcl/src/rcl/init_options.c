@@ -48,6 +48,9 @@ rcl_init_options_init(rcl_init_options_t * init_options, rcl_allocator_t allocat
     "failed to allocate memory for init options impl",
     return RCL_RET_BAD_ALLOC);
   init_options->impl->allocator = allocator;
+  init_options->impl->graph_cache_max_age = 0;
+  init_options->impl->entity_arena_block_size = 0;
+  init_options->impl->entity_pool_capacities = (rcl_entity_pool_capacities_t){0};
   init_options->impl->rmw_init_options = rmw_get_zero_initialized_init_options();
   rmw_ret_t rmw_ret = rmw_init_options_init(&(init_options->impl->rmw_init_options), allocator);
   if (RMW_RET_OK != rmw_ret) {
@@ -77,6 +80,9 @@ rcl_init_options_copy(const rcl_init_options_t * src, rcl_init_options_t * dst)
 
   // copy src information into dst
   dst->impl->allocator = src->impl->allocator;
+  dst->impl->graph_cache_max_age = src->impl->graph_cache_max_age;
+  dst->impl->entity_arena_block_size = src->impl->entity_arena_block_size;
+  dst->impl->entity_pool_capacities = src->impl->entity_pool_capacities;
   // first zero-initialize rmw init options
   rmw_ret_t rmw_ret = rmw_init_options_fini(&(dst->impl->rmw_init_options));
   if (RMW_RET_OK != rmw_ret) {
@@ -139,6 +145,82 @@ rcl_init_options_get_rmw_init_options(rcl_init_options_t * init_options)
   return &(init_options->impl->rmw_init_options);
 }
 
+rcl_ret_t
+rcl_init_options_set_graph_cache_max_age(rcl_init_options_t * init_options, int64_t max_age)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(init_options, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(init_options->impl, RCL_RET_INVALID_ARGUMENT);
+  if (max_age < 0) {
+    RCL_SET_ERROR_MSG("graph cache max age must not be negative");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  init_options->impl->graph_cache_max_age = max_age;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_init_options_get_graph_cache_max_age(
+  const rcl_init_options_t * init_options,
+  int64_t * max_age)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(init_options, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(init_options->impl, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(max_age, RCL_RET_INVALID_ARGUMENT);
+  *max_age = init_options->impl->graph_cache_max_age;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_init_options_set_entity_arena_block_size(
+  rcl_init_options_t * init_options,
+  size_t block_size)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(init_options, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(init_options->impl, RCL_RET_INVALID_ARGUMENT);
+  init_options->impl->entity_arena_block_size = block_size;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_init_options_get_entity_arena_block_size(
+  const rcl_init_options_t * init_options,
+  size_t * block_size)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(init_options, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(init_options->impl, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(block_size, RCL_RET_INVALID_ARGUMENT);
+  *block_size = init_options->impl->entity_arena_block_size;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_init_options_set_entity_pool_capacities(
+  rcl_init_options_t * init_options,
+  const rcl_entity_pool_capacities_t * capacities)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(init_options, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(init_options->impl, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(capacities, RCL_RET_INVALID_ARGUMENT);
+  if (capacities->wait_sets > 0 && 0 == capacities->wait_set_entries) {
+    RCL_SET_ERROR_MSG("pooled wait sets need a non-zero number of wait set entries");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  init_options->impl->entity_pool_capacities = *capacities;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_init_options_get_entity_pool_capacities(
+  const rcl_init_options_t * init_options,
+  rcl_entity_pool_capacities_t * capacities)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(init_options, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(init_options->impl, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(capacities, RCL_RET_INVALID_ARGUMENT);
+  *capacities = init_options->impl->entity_pool_capacities;
+  return RCL_RET_OK;
+}
+
 #ifdef __cplusplus
 }
 #endif
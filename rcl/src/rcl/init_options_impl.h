@@ -29,6 +29,12 @@ typedef struct rcl_init_options_impl_t
 {
   rcl_allocator_t allocator;
   rmw_init_options_t rmw_init_options;
+  /// Maximum age of the graph cache's snapshot in nanoseconds, 0 if disabled.
+  int64_t graph_cache_max_age;
+  /// Size of the blocks of the entity arena in bytes, 0 if disabled.
+  size_t entity_arena_block_size;
+  /// Number of slots of each entity pool, all 0 if disabled.
+  rcl_entity_pool_capacities_t entity_pool_capacities;
 } rcl_init_options_impl_t;
 
 #ifdef __cplusplus
@@ -31,6 +31,9 @@
  * The movement M is written as M = 1 + N so it can be stored in an unsigned integer.
  * For example, an `<else>` transition with M = 0 moves the lexer forwards 1 character, M = 1 keeps
  * the lexer at the current character, and M = 2 moves the lexer backwards one character.
+ *
+ * The transitions of every state are evaluated for every ASCII character at compile time, into a
+ * dense table indexed by state and character, so each character costs one lookup.
 
 digraph remapping_lexer {
   rankdir=LR;
@@ -134,30 +137,6 @@ digraph remapping_lexer {
 }
 */
 
-/// Represents a transition from one state to another
-/// \internal
-typedef struct rcl_lexer_transition_t
-{
-  /// Index of a state to transition to
-  const unsigned char to_state;
-  /// Start of a range of chars (inclusive) which activates this transition
-  const char range_start;
-  /// End of a range of chars (inclusive) which activates this transition
-  const char range_end;
-} rcl_lexer_transition_t;
-
-/// Represents a non-terminal state
-/// \internal
-typedef struct rcl_lexer_state_t
-{
-  /// Transition to this state if no other transition matches
-  const unsigned char else_state;
-  /// Movement associated with taking else state
-  const unsigned char else_movement;
-  /// Transitions in the state machine (NULL value at end of array)
-  const rcl_lexer_transition_t transitions[11];
-} rcl_lexer_state_t;
-
 #define S0 0u
 #define S1 1u
 #define S2 2u
@@ -218,314 +197,115 @@ typedef struct rcl_lexer_state_t
 #define FIRST_TERMINAL T_TILDE_SLASH
 #define LAST_TERMINAL T_NONE
 
-// Used to mark where the last transition is in a state
-#define END_TRANSITIONS {0, '\0', '\0'}
+// An entry of the transition table holds the next state, and the movement in the upper two bits.
+#define MOVEMENT_SHIFT 6u
+#define STATE_MASK 0x3fu
+#define ELSE(state, movement) ((state) | ((movement) << MOVEMENT_SHIFT))
+
+#define IS_IN(c, first, last) ((first) <= (c) && (c) <= (last))
+#define IS_ALPHA(c) (IS_IN(c, 'a', 'z') || IS_IN(c, 'A', 'Z'))
+#define IS_ALNUM(c) (IS_ALPHA(c) || IS_IN(c, '0', '9'))
 
-static const rcl_lexer_state_t g_states[LAST_STATE + 1] =
+// The transitions of each state in the diagram above, as a function of the character.
+#define S0_NEXT(c) \
+  ('/' == (c) ? T_FORWARD_SLASH : \
+  '\\' == (c) ? S1 : \
+  '~' == (c) ? S2 : \
+  '_' == (c) ? S3 : \
+  'r' == (c) ? S10 : \
+  IS_ALPHA(c) ? S8 : \
+  '*' == (c) ? S29 : \
+  ':' == (c) ? S30 : \
+  ELSE(T_NONE, 0u))
+#define S1_NEXT(c) (IS_IN(c, '1', '9') ? T_BR1 + ((c) - '1') : ELSE(T_NONE, 0u))
+#define S2_NEXT(c) ('/' == (c) ? T_TILDE_SLASH : ELSE(T_NONE, 0u))
+#define S3_NEXT(c) ('_' == (c) ? S4 : ELSE(S9, 1u))
+#define S4_NEXT(c) ('n' == (c) ? S5 : ELSE(T_NONE, 0u))
+#define S5_NEXT(c) ('s' == (c) ? T_NS : 'o' == (c) ? S6 : ELSE(T_NONE, 0u))
+#define S6_NEXT(c) ('d' == (c) ? S7 : ELSE(T_NONE, 0u))
+#define S7_NEXT(c) ('e' == (c) ? T_NODE : ELSE(T_NONE, 0u))
+#define S8_NEXT(c) (IS_ALNUM(c) ? S8 : '_' == (c) ? S9 : ELSE(T_TOKEN, 1u))
+#define S9_NEXT(c) (IS_ALNUM(c) ? S8 : ELSE(T_TOKEN, 1u))
+#define S10_NEXT(c) ('o' == (c) ? S11 : ELSE(S8, 1u))
+#define S11_NEXT(c) ('s' == (c) ? S12 : ELSE(S8, 1u))
+#define S12_NEXT(c) ('t' == (c) ? S13 : 's' == (c) ? S20 : ELSE(S8, 1u))
+#define S13_NEXT(c) ('o' == (c) ? S14 : ELSE(S8, 1u))
+#define S14_NEXT(c) ('p' == (c) ? S15 : ELSE(S8, 1u))
+#define S15_NEXT(c) ('i' == (c) ? S16 : ELSE(S8, 1u))
+#define S16_NEXT(c) ('c' == (c) ? S17 : ELSE(S8, 1u))
+#define S17_NEXT(c) (':' == (c) ? S18 : ELSE(S8, 1u))
+#define S18_NEXT(c) ('/' == (c) ? S19 : ELSE(S8, 2u))
+#define S19_NEXT(c) ('/' == (c) ? T_URL_TOPIC : ELSE(S8, 3u))
+#define S20_NEXT(c) ('e' == (c) ? S21 : ELSE(S8, 1u))
+#define S21_NEXT(c) ('r' == (c) ? S22 : ELSE(S8, 1u))
+#define S22_NEXT(c) ('v' == (c) ? S23 : ELSE(S8, 1u))
+#define S23_NEXT(c) ('i' == (c) ? S24 : ELSE(S8, 1u))
+#define S24_NEXT(c) ('c' == (c) ? S25 : ELSE(S8, 1u))
+#define S25_NEXT(c) ('e' == (c) ? S26 : ELSE(S8, 1u))
+#define S26_NEXT(c) (':' == (c) ? S27 : ELSE(S8, 1u))
+#define S27_NEXT(c) ('/' == (c) ? S28 : ELSE(S8, 2u))
+#define S28_NEXT(c) ('/' == (c) ? T_URL_SERVICE : ELSE(S8, 3u))
+#define S29_NEXT(c) ('*' == (c) ? T_WILD_MULTI : ELSE(T_WILD_ONE, 1u))
+#define S30_NEXT(c) ('=' == (c) ? T_SEPARATOR : ELSE(T_COLON, 1u))
+
+// Evaluate the transitions of a state for every ASCII character.
+#define RCL_LEXER_ROW(NEXT) \
+  { \
+    NEXT(0), NEXT(1), NEXT(2), NEXT(3), NEXT(4), NEXT(5), NEXT(6), NEXT(7), \
+    NEXT(8), NEXT(9), NEXT(10), NEXT(11), NEXT(12), NEXT(13), NEXT(14), NEXT(15), \
+    NEXT(16), NEXT(17), NEXT(18), NEXT(19), NEXT(20), NEXT(21), NEXT(22), NEXT(23), \
+    NEXT(24), NEXT(25), NEXT(26), NEXT(27), NEXT(28), NEXT(29), NEXT(30), NEXT(31), \
+    NEXT(32), NEXT(33), NEXT(34), NEXT(35), NEXT(36), NEXT(37), NEXT(38), NEXT(39), \
+    NEXT(40), NEXT(41), NEXT(42), NEXT(43), NEXT(44), NEXT(45), NEXT(46), NEXT(47), \
+    NEXT(48), NEXT(49), NEXT(50), NEXT(51), NEXT(52), NEXT(53), NEXT(54), NEXT(55), \
+    NEXT(56), NEXT(57), NEXT(58), NEXT(59), NEXT(60), NEXT(61), NEXT(62), NEXT(63), \
+    NEXT(64), NEXT(65), NEXT(66), NEXT(67), NEXT(68), NEXT(69), NEXT(70), NEXT(71), \
+    NEXT(72), NEXT(73), NEXT(74), NEXT(75), NEXT(76), NEXT(77), NEXT(78), NEXT(79), \
+    NEXT(80), NEXT(81), NEXT(82), NEXT(83), NEXT(84), NEXT(85), NEXT(86), NEXT(87), \
+    NEXT(88), NEXT(89), NEXT(90), NEXT(91), NEXT(92), NEXT(93), NEXT(94), NEXT(95), \
+    NEXT(96), NEXT(97), NEXT(98), NEXT(99), NEXT(100), NEXT(101), NEXT(102), NEXT(103), \
+    NEXT(104), NEXT(105), NEXT(106), NEXT(107), NEXT(108), NEXT(109), NEXT(110), NEXT(111), \
+    NEXT(112), NEXT(113), NEXT(114), NEXT(115), NEXT(116), NEXT(117), NEXT(118), NEXT(119), \
+    NEXT(120), NEXT(121), NEXT(122), NEXT(123), NEXT(124), NEXT(125), NEXT(126), NEXT(127) \
+  }
+
+/// Next state and movement for each state and ASCII character, computed by the compiler.
+/**
+ * Characters outside of ASCII take the same '<else,M>' transition as '\0'.
+ */
+static const unsigned char g_transitions[LAST_STATE + 1][128] =
 {
-  // S0
-  {
-    T_NONE,
-    0u,
-    {
-      {T_FORWARD_SLASH, '/', '/'},
-      {S1, '\\', '\\'},
-      {S2, '~', '~'},
-      {S3, '_', '_'},
-      {S8, 'a', 'q'},
-      {S8, 's', 'z'},
-      {S8, 'A', 'Z'},
-      {S10, 'r', 'r'},
-      {S29, '*', '*'},
-      {S30, ':', ':'},
-      END_TRANSITIONS
-    }
-  },
-  // S1
-  {
-    T_NONE,
-    0u,
-    {
-      {T_BR1, '1', '1'},
-      {T_BR2, '2', '2'},
-      {T_BR3, '3', '3'},
-      {T_BR4, '4', '4'},
-      {T_BR5, '5', '5'},
-      {T_BR6, '6', '6'},
-      {T_BR7, '7', '7'},
-      {T_BR8, '8', '8'},
-      {T_BR9, '9', '9'},
-      END_TRANSITIONS
-    }
-  },
-  // S2
-  {
-    T_NONE,
-    0u,
-    {
-      {T_TILDE_SLASH, '/', '/'},
-      END_TRANSITIONS
-    }
-  },
-  // S3
-  {
-    S9,
-    1u,
-    {
-      {S4, '_', '_'},
-      END_TRANSITIONS
-    }
-  },
-  // S4
-  {
-    T_NONE,
-    0u,
-    {
-      {S5, 'n', 'n'},
-      END_TRANSITIONS
-    }
-  },
-  // S5
-  {
-    T_NONE,
-    0u,
-    {
-      {T_NS, 's', 's'},
-      {S6, 'o', 'o'},
-      END_TRANSITIONS
-    }
-  },
-  // S6
-  {
-    T_NONE,
-    0u,
-    {
-      {S7, 'd', 'd'},
-      END_TRANSITIONS
-    }
-  },
-  // S7
-  {
-    T_NONE,
-    0u,
-    {
-      {T_NODE, 'e', 'e'},
-      END_TRANSITIONS
-    }
-  },
-  // S8
-  {
-    T_TOKEN,
-    1u,
-    {
-      {S8, 'a', 'z'},
-      {S8, 'A', 'Z'},
-      {S8, '0', '9'},
-      {S9, '_', '_'},
-      END_TRANSITIONS
-    }
-  },
-  // S9
-  {
-    T_TOKEN,
-    1u,
-    {
-      {S8, 'a', 'z'},
-      {S8, 'A', 'Z'},
-      {S8, '0', '9'},
-      END_TRANSITIONS
-    }
-  },
-  // S10
-  {
-    S8,
-    1u,
-    {
-      {S11, 'o', 'o'},
-      END_TRANSITIONS
-    }
-  },
-  // S11
-  {
-    S8,
-    1u,
-    {
-      {S12, 's', 's'},
-      END_TRANSITIONS
-    }
-  },
-  // S12
-  {
-    S8,
-    1u,
-    {
-      {S13, 't', 't'},
-      {S20, 's', 's'},
-      END_TRANSITIONS
-    }
-  },
-  // S13
-  {
-    S8,
-    1u,
-    {
-      {S14, 'o', 'o'},
-      END_TRANSITIONS
-    }
-  },
-  // S14
-  {
-    S8,
-    1u,
-    {
-      {S15, 'p', 'p'},
-      END_TRANSITIONS
-    }
-  },
-  // S15
-  {
-    S8,
-    1u,
-    {
-      {S16, 'i', 'i'},
-      END_TRANSITIONS
-    }
-  },
-  // S16
-  {
-    S8,
-    1u,
-    {
-      {S17, 'c', 'c'},
-      END_TRANSITIONS
-    }
-  },
-  // S17
-  {
-    S8,
-    1u,
-    {
-      {S18, ':', ':'},
-      END_TRANSITIONS
-    }
-  },
-  // S18
-  {
-    S8,
-    2u,
-    {
-      {S19, '/', '/'},
-      END_TRANSITIONS
-    }
-  },
-  // S19
-  {
-    S8,
-    3u,
-    {
-      {T_URL_TOPIC, '/', '/'},
-      END_TRANSITIONS
-    }
-  },
-  // S20
-  {
-    S8,
-    1u,
-    {
-      {S21, 'e', 'e'},
-      END_TRANSITIONS
-    }
-  },
-  // S21
-  {
-    S8,
-    1u,
-    {
-      {S22, 'r', 'r'},
-      END_TRANSITIONS
-    }
-  },
-  // S22
-  {
-    S8,
-    1u,
-    {
-      {S23, 'v', 'v'},
-      END_TRANSITIONS
-    }
-  },
-  // S23
-  {
-    S8,
-    1u,
-    {
-      {S24, 'i', 'i'},
-      END_TRANSITIONS
-    }
-  },
-  // S24
-  {
-    S8,
-    1u,
-    {
-      {S25, 'c', 'c'},
-      END_TRANSITIONS
-    }
-  },
-  // S25
-  {
-    S8,
-    1u,
-    {
-      {S26, 'e', 'e'},
-      END_TRANSITIONS
-    }
-  },
-  // S26
-  {
-    S8,
-    1u,
-    {
-      {S27, ':', ':'},
-      END_TRANSITIONS
-    }
-  },
-  // S27
-  {
-    S8,
-    2u,
-    {
-      {S28, '/', '/'},
-      END_TRANSITIONS
-    }
-  },
-  // S28
-  {
-    S8,
-    3u,
-    {
-      {T_URL_SERVICE, '/', '/'},
-      END_TRANSITIONS
-    }
-  },
-  // S29
-  {
-    T_WILD_ONE,
-    1u,
-    {
-      {T_WILD_MULTI, '*', '*'},
-      END_TRANSITIONS
-    }
-  },
-  // S30
-  {
-    T_COLON,
-    1u,
-    {
-      {T_SEPARATOR, '=', '='},
-      END_TRANSITIONS
-    }
-  },
+  RCL_LEXER_ROW(S0_NEXT),
+  RCL_LEXER_ROW(S1_NEXT),
+  RCL_LEXER_ROW(S2_NEXT),
+  RCL_LEXER_ROW(S3_NEXT),
+  RCL_LEXER_ROW(S4_NEXT),
+  RCL_LEXER_ROW(S5_NEXT),
+  RCL_LEXER_ROW(S6_NEXT),
+  RCL_LEXER_ROW(S7_NEXT),
+  RCL_LEXER_ROW(S8_NEXT),
+  RCL_LEXER_ROW(S9_NEXT),
+  RCL_LEXER_ROW(S10_NEXT),
+  RCL_LEXER_ROW(S11_NEXT),
+  RCL_LEXER_ROW(S12_NEXT),
+  RCL_LEXER_ROW(S13_NEXT),
+  RCL_LEXER_ROW(S14_NEXT),
+  RCL_LEXER_ROW(S15_NEXT),
+  RCL_LEXER_ROW(S16_NEXT),
+  RCL_LEXER_ROW(S17_NEXT),
+  RCL_LEXER_ROW(S18_NEXT),
+  RCL_LEXER_ROW(S19_NEXT),
+  RCL_LEXER_ROW(S20_NEXT),
+  RCL_LEXER_ROW(S21_NEXT),
+  RCL_LEXER_ROW(S22_NEXT),
+  RCL_LEXER_ROW(S23_NEXT),
+  RCL_LEXER_ROW(S24_NEXT),
+  RCL_LEXER_ROW(S25_NEXT),
+  RCL_LEXER_ROW(S26_NEXT),
+  RCL_LEXER_ROW(S27_NEXT),
+  RCL_LEXER_ROW(S28_NEXT),
+  RCL_LEXER_ROW(S29_NEXT),
+  RCL_LEXER_ROW(S30_NEXT),
 };
 
 static const rcl_lexeme_t g_terminals[LAST_TERMINAL + 1] = {
@@ -593,45 +373,22 @@ rcl_lexer_analyze(
     return RCL_RET_OK;
   }
 
-  const rcl_lexer_state_t * state;
-  char current_char;
   size_t next_state = S0;
   size_t movement;
 
   // Analyze one character at a time until lexeme is found
   do {
-    if (next_state > LAST_STATE) {
-      // Should never happen
-      RCL_SET_ERROR_MSG("Internal lexer bug: next state does not exist");
-      return RCL_RET_ERROR;
-    }
-    state = &(g_states[next_state]);
-    current_char = text[*length];
-    next_state = 0u;
-    movement = 0u;
-
-    // Look for a transition that contains this character in its range
-    size_t transition_idx = 0u;
-    const rcl_lexer_transition_t * transition;
-    do {
-      transition = &(state->transitions[transition_idx]);
-      if (transition->range_start <= current_char && transition->range_end >= current_char) {
-        next_state = transition->to_state;
-        break;
-      }
-      ++transition_idx;
-    } while (0u != transition->to_state);
-
-    // if no transition was found, take the else transition
-    if (0u == next_state) {
-      next_state = state->else_state;
-      movement = state->else_movement;
-    }
+    unsigned char current_char = (unsigned char)text[*length];
+    unsigned char entry = g_transitions[next_state][current_char < 128u ? current_char : 0u];
+    next_state = entry & STATE_MASK;
+    movement = entry >> MOVEMENT_SHIFT;
 
     // Move the lexer to another character in the string
     if (0u == movement) {
-      // Go forwards 1 char
-      ++(*length);
+      // Go forwards 1 char, but never past the end of the string
+      if ('\0' != current_char) {
+        ++(*length);
+      }
     } else {
       // Go backwards N chars
       if (movement - 1u > *length) {
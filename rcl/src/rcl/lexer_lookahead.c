@@ -28,6 +28,8 @@ struct rcl_lexer_lookahead2_impl_t
   size_t end[2];
   // Type of lexeme
   rcl_lexeme_t type[2];
+  // Number of lexemes already analyzed starting at text_idx, from 0 to 2
+  size_t count;
 
   // Allocator to use if an error occurrs
   rcl_allocator_t allocator;
@@ -68,6 +70,7 @@ rcl_lexer_lookahead2_init(
   buffer->impl->end[1] = 0u;
   buffer->impl->type[0] = RCL_LEXEME_NONE;
   buffer->impl->type[1] = RCL_LEXEME_NONE;
+  buffer->impl->count = 0u;
   buffer->impl->allocator = allocator;
 
   return RCL_RET_OK;
@@ -101,7 +104,7 @@ rcl_lexer_lookahead2_peek(
   rcl_ret_t ret;
   size_t length;
 
-  if (buffer->impl->text_idx >= buffer->impl->end[0]) {
+  if (0u == buffer->impl->count) {
     // No buffered lexeme; get one
     ret = rcl_lexer_analyze(
       rcl_lexer_lookahead2_get_text(buffer),
@@ -114,6 +117,7 @@ rcl_lexer_lookahead2_peek(
 
     buffer->impl->start[0] = buffer->impl->text_idx;
     buffer->impl->end[0] = buffer->impl->start[0] + length;
+    buffer->impl->count = 1u;
   }
 
   *next_type = buffer->impl->type[0];
@@ -136,8 +140,8 @@ rcl_lexer_lookahead2_peek2(
 
   size_t length;
 
-  if (buffer->impl->text_idx >= buffer->impl->end[1]) {
-    // No buffered lexeme; get one
+  if (buffer->impl->count < 2u) {
+    // No second buffered lexeme; get one
     ret = rcl_lexer_analyze(
       &(buffer->impl->text[buffer->impl->end[0]]),
       &(buffer->impl->type[1]),
@@ -149,6 +153,7 @@ rcl_lexer_lookahead2_peek2(
 
     buffer->impl->start[1] = buffer->impl->end[0];
     buffer->impl->end[1] = buffer->impl->start[1] + length;
+    buffer->impl->count = 2u;
   }
 
   *next_type2 = buffer->impl->type[1];
@@ -181,7 +186,7 @@ rcl_lexer_lookahead2_accept(
     return RCL_RET_OK;
   }
 
-  if (buffer->impl->text_idx >= buffer->impl->end[0]) {
+  if (0u == buffer->impl->count) {
     RCL_SET_ERROR_MSG("no lexeme to accept");
     return RCL_RET_ERROR;
   }
@@ -198,6 +203,7 @@ rcl_lexer_lookahead2_accept(
   buffer->impl->start[0] = buffer->impl->start[1];
   buffer->impl->end[0] = buffer->impl->end[1];
   buffer->impl->type[0] = buffer->impl->type[1];
+  --(buffer->impl->count);
 
   return RCL_RET_OK;
 }
@@ -0,0 +1,81 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./mutex.h"
+
+#include "rcl/error_handling.h"
+
+rcl_ret_t
+rcl_mutex_init(rcl_mutex_t * mutex)
+{
+#if defined(_WIN32)
+  InitializeSRWLock(&mutex->lock);
+#else
+  if (0 != pthread_mutex_init(&mutex->lock, NULL)) {
+    RCL_SET_ERROR_MSG("failed to initialize mutex");
+    return RCL_RET_ERROR;
+  }
+#endif
+  return RCL_RET_OK;
+}
+
+void
+rcl_mutex_fini(rcl_mutex_t * mutex)
+{
+#if defined(_WIN32)
+  (void)mutex;
+#else
+  (void)pthread_mutex_destroy(&mutex->lock);
+#endif
+}
+
+void
+rcl_mutex_lock(rcl_mutex_t * mutex)
+{
+#if defined(_WIN32)
+  AcquireSRWLockExclusive(&mutex->lock);
+#else
+  (void)pthread_mutex_lock(&mutex->lock);
+#endif
+}
+
+void
+rcl_mutex_unlock(rcl_mutex_t * mutex)
+{
+#if defined(_WIN32)
+  ReleaseSRWLockExclusive(&mutex->lock);
+#else
+  (void)pthread_mutex_unlock(&mutex->lock);
+#endif
+}
+
+void
+rcl_thread_yield(void)
+{
+#if defined(_WIN32)
+  SwitchToThread();
+#else
+  (void)sched_yield();
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
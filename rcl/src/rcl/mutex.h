@@ -0,0 +1,79 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RCL__MUTEX_H_
+#define RCL__MUTEX_H_
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "rcl/types.h"
+#include "rcl/visibility_control.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// Mutex for locks which may be held across calls into the middleware.
+/**
+ * Short critical sections use spin locks on an `atomic_bool` instead, a
+ * waiter for this mutex sleeps rather than spins.
+ */
+typedef struct rcl_mutex_t
+{
+#if defined(_WIN32)
+  SRWLOCK lock;
+#else
+  pthread_mutex_t lock;
+#endif
+} rcl_mutex_t;
+
+/// Initialize the mutex.
+/**
+ * \return `RCL_RET_OK` if the mutex was initialized, or
+ * \return `RCL_RET_ERROR` if the system could not create the mutex.
+ */
+RCL_LOCAL
+rcl_ret_t
+rcl_mutex_init(rcl_mutex_t * mutex);
+
+/// Destroy a mutex which is not locked.
+RCL_LOCAL
+void
+rcl_mutex_fini(rcl_mutex_t * mutex);
+
+RCL_LOCAL
+void
+rcl_mutex_lock(rcl_mutex_t * mutex);
+
+RCL_LOCAL
+void
+rcl_mutex_unlock(rcl_mutex_t * mutex);
+
+/// Let other threads run, while polling for them to give up a resource.
+RCL_LOCAL
+void
+rcl_thread_yield(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__MUTEX_H_
@@ -0,0 +1,261 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./name_resolver.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "rcl/error_handling.h"
+#include "rcl/validate_topic_name.h"
+#include "rcutils/types/string_map.h"
+#include "rmw/error_handling.h"
+#include "rmw/validate_full_topic_name.h"
+#include "rmw/validate_namespace.h"
+#include "rmw/validate_node_name.h"
+
+// built-in substitution strings, as in rcl_expand_topic_name()
+#define SUBSTITUION_NODE_NAME "{node}"
+#define SUBSTITUION_NAMESPACE "{ns}"
+#define SUBSTITUION_NAMESPACE2 "{namespace}"
+
+rcl_name_resolver_t
+rcl_get_zero_initialized_name_resolver(void)
+{
+  static rcl_name_resolver_t null_resolver = {
+    .node_name = NULL,
+    .node_name_length = 0,
+    .node_namespace = NULL,
+    .node_namespace_length = 0,
+    .node_validation_ret = RCL_RET_OK,
+    .remap_table = NULL
+  };
+  return null_resolver;
+}
+
+rcl_ret_t
+rcl_name_resolver_init(
+  rcl_name_resolver_t * resolver,
+  const char * node_name,
+  const char * node_namespace,
+  const rcl_remap_table_t * remap_table)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(resolver, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(node_name, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(node_namespace, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(remap_table, RCL_RET_INVALID_ARGUMENT);
+  resolver->node_name = node_name;
+  resolver->node_name_length = strlen(node_name);
+  resolver->node_namespace = node_namespace;
+  resolver->node_namespace_length = strlen(node_namespace);
+  resolver->remap_table = remap_table;
+  resolver->node_validation_ret = RCL_RET_OK;
+
+  int validation_result;
+  rmw_ret_t rmw_ret = rmw_validate_node_name(node_name, &validation_result, NULL);
+  if (RMW_RET_OK != rmw_ret) {
+    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+    return RCL_RET_ERROR;
+  }
+  if (RMW_NODE_NAME_VALID != validation_result) {
+    resolver->node_validation_ret = RCL_RET_NODE_INVALID_NAME;
+    return RCL_RET_OK;
+  }
+  rmw_ret = rmw_validate_namespace(node_namespace, &validation_result, NULL);
+  if (RMW_RET_OK != rmw_ret) {
+    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+    return RCL_RET_ERROR;
+  }
+  if (RMW_NAMESPACE_VALID != validation_result) {
+    resolver->node_validation_ret = RCL_RET_NODE_INVALID_NAMESPACE;
+  }
+  return RCL_RET_OK;
+}
+
+/// Append text to the buffer, false if it does not fit along with a terminating null.
+static bool
+_rcl_name_resolver_append(
+  char * buffer,
+  size_t buffer_size,
+  size_t * length,
+  const char * text,
+  size_t text_length)
+{
+  if (text_length >= buffer_size - *length) {
+    return false;
+  }
+  memcpy(buffer + *length, text, text_length);
+  *length += text_length;
+  return true;
+}
+
+/// Expand a validated name into a fully qualified one, like rcl_expand_topic_name().
+/**
+ * The name is read once: `~` and the substitutions are replaced as they are
+ * found, and the namespace is moved in front of a relative name at the end.
+ */
+static rcl_ret_t
+_rcl_name_resolver_expand(
+  const rcl_name_resolver_t * resolver,
+  const char * name,
+  char * buffer,
+  size_t buffer_size)
+{
+  // The root namespace already ends with the separator.
+  size_t separator_length = (resolver->node_namespace_length > 1) ? 1 : 0;
+  size_t length = 0;
+  bool fits = true;
+  if ('~' == name[0]) {
+    fits = _rcl_name_resolver_append(
+      buffer, buffer_size, &length, resolver->node_namespace, resolver->node_namespace_length) &&
+      _rcl_name_resolver_append(buffer, buffer_size, &length, "/", separator_length) &&
+      _rcl_name_resolver_append(
+      buffer, buffer_size, &length, resolver->node_name, resolver->node_name_length);
+    ++name;
+  }
+  while (fits && '\0' != *name) {
+    if ('{' != *name) {
+      size_t text_length = strcspn(name, "{");
+      fits = _rcl_name_resolver_append(buffer, buffer_size, &length, name, text_length);
+      name += text_length;
+      continue;
+    }
+    // Braces are balanced and not nested, the name was validated.
+    size_t substitution_length = (size_t)(strchr(name, '}') - name) + 1;
+    const char * replacement = NULL;
+    size_t replacement_length = 0;
+    if (0 == strncmp(SUBSTITUION_NODE_NAME, name, substitution_length)) {
+      replacement = resolver->node_name;
+      replacement_length = resolver->node_name_length;
+    } else if (  // NOLINT
+      0 == strncmp(SUBSTITUION_NAMESPACE, name, substitution_length) ||
+      0 == strncmp(SUBSTITUION_NAMESPACE2, name, substitution_length))
+    {
+      replacement = resolver->node_namespace;
+      replacement_length = resolver->node_namespace_length;
+    } else {
+      replacement = rcutils_string_map_getn(
+        &(resolver->remap_table->substitutions), name + 1, substitution_length - 2);
+      if (NULL == replacement) {
+        RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
+          "unknown substitution: %.*s", (int)substitution_length, name);
+        return RCL_RET_UNKNOWN_SUBSTITUTION;
+      }
+      replacement_length = strlen(replacement);
+    }
+    fits = _rcl_name_resolver_append(buffer, buffer_size, &length, replacement, replacement_length);
+    name += substitution_length;
+  }
+  if (fits && (0 == length || '/' != buffer[0])) {
+    size_t prefix_length = resolver->node_namespace_length + separator_length;
+    fits = prefix_length < buffer_size - length;
+    if (fits) {
+      memmove(buffer + prefix_length, buffer, length);
+      memcpy(buffer, resolver->node_namespace, resolver->node_namespace_length);
+      if (separator_length > 0) {
+        buffer[resolver->node_namespace_length] = '/';
+      }
+      length += prefix_length;
+    }
+  }
+  if (!fits) {
+    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "expanded name does not fit in %zu characters", buffer_size - 1);
+    return RCL_RET_TOPIC_NAME_INVALID;
+  }
+  buffer[length] = '\0';
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_name_resolver_resolve(
+  const rcl_name_resolver_t * resolver,
+  rcl_remap_type_t type,
+  const char * input_name,
+  char * buffer,
+  size_t buffer_size)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(resolver, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(input_name, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(buffer, RCL_RET_INVALID_ARGUMENT);
+  if (0 == buffer_size) {
+    RCL_SET_ERROR_MSG("buffer_size must not be 0");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  if (RCL_RET_NODE_INVALID_NAME == resolver->node_validation_ret) {
+    RCL_SET_ERROR_MSG("node name is invalid");
+    return resolver->node_validation_ret;
+  } else if (RCL_RET_NODE_INVALID_NAMESPACE == resolver->node_validation_ret) {
+    RCL_SET_ERROR_MSG("node namespace is invalid");
+    return resolver->node_validation_ret;
+  }
+  int validation_result;
+  rcl_ret_t ret = rcl_validate_topic_name(input_name, &validation_result, NULL);
+  if (RCL_RET_OK != ret) {
+    return ret;  // error already set
+  }
+  if (RCL_TOPIC_NAME_VALID != validation_result) {
+    RCL_SET_ERROR_MSG("topic name is invalid");
+    return RCL_RET_TOPIC_NAME_INVALID;
+  }
+  ret = _rcl_name_resolver_expand(resolver, input_name, buffer, buffer_size);
+  if (RCL_RET_OK != ret) {
+    return ret;  // error already set
+  }
+
+  const rcl_remap_table_entry_t * entry =
+    rcl_remap_table_find_entry(resolver->remap_table, type, buffer);
+  if (NULL != entry) {
+    // The back-references are replaced before the expanded name is overwritten.
+    char substituted_replacement[RCL_RESOLVED_NAME_BUFFER_SIZE];
+    const char * replacement = NULL;
+    ret = rcl_remap_table_entry_get_replacement(
+      entry, buffer, substituted_replacement, sizeof(substituted_replacement), &replacement);
+    if (RCL_RET_OK != ret) {
+      return ret;  // error already set
+    }
+    ret = rcl_validate_topic_name(replacement, &validation_result, NULL);
+    if (RCL_RET_OK != ret) {
+      return ret;  // error already set
+    }
+    if (RCL_TOPIC_NAME_VALID != validation_result) {
+      RCL_SET_ERROR_MSG("remapped topic name is invalid");
+      return RCL_RET_TOPIC_NAME_INVALID;
+    }
+    ret = _rcl_name_resolver_expand(resolver, replacement, buffer, buffer_size);
+    if (RCL_RET_OK != ret) {
+      return ret;  // error already set
+    }
+  }
+
+  rmw_ret_t rmw_ret = rmw_validate_full_topic_name(buffer, &validation_result, NULL);
+  if (RMW_RET_OK != rmw_ret) {
+    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+    return RCL_RET_ERROR;
+  }
+  if (RMW_TOPIC_VALID != validation_result) {
+    RCL_SET_ERROR_MSG(rmw_full_topic_name_validation_result_string(validation_result));
+    return RCL_RET_TOPIC_NAME_INVALID;
+  }
+  return RCL_RET_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
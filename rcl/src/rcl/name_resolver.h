@@ -0,0 +1,118 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__NAME_RESOLVER_H_
+#define RCL__NAME_RESOLVER_H_
+
+#include <stddef.h>
+
+#include "rcl/node.h"
+#include "rcl/types.h"
+#include "rcl/visibility_control.h"
+#include "rmw/validate_full_topic_name.h"
+
+#include "./remap_impl.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// Size of a buffer which holds any valid topic or service name, with the terminating null.
+#define RCL_RESOLVED_NAME_BUFFER_SIZE (RMW_TOPIC_MAX_NAME_LENGTH + 1)
+
+/// What resolving the topic and service names of a node needs, computed once per node.
+typedef struct rcl_name_resolver_t
+{
+  /// Name of the node, the value of the `{node}` substitution.
+  const char * node_name;
+  size_t node_name_length;
+  /// Absolute namespace of the node, the value of the `{ns}` and `{namespace}` substitutions.
+  const char * node_namespace;
+  size_t node_namespace_length;
+  /// Result of validating the node name and namespace, returned for every name if not ok.
+  rcl_ret_t node_validation_ret;
+  /// Remap rules of the node, which also hold the default substitutions.
+  const rcl_remap_table_t * remap_table;
+} rcl_name_resolver_t;
+
+/// Return a rcl_name_resolver_t struct with members set to `NULL` or 0.
+RCL_LOCAL
+rcl_name_resolver_t
+rcl_get_zero_initialized_name_resolver(void);
+
+/// Validate the node name and namespace once for all names of a node.
+/**
+ * The resolver refers to the strings and the table, which must outlive it.
+ * A node name or namespace which fails validation does not fail this
+ * function, but every name resolved with the resolver instead.
+ *
+ * \param[out] resolver the resolver to be initialized
+ * \param[in] node_name the name of the node, after remapping
+ * \param[in] node_namespace the namespace of the node, after remapping
+ * \param[in] remap_table the remap table of the node
+ * \return `RCL_RET_OK` if the resolver was initialized, or
+ * \return `RCL_RET_ERROR` if the names could not be validated.
+ */
+RCL_LOCAL
+rcl_ret_t
+rcl_name_resolver_init(
+  rcl_name_resolver_t * resolver,
+  const char * node_name,
+  const char * node_namespace,
+  const rcl_remap_table_t * remap_table);
+
+/// Expand, remap and validate a topic or service name in a single pass.
+/**
+ * Gives the same name as rcl_expand_topic_name() with the default
+ * substitutions, followed by remapping with the rule found by
+ * rcl_remap_table_find_entry() and rmw_validate_full_topic_name(), but
+ * writes it into the buffer without allocating memory.
+ * The node name and namespace are not validated again.
+ *
+ * A buffer of RCL_RESOLVED_NAME_BUFFER_SIZE bytes holds any valid name.
+ * An expanded name which does not fit in the buffer is reported as invalid,
+ * even if a remap rule would make it shorter.
+ *
+ * \param[in] resolver an initialized resolver
+ * \param[in] type RCL_TOPIC_REMAP or RCL_SERVICE_REMAP
+ * \param[in] input_name the name given for the entity
+ * \param[out] buffer the fully qualified, remapped name
+ * \param[in] buffer_size size of the buffer in bytes
+ * \return `RCL_RET_OK` if the name was resolved, or
+ * \return `RCL_RET_TOPIC_NAME_INVALID` if the name is invalid or too long, or
+ * \return `RCL_RET_UNKNOWN_SUBSTITUTION` if the name has an unknown substitution, or
+ * \return `RCL_RET_NODE_INVALID_NAME` if the node name is invalid, or
+ * \return `RCL_RET_NODE_INVALID_NAMESPACE` if the node namespace is invalid, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_LOCAL
+rcl_ret_t
+rcl_name_resolver_resolve(
+  const rcl_name_resolver_t * resolver,
+  rcl_remap_type_t type,
+  const char * input_name,
+  char * buffer,
+  size_t buffer_size);
+
+/// Return the resolver built by rcl_node_init(), or `NULL` if the node is invalid.
+RCL_LOCAL
+const rcl_name_resolver_t *
+rcl_node_get_name_resolver(const rcl_node_t * node);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__NAME_RESOLVER_H_
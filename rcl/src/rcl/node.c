@@ -43,13 +43,14 @@ extern "C"
 #include "rmw/validate_namespace.h"
 #include "rmw/validate_node_name.h"
 
+#include "./arguments_impl.h"
 #include "./common.h"
 #include "./context_impl.h"
-
-#define ROS_SECURITY_NODE_DIRECTORY_VAR_NAME "ROS_SECURITY_NODE_DIRECTORY"
-#define ROS_SECURITY_ROOT_DIRECTORY_VAR_NAME "ROS_SECURITY_ROOT_DIRECTORY"
-#define ROS_SECURITY_STRATEGY_VAR_NAME "ROS_SECURITY_STRATEGY"
-#define ROS_SECURITY_ENABLE_VAR_NAME "ROS_SECURITY_ENABLE"
+#include "./graph_cache.h"
+#include "./guard_condition_impl.h"
+#include "./name_resolver.h"
+#include "./security_index.h"
+#include "./tracing_impl.h"
 
 typedef struct rcl_node_impl_t
 {
@@ -58,6 +59,10 @@ typedef struct rcl_node_impl_t
   rmw_node_t * rmw_node_handle;
   rcl_guard_condition_t * graph_guard_condition;
   const char * logger_name;
+  /// Topic and service remap rules applying to this node.
+  rcl_remap_table_t remap_table;
+  /// Resolves the topic and service names of this node's entities.
+  rcl_name_resolver_t name_resolver;
 } rcl_node_impl_t;
 
 
@@ -189,16 +194,41 @@ rcl_get_zero_initialized_node()
   return null_node;
 }
 
-rcl_ret_t
-rcl_node_init(
+/// Work shared by the nodes initialized together, see rcl_node_init_many().
+typedef struct rcl_node_init_shared_t
+{
+  /// False if no remap rule can change the name or namespace of a node.
+  bool may_remap;
+  /// Namespace, as given by the caller, which passed validation last.
+  const char * validated_namespace;
+} rcl_node_init_shared_t;
+
+/// Return true if any of the remap rules applies to node names or namespaces.
+static bool
+_rcl_node_arguments_remap_nodes(const rcl_arguments_t * arguments)
+{
+  if (NULL == arguments->impl) {
+    return false;
+  }
+  int i;
+  for (i = 0; i < arguments->impl->num_remap_rules; ++i) {
+    if (arguments->impl->remap_rules[i].type & (RCL_NODENAME_REMAP | RCL_NAMESPACE_REMAP)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static rcl_ret_t
+_rcl_node_init(
   rcl_node_t * node,
   const char * name,
   const char * namespace_,
   rcl_context_t * context,
-  const rcl_node_options_t * options)
+  const rcl_node_options_t * options,
+  rcl_node_init_shared_t * shared)
 {
   size_t domain_id = 0;
-  const char * ros_domain_id;
   const rmw_guard_condition_t * rmw_graph_guard_condition = NULL;
   rcl_guard_condition_options_t graph_guard_condition_options =
     rcl_guard_condition_get_default_options();
@@ -261,19 +291,22 @@ rcl_node_init(
       ret = RCL_RET_BAD_ALLOC; goto cleanup);
     should_free_local_namespace_ = true;
   }
-  // Make sure the node namespace is valid.
-  validation_result = 0;
-  ret = rmw_validate_namespace(local_namespace_, &validation_result, NULL);
-  if (ret != RMW_RET_OK) {
-    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
-    goto cleanup;
-  }
-  if (validation_result != RMW_NAMESPACE_VALID) {
-    const char * msg = rmw_namespace_validation_result_string(validation_result);
-    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("%s, result: %d", msg, validation_result);
+  // Make sure the node namespace is valid, unless it was just validated for another node.
+  if (NULL == shared->validated_namespace || 0 != strcmp(namespace_, shared->validated_namespace)) {
+    validation_result = 0;
+    ret = rmw_validate_namespace(local_namespace_, &validation_result, NULL);
+    if (ret != RMW_RET_OK) {
+      RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+      goto cleanup;
+    }
+    if (validation_result != RMW_NAMESPACE_VALID) {
+      const char * msg = rmw_namespace_validation_result_string(validation_result);
+      RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("%s, result: %d", msg, validation_result);
 
-    ret = RCL_RET_NODE_INVALID_NAMESPACE;
-    goto cleanup;
+      ret = RCL_RET_NODE_INVALID_NAMESPACE;
+      goto cleanup;
+    }
+    shared->validated_namespace = namespace_;
   }
 
   // Allocate space for the implementation struct.
@@ -283,6 +316,8 @@ rcl_node_init(
   node->impl->rmw_node_handle = NULL;
   node->impl->graph_guard_condition = NULL;
   node->impl->logger_name = NULL;
+  node->impl->remap_table = rcl_get_zero_initialized_remap_table();
+  node->impl->name_resolver = rcl_get_zero_initialized_name_resolver();
   node->impl->options = rcl_node_get_default_options();
   node->context = context;
   // Initialize node impl.
@@ -292,30 +327,32 @@ rcl_node_init(
   }
 
   // Remap the node name and namespace if remap rules are given
-  rcl_arguments_t * global_args = NULL;
-  if (node->impl->options.use_global_arguments) {
-    global_args = &(node->context->global_arguments);
-  }
-  ret = rcl_remap_node_name(
-    &(node->impl->options.arguments), global_args, name, *allocator,
-    &remapped_node_name);
-  if (RCL_RET_OK != ret) {
-    goto fail;
-  } else if (NULL != remapped_node_name) {
-    name = remapped_node_name;
-  }
-  char * remapped_namespace = NULL;
-  ret = rcl_remap_node_namespace(
-    &(node->impl->options.arguments), global_args, name,
-    *allocator, &remapped_namespace);
-  if (RCL_RET_OK != ret) {
-    goto fail;
-  } else if (NULL != remapped_namespace) {
-    if (should_free_local_namespace_) {
-      allocator->deallocate((char *)local_namespace_, allocator->state);
+  if (shared->may_remap) {
+    rcl_arguments_t * global_args = NULL;
+    if (node->impl->options.use_global_arguments) {
+      global_args = &(node->context->global_arguments);
+    }
+    ret = rcl_remap_node_name(
+      &(node->impl->options.arguments), global_args, name, *allocator,
+      &remapped_node_name);
+    if (RCL_RET_OK != ret) {
+      goto fail;
+    } else if (NULL != remapped_node_name) {
+      name = remapped_node_name;
+    }
+    char * remapped_namespace = NULL;
+    ret = rcl_remap_node_namespace(
+      &(node->impl->options.arguments), global_args, name,
+      *allocator, &remapped_namespace);
+    if (RCL_RET_OK != ret) {
+      goto fail;
+    } else if (NULL != remapped_namespace) {
+      if (should_free_local_namespace_) {
+        allocator->deallocate((char *)local_namespace_, allocator->state);
+      }
+      should_free_local_namespace_ = true;
+      local_namespace_ = remapped_namespace;
     }
-    should_free_local_namespace_ = true;
-    local_namespace_ = remapped_namespace;
   }
 
   // node logger name
@@ -324,19 +361,15 @@ rcl_node_init(
     node->impl->logger_name, "creating logger name failed", goto fail);
 
   // node rmw_node_handle
+  const rcl_context_env_t * env = &(node->context->impl->env);
   if (node->impl->options.domain_id == RCL_NODE_OPTIONS_DEFAULT_DOMAIN_ID) {
-    // Find the domain ID set by the environment.
-    ret = rcl_impl_getenv("ROS_DOMAIN_ID", &ros_domain_id);
-    if (ret != RCL_RET_OK) {
+    // Use the domain ID set by the environment, read by rcl_init().
+    if (env->invalid_domain_id) {
+      RCL_SET_ERROR_MSG("failed to interpret ROS_DOMAIN_ID as integral number");
       goto fail;
     }
-    if (ros_domain_id) {
-      unsigned long number = strtoul(ros_domain_id, NULL, 0);  // NOLINT(runtime/int)
-      if (number == ULONG_MAX) {
-        RCL_SET_ERROR_MSG("failed to interpret ROS_DOMAIN_ID as integral number");
-        goto fail;
-      }
-      domain_id = (size_t)number;
+    if (env->has_domain_id) {
+      domain_id = env->domain_id;
     }
   } else {
     domain_id = node->impl->options.domain_id;
@@ -345,39 +378,20 @@ rcl_node_init(
   node->impl->actual_domain_id = domain_id;
   RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Using domain ID of '%zu'", domain_id);
 
-  const char * ros_security_enable = NULL;
-  const char * ros_enforce_security = NULL;
-
-  if (rcutils_get_env(ROS_SECURITY_ENABLE_VAR_NAME, &ros_security_enable)) {
-    RCL_SET_ERROR_MSG(
-      "Environment variable " RCUTILS_STRINGIFY(ROS_SECURITY_ENABLE_VAR_NAME)
-      " could not be read");
-    ret = RCL_RET_ERROR;
-    goto fail;
-  }
-
-  bool use_security = (0 == strcmp(ros_security_enable, "true"));
+  bool use_security = env->use_security;
   RCUTILS_LOG_DEBUG_NAMED(
     ROS_PACKAGE_NAME, "Using security: %s", use_security ? "true" : "false");
 
-  if (rcutils_get_env(ROS_SECURITY_STRATEGY_VAR_NAME, &ros_enforce_security)) {
-    RCL_SET_ERROR_MSG(
-      "Environment variable " RCUTILS_STRINGIFY(ROS_SECURITY_STRATEGY_VAR_NAME)
-      " could not be read");
-    ret = RCL_RET_ERROR;
-    goto fail;
-  }
-
   rmw_node_security_options_t node_security_options =
     rmw_get_zero_initialized_node_security_options();
-  node_security_options.enforce_security = (0 == strcmp(ros_enforce_security, "Enforce")) ?
-    RMW_SECURITY_ENFORCEMENT_ENFORCE : RMW_SECURITY_ENFORCEMENT_PERMISSIVE;
+  node_security_options.enforce_security = env->enforce_security;
 
   if (!use_security) {
     node_security_options.enforce_security = RMW_SECURITY_ENFORCEMENT_PERMISSIVE;
   } else {  // if use_security
-    // File discovery magic here
-    const char * node_secure_root = rcl_get_secure_root(name, local_namespace_, allocator);
+    // Directories were scanned by rcl_init(), the index owns the path.
+    const char * node_secure_root = rcl_security_index_find(
+      &(node->context->impl->security_index), name, local_namespace_);
     if (node_secure_root) {
       node_security_options.security_root_path = node_secure_root;
     } else {
@@ -399,6 +413,29 @@ rcl_node_init(
 
   RCL_CHECK_FOR_NULL_WITH_MSG(
     node->impl->rmw_node_handle, rmw_get_error_string().str, goto fail);
+  // Expand the topic and service rules once, for the entities of this node.
+  {
+    rcl_arguments_t * global_args = NULL;
+    if (node->impl->options.use_global_arguments) {
+      global_args = &(node->context->global_arguments);
+    }
+    ret = rcl_remap_table_init(
+      &(node->impl->remap_table), &(node->impl->options.arguments), global_args,
+      name, local_namespace_, *allocator);
+    if (ret != RCL_RET_OK) {
+      // error message already set
+      fail_ret = ret;
+      goto fail;
+    }
+  }
+  // The names are owned by the rmw node, which lives as long as the resolver.
+  ret = rcl_name_resolver_init(
+    &(node->impl->name_resolver), node->impl->rmw_node_handle->name,
+    node->impl->rmw_node_handle->namespace_, &(node->impl->remap_table));
+  if (ret != RCL_RET_OK) {
+    // error message already set
+    goto fail;
+  }
   // graph guard condition
   rmw_graph_guard_condition = rmw_node_get_graph_guard_condition(node->impl->rmw_node_handle);
   RCL_CHECK_FOR_NULL_WITH_MSG(
@@ -421,7 +458,17 @@ rcl_node_init(
     // error message already set
     goto fail;
   }
+  // Let rcl_wait() report changes of the graph to the context's graph cache.
+  node->impl->graph_guard_condition->impl->is_graph_guard_condition = true;
+  ret = rcl_context_add_node_graph_guard_condition(context, rmw_graph_guard_condition);
+  if (ret != RCL_RET_OK) {
+    // error message already set
+    fail_ret = ret;
+    goto fail;
+  }
+  rcl_graph_cache_invalidate_for_node(node);
   RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Node initialized");
+  RCL_TRACEPOINT(RCL_TRACE_NODE_INIT, node, 0);
   ret = RCL_RET_OK;
   goto cleanup;
 fail:
@@ -448,6 +495,12 @@ fail:
       }
       allocator->deallocate(node->impl->graph_guard_condition, allocator->state);
     }
+    if (RCL_RET_OK != rcl_remap_table_fini(&(node->impl->remap_table))) {
+      RCUTILS_LOG_ERROR_NAMED(
+        ROS_PACKAGE_NAME,
+        "failed to fini remap table in error recovery: %s", rcl_get_error_string().str
+      );
+    }
     if (NULL != node->impl->options.arguments.impl) {
       ret = rcl_arguments_fini(&(node->impl->options.arguments));
       if (ret != RCL_RET_OK) {
@@ -474,6 +527,64 @@ cleanup:
   return ret;
 }
 
+rcl_ret_t
+rcl_node_init(
+  rcl_node_t * node,
+  const char * name,
+  const char * namespace_,
+  rcl_context_t * context,
+  const rcl_node_options_t * options)
+{
+  rcl_node_init_shared_t shared = {true, NULL};
+  return _rcl_node_init(node, name, namespace_, context, options, &shared);
+}
+
+rcl_ret_t
+rcl_node_init_many(
+  rcl_node_t * nodes,
+  size_t count,
+  const char * const * names,
+  const char * const * namespaces,
+  rcl_context_t * context,
+  const rcl_node_options_t * options)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(options, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ALLOCATOR_WITH_MSG(
+    &options->allocator, "invalid allocator", return RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(nodes, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(names, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(namespaces, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    context, "given context in options is NULL", return RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_context_is_valid(context)) {
+    RCL_SET_ERROR_MSG(
+      "the given context is not valid, "
+      "either rcl_init() was not called or rcl_shutdown() was called.");
+    return RCL_RET_NOT_INIT;
+  }
+  // The remap rules are the same for all nodes, look for node name and namespace rules once.
+  rcl_node_init_shared_t shared;
+  shared.may_remap = _rcl_node_arguments_remap_nodes(&options->arguments) ||
+    (options->use_global_arguments && _rcl_node_arguments_remap_nodes(&context->global_arguments));
+  shared.validated_namespace = NULL;
+  size_t i;
+  for (i = 0; i < count; ++i) {
+    rcl_ret_t ret = _rcl_node_init(&nodes[i], names[i], namespaces[i], context, options, &shared);
+    if (RCL_RET_OK != ret) {
+      // Finalize the nodes initialized so far, keeping the error of the one which failed.
+      rcl_error_string_t error = rcl_get_error_string();
+      while (i-- > 0) {
+        if (RCL_RET_OK != rcl_node_fini(&nodes[i])) {
+          rcl_reset_error();
+        }
+      }
+      RCL_SET_ERROR_MSG(error.str);
+      return ret;
+    }
+  }
+  return RCL_RET_OK;
+}
+
 rcl_ret_t
 rcl_node_fini(rcl_node_t * node)
 {
@@ -483,6 +594,10 @@ rcl_node_fini(rcl_node_t * node)
     // Repeat calls to fini or calling fini on a zero initialized node is ok.
     return RCL_RET_OK;
   }
+  if (NULL != node->context && NULL != node->context->impl) {
+    rcl_context_remove_node_graph_guard_condition(
+      node->context, node->impl->graph_guard_condition->impl->rmw_handle);
+  }
   rcl_allocator_t allocator = node->impl->options.allocator;
   rcl_ret_t result = RCL_RET_OK;
   rmw_ret_t rmw_ret = rmw_destroy_node(node->impl->rmw_node_handle);
@@ -490,6 +605,8 @@ rcl_node_fini(rcl_node_t * node)
     RCL_SET_ERROR_MSG(rmw_get_error_string().str);
     result = RCL_RET_ERROR;
   }
+  // Only after the node is gone, so a refresh in between can not cache it again.
+  rcl_graph_cache_invalidate_for_node(node);
   rcl_ret_t rcl_ret = rcl_guard_condition_fini(node->impl->graph_guard_condition);
   if (rcl_ret != RCL_RET_OK) {
     RCL_SET_ERROR_MSG(rmw_get_error_string().str);
@@ -498,6 +615,9 @@ rcl_node_fini(rcl_node_t * node)
   allocator.deallocate(node->impl->graph_guard_condition, allocator.state);
   // assuming that allocate and deallocate are ok since they are checked in init
   allocator.deallocate((char *)node->impl->logger_name, allocator.state);
+  if (RCL_RET_OK != rcl_remap_table_fini(&(node->impl->remap_table))) {
+    result = RCL_RET_ERROR;  // error already set
+  }
   if (NULL != node->impl->options.arguments.impl) {
     rcl_ret_t ret = rcl_arguments_fini(&(node->impl->options.arguments));
     if (ret != RCL_RET_OK) {
@@ -596,6 +716,24 @@ rcl_node_get_options(const rcl_node_t * node)
   return &node->impl->options;
 }
 
+const rcl_remap_table_t *
+rcl_node_get_remap_table(const rcl_node_t * node)
+{
+  if (!rcl_node_is_valid_except_context(node)) {
+    return NULL;  // error already set
+  }
+  return &node->impl->remap_table;
+}
+
+const rcl_name_resolver_t *
+rcl_node_get_name_resolver(const rcl_node_t * node)
+{
+  if (!rcl_node_is_valid_except_context(node)) {
+    return NULL;  // error already set
+  }
+  return &node->impl->name_resolver;
+}
+
 rcl_ret_t
 rcl_node_get_domain_id(const rcl_node_t * node, size_t * domain_id)
 {
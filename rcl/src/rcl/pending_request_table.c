@@ -0,0 +1,322 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./pending_request_table.h"
+
+#include <string.h>
+
+#include "rcl/error_handling.h"
+
+rcl_pending_request_table_t
+rcl_get_zero_initialized_pending_request_table()
+{
+  static rcl_pending_request_table_t null_table = {0};
+  return null_table;
+}
+
+rcl_ret_t
+rcl_pending_request_table_init(
+  rcl_pending_request_table_t * table,
+  size_t capacity,
+  rcl_allocator_t allocator)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(table, RCL_RET_INVALID_ARGUMENT);
+  *table = rcl_get_zero_initialized_pending_request_table();
+  if (0 == capacity || capacity > SIZE_MAX / (4 * sizeof(rcl_pending_request_t))) {
+    RCL_SET_ERROR_MSG("invalid pending request capacity");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  // Keep the load factor at or below one half so probe sequences stay short.
+  size_t slot_count = 1;
+  while (slot_count < 2 * capacity) {
+    slot_count <<= 1;
+  }
+  table->slots = (rcl_pending_request_t *)allocator.zero_allocate(
+    slot_count, sizeof(rcl_pending_request_t), allocator.state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    table->slots, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  table->heap = (size_t *)allocator.allocate(sizeof(size_t) * capacity, allocator.state);
+  if (NULL == table->heap) {
+    allocator.deallocate(table->slots, allocator.state);
+    table->slots = NULL;
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    return RCL_RET_BAD_ALLOC;
+  }
+  if (RCL_RET_OK != rcl_mutex_init(&table->lock)) {
+    allocator.deallocate(table->heap, allocator.state);
+    allocator.deallocate(table->slots, allocator.state);
+    table->heap = NULL;
+    table->slots = NULL;
+    return RCL_RET_ERROR;  // error already set
+  }
+  table->slot_mask = slot_count - 1;
+  table->capacity = capacity;
+  table->allocator = allocator;
+  return RCL_RET_OK;
+}
+
+void
+rcl_pending_request_table_fini(rcl_pending_request_table_t * table)
+{
+  if (NULL == table->slots) {
+    return;
+  }
+  rcl_mutex_fini(&table->lock);
+  table->allocator.deallocate(table->slots, table->allocator.state);
+  table->allocator.deallocate(table->heap, table->allocator.state);
+  table->slots = NULL;
+  table->heap = NULL;
+  table->capacity = 0;
+  table->size = 0;
+  table->heap_size = 0;
+}
+
+bool
+rcl_pending_request_table_is_enabled(const rcl_pending_request_table_t * table)
+{
+  return NULL != table->slots;
+}
+
+static size_t
+_rcl_pending_request_home_slot(const rcl_pending_request_table_t * table, int64_t sequence_number)
+{
+  // Fibonacci hashing, sequence numbers are consecutive so they need to be spread out.
+  return (size_t)(((uint64_t)sequence_number * 0x9E3779B97F4A7C15ULL) >> 32) & table->slot_mask;
+}
+
+static bool
+_rcl_pending_request_heap_less(
+  const rcl_pending_request_table_t * table, size_t heap_a, size_t heap_b)
+{
+  return table->slots[table->heap[heap_a]].deadline < table->slots[table->heap[heap_b]].deadline;
+}
+
+static void
+_rcl_pending_request_heap_swap(rcl_pending_request_table_t * table, size_t heap_a, size_t heap_b)
+{
+  size_t slot_a = table->heap[heap_a];
+  table->heap[heap_a] = table->heap[heap_b];
+  table->heap[heap_b] = slot_a;
+  table->slots[table->heap[heap_a]].heap_index = heap_a;
+  table->slots[table->heap[heap_b]].heap_index = heap_b;
+}
+
+static void
+_rcl_pending_request_heap_sift_up(rcl_pending_request_table_t * table, size_t position)
+{
+  while (position > 0) {
+    size_t parent = (position - 1) / 2;
+    if (!_rcl_pending_request_heap_less(table, position, parent)) {
+      break;
+    }
+    _rcl_pending_request_heap_swap(table, position, parent);
+    position = parent;
+  }
+}
+
+static void
+_rcl_pending_request_heap_sift_down(rcl_pending_request_table_t * table, size_t position)
+{
+  for (;;) {
+    size_t smallest = position;
+    size_t left = 2 * position + 1;
+    size_t right = left + 1;
+    if (left < table->heap_size && _rcl_pending_request_heap_less(table, left, smallest)) {
+      smallest = left;
+    }
+    if (right < table->heap_size && _rcl_pending_request_heap_less(table, right, smallest)) {
+      smallest = right;
+    }
+    if (smallest == position) {
+      break;
+    }
+    _rcl_pending_request_heap_swap(table, position, smallest);
+    position = smallest;
+  }
+}
+
+static void
+_rcl_pending_request_heap_remove(rcl_pending_request_table_t * table, size_t position)
+{
+  --table->heap_size;
+  if (position == table->heap_size) {
+    return;
+  }
+  table->heap[position] = table->heap[table->heap_size];
+  table->slots[table->heap[position]].heap_index = position;
+  _rcl_pending_request_heap_sift_down(table, position);
+  _rcl_pending_request_heap_sift_up(table, position);
+}
+
+/// Return the slot holding the sequence number, or SIZE_MAX if it is not stored.
+static size_t
+_rcl_pending_request_find(const rcl_pending_request_table_t * table, int64_t sequence_number)
+{
+  size_t slot = _rcl_pending_request_home_slot(table, sequence_number);
+  // The load factor is at most one half, so an empty slot is always reached.
+  while (table->slots[slot].occupied) {
+    if (table->slots[slot].sequence_number == sequence_number) {
+      return slot;
+    }
+    slot = (slot + 1) & table->slot_mask;
+  }
+  return SIZE_MAX;
+}
+
+/// Empty a slot, shifting later entries of its probe sequence back so no tombstones are needed.
+static void
+_rcl_pending_request_erase_slot(rcl_pending_request_table_t * table, size_t hole)
+{
+  if (SIZE_MAX != table->slots[hole].heap_index) {
+    _rcl_pending_request_heap_remove(table, table->slots[hole].heap_index);
+  }
+  size_t slot = hole;
+  for (;;) {
+    slot = (slot + 1) & table->slot_mask;
+    if (!table->slots[slot].occupied) {
+      break;
+    }
+    size_t home = _rcl_pending_request_home_slot(table, table->slots[slot].sequence_number);
+    // An entry whose home lies cyclically in (hole, slot] is still reachable, leave it.
+    bool reachable = hole <= slot ?
+      (hole < home && home <= slot) :
+      (hole < home || home <= slot);
+    if (reachable) {
+      continue;
+    }
+    table->slots[hole] = table->slots[slot];
+    if (SIZE_MAX != table->slots[hole].heap_index) {
+      table->heap[table->slots[hole].heap_index] = hole;
+    }
+    hole = slot;
+  }
+  table->slots[hole].occupied = false;
+  --table->size;
+}
+
+bool
+rcl_pending_request_table_begin_send(rcl_pending_request_table_t * table)
+{
+  rcl_mutex_lock(&table->lock);
+  if (table->size < table->capacity) {
+    return true;
+  }
+  rcl_mutex_unlock(&table->lock);
+  return false;
+}
+
+void
+rcl_pending_request_table_cancel_send(rcl_pending_request_table_t * table)
+{
+  rcl_mutex_unlock(&table->lock);
+}
+
+void
+rcl_pending_request_table_end_send(
+  rcl_pending_request_table_t * table,
+  int64_t sequence_number,
+  rcutils_time_point_value_t deadline,
+  void * user_data)
+{
+  size_t slot = _rcl_pending_request_find(table, sequence_number);
+  if (SIZE_MAX != slot) {
+    // The middleware reused a sequence number, forget the old request.
+    _rcl_pending_request_erase_slot(table, slot);
+  }
+  slot = _rcl_pending_request_home_slot(table, sequence_number);
+  while (table->slots[slot].occupied) {
+    slot = (slot + 1) & table->slot_mask;
+  }
+  rcl_pending_request_t * request = &table->slots[slot];
+  request->sequence_number = sequence_number;
+  request->deadline = deadline;
+  request->user_data = user_data;
+  request->heap_index = SIZE_MAX;
+  request->occupied = true;
+  ++table->size;
+  if (RCL_PENDING_REQUEST_NO_DEADLINE != deadline) {
+    request->heap_index = table->heap_size;
+    table->heap[table->heap_size++] = slot;
+    _rcl_pending_request_heap_sift_up(table, request->heap_index);
+  }
+  rcl_mutex_unlock(&table->lock);
+}
+
+bool
+rcl_pending_request_table_remove(
+  rcl_pending_request_table_t * table,
+  int64_t sequence_number,
+  void ** user_data)
+{
+  rcl_mutex_lock(&table->lock);
+  size_t slot = _rcl_pending_request_find(table, sequence_number);
+  bool found = SIZE_MAX != slot;
+  if (found) {
+    *user_data = table->slots[slot].user_data;
+    _rcl_pending_request_erase_slot(table, slot);
+  }
+  rcl_mutex_unlock(&table->lock);
+  return found;
+}
+
+bool
+rcl_pending_request_table_take_expired(
+  rcl_pending_request_table_t * table,
+  rcutils_time_point_value_t now,
+  int64_t * sequence_number,
+  void ** user_data)
+{
+  rcl_mutex_lock(&table->lock);
+  bool expired = table->heap_size > 0 && table->slots[table->heap[0]].deadline <= now;
+  if (expired) {
+    size_t slot = table->heap[0];
+    *sequence_number = table->slots[slot].sequence_number;
+    *user_data = table->slots[slot].user_data;
+    _rcl_pending_request_erase_slot(table, slot);
+  }
+  rcl_mutex_unlock(&table->lock);
+  return expired;
+}
+
+bool
+rcl_pending_request_table_get_next_deadline(
+  rcl_pending_request_table_t * table,
+  rcutils_time_point_value_t * deadline)
+{
+  rcl_mutex_lock(&table->lock);
+  bool has_deadline = table->heap_size > 0;
+  if (has_deadline) {
+    *deadline = table->slots[table->heap[0]].deadline;
+  }
+  rcl_mutex_unlock(&table->lock);
+  return has_deadline;
+}
+
+size_t
+rcl_pending_request_table_get_size(rcl_pending_request_table_t * table)
+{
+  rcl_mutex_lock(&table->lock);
+  size_t size = table->size;
+  rcl_mutex_unlock(&table->lock);
+  return size;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,190 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__PENDING_REQUEST_TABLE_H_
+#define RCL__PENDING_REQUEST_TABLE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcl/allocator.h"
+#include "rcl/types.h"
+#include "rcl/visibility_control.h"
+#include "rcutils/time.h"
+
+#include "./mutex.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// Deadline value of a pending request which never expires.
+#define RCL_PENDING_REQUEST_NO_DEADLINE -1
+
+/// One slot of the pending request table.
+typedef struct rcl_pending_request_t
+{
+  int64_t sequence_number;
+  /// Steady time at which the request expires, or RCL_PENDING_REQUEST_NO_DEADLINE.
+  rcutils_time_point_value_t deadline;
+  void * user_data;
+  /// Position in the deadline heap, or SIZE_MAX if the request has no deadline.
+  size_t heap_index;
+  bool occupied;
+} rcl_pending_request_t;
+
+/// Requests sent by a client which did not get a response yet.
+/**
+ * The requests are stored in an open addressing hash table with linear
+ * probing, keyed by sequence number, so a response is matched in constant
+ * time.
+ * Requests with a deadline are additionally referenced from a binary min-heap
+ * ordered by deadline, so the next deadline is found in constant time and an
+ * expired request is removed in logarithmic time.
+ *
+ * All memory is allocated in rcl_pending_request_table_init(), the other
+ * functions do not allocate.
+ * All functions but init and fini may be called concurrently, they are
+ * serialized by a mutex.
+ * A sender holds the mutex while the middleware sends the request, see
+ * rcl_pending_request_table_begin_send(), so a response taken concurrently
+ * is only looked up once its request is stored.
+ */
+typedef struct rcl_pending_request_table_t
+{
+  /// Hash table slots, `NULL` if the table is disabled.
+  rcl_pending_request_t * slots;
+  /// Number of slots minus one, the number of slots is a power of two.
+  size_t slot_mask;
+  /// Maximum number of pending requests.
+  size_t capacity;
+  /// Number of stored requests.
+  size_t size;
+  /// Slot indices of the requests with a deadline, ordered as a min-heap.
+  size_t * heap;
+  size_t heap_size;
+  rcl_mutex_t lock;
+  rcl_allocator_t allocator;
+} rcl_pending_request_table_t;
+
+/// Return a disabled table, for which rcl_pending_request_table_is_enabled() is false.
+RCL_LOCAL
+rcl_pending_request_table_t
+rcl_get_zero_initialized_pending_request_table(void);
+
+/// Allocate a table for up to `capacity` pending requests.
+/**
+ * \return `RCL_RET_OK` if the table was initialized, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if the capacity is 0 or too large, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if the mutex could not be created.
+ */
+RCL_LOCAL
+rcl_ret_t
+rcl_pending_request_table_init(
+  rcl_pending_request_table_t * table,
+  size_t capacity,
+  rcl_allocator_t allocator);
+
+/// Free the table's memory, safe to call on a zero initialized table.
+RCL_LOCAL
+void
+rcl_pending_request_table_fini(rcl_pending_request_table_t * table);
+
+/// Return true if the table was initialized.
+RCL_LOCAL
+bool
+rcl_pending_request_table_is_enabled(const rcl_pending_request_table_t * table);
+
+/// Lock the table for sending a request, if there is room for one more.
+/**
+ * The middleware only assigns the sequence number while sending, so the
+ * request can not be stored beforehand.
+ * Instead the table stays locked until the request is stored by
+ * rcl_pending_request_table_end_send(), or until the send failed and
+ * rcl_pending_request_table_cancel_send() is called, so that a concurrent
+ * rcl_pending_request_table_remove() for its response waits for it.
+ *
+ * \return `true` if the table was locked, `false` if it is full, in which
+ *   case it is not locked.
+ */
+RCL_LOCAL
+bool
+rcl_pending_request_table_begin_send(rcl_pending_request_table_t * table);
+
+/// Unlock the table after the request could not be sent.
+RCL_LOCAL
+void
+rcl_pending_request_table_cancel_send(rcl_pending_request_table_t * table);
+
+/// Store the sent request and unlock the table.
+/**
+ * A request with a sequence number which is already stored replaces the
+ * stored one.
+ */
+RCL_LOCAL
+void
+rcl_pending_request_table_end_send(
+  rcl_pending_request_table_t * table,
+  int64_t sequence_number,
+  rcutils_time_point_value_t deadline,
+  void * user_data);
+
+/// Remove the request with the given sequence number.
+/**
+ * \return `true` and the request's user data if it was pending, otherwise
+ *   `false`, e.g. if it expired already.
+ */
+RCL_LOCAL
+bool
+rcl_pending_request_table_remove(
+  rcl_pending_request_table_t * table,
+  int64_t sequence_number,
+  void ** user_data);
+
+/// Remove the request with the earliest deadline if that deadline is not after `now`.
+/**
+ * \return `true` and the sequence number and user data of the expired
+ *   request, or `false` if no request expired.
+ */
+RCL_LOCAL
+bool
+rcl_pending_request_table_take_expired(
+  rcl_pending_request_table_t * table,
+  rcutils_time_point_value_t now,
+  int64_t * sequence_number,
+  void ** user_data);
+
+/// Get the earliest deadline of the pending requests.
+/**
+ * \return `true` and the deadline, or `false` if no request has a deadline.
+ */
+RCL_LOCAL
+bool
+rcl_pending_request_table_get_next_deadline(
+  rcl_pending_request_table_t * table,
+  rcutils_time_point_value_t * deadline);
+
+/// Return the number of pending requests.
+RCL_LOCAL
+size_t
+rcl_pending_request_table_get_size(rcl_pending_request_table_t * table);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__PENDING_REQUEST_TABLE_H_
@@ -22,23 +22,39 @@ extern "C"
 #include <stdio.h>
 #include <string.h>
 
+#include "./allocation_audit_impl.h"
 #include "./common.h"
+#include "./entity_pool.h"
+#include "./entity_statistics_impl.h"
+#include "./graph_cache.h"
+#include "./name_resolver.h"
+#include "./tracing_impl.h"
 #include "rcl/allocator.h"
 #include "rcl/error_handling.h"
-#include "rcl/expand_topic_name.h"
-#include "rcl/remap.h"
 #include "rcutils/logging_macros.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/time.h"
 #include "rmw/error_handling.h"
 #include "rmw/rmw.h"
-#include "rmw/validate_full_topic_name.h"
 
 typedef struct rcl_publisher_impl_t
 {
   rcl_publisher_options_t options;
   rcl_context_t * context;
   rmw_publisher_t * rmw_handle;
+  rcl_entity_statistics_storage_t statistics;
+  /// Minimum time between two messages passed to the middleware, 0 if not rate limited.
+  rcutils_duration_value_t min_publish_period;
+  /// Steady time at which the last message was passed to the middleware.
+  atomic_int_least64_t last_publish_time;
+  /// Number of publish calls seen so far, used for decimation.
+  atomic_uint_least64_t publish_count;
+  /// The struct came from the publisher pool of the context.
+  bool is_pooled;
 } rcl_publisher_impl_t;
 
+const size_t rcl_publisher_impl_size = sizeof(rcl_publisher_impl_t);
+
 rcl_publisher_t
 rcl_get_zero_initialized_publisher()
 {
@@ -71,96 +87,38 @@ rcl_publisher_init(
   }
   RCL_CHECK_ARGUMENT_FOR_NULL(type_support, RCL_RET_INVALID_ARGUMENT);
   RCL_CHECK_ARGUMENT_FOR_NULL(topic_name, RCL_RET_INVALID_ARGUMENT);
+  if (!(options->max_publish_rate >= 0.0)) {
+    RCL_SET_ERROR_MSG("max_publish_rate must not be negative");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
   RCUTILS_LOG_DEBUG_NAMED(
     ROS_PACKAGE_NAME, "Initializing publisher for topic name '%s'", topic_name);
-  // Expand the given topic name.
-  rcutils_allocator_t rcutils_allocator = *allocator;  // implicit conversion to rcutils version
-  rcutils_string_map_t substitutions_map = rcutils_get_zero_initialized_string_map();
-  rcutils_ret_t rcutils_ret = rcutils_string_map_init(&substitutions_map, 0, rcutils_allocator);
-  if (rcutils_ret != RCUTILS_RET_OK) {
-    RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
-    if (rcutils_ret == RCUTILS_RET_BAD_ALLOC) {
-      return RCL_RET_BAD_ALLOC;
-    }
-    return RCL_RET_ERROR;
-  }
-  rcl_ret_t ret = rcl_get_default_topic_name_substitutions(&substitutions_map);
-  if (ret != RCL_RET_OK) {
-    rcutils_ret = rcutils_string_map_fini(&substitutions_map);
-    if (rcutils_ret != RCUTILS_RET_OK) {
-      RCUTILS_LOG_ERROR_NAMED(
-        ROS_PACKAGE_NAME,
-        "failed to fini string_map (%d) during error handling: %s",
-        rcutils_ret,
-        rcutils_get_error_string().str);
-    }
-    if (ret == RCL_RET_BAD_ALLOC) {
-      return ret;
-    }
-    return RCL_RET_ERROR;
-  }
-  char * expanded_topic_name = NULL;
-  char * remapped_topic_name = NULL;
-  ret = rcl_expand_topic_name(
-    topic_name,
-    rcl_node_get_name(node),
-    rcl_node_get_namespace(node),
-    &substitutions_map,
-    *allocator,
-    &expanded_topic_name);
-  rcutils_ret = rcutils_string_map_fini(&substitutions_map);
-  if (rcutils_ret != RCUTILS_RET_OK) {
-    RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
-    ret = RCL_RET_ERROR;
-    goto cleanup;
+  // Expand, remap and validate the given topic name.
+  const rcl_name_resolver_t * name_resolver = rcl_node_get_name_resolver(node);
+  if (NULL == name_resolver) {
+    return RCL_RET_ERROR;  // error already set
   }
+  char remapped_topic_name[RCL_RESOLVED_NAME_BUFFER_SIZE];
+  rcl_ret_t ret = rcl_name_resolver_resolve(
+    name_resolver, RCL_TOPIC_REMAP, topic_name, remapped_topic_name, sizeof(remapped_topic_name));
   if (ret != RCL_RET_OK) {
     if (ret == RCL_RET_TOPIC_NAME_INVALID || ret == RCL_RET_UNKNOWN_SUBSTITUTION) {
-      ret = RCL_RET_TOPIC_NAME_INVALID;
-    } else {
-      ret = RCL_RET_ERROR;
+      return RCL_RET_TOPIC_NAME_INVALID;
     }
-    goto cleanup;
-  }
-  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Expanded topic name '%s'", expanded_topic_name);
-
-  const rcl_node_options_t * node_options = rcl_node_get_options(node);
-  if (NULL == node_options) {
-    ret = RCL_RET_ERROR;
-    goto cleanup;
-  }
-  rcl_arguments_t * global_args = NULL;
-  if (node_options->use_global_arguments) {
-    global_args = &(node->context->global_arguments);
+    return RCL_RET_ERROR;
   }
-  ret = rcl_remap_topic_name(
-    &(node_options->arguments), global_args, expanded_topic_name,
-    rcl_node_get_name(node), rcl_node_get_namespace(node), *allocator, &remapped_topic_name);
+  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Resolved topic name '%s'", remapped_topic_name);
+  // Allocate space for the implementation struct.
+  void * impl = NULL;
+  bool is_pooled = false;
+  ret = rcl_context_allocate_entity(
+    node->context, RCL_ENTITY_POOL_PUBLISHER, sizeof(rcl_publisher_impl_t), allocator, &impl,
+    &is_pooled);
   if (RCL_RET_OK != ret) {
-    goto fail;
-  } else if (NULL == remapped_topic_name) {
-    remapped_topic_name = expanded_topic_name;
-    expanded_topic_name = NULL;
+    goto cleanup;  // error message already set
   }
-
-  // Validate the expanded topic name.
-  int validation_result;
-  rmw_ret_t rmw_ret = rmw_validate_full_topic_name(remapped_topic_name, &validation_result, NULL);
-  if (rmw_ret != RMW_RET_OK) {
-    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
-    ret = RCL_RET_ERROR;
-    goto cleanup;
-  }
-  if (validation_result != RMW_TOPIC_VALID) {
-    RCL_SET_ERROR_MSG(rmw_full_topic_name_validation_result_string(validation_result));
-    ret = RCL_RET_TOPIC_NAME_INVALID;
-    goto cleanup;
-  }
-  // Allocate space for the implementation struct.
-  publisher->impl = (rcl_publisher_impl_t *)allocator->allocate(
-    sizeof(rcl_publisher_impl_t), allocator->state);
-  RCL_CHECK_FOR_NULL_WITH_MSG(
-    publisher->impl, "allocating memory failed", ret = RCL_RET_BAD_ALLOC; goto cleanup);
+  publisher->impl = (rcl_publisher_impl_t *)impl;
+  publisher->impl->is_pooled = is_pooled;
   // Fill out implementation struct.
   // rmw handle (create rmw publisher)
   // TODO(wjwwood): pass along the allocator to rmw when it supports it
@@ -173,23 +131,30 @@ rcl_publisher_init(
     rmw_get_error_string().str, goto fail);
   // options
   publisher->impl->options = *options;
+  rcl_entity_statistics_storage_init(&publisher->impl->statistics);
+  // rate limiting and decimation state
+  publisher->impl->min_publish_period = 0;
+  if (options->max_publish_rate > 0.0) {
+    publisher->impl->min_publish_period =
+      (rcutils_duration_value_t)(RCUTILS_S_TO_NS(1.0) / options->max_publish_rate);
+  }
+  atomic_init(&publisher->impl->last_publish_time, 0);
+  atomic_init(&publisher->impl->publish_count, 0);
   RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Publisher initialized");
+  RCL_TRACEPOINT(RCL_TRACE_PUBLISHER_INIT, publisher, 0);
+  rcl_graph_cache_invalidate_for_node(node);
   // context
   publisher->impl->context = node->context;
   goto cleanup;
 fail:
   if (publisher->impl) {
-    allocator->deallocate(publisher->impl, allocator->state);
+    rcl_context_deallocate_entity(
+      node->context, RCL_ENTITY_POOL_PUBLISHER, publisher->impl,
+      sizeof(rcl_publisher_impl_t), allocator, publisher->impl->is_pooled);
   }
   ret = fail_ret;
   // Fall through to cleanup
 cleanup:
-  if (NULL != expanded_topic_name) {
-    allocator->deallocate(expanded_topic_name, allocator->state);
-  }
-  if (NULL != remapped_topic_name) {
-    allocator->deallocate(remapped_topic_name, allocator->state);
-  }
   return ret;
 }
 
@@ -215,7 +180,10 @@ rcl_publisher_fini(rcl_publisher_t * publisher, rcl_node_t * node)
       RCL_SET_ERROR_MSG(rmw_get_error_string().str);
       result = RCL_RET_ERROR;
     }
-    allocator.deallocate(publisher->impl, allocator.state);
+    rcl_context_deallocate_entity(
+      node->context, RCL_ENTITY_POOL_PUBLISHER, publisher->impl,
+      sizeof(rcl_publisher_impl_t), &allocator, publisher->impl->is_pooled);
+    rcl_graph_cache_invalidate_for_node(node);
   }
   RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Publisher finalized");
   return result;
@@ -229,23 +197,76 @@ rcl_publisher_get_default_options()
   // Must set the allocator and qos after because they are not a compile time constant.
   default_options.qos = rmw_qos_profile_default;
   default_options.allocator = rcl_get_default_allocator();
+  default_options.max_publish_rate = 0.0;
+  default_options.publish_decimation = 0;
   return default_options;
 }
 
-rcl_ret_t
-rcl_publish(const rcl_publisher_t * publisher, const void * ros_message)
+/// Return true if the next message should not be passed on to the middleware.
+/**
+ * Decimation is applied first, so that the rate limit only considers the
+ * messages which survived it.
+ * When several threads publish concurrently only one of them can claim a
+ * rate limited slot, the others drop their message.
+ */
+static bool
+_rcl_publisher_should_drop(rcl_publisher_impl_t * impl)
+{
+  const size_t decimation = impl->options.publish_decimation;
+  if (decimation > 1) {
+    uint64_t count = rcutils_atomic_fetch_add_uint64_t(&impl->publish_count, 1);
+    if (0 != count % decimation) {
+      return true;
+    }
+  }
+  if (0 == impl->min_publish_period) {
+    return false;
+  }
+  rcutils_time_point_value_t now;
+  if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+    // Without a time source, err on the side of delivering the message.
+    rcutils_reset_error();
+    return false;
+  }
+  int64_t last = rcutils_atomic_load_int64_t(&impl->last_publish_time);
+  if (0 != last && now - last < impl->min_publish_period) {
+    return true;
+  }
+  bool claimed;
+  rcutils_atomic_compare_exchange_strong(&impl->last_publish_time, claimed, &last, now);
+  return !claimed;
+}
+
+static rcl_ret_t
+_rcl_publish(const rcl_publisher_t * publisher, const void * ros_message)
 {
   if (!rcl_publisher_is_valid(publisher)) {
     return RCL_RET_PUBLISHER_INVALID;  // error already set
   }
   RCL_CHECK_ARGUMENT_FOR_NULL(ros_message, RCL_RET_INVALID_ARGUMENT);
+  if (_rcl_publisher_should_drop(publisher->impl)) {
+    return RCL_RET_OK;
+  }
+  RCL_TRACEPOINT(RCL_TRACE_PUBLISH, publisher, 0);
   if (rmw_publish(publisher->impl->rmw_handle, ros_message) != RMW_RET_OK) {
+    RCL_ENTITY_STATISTICS_RECORD_FAILURE(&publisher->impl->statistics);
     RCL_SET_ERROR_MSG(rmw_get_error_string().str);
     return RCL_RET_ERROR;
   }
+  RCL_ENTITY_STATISTICS_RECORD_MESSAGE(&publisher->impl->statistics, 0);
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_publish(const rcl_publisher_t * publisher, const void * ros_message)
+{
+  rcl_allocation_audit_api_t previous_api =
+    RCL_ALLOCATION_AUDIT_ENTER(RCL_ALLOCATION_AUDIT_PUBLISH);
+  rcl_ret_t ret = _rcl_publish(publisher, ros_message);
+  RCL_ALLOCATION_AUDIT_EXIT(previous_api);
+  return ret;
+}
+
 rcl_ret_t
 rcl_publish_serialized_message(
   const rcl_publisher_t * publisher, const rcl_serialized_message_t * serialized_message)
@@ -254,14 +275,21 @@ rcl_publish_serialized_message(
     return RCL_RET_PUBLISHER_INVALID;  // error already set
   }
   RCL_CHECK_ARGUMENT_FOR_NULL(serialized_message, RCL_RET_INVALID_ARGUMENT);
+  if (_rcl_publisher_should_drop(publisher->impl)) {
+    return RCL_RET_OK;
+  }
+  RCL_TRACEPOINT(RCL_TRACE_PUBLISH, publisher, serialized_message->buffer_length);
   rmw_ret_t ret = rmw_publish_serialized_message(publisher->impl->rmw_handle, serialized_message);
   if (ret != RMW_RET_OK) {
+    RCL_ENTITY_STATISTICS_RECORD_FAILURE(&publisher->impl->statistics);
     RCL_SET_ERROR_MSG(rmw_get_error_string().str);
     if (ret == RMW_RET_BAD_ALLOC) {
       return RCL_RET_BAD_ALLOC;
     }
     return RMW_RET_ERROR;
   }
+  RCL_ENTITY_STATISTICS_RECORD_MESSAGE(
+    &publisher->impl->statistics, serialized_message->buffer_length);
   return RCL_RET_OK;
 }
 
@@ -349,6 +377,17 @@ rcl_publisher_get_subscription_count(
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_publisher_get_statistics(
+  const rcl_publisher_t * publisher,
+  rcl_entity_statistics_t * statistics)
+{
+  if (!rcl_publisher_is_valid_except_context(publisher)) {
+    return RCL_RET_PUBLISHER_INVALID;  // error already set
+  }
+  return rcl_entity_statistics_storage_get(&publisher->impl->statistics, statistics);
+}
+
 #ifdef __cplusplus
 }
 #endif
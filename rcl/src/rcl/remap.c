@@ -14,11 +14,16 @@
 
 #include "rcl/remap.h"
 
+#include <stdint.h>
+#include <string.h>
+
 #include "./arguments_impl.h"
 #include "./remap_impl.h"
 #include "rcl/error_handling.h"
 #include "rcl/expand_topic_name.h"
 #include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/format_string.h"
 #include "rcutils/strdup.h"
 #include "rcutils/types/string_map.h"
 
@@ -35,6 +40,7 @@ rcl_remap_get_zero_initialized()
   rule.node_name = NULL;
   rule.match = NULL;
   rule.replacement = NULL;
+  rule.is_mapped = false;
   rule.allocator = rcutils_get_zero_initialized_allocator();
   return rule;
 }
@@ -50,6 +56,7 @@ rcl_remap_copy(
   rcl_allocator_t allocator = rule->allocator;
   rule_out->allocator = allocator;
   rule_out->type = rule->type;
+  rule_out->is_mapped = false;
   if (NULL != rule->node_name) {
     rule_out->node_name = rcutils_strdup(rule->node_name, allocator);
     if (NULL == rule_out->node_name) {
@@ -80,6 +87,12 @@ rcl_ret_t
 rcl_remap_fini(
   rcl_remap_t * rule)
 {
+  if (rule->is_mapped) {
+    rule->node_name = NULL;
+    rule->match = NULL;
+    rule->replacement = NULL;
+    rule->is_mapped = false;
+  }
   if (NULL != rule->node_name) {
     rule->allocator.deallocate(rule->node_name, rule->allocator.state);
     rule->node_name = NULL;
@@ -96,6 +109,217 @@ rcl_remap_fini(
   return RCL_RET_OK;
 }
 
+/// Text of a name matched by a wildcard, referred to by a back-reference.
+typedef struct rcl_remap_capture_t
+{
+  const char * start;
+  size_t length;
+} rcl_remap_capture_t;
+
+/// Return true if the match of a rule has wildcards, its tokens cannot contain '*' otherwise.
+static bool
+_rcl_remap_is_pattern(const rcl_remap_t * rule)
+{
+  return NULL != rule->match && NULL != strchr(rule->match, '*');
+}
+
+/// Expand the match of a rule with wildcards to a fully qualified pattern.
+/**
+ * rcl_expand_topic_name() rejects wildcards, but matches are only tokens, so
+ * making them fully qualified is enough.
+ */
+static char *
+_rcl_remap_expand_pattern(
+  const char * match,
+  const char * node_name,
+  const char * node_namespace,
+  rcl_allocator_t allocator)
+{
+  // The root namespace already ends with the separator.
+  const char * separator = ('\0' == node_namespace[1]) ? "" : "/";
+  if ('/' == match[0]) {
+    return rcutils_strdup(match, allocator);
+  }
+  if ('~' == match[0]) {
+    return rcutils_format_string(
+      allocator, "%s%s%s%s", node_namespace, separator, node_name, match + 1);
+  }
+  return rcutils_format_string(allocator, "%s%s%s", node_namespace, separator, match);
+}
+
+/// Return the end of the token starting after the separator at position.
+static const char *
+_rcl_remap_token_end(const char * position)
+{
+  const char * end = strchr(position + 1, '/');
+  return NULL != end ? end : position + 1 + strlen(position + 1);
+}
+
+/// Match the tokens of a pattern and a name, starting at a separator or at the end of each.
+/**
+ * `*` matches one token and `**` zero or more tokens, as few as possible.
+ * The text matched by the first RCL_REMAP_MAX_CAPTURES wildcards is captured.
+ */
+static bool
+_rcl_remap_pattern_match_tokens(
+  const char * pattern,
+  const char * name,
+  rcl_remap_capture_t * captures,
+  size_t capture_index)
+{
+  if ('\0' == *pattern) {
+    return '\0' == *name;
+  }
+  const char * pattern_end = _rcl_remap_token_end(pattern);
+  size_t pattern_length = (size_t)(pattern_end - pattern - 1);
+  if (2 == pattern_length && 0 == strncmp(pattern + 1, "**", 2)) {
+    const char * name_end = name;
+    while (true) {
+      if (NULL != captures && capture_index < RCL_REMAP_MAX_CAPTURES) {
+        captures[capture_index].start = name + 1;
+        captures[capture_index].length = (name_end == name) ? 0 : (size_t)(name_end - name - 1);
+      }
+      if (_rcl_remap_pattern_match_tokens(pattern_end, name_end, captures, capture_index + 1)) {
+        return true;
+      }
+      if ('\0' == *name_end) {
+        return false;
+      }
+      name_end = _rcl_remap_token_end(name_end);
+    }
+  }
+  if ('\0' == *name) {
+    return false;
+  }
+  const char * name_end = _rcl_remap_token_end(name);
+  size_t name_length = (size_t)(name_end - name - 1);
+  if (1 == pattern_length && '*' == pattern[1]) {
+    if (NULL != captures && capture_index < RCL_REMAP_MAX_CAPTURES) {
+      captures[capture_index].start = name + 1;
+      captures[capture_index].length = name_length;
+    }
+    return _rcl_remap_pattern_match_tokens(pattern_end, name_end, captures, capture_index + 1);
+  }
+  if (pattern_length != name_length || 0 != strncmp(pattern + 1, name + 1, name_length)) {
+    return false;
+  }
+  return _rcl_remap_pattern_match_tokens(pattern_end, name_end, captures, capture_index);
+}
+
+/// Match a fully qualified name against a fully qualified pattern.
+static bool
+_rcl_remap_pattern_match(
+  const char * pattern,
+  const char * name,
+  rcl_remap_capture_t * captures)
+{
+  if ('/' != pattern[0] || '/' != name[0]) {
+    return false;
+  }
+  // The root name "/" has no tokens.
+  return _rcl_remap_pattern_match_tokens(pattern, '\0' == name[1] ? name + 1 : name, captures, 0);
+}
+
+/// Return the size needed to replace the back-references of a replacement, with the null.
+static size_t
+_rcl_remap_substituted_size(const char * replacement, const rcl_remap_capture_t * captures)
+{
+  size_t size = strlen(replacement) + 1;
+  for (size_t i = 0; i < RCL_REMAP_MAX_CAPTURES; ++i) {
+    size += captures[i].length;
+  }
+  return size;
+}
+
+/// Replace the back-references of a replacement with the captured text.
+/**
+ * A back-reference to an empty capture is dropped along with its separator.
+ * The output must hold _rcl_remap_substituted_size() characters.
+ */
+static void
+_rcl_remap_substitute(
+  const char * replacement,
+  const rcl_remap_capture_t * captures,
+  char * output)
+{
+  size_t length = 0;
+  const char * token = replacement;
+  // Keep the "/" or "~/" the replacement starts with.
+  if ('/' == token[0]) {
+    output[length++] = '/';
+    ++token;
+  } else if ('~' == token[0] && '/' == token[1]) {
+    output[length++] = '~';
+    output[length++] = '/';
+    token += 2;
+  }
+  size_t prefix_length = length;
+  while ('\0' != *token) {
+    const char * token_end = strchr(token, '/');
+    if (NULL == token_end) {
+      token_end = token + strlen(token);
+    }
+    const char * text = token;
+    size_t text_length = (size_t)(token_end - token);
+    if (2 == text_length && '\\' == token[0] && token[1] >= '1' && token[1] <= '9') {
+      const rcl_remap_capture_t * capture = &(captures[token[1] - '1']);
+      text = capture->start;
+      text_length = capture->length;
+    }
+    if (text_length > 0) {
+      if (length > prefix_length) {
+        output[length++] = '/';
+      }
+      memcpy(output + length, text, text_length);
+      length += text_length;
+    }
+    token = ('\0' == *token_end) ? token_end : token_end + 1;
+  }
+  output[length] = '\0';
+}
+
+/// Expand the replacement of a matching topic or service rule.
+/**
+ * \param[in] pattern the expanded match of the rule if it has wildcards, else `NULL`
+ */
+static rcl_ret_t
+_rcl_remap_expand_replacement(
+  const rcl_remap_t * rule,
+  const char * pattern,
+  const char * name,
+  const char * node_name,
+  const char * node_namespace,
+  const rcutils_string_map_t * substitutions,
+  rcl_allocator_t allocator,
+  char ** output_name)
+{
+  const char * replacement = rule->replacement;
+  char * substituted_replacement = NULL;
+  if (NULL != pattern && NULL != strchr(replacement, '\\')) {
+    rcl_remap_capture_t captures[RCL_REMAP_MAX_CAPTURES];
+    memset(captures, 0, sizeof(captures));
+    if (!_rcl_remap_pattern_match(pattern, name, captures)) {
+      RCL_SET_ERROR_MSG("name does not match the rule");
+      return RCL_RET_ERROR;
+    }
+    substituted_replacement = (char *)allocator.allocate(
+      _rcl_remap_substituted_size(replacement, captures), allocator.state);
+    if (NULL == substituted_replacement) {
+      RCL_SET_ERROR_MSG("allocating memory failed");
+      return RCL_RET_BAD_ALLOC;
+    }
+    _rcl_remap_substitute(replacement, captures, substituted_replacement);
+    replacement = substituted_replacement;
+  }
+  // topic and service rules need the replacement to be expanded to a FQN
+  rcl_ret_t ret = rcl_expand_topic_name(
+    replacement, node_name, node_namespace, substitutions, allocator, output_name);
+  if (NULL != substituted_replacement) {
+    allocator.deallocate(substituted_replacement, allocator.state);
+  }
+  return ret;
+}
+
 /// Get the first matching rule in a chain.
 /// \return RCL_RET_OK if no errors occurred while searching for a rule
 RCL_LOCAL
@@ -123,7 +347,16 @@ _rcl_remap_first_match(
       continue;
     }
     bool matched = false;
-    if (rule->type & (RCL_TOPIC_REMAP | RCL_SERVICE_REMAP)) {
+    if (_rcl_remap_is_pattern(rule)) {
+      char * pattern = _rcl_remap_expand_pattern(
+        rule->match, node_name, node_namespace, allocator);
+      if (NULL == pattern) {
+        RCL_SET_ERROR_MSG("allocating memory failed");
+        return RCL_RET_BAD_ALLOC;
+      }
+      matched = _rcl_remap_pattern_match(pattern, name, NULL);
+      allocator.deallocate(pattern, allocator.state);
+    } else if (rule->type & (RCL_TOPIC_REMAP | RCL_SERVICE_REMAP)) {
       // topic and service rules need the match side to be expanded to a FQN
       char * expanded_match = NULL;
       rcl_ret_t ret = rcl_expand_topic_name(
@@ -205,9 +438,19 @@ _rcl_remap_name(
   // Do the remapping
   if (NULL != rule) {
     if (rule->type & (RCL_TOPIC_REMAP | RCL_SERVICE_REMAP)) {
-      // topic and service rules need the replacement to be expanded to a FQN
-      rcl_ret_t ret = rcl_expand_topic_name(
-        rule->replacement, node_name, node_namespace, substitutions, allocator, output_name);
+      char * pattern = NULL;
+      if (_rcl_remap_is_pattern(rule)) {
+        pattern = _rcl_remap_expand_pattern(rule->match, node_name, node_namespace, allocator);
+        if (NULL == pattern) {
+          RCL_SET_ERROR_MSG("allocating memory failed");
+          return RCL_RET_BAD_ALLOC;
+        }
+      }
+      rcl_ret_t ret = _rcl_remap_expand_replacement(
+        rule, pattern, name, node_name, node_namespace, substitutions, allocator, output_name);
+      if (NULL != pattern) {
+        allocator.deallocate(pattern, allocator.state);
+      }
       if (RCL_RET_OK != ret) {
         return ret;
       }
@@ -311,6 +554,516 @@ rcl_remap_node_namespace(
     allocator, output_namespace);
 }
 
+rcl_remap_table_t
+rcl_get_zero_initialized_remap_table(void)
+{
+  rcl_remap_table_t table;
+  table.entries = NULL;
+  table.entry_count = 0;
+  table.slots = NULL;
+  table.slot_mask = 0;
+  table.states = NULL;
+  table.state_count = 0;
+  table.transitions = NULL;
+  table.transition_count = 0;
+  table.transition_slots = NULL;
+  table.transition_slot_mask = 0;
+  table.state_sets = NULL;
+  table.substitutions = rcutils_get_zero_initialized_string_map();
+  table.allocator = rcutils_get_zero_initialized_allocator();
+  return table;
+}
+
+static size_t
+_rcl_remap_table_hash(rcl_remap_type_t type, const char * name)
+{
+  uint64_t hash = 0xcbf29ce484222325ULL ^ (uint64_t)type;
+  for (; '\0' != *name; ++name) {
+    hash ^= (uint8_t)*name;
+    hash *= 0x100000001b3ULL;
+  }
+  return (size_t)hash;
+}
+
+/// Return the entry of the first rule of a type matching the name, or NULL.
+static const rcl_remap_table_entry_t *
+_rcl_remap_table_find(
+  const rcl_remap_table_t * table,
+  rcl_remap_type_t type,
+  const char * name)
+{
+  if (NULL == table->slots) {
+    return NULL;
+  }
+  size_t slot = _rcl_remap_table_hash(type, name) & table->slot_mask;
+  while (0 != table->slots[slot]) {
+    const rcl_remap_table_entry_t * entry = &(table->entries[table->slots[slot] - 1]);
+    if (entry->type == type && 0 == strcmp(entry->expanded_match, name)) {
+      return entry;
+    }
+    slot = (slot + 1) & table->slot_mask;
+  }
+  return NULL;
+}
+
+/// Add the topic and service rules of some arguments which apply to the node.
+static rcl_ret_t
+_rcl_remap_table_add_rules(
+  rcl_remap_table_t * table,
+  const rcl_arguments_t * arguments,
+  const char * node_name,
+  const char * node_namespace,
+  size_t * priority)
+{
+  if (NULL == arguments || NULL == arguments->impl) {
+    return RCL_RET_OK;
+  }
+  rcl_allocator_t allocator = table->allocator;
+  const rcl_remap_type_t types[] = {RCL_TOPIC_REMAP, RCL_SERVICE_REMAP};
+  for (int i = 0; i < arguments->impl->num_remap_rules; ++i) {
+    const rcl_remap_t * rule = &(arguments->impl->remap_rules[i]);
+    size_t rule_priority = (*priority)++;
+    if (!(rule->type & (RCL_TOPIC_REMAP | RCL_SERVICE_REMAP))) {
+      continue;
+    }
+    if (rule->node_name != NULL && 0 != strcmp(rule->node_name, node_name)) {
+      // Rule has a node name prefix and the node name didn't match
+      continue;
+    }
+    bool is_pattern = _rcl_remap_is_pattern(rule);
+    char * expanded_match = NULL;
+    rcl_ret_t ret = RCL_RET_OK;
+    if (is_pattern) {
+      expanded_match = _rcl_remap_expand_pattern(rule->match, node_name, node_namespace, allocator);
+      if (NULL == expanded_match) {
+        RCL_SET_ERROR_MSG("allocating memory failed");
+        return RCL_RET_BAD_ALLOC;
+      }
+    } else {
+      ret = rcl_expand_topic_name(
+        rule->match, node_name, node_namespace, &(table->substitutions), allocator,
+        &expanded_match);
+    }
+    if (RCL_RET_OK != ret) {
+      if (
+        RCL_RET_NODE_INVALID_NAMESPACE == ret ||
+        RCL_RET_NODE_INVALID_NAME == ret ||
+        RCL_RET_BAD_ALLOC == ret)
+      {
+        return ret;  // error already set
+      }
+      // Like a rule whose match cannot be expanded never matches.
+      rcl_reset_error();
+      continue;
+    }
+    bool is_used = false;
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); ++t) {
+      // Only the first rule matching a name applies, patterns are deduplicated by the automaton.
+      if (!(rule->type & types[t]) ||
+        (!is_pattern && NULL != _rcl_remap_table_find(table, types[t], expanded_match)))
+      {
+        continue;
+      }
+      rcl_remap_table_entry_t * entry = &(table->entries[table->entry_count]);
+      entry->type = types[t];
+      entry->priority = rule_priority;
+      entry->expanded_match = expanded_match;
+      entry->is_pattern = is_pattern;
+      entry->rule = rule;
+      ++table->entry_count;
+      is_used = true;
+      if (is_pattern) {
+        continue;
+      }
+      size_t slot = _rcl_remap_table_hash(types[t], expanded_match) & table->slot_mask;
+      while (0 != table->slots[slot]) {
+        slot = (slot + 1) & table->slot_mask;
+      }
+      table->slots[slot] = table->entry_count;
+    }
+    if (!is_used) {
+      allocator.deallocate(expanded_match, allocator.state);
+    }
+  }
+  return RCL_RET_OK;
+}
+
+static size_t
+_rcl_remap_transition_hash(size_t from_state, const char * token, size_t token_length)
+{
+  uint64_t hash = 0xcbf29ce484222325ULL ^ (uint64_t)from_state;
+  for (size_t i = 0; i < token_length; ++i) {
+    hash ^= (uint8_t)token[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return (size_t)hash;
+}
+
+/// Return the state after a token without wildcards, or SIZE_MAX.
+static size_t
+_rcl_remap_table_transition(
+  const rcl_remap_table_t * table,
+  size_t from_state,
+  const char * token,
+  size_t token_length)
+{
+  size_t slot = _rcl_remap_transition_hash(from_state, token, token_length) &
+    table->transition_slot_mask;
+  while (0 != table->transition_slots[slot]) {
+    const rcl_remap_transition_t * transition =
+      &(table->transitions[table->transition_slots[slot] - 1]);
+    if (transition->from_state == from_state && transition->token_length == token_length &&
+      0 == strncmp(transition->token, token, token_length))
+    {
+      return transition->to_state;
+    }
+    slot = (slot + 1) & table->transition_slot_mask;
+  }
+  return SIZE_MAX;
+}
+
+static size_t
+_rcl_remap_table_add_state(rcl_remap_table_t * table, bool is_wild_multi)
+{
+  rcl_remap_state_t * state = &(table->states[table->state_count]);
+  state->wild_one = SIZE_MAX;
+  state->wild_multi = SIZE_MAX;
+  state->is_wild_multi = is_wild_multi;
+  state->accepted_entries[0] = SIZE_MAX;
+  state->accepted_entries[1] = SIZE_MAX;
+  return table->state_count++;
+}
+
+/// Compile the patterns of the entries into the automaton.
+static rcl_ret_t
+_rcl_remap_table_build_automaton(rcl_remap_table_t * table)
+{
+  rcl_allocator_t allocator = table->allocator;
+  // Every token of a pattern adds at most one state and one transition.
+  size_t max_states = 1;
+  for (size_t i = 0; i < table->entry_count; ++i) {
+    if (table->entries[i].is_pattern) {
+      for (const char * c = table->entries[i].expanded_match; '\0' != *c; ++c) {
+        max_states += ('/' == *c) ? 1 : 0;
+      }
+    }
+  }
+  if (1 == max_states) {
+    return RCL_RET_OK;
+  }
+  size_t slot_count = 1;
+  while (slot_count < 2 * max_states) {
+    slot_count <<= 1;
+  }
+  table->states = (rcl_remap_state_t *)allocator.allocate(
+    max_states * sizeof(rcl_remap_state_t), allocator.state);
+  table->transitions = (rcl_remap_transition_t *)allocator.allocate(
+    max_states * sizeof(rcl_remap_transition_t), allocator.state);
+  table->transition_slots = (size_t *)allocator.zero_allocate(
+    slot_count, sizeof(size_t), allocator.state);
+  // Each state is active at most once, so two sets of all states are enough to match a name.
+  size_t * state_sets = (size_t *)allocator.allocate(
+    2 * max_states * sizeof(size_t), allocator.state);
+  if (NULL == table->states || NULL == table->transitions || NULL == table->transition_slots ||
+    NULL == state_sets)
+  {
+    if (NULL != state_sets) {
+      allocator.deallocate(state_sets, allocator.state);
+    }
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    return RCL_RET_BAD_ALLOC;
+  }
+  if (RCL_RET_OK != rcl_mutex_init(&(table->state_sets_lock))) {
+    allocator.deallocate(state_sets, allocator.state);
+    return RCL_RET_ERROR;  // error already set
+  }
+  // The lock is finalized with the state sets.
+  table->state_sets = state_sets;
+  table->transition_slot_mask = slot_count - 1;
+  _rcl_remap_table_add_state(table, false);
+
+  // Entries are in the order of their rules, so the first rule ending in a state is kept.
+  for (size_t i = 0; i < table->entry_count; ++i) {
+    const rcl_remap_table_entry_t * entry = &(table->entries[i]);
+    if (!entry->is_pattern) {
+      continue;
+    }
+    size_t state = 0;
+    const char * token = entry->expanded_match;
+    while ('\0' != *token) {
+      const char * token_end = _rcl_remap_token_end(token);
+      size_t token_length = (size_t)(token_end - token - 1);
+      if (2 == token_length && 0 == strncmp(token + 1, "**", 2)) {
+        if (SIZE_MAX == table->states[state].wild_multi) {
+          table->states[state].wild_multi = _rcl_remap_table_add_state(table, true);
+        }
+        state = table->states[state].wild_multi;
+      } else if (1 == token_length && '*' == token[1]) {
+        if (SIZE_MAX == table->states[state].wild_one) {
+          table->states[state].wild_one = _rcl_remap_table_add_state(table, false);
+        }
+        state = table->states[state].wild_one;
+      } else {
+        size_t next_state = _rcl_remap_table_transition(table, state, token + 1, token_length);
+        if (SIZE_MAX == next_state) {
+          next_state = _rcl_remap_table_add_state(table, false);
+          rcl_remap_transition_t * transition = &(table->transitions[table->transition_count]);
+          transition->from_state = state;
+          transition->token = token + 1;
+          transition->token_length = token_length;
+          transition->to_state = next_state;
+          size_t slot = _rcl_remap_transition_hash(state, token + 1, token_length) &
+            table->transition_slot_mask;
+          while (0 != table->transition_slots[slot]) {
+            slot = (slot + 1) & table->transition_slot_mask;
+          }
+          table->transition_slots[slot] = ++table->transition_count;
+        }
+        state = next_state;
+      }
+      token = token_end;
+    }
+    size_t * accepted_entry =
+      &(table->states[state].accepted_entries[RCL_TOPIC_REMAP == entry->type ? 0 : 1]);
+    if (SIZE_MAX == *accepted_entry) {
+      *accepted_entry = i;
+    }
+  }
+  return RCL_RET_OK;
+}
+
+/// Add a state and the states after its `**` to a set of active states.
+static void
+_rcl_remap_table_activate(
+  const rcl_remap_table_t * table,
+  size_t state,
+  size_t * active_states,
+  size_t * active_count)
+{
+  while (SIZE_MAX != state) {
+    for (size_t i = 0; i < *active_count; ++i) {
+      if (active_states[i] == state) {
+        return;
+      }
+    }
+    active_states[(*active_count)++] = state;
+    state = table->states[state].wild_multi;
+  }
+}
+
+/// Find the first rule with wildcards of a type matching a fully qualified name, or NULL.
+/**
+ * Matches with the preallocated state sets of the table, the caller holds their lock.
+ */
+static const rcl_remap_table_entry_t *
+_rcl_remap_table_match_patterns(
+  const rcl_remap_table_t * table,
+  rcl_remap_type_t type,
+  const char * name)
+{
+  size_t * active_states = table->state_sets;
+  size_t * next_states = table->state_sets + table->state_count;
+  size_t active_count = 0;
+  _rcl_remap_table_activate(table, 0, active_states, &active_count);
+
+  // The root name "/" has no tokens.
+  const char * token = ('\0' == name[1]) ? name + 1 : name;
+  while ('\0' != *token && active_count > 0) {
+    const char * token_end = _rcl_remap_token_end(token);
+    size_t token_length = (size_t)(token_end - token - 1);
+    size_t next_count = 0;
+    for (size_t i = 0; i < active_count; ++i) {
+      const rcl_remap_state_t * state = &(table->states[active_states[i]]);
+      if (state->is_wild_multi) {
+        _rcl_remap_table_activate(table, active_states[i], next_states, &next_count);
+      }
+      _rcl_remap_table_activate(table, state->wild_one, next_states, &next_count);
+      _rcl_remap_table_activate(
+        table, _rcl_remap_table_transition(table, active_states[i], token + 1, token_length),
+        next_states, &next_count);
+    }
+    size_t * swap = active_states;
+    active_states = next_states;
+    next_states = swap;
+    active_count = next_count;
+    token = token_end;
+  }
+  if ('\0' != *token) {
+    return NULL;
+  }
+  const rcl_remap_table_entry_t * output_entry = NULL;
+  size_t type_index = RCL_TOPIC_REMAP == type ? 0 : 1;
+  for (size_t i = 0; i < active_count; ++i) {
+    size_t accepted_entry = table->states[active_states[i]].accepted_entries[type_index];
+    if (SIZE_MAX == accepted_entry) {
+      continue;
+    }
+    if (NULL == output_entry || table->entries[accepted_entry].priority < output_entry->priority) {
+      output_entry = &(table->entries[accepted_entry]);
+    }
+  }
+  return output_entry;
+}
+
+rcl_ret_t
+rcl_remap_table_init(
+  rcl_remap_table_t * table,
+  const rcl_arguments_t * local_arguments,
+  const rcl_arguments_t * global_arguments,
+  const char * node_name,
+  const char * node_namespace,
+  rcl_allocator_t allocator)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(table, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(node_name, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(node_namespace, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ALLOCATOR_WITH_MSG(&allocator, "allocator is invalid", return RCL_RET_INVALID_ARGUMENT);
+  table->allocator = allocator;
+
+  rcutils_ret_t rcutils_ret = rcutils_string_map_init(&(table->substitutions), 0, allocator);
+  if (RCUTILS_RET_OK != rcutils_ret) {
+    RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
+    return RCUTILS_RET_BAD_ALLOC == rcutils_ret ? RCL_RET_BAD_ALLOC : RCL_RET_ERROR;
+  }
+  rcl_ret_t ret = rcl_get_default_topic_name_substitutions(&(table->substitutions));
+  if (RCL_RET_OK != ret) {
+    goto fail;
+  }
+
+  // A rule for topics and services gets two entries.
+  size_t max_entries = 0;
+  if (NULL != local_arguments && NULL != local_arguments->impl) {
+    max_entries += 2 * (size_t)local_arguments->impl->num_remap_rules;
+  }
+  if (NULL != global_arguments && NULL != global_arguments->impl) {
+    max_entries += 2 * (size_t)global_arguments->impl->num_remap_rules;
+  }
+  if (0 == max_entries) {
+    return RCL_RET_OK;
+  }
+  table->entries = (rcl_remap_table_entry_t *)allocator.allocate(
+    max_entries * sizeof(rcl_remap_table_entry_t), allocator.state);
+  // Keep the load factor at or below one half, so every probe sequence ends in an empty slot.
+  size_t slot_count = 1;
+  while (slot_count < 2 * max_entries) {
+    slot_count <<= 1;
+  }
+  table->slots = (size_t *)allocator.zero_allocate(slot_count, sizeof(size_t), allocator.state);
+  if (NULL == table->entries || NULL == table->slots) {
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    ret = RCL_RET_BAD_ALLOC;
+    goto fail;
+  }
+  table->slot_mask = slot_count - 1;
+
+  // Local rules are searched before global ones.
+  size_t priority = 0;
+  ret = _rcl_remap_table_add_rules(table, local_arguments, node_name, node_namespace, &priority);
+  if (RCL_RET_OK == ret) {
+    ret = _rcl_remap_table_add_rules(
+      table, global_arguments, node_name, node_namespace, &priority);
+  }
+  if (RCL_RET_OK == ret) {
+    ret = _rcl_remap_table_build_automaton(table);
+  }
+  if (RCL_RET_OK != ret) {
+    goto fail;
+  }
+  return RCL_RET_OK;
+fail:
+  if (RCL_RET_OK != rcl_remap_table_fini(table)) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("failed to finalize remap table after another error\n");
+  }
+  return ret;
+}
+
+rcl_ret_t
+rcl_remap_table_fini(rcl_remap_table_t * table)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(table, RCL_RET_INVALID_ARGUMENT);
+  rcl_ret_t ret = RCL_RET_OK;
+  rcl_allocator_t allocator = table->allocator;
+  if (NULL != table->entries) {
+    for (size_t i = 0; i < table->entry_count; ++i) {
+      // Rules for topics and services share the expanded match between their entries.
+      if (0 == i || table->entries[i - 1].expanded_match != table->entries[i].expanded_match) {
+        allocator.deallocate(table->entries[i].expanded_match, allocator.state);
+      }
+    }
+    allocator.deallocate(table->entries, allocator.state);
+  }
+  if (NULL != table->slots) {
+    allocator.deallocate(table->slots, allocator.state);
+  }
+  if (NULL != table->states) {
+    allocator.deallocate(table->states, allocator.state);
+  }
+  if (NULL != table->transitions) {
+    allocator.deallocate(table->transitions, allocator.state);
+  }
+  if (NULL != table->transition_slots) {
+    allocator.deallocate(table->transition_slots, allocator.state);
+  }
+  if (NULL != table->state_sets) {
+    rcl_mutex_fini(&(table->state_sets_lock));
+    allocator.deallocate(table->state_sets, allocator.state);
+  }
+  if (RCUTILS_RET_OK != rcutils_string_map_fini(&(table->substitutions))) {
+    RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
+    ret = RCL_RET_ERROR;
+  }
+  *table = rcl_get_zero_initialized_remap_table();
+  return ret;
+}
+
+const rcl_remap_table_entry_t *
+rcl_remap_table_find_entry(
+  const rcl_remap_table_t * table,
+  rcl_remap_type_t type,
+  const char * name)
+{
+  const rcl_remap_table_entry_t * entry = _rcl_remap_table_find(table, type, name);
+  const rcl_remap_table_entry_t * pattern_entry = NULL;
+  if (0 != table->state_count && '/' == name[0]) {
+    // The lock guards scratch memory, not the rules, so it does not make the table mutable.
+    rcl_mutex_t * lock = (rcl_mutex_t *)&(table->state_sets_lock);
+    rcl_mutex_lock(lock);
+    pattern_entry = _rcl_remap_table_match_patterns(table, type, name);
+    rcl_mutex_unlock(lock);
+  }
+  if (NULL == entry || (NULL != pattern_entry && pattern_entry->priority < entry->priority)) {
+    return pattern_entry;
+  }
+  return entry;
+}
+
+rcl_ret_t
+rcl_remap_table_entry_get_replacement(
+  const rcl_remap_table_entry_t * entry,
+  const char * name,
+  char * buffer,
+  size_t buffer_size,
+  const char ** replacement)
+{
+  *replacement = entry->rule->replacement;
+  if (!entry->is_pattern || NULL == strchr(entry->rule->replacement, '\\')) {
+    return RCL_RET_OK;
+  }
+  rcl_remap_capture_t captures[RCL_REMAP_MAX_CAPTURES];
+  memset(captures, 0, sizeof(captures));
+  if (!_rcl_remap_pattern_match(entry->expanded_match, name, captures)) {
+    RCL_SET_ERROR_MSG("name does not match the rule");
+    return RCL_RET_ERROR;
+  }
+  if (_rcl_remap_substituted_size(entry->rule->replacement, captures) > buffer_size) {
+    RCL_SET_ERROR_MSG("remapped name is too long");
+    return RCL_RET_TOPIC_NAME_INVALID;
+  }
+  _rcl_remap_substitute(entry->rule->replacement, captures, buffer);
+  *replacement = buffer;
+  return RCL_RET_OK;
+}
+
 #ifdef __cplusplus
 }
 #endif
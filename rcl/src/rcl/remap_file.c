@@ -0,0 +1,449 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./remap_file.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "rcl/error_handling.h"
+
+/// Layout of a compiled file: the header, the rules, then the strings.
+typedef struct rcl_remap_file_header_t
+{
+  char magic[8];
+  uint32_t version;
+  /// 0x01020304 in the byte order of the host which wrote the file.
+  uint32_t byte_order;
+  uint32_t rule_count;
+  /// Size of the strings, the last one is null terminated.
+  uint32_t strings_size;
+} rcl_remap_file_header_t;
+
+/// A rule, its strings are offsets from the start of the strings.
+typedef struct rcl_remap_file_rule_t
+{
+  uint32_t type;
+  uint32_t node_name;
+  uint32_t match;
+  uint32_t replacement;
+} rcl_remap_file_rule_t;
+
+#define RCL_REMAP_FILE_BYTE_ORDER 0x01020304u
+/// Offset of a string which is `NULL`.
+#define RCL_REMAP_FILE_NO_STRING UINT32_MAX
+
+rcl_remap_file_t
+rcl_get_zero_initialized_remap_file(void)
+{
+  static rcl_remap_file_t null_file = {
+    .data = NULL,
+    .size = 0
+  };
+  return null_file;
+}
+
+rcl_ret_t
+rcl_remap_file_map(const char * file_path, rcl_remap_file_t * file)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(file_path, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(file, RCL_RET_INVALID_ARGUMENT);
+#if defined(_WIN32)
+  HANDLE handle = CreateFileA(
+    file_path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (INVALID_HANDLE_VALUE == handle) {
+    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("could not open remap file '%s'", file_path);
+    return RCL_RET_ERROR;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(handle, &size)) {
+    CloseHandle(handle);
+    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("could not get the size of remap file '%s'", file_path);
+    return RCL_RET_ERROR;
+  }
+  if (0 == size.QuadPart) {
+    CloseHandle(handle);
+    *file = rcl_get_zero_initialized_remap_file();
+    return RCL_RET_OK;
+  }
+  HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+  CloseHandle(handle);
+  if (NULL == mapping) {
+    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("could not map remap file '%s'", file_path);
+    return RCL_RET_ERROR;
+  }
+  // The view keeps the mapping alive.
+  void * data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (NULL == data) {
+    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("could not map remap file '%s'", file_path);
+    return RCL_RET_ERROR;
+  }
+  file->data = (const char *)data;
+  file->size = (size_t)size.QuadPart;
+#else
+  int fd = open(file_path, O_RDONLY);
+  if (fd < 0) {
+    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("could not open remap file '%s'", file_path);
+    return RCL_RET_ERROR;
+  }
+  struct stat file_stat;
+  if (0 != fstat(fd, &file_stat)) {
+    close(fd);
+    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("could not get the size of remap file '%s'", file_path);
+    return RCL_RET_ERROR;
+  }
+  if (0 == file_stat.st_size) {
+    close(fd);
+    *file = rcl_get_zero_initialized_remap_file();
+    return RCL_RET_OK;
+  }
+  // The mapping stays valid after the file is closed.
+  void * data = mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (MAP_FAILED == data) {
+    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("could not map remap file '%s'", file_path);
+    return RCL_RET_ERROR;
+  }
+  file->data = (const char *)data;
+  file->size = (size_t)file_stat.st_size;
+#endif
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_remap_file_unmap(rcl_remap_file_t * file)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(file, RCL_RET_INVALID_ARGUMENT);
+  if (NULL != file->data) {
+#if defined(_WIN32)
+    if (!UnmapViewOfFile(file->data)) {
+      RCL_SET_ERROR_MSG("could not unmap remap file");
+      return RCL_RET_ERROR;
+    }
+#else
+    if (0 != munmap((void *)file->data, file->size)) {
+      RCL_SET_ERROR_MSG("could not unmap remap file");
+      return RCL_RET_ERROR;
+    }
+#endif
+  }
+  *file = rcl_get_zero_initialized_remap_file();
+  return RCL_RET_OK;
+}
+
+bool
+rcl_remap_file_is_compiled(const rcl_remap_file_t * file)
+{
+  return file->size >= sizeof(RCL_REMAP_FILE_MAGIC) - 1 &&
+         0 == memcmp(file->data, RCL_REMAP_FILE_MAGIC, sizeof(RCL_REMAP_FILE_MAGIC) - 1);
+}
+
+static bool
+_rcl_remap_file_is_space(char c)
+{
+  return ' ' == c || '\t' == c || '\r' == c;
+}
+
+bool
+rcl_remap_file_next_line(
+  const rcl_remap_file_t * file,
+  size_t * position,
+  const char ** line,
+  size_t * line_length)
+{
+  while (*position < file->size) {
+    const char * start = file->data + *position;
+    const char * newline = memchr(start, '\n', file->size - *position);
+    const char * end = NULL == newline ? file->data + file->size : newline;
+    *position = (size_t)(end - file->data) + (NULL == newline ? 0 : 1);
+    while (start < end && _rcl_remap_file_is_space(*start)) {
+      ++start;
+    }
+    while (end > start && _rcl_remap_file_is_space(end[-1])) {
+      --end;
+    }
+    if (start < end && '#' != *start) {
+      *line = start;
+      *line_length = (size_t)(end - start);
+      return true;
+    }
+  }
+  return false;
+}
+
+rcl_ret_t
+rcl_remap_file_get_rule_count(const rcl_remap_file_t * file, size_t * rule_count)
+{
+  rcl_remap_file_header_t header;
+  if (file->size < sizeof(header)) {
+    RCL_SET_ERROR_MSG("remap file is truncated");
+    return RCL_RET_INVALID_REMAP_RULE;
+  }
+  memcpy(&header, file->data, sizeof(header));
+  if (RCL_REMAP_FILE_VERSION != header.version) {
+    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "remap file has version %u, expected %u", header.version, RCL_REMAP_FILE_VERSION);
+    return RCL_RET_INVALID_REMAP_RULE;
+  }
+  if (RCL_REMAP_FILE_BYTE_ORDER != header.byte_order) {
+    RCL_SET_ERROR_MSG("remap file was written on a host with another byte order");
+    return RCL_RET_INVALID_REMAP_RULE;
+  }
+  // The sizes are 32 bit, so this can not overflow.
+  uint64_t expected_size = sizeof(header) +
+    (uint64_t)header.rule_count * sizeof(rcl_remap_file_rule_t) + header.strings_size;
+  if (expected_size != file->size) {
+    RCL_SET_ERROR_MSG("remap file is truncated or corrupted");
+    return RCL_RET_INVALID_REMAP_RULE;
+  }
+  if (header.strings_size > 0 && '\0' != file->data[file->size - 1]) {
+    RCL_SET_ERROR_MSG("remap file strings are not null terminated");
+    return RCL_RET_INVALID_REMAP_RULE;
+  }
+  *rule_count = header.rule_count;
+  return RCL_RET_OK;
+}
+
+/// Get a string of a compiled file, false if the offset is out of bounds.
+static bool
+_rcl_remap_file_get_string(
+  const char * strings,
+  uint32_t strings_size,
+  uint32_t offset,
+  char ** string)
+{
+  if (RCL_REMAP_FILE_NO_STRING == offset) {
+    *string = NULL;
+    return true;
+  }
+  if (offset >= strings_size) {
+    return false;
+  }
+  // The rules never change the strings, they are only freed if not mapped.
+  *string = (char *)(strings + offset);
+  return true;
+}
+
+rcl_ret_t
+rcl_remap_file_load_rules(
+  const rcl_remap_file_t * file,
+  rcl_allocator_t allocator,
+  rcl_remap_t * rules)
+{
+  size_t rule_count;
+  rcl_ret_t ret = rcl_remap_file_get_rule_count(file, &rule_count);
+  if (RCL_RET_OK != ret) {
+    return ret;  // error already set
+  }
+  rcl_remap_file_header_t header;
+  memcpy(&header, file->data, sizeof(header));
+  const char * records = file->data + sizeof(header);
+  const char * strings = records + rule_count * sizeof(rcl_remap_file_rule_t);
+  size_t i;
+  for (i = 0; i < rule_count; ++i) {
+    rcl_remap_file_rule_t record;
+    memcpy(&record, records + i * sizeof(record), sizeof(record));
+    rcl_remap_t * rule = &(rules[i]);
+    *rule = rcl_remap_get_zero_initialized();
+    rule->type = (rcl_remap_type_t)record.type;
+    rule->allocator = allocator;
+    rule->is_mapped = true;
+    bool is_name_remap = 0 == (record.type & ~(RCL_TOPIC_REMAP | RCL_SERVICE_REMAP));
+    bool is_node_remap = RCL_NODENAME_REMAP == record.type || RCL_NAMESPACE_REMAP == record.type;
+    if (
+      (!is_name_remap && !is_node_remap) || RCL_UNKNOWN_REMAP == record.type ||
+      !_rcl_remap_file_get_string(strings, header.strings_size, record.node_name,
+      &rule->node_name) ||
+      !_rcl_remap_file_get_string(strings, header.strings_size, record.match, &rule->match) ||
+      !_rcl_remap_file_get_string(
+        strings, header.strings_size, record.replacement, &rule->replacement) ||
+      (is_name_remap && NULL == rule->match) || (is_node_remap && NULL != rule->match) ||
+      NULL == rule->replacement)
+    {
+      RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("rule %zu of remap file is corrupted", i);
+      return RCL_RET_INVALID_REMAP_RULE;
+    }
+  }
+  return RCL_RET_OK;
+}
+
+/// Strings of a file being written, each one stored once.
+typedef struct rcl_remap_file_strings_t
+{
+  char * data;
+  size_t size;
+  size_t capacity;
+  /// Offset of the string plus one, 0 for an empty slot.
+  size_t * slots;
+  size_t slot_mask;
+  rcl_allocator_t allocator;
+} rcl_remap_file_strings_t;
+
+static uint64_t
+_rcl_remap_file_hash(const char * string)
+{
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (; '\0' != *string; ++string) {
+    hash ^= (uint8_t)*string;
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+/// Get the offset of a string, appending it if it was not stored yet.
+static rcl_ret_t
+_rcl_remap_file_intern(
+  rcl_remap_file_strings_t * strings,
+  const char * string,
+  uint32_t * offset)
+{
+  if (NULL == string) {
+    *offset = RCL_REMAP_FILE_NO_STRING;
+    return RCL_RET_OK;
+  }
+  size_t slot = (size_t)_rcl_remap_file_hash(string) & strings->slot_mask;
+  while (0 != strings->slots[slot]) {
+    size_t existing = strings->slots[slot] - 1;
+    if (0 == strcmp(strings->data + existing, string)) {
+      *offset = (uint32_t)existing;
+      return RCL_RET_OK;
+    }
+    slot = (slot + 1) & strings->slot_mask;
+  }
+  size_t length = strlen(string) + 1;
+  if (strings->size + length >= RCL_REMAP_FILE_NO_STRING) {
+    RCL_SET_ERROR_MSG("rules do not fit in a remap file");
+    return RCL_RET_ERROR;
+  }
+  if (strings->size + length > strings->capacity) {
+    size_t capacity = 2 * strings->capacity + length;
+    char * data = strings->allocator.reallocate(
+      strings->data, capacity, strings->allocator.state);
+    if (NULL == data) {
+      RCL_SET_ERROR_MSG("allocating memory failed");
+      return RCL_RET_BAD_ALLOC;
+    }
+    strings->data = data;
+    strings->capacity = capacity;
+  }
+  memcpy(strings->data + strings->size, string, length);
+  strings->slots[slot] = strings->size + 1;
+  *offset = (uint32_t)strings->size;
+  strings->size += length;
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_remap_file_write(
+  const rcl_remap_t * rules,
+  size_t rule_count,
+  const char * file_path,
+  rcl_allocator_t allocator)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(file_path, RCL_RET_INVALID_ARGUMENT);
+  if (rule_count > 0) {
+    RCL_CHECK_ARGUMENT_FOR_NULL(rules, RCL_RET_INVALID_ARGUMENT);
+  }
+  if (rule_count >= UINT32_MAX / sizeof(rcl_remap_file_rule_t)) {
+    RCL_SET_ERROR_MSG("too many rules for a remap file");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  rcl_ret_t ret = RCL_RET_OK;
+  rcl_remap_file_strings_t strings = {NULL, 0, 0, NULL, 0, allocator};
+  rcl_remap_file_rule_t * records = NULL;
+  FILE * stream = NULL;
+
+  // Keep the load factor at or below one half, each rule has at most three strings.
+  size_t slot_count = 1;
+  while (slot_count < 6 * rule_count) {
+    slot_count <<= 1;
+  }
+  strings.slots = allocator.zero_allocate(slot_count, sizeof(size_t), allocator.state);
+  strings.slot_mask = slot_count - 1;
+  if (rule_count > 0) {
+    records = allocator.allocate(rule_count * sizeof(rcl_remap_file_rule_t), allocator.state);
+  }
+  if (NULL == strings.slots || (rule_count > 0 && NULL == records)) {
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    ret = RCL_RET_BAD_ALLOC;
+    goto cleanup;
+  }
+  size_t i;
+  for (i = 0; i < rule_count && RCL_RET_OK == ret; ++i) {
+    records[i].type = (uint32_t)rules[i].type;
+    ret = _rcl_remap_file_intern(&strings, rules[i].node_name, &records[i].node_name);
+    if (RCL_RET_OK == ret) {
+      ret = _rcl_remap_file_intern(&strings, rules[i].match, &records[i].match);
+    }
+    if (RCL_RET_OK == ret) {
+      ret = _rcl_remap_file_intern(&strings, rules[i].replacement, &records[i].replacement);
+    }
+  }
+  if (RCL_RET_OK != ret) {
+    goto cleanup;  // error already set
+  }
+
+  rcl_remap_file_header_t header;
+  memcpy(header.magic, RCL_REMAP_FILE_MAGIC, sizeof(header.magic));
+  header.version = RCL_REMAP_FILE_VERSION;
+  header.byte_order = RCL_REMAP_FILE_BYTE_ORDER;
+  header.rule_count = (uint32_t)rule_count;
+  header.strings_size = (uint32_t)strings.size;
+  stream = fopen(file_path, "wb");
+  if (
+    NULL == stream ||
+    1 != fwrite(&header, sizeof(header), 1, stream) ||
+    rule_count != fwrite(records, sizeof(rcl_remap_file_rule_t), rule_count, stream) ||
+    strings.size != fwrite(strings.data, 1, strings.size, stream))
+  {
+    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("could not write remap file '%s'", file_path);
+    ret = RCL_RET_ERROR;
+  }
+  if (NULL != stream && 0 != fclose(stream) && RCL_RET_OK == ret) {
+    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("could not write remap file '%s'", file_path);
+    ret = RCL_RET_ERROR;
+  }
+
+cleanup:
+  if (NULL != strings.data) {
+    allocator.deallocate(strings.data, allocator.state);
+  }
+  if (NULL != strings.slots) {
+    allocator.deallocate(strings.slots, allocator.state);
+  }
+  if (NULL != records) {
+    allocator.deallocate(records, allocator.state);
+  }
+  return ret;
+}
+
+#ifdef __cplusplus
+}
+#endif
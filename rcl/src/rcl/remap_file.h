@@ -0,0 +1,153 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__REMAP_FILE_H_
+#define RCL__REMAP_FILE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rcl/allocator.h"
+#include "rcl/types.h"
+#include "rcl/visibility_control.h"
+
+#include "./remap_impl.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// First bytes of a compiled rules file, no text rule starts with them.
+#define RCL_REMAP_FILE_MAGIC "\177rclrmap"
+#define RCL_REMAP_FILE_VERSION 1u
+
+/// A rules file mapped read only into memory, given with `__remap_file:=`.
+/**
+ * The file is either text, with one remap rule per line as it would be given
+ * on the command line, or compiled with rcl_remap_file_write().
+ * In a text file, blank lines and lines starting with `#` are skipped.
+ *
+ * A compiled file holds the rules with their strings interned, so loading it
+ * parses nothing and the rules point into the mapping, which processes using
+ * the same file share through the page cache.
+ */
+typedef struct rcl_remap_file_t
+{
+  /// Content of the file, `NULL` if it is empty.
+  const char * data;
+  size_t size;
+} rcl_remap_file_t;
+
+/// Return a rcl_remap_file_t struct with members set to `NULL` or 0.
+RCL_LOCAL
+rcl_remap_file_t
+rcl_get_zero_initialized_remap_file(void);
+
+/// Map a rules file into memory.
+/**
+ * \param[in] file_path path of the file
+ * \param[out] file a zero initialized file
+ * \return `RCL_RET_OK` if the file was mapped, or
+ * \return `RCL_RET_ERROR` if the file could not be opened or mapped.
+ */
+RCL_LOCAL
+rcl_ret_t
+rcl_remap_file_map(const char * file_path, rcl_remap_file_t * file);
+
+/// Unmap a file, safe to call on a zero initialized file.
+RCL_LOCAL
+rcl_ret_t
+rcl_remap_file_unmap(rcl_remap_file_t * file);
+
+/// Return true if the file was written by rcl_remap_file_write().
+RCL_LOCAL
+bool
+rcl_remap_file_is_compiled(const rcl_remap_file_t * file);
+
+/// Return the next rule of a text file, skipping blank lines and comments.
+/**
+ * \param[in] file a mapped text file
+ * \param[in,out] position where to start looking, 0 for the first line
+ * \param[out] line start of the rule, not null terminated
+ * \param[out] line_length length of the rule without surrounding white space
+ * \return true if a rule was found, or false at the end of the file.
+ */
+RCL_LOCAL
+bool
+rcl_remap_file_next_line(
+  const rcl_remap_file_t * file,
+  size_t * position,
+  const char ** line,
+  size_t * line_length);
+
+/// Count the rules of a compiled file, after checking its layout.
+/**
+ * \param[in] file a compiled file
+ * \param[out] rule_count the number of rules
+ * \return `RCL_RET_OK` if the file is well formed, or
+ * \return `RCL_RET_INVALID_REMAP_RULE` if it is truncated, corrupted, or from another version.
+ */
+RCL_LOCAL
+rcl_ret_t
+rcl_remap_file_get_rule_count(const rcl_remap_file_t * file, size_t * rule_count);
+
+/// Load the rules of a compiled file, their strings point into the file.
+/**
+ * The rules are marked as mapped, so rcl_remap_fini() does not free their
+ * strings; the file must stay mapped while they are used.
+ * The rules were validated when the file was written, only the layout is
+ * checked again.
+ *
+ * \param[in] file a compiled file
+ * \param[in] allocator allocator set in the rules, used to copy them
+ * \param[out] rules array of as many rules as rcl_remap_file_get_rule_count() gives
+ * \return `RCL_RET_OK` if the rules were loaded, or
+ * \return `RCL_RET_INVALID_REMAP_RULE` if the file is corrupted.
+ */
+RCL_LOCAL
+rcl_ret_t
+rcl_remap_file_load_rules(
+  const rcl_remap_file_t * file,
+  rcl_allocator_t allocator,
+  rcl_remap_t * rules);
+
+/// Compile rules into a file, each distinct string is stored once.
+/**
+ * Files are written in the byte order of the host, and loading them on a host
+ * with a different one fails.
+ * A file which is mapped by running processes must not be written over, write
+ * a new file and rename it instead.
+ *
+ * \param[in] rules rules to be written, in the order they apply
+ * \param[in] rule_count number of rules
+ * \param[in] file_path path of the file to create or truncate
+ * \param[in] allocator allocator for temporary memory
+ * \return `RCL_RET_OK` if the file was written, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if the file could not be written.
+ */
+RCL_LOCAL
+rcl_ret_t
+rcl_remap_file_write(
+  const rcl_remap_t * rules,
+  size_t rule_count,
+  const char * file_path,
+  rcl_allocator_t allocator);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__REMAP_FILE_H_
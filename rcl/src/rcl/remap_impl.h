@@ -15,10 +15,18 @@
 #ifndef RCL__REMAP_IMPL_H_
 #define RCL__REMAP_IMPL_H_
 
+#include <stdbool.h>
+#include <stddef.h>
+
 #include "rcl/allocator.h"
+#include "rcl/arguments.h"
 #include "rcl/macros.h"
+#include "rcl/node.h"
 #include "rcl/types.h"
 #include "rcl/visibility_control.h"
+#include "rcutils/types/string_map.h"
+
+#include "./mutex.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -45,6 +53,8 @@ typedef struct rcl_remap_t
   char * match;
   /// Replacement portion of a rule.
   char * replacement;
+  /// The strings are interned in a memory mapped rules file, which owns them.
+  bool is_mapped;
 
   /// Allocator used to allocate objects in this struct
   rcl_allocator_t allocator;
@@ -101,6 +111,166 @@ rcl_ret_t
 rcl_remap_fini(
   rcl_remap_t * rule);
 
+/// Number of wildcards a replacement can refer to, with the back-references `\1` to `\9`.
+#define RCL_REMAP_MAX_CAPTURES 9
+
+/// A topic or service rule whose match was expanded for a node.
+typedef struct rcl_remap_table_entry_t
+{
+  /// RCL_TOPIC_REMAP or RCL_SERVICE_REMAP, rules for both get an entry for each.
+  rcl_remap_type_t type;
+  /// Position of the rule, local rules before global ones, lower positions win.
+  size_t priority;
+  /// Fully qualified name matched by the rule, or pattern if the match has wildcards.
+  char * expanded_match;
+  /// The match has wildcards, the entry is part of the automaton instead of the index.
+  bool is_pattern;
+  /// The rule, owned by the node's or the context's arguments.
+  const rcl_remap_t * rule;
+} rcl_remap_table_entry_t;
+
+/// A state of the automaton matching the rules with wildcards.
+/**
+ * The states form a trie of the tokens of the patterns, where `*` and `**`
+ * are transitions of their own.
+ * The state after a `**` loops on any token, and is active whenever the
+ * state before it is, as `**` also matches no token at all.
+ */
+typedef struct rcl_remap_state_t
+{
+  /// State after a `*`, or SIZE_MAX.
+  size_t wild_one;
+  /// State after a `**`, or SIZE_MAX.
+  size_t wild_multi;
+  /// The state was reached by `**` and stays active for any token.
+  bool is_wild_multi;
+  /// Entry of the first topic rule and the first service rule ending here, or SIZE_MAX.
+  size_t accepted_entries[2];
+} rcl_remap_state_t;
+
+/// A transition of the automaton for a token without wildcards.
+typedef struct rcl_remap_transition_t
+{
+  size_t from_state;
+  /// The token, pointing into the pattern of an entry.
+  const char * token;
+  size_t token_length;
+  size_t to_state;
+} rcl_remap_transition_t;
+
+/// Topic and service rules applying to a node, indexed by the names they match.
+/**
+ * The match of every rule is expanded once, when the table is built, so
+ * remapping a name is a hash lookup no matter how many rules are given.
+ * Only the first rule matching a name is kept, like rules are searched in
+ * order.
+ *
+ * Rules with wildcards are compiled into an automaton instead, which reads
+ * each token of a name once; its cost grows with the number of patterns
+ * which match a prefix of the name at the same time, not with the number of
+ * rules.
+ * The first rule matching in either of them wins.
+ * The table refers to the rules of the arguments it was built from, which
+ * must outlive it.
+ */
+typedef struct rcl_remap_table_t
+{
+  rcl_remap_table_entry_t * entries;
+  size_t entry_count;
+  /// Position of the entry plus one, 0 for an empty slot.
+  size_t * slots;
+  /// Number of slots minus one, the number of slots is a power of two.
+  size_t slot_mask;
+  /// States of the automaton for the rules with wildcards, the first one is the start.
+  rcl_remap_state_t * states;
+  size_t state_count;
+  rcl_remap_transition_t * transitions;
+  size_t transition_count;
+  /// Position of the transition plus one, 0 for an empty slot.
+  size_t * transition_slots;
+  size_t transition_slot_mask;
+  /// Two sets of active states, one for each token and one for the next, used while matching.
+  size_t * state_sets;
+  /// Guards the state sets, so several entities of a node may be initialized at once.
+  rcl_mutex_t state_sets_lock;
+  /// Default substitutions used to expand replacements.
+  rcutils_string_map_t substitutions;
+  rcl_allocator_t allocator;
+} rcl_remap_table_t;
+
+/// Return a rcl_remap_table_t struct with members set to `NULL` or 0.
+RCL_LOCAL
+rcl_remap_table_t
+rcl_get_zero_initialized_remap_table(void);
+
+/// Build the remap table of a node.
+/**
+ * \param[out] table a zero initialized table
+ * \param[in] local_arguments the node's arguments, may be `NULL`
+ * \param[in] global_arguments the context's arguments, may be `NULL`
+ * \param[in] node_name the name of the node, after remapping
+ * \param[in] node_namespace the namespace of the node, after remapping
+ * \param[in] allocator allocator used for the table
+ * \return `RCL_RET_OK` if the table was built, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if an unspecified error occurs.
+ */
+RCL_LOCAL
+rcl_ret_t
+rcl_remap_table_init(
+  rcl_remap_table_t * table,
+  const rcl_arguments_t * local_arguments,
+  const rcl_arguments_t * global_arguments,
+  const char * node_name,
+  const char * node_namespace,
+  rcl_allocator_t allocator);
+
+/// Free the table, safe to call on a zero initialized table.
+RCL_LOCAL
+rcl_ret_t
+rcl_remap_table_fini(rcl_remap_table_t * table);
+
+/// Find the first rule of a type matching a fully qualified name, without allocating memory.
+/**
+ * \param[in] type RCL_TOPIC_REMAP or RCL_SERVICE_REMAP
+ * \return the entry of the rule, or `NULL` if no rule matched.
+ */
+RCL_LOCAL
+const rcl_remap_table_entry_t *
+rcl_remap_table_find_entry(
+  const rcl_remap_table_t * table,
+  rcl_remap_type_t type,
+  const char * name);
+
+/// Get the replacement of a rule for a name it matches, without allocating memory.
+/**
+ * The back-references of a rule with wildcards are replaced with the text the
+ * wildcards matched in the name, and written into the buffer.
+ * The replacement still needs to be expanded to a fully qualified name.
+ *
+ * \param[in] entry an entry found with rcl_remap_table_find_entry()
+ * \param[in] name the name the entry was found for
+ * \param[in] buffer used if the replacement has back-references
+ * \param[in] buffer_size size of the buffer in bytes
+ * \param[out] replacement the rule's replacement or the buffer
+ * \return `RCL_RET_OK` if successful, or
+ * \return `RCL_RET_TOPIC_NAME_INVALID` if the replacement does not fit in the buffer, or
+ * \return `RCL_RET_ERROR` if the entry does not match the name.
+ */
+RCL_LOCAL
+rcl_ret_t
+rcl_remap_table_entry_get_replacement(
+  const rcl_remap_table_entry_t * entry,
+  const char * name,
+  char * buffer,
+  size_t buffer_size,
+  const char ** replacement);
+
+/// Return the remap table built by rcl_node_init(), or `NULL` if the node is invalid.
+RCL_LOCAL
+const rcl_remap_table_t *
+rcl_node_get_remap_table(const rcl_node_t * node);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,331 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./request_coalescer.h"
+
+#include <string.h>
+
+#include "rcl/error_handling.h"
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+#include "rmw/serialized_message.h"
+
+rcl_request_coalescer_t
+rcl_get_zero_initialized_request_coalescer()
+{
+  static rcl_request_coalescer_t null_coalescer = {0};
+  return null_coalescer;
+}
+
+rcl_ret_t
+rcl_request_coalescer_init(
+  rcl_request_coalescer_t * coalescer,
+  const rosidl_message_type_support_t * type_support,
+  size_t pending_request_capacity,
+  rcl_allocator_t allocator)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(coalescer, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(type_support, RCL_RET_INVALID_ARGUMENT);
+  *coalescer = rcl_get_zero_initialized_request_coalescer();
+  if (0 == pending_request_capacity ||
+    pending_request_capacity > SIZE_MAX / (2 * sizeof(rcl_coalesced_request_t)))
+  {
+    RCL_SET_ERROR_MSG("request coalescing requires a valid non zero pending request capacity");
+    return RCL_RET_INVALID_ARGUMENT;
+  }
+  // Room for the requests in flight and as many completed ones being fanned out.
+  size_t capacity = 2 * pending_request_capacity;
+  coalescer->requests = (rcl_coalesced_request_t *)allocator.zero_allocate(
+    capacity, sizeof(rcl_coalesced_request_t), allocator.state);
+  RCL_CHECK_FOR_NULL_WITH_MSG(
+    coalescer->requests, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  if (RCL_RET_OK != rcl_mutex_init(&coalescer->lock)) {
+    allocator.deallocate(coalescer->requests, allocator.state);
+    coalescer->requests = NULL;
+    return RCL_RET_ERROR;  // error already set
+  }
+  coalescer->type_support = type_support;
+  coalescer->capacity = capacity;
+  coalescer->allocator = allocator;
+  return RCL_RET_OK;
+}
+
+static void
+_rcl_request_coalescer_fini_serialized_request(rcl_serialized_message_t * serialized_request)
+{
+  if (NULL != serialized_request->buffer &&
+    RMW_RET_OK != rmw_serialized_message_fini(serialized_request))
+  {
+    rmw_reset_error();
+  }
+}
+
+static void
+_rcl_request_coalescer_deallocate(rcl_request_coalescer_t * coalescer, void * pointer)
+{
+  if (NULL != pointer) {
+    coalescer->allocator.deallocate(pointer, coalescer->allocator.state);
+  }
+}
+
+void
+rcl_request_coalescer_fini(rcl_request_coalescer_t * coalescer)
+{
+  if (NULL == coalescer->requests) {
+    return;
+  }
+  size_t i;
+  for (i = 0; i < coalescer->capacity; ++i) {
+    _rcl_request_coalescer_fini_serialized_request(&coalescer->requests[i].serialized_request);
+    _rcl_request_coalescer_deallocate(coalescer, coalescer->requests[i].waiters);
+  }
+  rcl_mutex_fini(&coalescer->lock);
+  coalescer->allocator.deallocate(coalescer->requests, coalescer->allocator.state);
+  *coalescer = rcl_get_zero_initialized_request_coalescer();
+}
+
+bool
+rcl_request_coalescer_is_enabled(const rcl_request_coalescer_t * coalescer)
+{
+  return NULL != coalescer->requests;
+}
+
+/// 64 bit FNV-1a hash of the serialized request.
+static uint64_t
+_rcl_request_coalescer_hash(const rcl_serialized_message_t * serialized_request)
+{
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  size_t i;
+  for (i = 0; i < serialized_request->buffer_length; ++i) {
+    hash ^= (uint8_t)serialized_request->buffer[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+rcl_ret_t
+rcl_request_coalescer_serialize(
+  rcl_request_coalescer_t * coalescer,
+  const void * ros_request,
+  rcl_serialized_message_t * serialized_request)
+{
+  if (RMW_RET_OK != rmw_serialized_message_init(serialized_request, 0, &coalescer->allocator)) {
+    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+    return RCL_RET_BAD_ALLOC;
+  }
+  if (RMW_RET_OK != rmw_serialize(ros_request, coalescer->type_support, serialized_request)) {
+    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+    rmw_reset_error();
+    if (RMW_RET_OK != rmw_serialized_message_fini(serialized_request)) {
+      rmw_reset_error();
+    }
+    return RCL_RET_ERROR;
+  }
+  return RCL_RET_OK;
+}
+
+static bool
+_rcl_coalesced_request_matches(
+  const rcl_coalesced_request_t * request,
+  uint64_t hash,
+  const rcl_serialized_message_t * serialized_request)
+{
+  if (RCL_COALESCED_REQUEST_IN_FLIGHT != request->state || request->hash != hash ||
+    request->serialized_request.buffer_length != serialized_request->buffer_length)
+  {
+    return false;
+  }
+  return 0 == memcmp(
+    request->serialized_request.buffer, serialized_request->buffer,
+    serialized_request->buffer_length);
+}
+
+rcl_ret_t
+rcl_request_coalescer_begin_send(
+  rcl_request_coalescer_t * coalescer,
+  rcl_serialized_message_t * serialized_request,
+  void * user_data,
+  bool * attached,
+  int64_t * sequence_number,
+  size_t * entry)
+{
+  *attached = false;
+  *entry = SIZE_MAX;
+  uint64_t hash = _rcl_request_coalescer_hash(serialized_request);
+  rcl_ret_t ret = RCL_RET_OK;
+  // A waiter list which is full is grown outside of the lock, then the
+  // request is looked up again since it may have completed meanwhile.
+  void ** new_waiters = NULL;
+  size_t new_capacity = 0;
+  void ** old_waiters = NULL;
+  bool registered = false;
+  while (true) {
+    size_t needed_capacity = 0;
+    rcl_mutex_lock(&coalescer->lock);
+    rcl_coalesced_request_t * match = NULL;
+    size_t free_entry = SIZE_MAX;
+    size_t i;
+    for (i = 0; i < coalescer->capacity && NULL == match; ++i) {
+      rcl_coalesced_request_t * request = &coalescer->requests[i];
+      if (RCL_COALESCED_REQUEST_FREE == request->state) {
+        free_entry = SIZE_MAX == free_entry ? i : free_entry;
+      } else if (_rcl_coalesced_request_matches(request, hash, serialized_request)) {
+        match = request;
+      }
+    }
+    if (NULL != match && match->waiter_count == match->waiter_capacity) {
+      if (new_capacity > match->waiter_capacity) {
+        if (0 != match->waiter_count) {
+          memcpy(new_waiters, match->waiters, sizeof(void *) * match->waiter_count);
+        }
+        old_waiters = match->waiters;
+        match->waiters = new_waiters;
+        match->waiter_capacity = new_capacity;
+        new_waiters = NULL;
+      } else {
+        needed_capacity = match->waiter_capacity ? 2 * match->waiter_capacity : 4;
+      }
+    }
+    if (NULL != match && 0 == needed_capacity) {
+      match->waiters[match->waiter_count++] = user_data;
+      *sequence_number = match->sequence_number;
+      *attached = true;
+    } else if (NULL == match && SIZE_MAX != free_entry) {
+      rcl_coalesced_request_t * request = &coalescer->requests[free_entry];
+      request->state = RCL_COALESCED_REQUEST_SENDING;
+      request->hash = hash;
+      request->serialized_request = *serialized_request;
+      *entry = free_entry;
+      registered = true;
+    }
+    rcl_mutex_unlock(&coalescer->lock);
+    if (0 == needed_capacity) {
+      break;
+    }
+    _rcl_request_coalescer_deallocate(coalescer, new_waiters);
+    new_capacity = needed_capacity;
+    new_waiters = (void **)coalescer->allocator.allocate(
+      sizeof(void *) * new_capacity, coalescer->allocator.state);
+    if (NULL == new_waiters) {
+      RCL_SET_ERROR_MSG("allocating memory failed");
+      ret = RCL_RET_BAD_ALLOC;
+      break;
+    }
+  }
+  _rcl_request_coalescer_deallocate(coalescer, new_waiters);
+  _rcl_request_coalescer_deallocate(coalescer, old_waiters);
+  if (!registered) {
+    _rcl_request_coalescer_fini_serialized_request(serialized_request);
+  }
+  *serialized_request = rmw_get_zero_initialized_serialized_message();
+  return ret;
+}
+
+void
+rcl_request_coalescer_cancel_send(rcl_request_coalescer_t * coalescer, size_t entry)
+{
+  rcl_mutex_lock(&coalescer->lock);
+  rcl_coalesced_request_t request = coalescer->requests[entry];
+  memset(&coalescer->requests[entry], 0, sizeof(rcl_coalesced_request_t));
+  rcl_mutex_unlock(&coalescer->lock);
+  // Nothing attached to the request while it was sending, only its serialized form is left.
+  _rcl_request_coalescer_fini_serialized_request(&request.serialized_request);
+}
+
+void
+rcl_request_coalescer_end_send(
+  rcl_request_coalescer_t * coalescer,
+  size_t entry,
+  int64_t sequence_number)
+{
+  rcl_mutex_lock(&coalescer->lock);
+  coalescer->requests[entry].sequence_number = sequence_number;
+  coalescer->requests[entry].state = RCL_COALESCED_REQUEST_IN_FLIGHT;
+  rcl_mutex_unlock(&coalescer->lock);
+}
+
+/// Find the request in the given state with the given sequence number, or return `NULL`.
+static rcl_coalesced_request_t *
+_rcl_request_coalescer_find(
+  rcl_request_coalescer_t * coalescer,
+  rcl_coalesced_request_state_t state,
+  int64_t sequence_number)
+{
+  size_t i;
+  for (i = 0; i < coalescer->capacity; ++i) {
+    rcl_coalesced_request_t * request = &coalescer->requests[i];
+    if (request->state == state && request->sequence_number == sequence_number) {
+      return request;
+    }
+  }
+  return NULL;
+}
+
+void
+rcl_request_coalescer_complete(rcl_request_coalescer_t * coalescer, int64_t sequence_number)
+{
+  rcl_serialized_message_t serialized_request = rmw_get_zero_initialized_serialized_message();
+  void ** waiters = NULL;
+  rcl_mutex_lock(&coalescer->lock);
+  rcl_coalesced_request_t * request = _rcl_request_coalescer_find(
+    coalescer, RCL_COALESCED_REQUEST_IN_FLIGHT, sequence_number);
+  if (NULL != request) {
+    // Identical requests are sent again from now on, the bytes are not needed anymore.
+    serialized_request = request->serialized_request;
+    request->serialized_request = rmw_get_zero_initialized_serialized_message();
+    if (0 == request->waiter_count) {
+      waiters = request->waiters;
+      memset(request, 0, sizeof(rcl_coalesced_request_t));
+    } else {
+      request->state = RCL_COALESCED_REQUEST_COMPLETED;
+      request->next_waiter = 0;
+    }
+  }
+  rcl_mutex_unlock(&coalescer->lock);
+  _rcl_request_coalescer_fini_serialized_request(&serialized_request);
+  _rcl_request_coalescer_deallocate(coalescer, waiters);
+}
+
+bool
+rcl_request_coalescer_take_waiter(
+  rcl_request_coalescer_t * coalescer,
+  int64_t sequence_number,
+  void ** user_data)
+{
+  void ** waiters = NULL;
+  rcl_mutex_lock(&coalescer->lock);
+  rcl_coalesced_request_t * request = _rcl_request_coalescer_find(
+    coalescer, RCL_COALESCED_REQUEST_COMPLETED, sequence_number);
+  bool taken = NULL != request;
+  if (taken) {
+    *user_data = request->waiters[request->next_waiter++];
+    if (request->next_waiter == request->waiter_count) {
+      // The last waiter was handed out, the entry can be reused.
+      waiters = request->waiters;
+      memset(request, 0, sizeof(rcl_coalesced_request_t));
+    }
+  }
+  rcl_mutex_unlock(&coalescer->lock);
+  _rcl_request_coalescer_deallocate(coalescer, waiters);
+  return taken;
+}
+
+#ifdef __cplusplus
+}
+#endif
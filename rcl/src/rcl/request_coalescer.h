@@ -0,0 +1,197 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__REQUEST_COALESCER_H_
+#define RCL__REQUEST_COALESCER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcl/allocator.h"
+#include "rcl/types.h"
+#include "rcl/visibility_control.h"
+#include "rosidl_generator_c/message_type_support_struct.h"
+
+#include "./mutex.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// State of an entry of the coalescer.
+typedef enum rcl_coalesced_request_state_t
+{
+  /// The entry is unused.
+  RCL_COALESCED_REQUEST_FREE = 0,
+  /// The request is being sent, its sequence number is not known yet.
+  RCL_COALESCED_REQUEST_SENDING,
+  /// The request was sent, identical requests attach to it.
+  RCL_COALESCED_REQUEST_IN_FLIGHT,
+  /// The request completed, its waiters are handed out until none is left.
+  RCL_COALESCED_REQUEST_COMPLETED
+} rcl_coalesced_request_state_t;
+
+/// A request which identical requests can attach to, and its waiters.
+typedef struct rcl_coalesced_request_t
+{
+  rcl_coalesced_request_state_t state;
+  int64_t sequence_number;
+  /// Hash of the serialized request, compared before the bytes are.
+  uint64_t hash;
+  /// The serialized request, only kept while the request is sending or in flight.
+  rcl_serialized_message_t serialized_request;
+  /// User data of the requests which attached to this one, in order.
+  void ** waiters;
+  size_t waiter_count;
+  size_t waiter_capacity;
+  /// Index of the next waiter handed out once the request completed.
+  size_t next_waiter;
+} rcl_coalesced_request_t;
+
+/// Detects identical requests of a client while one of them is in flight.
+/**
+ * Requests are compared in their serialized form.
+ * The requests are kept in a fixed array, which is scanned comparing the
+ * hashes, with two entries per pending request of the client: one for each
+ * request which may be in flight, and one for each completed request whose
+ * waiters have not all been taken yet.
+ * When all entries are used, requests are sent without being coalesced.
+ *
+ * A request is registered by rcl_request_coalescer_begin_send() before it is
+ * sent, and either gets its sequence number from
+ * rcl_request_coalescer_end_send() or is removed again by
+ * rcl_request_coalescer_cancel_send() if sending failed.
+ * When a request completes, i.e. its response is taken or it expires, the
+ * user data of its waiters is handed out one by one by
+ * rcl_request_coalescer_take_waiter(), and the entry is freed once the last
+ * waiter is taken.
+ *
+ * All functions but init and fini may be called concurrently, they are
+ * serialized by a mutex, which is not held while memory is allocated or freed.
+ */
+typedef struct rcl_request_coalescer_t
+{
+  /// Type support of the request message, `NULL` if coalescing is disabled.
+  const rosidl_message_type_support_t * type_support;
+  rcl_coalesced_request_t * requests;
+  size_t capacity;
+  rcl_mutex_t lock;
+  rcl_allocator_t allocator;
+} rcl_request_coalescer_t;
+
+/// Return a disabled coalescer, for which rcl_request_coalescer_is_enabled() is false.
+RCL_LOCAL
+rcl_request_coalescer_t
+rcl_get_zero_initialized_request_coalescer(void);
+
+/// Allocate room for up to `pending_request_capacity` requests in flight.
+/**
+ * \return `RCL_RET_OK` if the coalescer was initialized, or
+ * \return `RCL_RET_INVALID_ARGUMENT` if an argument is invalid, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if the mutex could not be created.
+ */
+RCL_LOCAL
+rcl_ret_t
+rcl_request_coalescer_init(
+  rcl_request_coalescer_t * coalescer,
+  const rosidl_message_type_support_t * type_support,
+  size_t pending_request_capacity,
+  rcl_allocator_t allocator);
+
+/// Free all memory, safe to call on a zero initialized coalescer.
+RCL_LOCAL
+void
+rcl_request_coalescer_fini(rcl_request_coalescer_t * coalescer);
+
+/// Return true if the coalescer was initialized.
+RCL_LOCAL
+bool
+rcl_request_coalescer_is_enabled(const rcl_request_coalescer_t * coalescer);
+
+/// Serialize a request into a zero initialized serialized message.
+/**
+ * On success the caller owns the serialized message, which it must pass to
+ * rcl_request_coalescer_begin_send().
+ */
+RCL_LOCAL
+rcl_ret_t
+rcl_request_coalescer_serialize(
+  rcl_request_coalescer_t * coalescer,
+  const void * ros_request,
+  rcl_serialized_message_t * serialized_request);
+
+/// Attach to an identical request in flight, or register the request to be sent.
+/**
+ * The coalescer takes ownership of the serialized request in any case.
+ *
+ * If no identical request is in flight and `entry` is set to a value other
+ * than `SIZE_MAX`, the request was registered and the caller must finish it
+ * with either rcl_request_coalescer_end_send() or
+ * rcl_request_coalescer_cancel_send().
+ * `SIZE_MAX` means that the request is sent without being coalesced.
+ *
+ * \param[out] attached `true` if the request was attached
+ * \param[out] sequence_number the sequence number of the request attached to
+ * \param[out] entry the entry the request was registered in, if not attached
+ * \return `RCL_RET_OK` if the lookup succeeded, or
+ * \return `RCL_RET_BAD_ALLOC` if the waiter could not be stored.
+ */
+RCL_LOCAL
+rcl_ret_t
+rcl_request_coalescer_begin_send(
+  rcl_request_coalescer_t * coalescer,
+  rcl_serialized_message_t * serialized_request,
+  void * user_data,
+  bool * attached,
+  int64_t * sequence_number,
+  size_t * entry);
+
+/// Remove a registered request which could not be sent.
+RCL_LOCAL
+void
+rcl_request_coalescer_cancel_send(rcl_request_coalescer_t * coalescer, size_t entry);
+
+/// Mark a registered request as in flight, so identical requests attach to it.
+RCL_LOCAL
+void
+rcl_request_coalescer_end_send(
+  rcl_request_coalescer_t * coalescer,
+  size_t entry,
+  int64_t sequence_number);
+
+/// Mark a request as completed, making its waiters available to take_waiter.
+RCL_LOCAL
+void
+rcl_request_coalescer_complete(rcl_request_coalescer_t * coalescer, int64_t sequence_number);
+
+/// Hand out the next waiter of a completed request.
+/**
+ * \return `true` and the waiter's user data, or `false` if there is no
+ *   waiter left or the request with `sequence_number` did not complete.
+ */
+RCL_LOCAL
+bool
+rcl_request_coalescer_take_waiter(
+  rcl_request_coalescer_t * coalescer,
+  int64_t sequence_number,
+  void ** user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__REQUEST_COALESCER_H_
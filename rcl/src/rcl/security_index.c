@@ -0,0 +1,343 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./security_index.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+#include "rcl/error_handling.h"
+#include "rcutils/filesystem.h"
+#include "rcutils/format_string.h"
+#include "rcutils/get_env.h"
+#include "rcutils/logging_macros.h"
+#include "rcutils/macros.h"
+#include "rcutils/strdup.h"
+
+rcl_security_index_t
+rcl_get_zero_initialized_security_index(void)
+{
+  static rcl_security_index_t null_index = {
+    .has_node_directory = false,
+    .node_directory = NULL,
+    .node_names = NULL,
+    .directories = NULL,
+    .count = 0,
+    .capacity = 0,
+    .slots = NULL,
+    .slot_mask = 0,
+    .allocator = {NULL, NULL, NULL, NULL, NULL}
+  };
+  return null_index;
+}
+
+static uint64_t
+_rcl_security_index_hash(uint64_t hash, const char * string)
+{
+  for (; '\0' != *string; ++string) {
+    hash ^= (uint8_t)*string;
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+/// Hash the fully qualified name of a node without formatting it.
+static uint64_t
+_rcl_security_index_hash_node(const char * node_name, const char * node_namespace)
+{
+  uint64_t hash = _rcl_security_index_hash(0xcbf29ce484222325ULL, node_namespace);
+  // The root namespace already ends with the separator.
+  if ('\0' != node_namespace[0] && '\0' != node_namespace[1]) {
+    hash = _rcl_security_index_hash(hash, "/");
+  }
+  return _rcl_security_index_hash(hash, node_name);
+}
+
+/// Compare a fully qualified name with the one of a node, without formatting it.
+static bool
+_rcl_security_index_is_node(
+  const char * fully_qualified_name,
+  const char * node_name,
+  const char * node_namespace)
+{
+  size_t namespace_length = strlen(node_namespace);
+  if (0 != strncmp(fully_qualified_name, node_namespace, namespace_length)) {
+    return false;
+  }
+  fully_qualified_name += namespace_length;
+  if (namespace_length > 1) {
+    if ('/' != *fully_qualified_name) {
+      return false;
+    }
+    ++fully_qualified_name;
+  }
+  return 0 == strcmp(fully_qualified_name, node_name);
+}
+
+/// Append a directory, taking ownership of its name and path.
+static rcl_ret_t
+_rcl_security_index_add(rcl_security_index_t * index, char * node_name, char * directory)
+{
+  rcl_allocator_t * allocator = &index->allocator;
+  if (index->count == index->capacity) {
+    size_t capacity = 0 == index->capacity ? 16 : 2 * index->capacity;
+    char ** node_names = (char **)allocator->reallocate(
+      index->node_names, capacity * sizeof(char *), allocator->state);
+    if (NULL == node_names) {
+      goto fail;
+    }
+    index->node_names = node_names;
+    char ** directories = (char **)allocator->reallocate(
+      index->directories, capacity * sizeof(char *), allocator->state);
+    if (NULL == directories) {
+      goto fail;
+    }
+    index->directories = directories;
+    index->capacity = capacity;
+  }
+  index->node_names[index->count] = node_name;
+  index->directories[index->count] = directory;
+  ++index->count;
+  return RCL_RET_OK;
+fail:
+  allocator->deallocate(node_name, allocator->state);
+  allocator->deallocate(directory, allocator->state);
+  RCL_SET_ERROR_MSG("allocating memory failed");
+  return RCL_RET_BAD_ALLOC;
+}
+
+static rcl_ret_t
+_rcl_security_index_scan(
+  rcl_security_index_t * index,
+  const char * directory,
+  const char * node_name_prefix,
+  size_t depth);
+
+/// Index an entry of a scanned directory if it is a directory itself, and scan it.
+static rcl_ret_t
+_rcl_security_index_visit(
+  rcl_security_index_t * index,
+  const char * directory,
+  const char * node_name_prefix,
+  const char * entry_name,
+  size_t depth)
+{
+  // Skips "." and "..", no node name starts with a dot.
+  if ('.' == entry_name[0]) {
+    return RCL_RET_OK;
+  }
+  rcl_allocator_t * allocator = &index->allocator;
+  char * path = rcutils_join_path(directory, entry_name, *allocator);
+  if (NULL == path) {
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    return RCL_RET_BAD_ALLOC;
+  }
+  if (!rcutils_is_directory(path)) {
+    allocator->deallocate(path, allocator->state);
+    return RCL_RET_OK;
+  }
+  char * node_name = rcutils_format_string(*allocator, "%s/%s", node_name_prefix, entry_name);
+  if (NULL == node_name) {
+    allocator->deallocate(path, allocator->state);
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    return RCL_RET_BAD_ALLOC;
+  }
+  rcl_ret_t ret = _rcl_security_index_add(index, node_name, path);
+  if (RCL_RET_OK != ret) {
+    return ret;  // error already set
+  }
+  if (depth + 1 >= RCL_SECURITY_INDEX_MAX_DEPTH) {
+    return RCL_RET_OK;
+  }
+  // The index owns the strings now, they stay valid when its arrays grow.
+  return _rcl_security_index_scan(index, path, node_name, depth + 1);
+}
+
+static rcl_ret_t
+_rcl_security_index_scan(
+  rcl_security_index_t * index,
+  const char * directory,
+  const char * node_name_prefix,
+  size_t depth)
+{
+  rcl_ret_t ret = RCL_RET_OK;
+#if defined(_WIN32)
+  rcl_allocator_t * allocator = &index->allocator;
+  char * pattern = rcutils_join_path(directory, "*", *allocator);
+  if (NULL == pattern) {
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    return RCL_RET_BAD_ALLOC;
+  }
+  WIN32_FIND_DATAA entry;
+  HANDLE handle = FindFirstFileA(pattern, &entry);
+  allocator->deallocate(pattern, allocator->state);
+  if (INVALID_HANDLE_VALUE == handle) {
+    return RCL_RET_OK;  // unreadable directories are skipped
+  }
+  do {
+    ret = _rcl_security_index_visit(index, directory, node_name_prefix, entry.cFileName, depth);
+  } while (RCL_RET_OK == ret && FindNextFileA(handle, &entry));
+  FindClose(handle);
+#else
+  DIR * dir = opendir(directory);
+  if (NULL == dir) {
+    return RCL_RET_OK;  // unreadable directories are skipped
+  }
+  struct dirent * entry;
+  while (RCL_RET_OK == ret && NULL != (entry = readdir(dir))) {
+    ret = _rcl_security_index_visit(index, directory, node_name_prefix, entry->d_name, depth);
+  }
+  closedir(dir);
+#endif
+  return ret;
+}
+
+static rcl_ret_t
+_rcl_security_index_build_slots(rcl_security_index_t * index)
+{
+  rcl_allocator_t * allocator = &index->allocator;
+  // Keep the load factor at or below one half, so every probe sequence ends in an empty slot.
+  size_t slot_count = 1;
+  while (slot_count < 2 * index->count) {
+    slot_count <<= 1;
+  }
+  index->slots = (size_t *)allocator->zero_allocate(slot_count, sizeof(size_t), allocator->state);
+  if (NULL == index->slots) {
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    return RCL_RET_BAD_ALLOC;
+  }
+  index->slot_mask = slot_count - 1;
+  size_t i;
+  for (i = 0; i < index->count; ++i) {
+    // Same hash as _rcl_security_index_hash_node(), which hashes the name in pieces.
+    size_t slot = (size_t)_rcl_security_index_hash(
+      0xcbf29ce484222325ULL, index->node_names[i]) & index->slot_mask;
+    while (0 != index->slots[slot]) {
+      slot = (slot + 1) & index->slot_mask;
+    }
+    index->slots[slot] = i + 1;
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_security_index_init(rcl_security_index_t * index, rcl_allocator_t allocator)
+{
+  index->allocator = allocator;
+
+  const char * ros_secure_node_env = NULL;
+  if (rcutils_get_env(ROS_SECURITY_NODE_DIRECTORY_VAR_NAME, &ros_secure_node_env)) {
+    RCL_SET_ERROR_MSG(
+      "Environment variable " RCUTILS_STRINGIFY(ROS_SECURITY_NODE_DIRECTORY_VAR_NAME)
+      " could not be read");
+    return RCL_RET_ERROR;
+  }
+  if (NULL != ros_secure_node_env && '\0' != ros_secure_node_env[0]) {
+    index->has_node_directory = true;
+    if (rcutils_is_directory(ros_secure_node_env)) {
+      index->node_directory = rcutils_strdup(ros_secure_node_env, allocator);
+      if (NULL == index->node_directory) {
+        RCL_SET_ERROR_MSG("allocating memory failed");
+        return RCL_RET_BAD_ALLOC;
+      }
+    }
+    return RCL_RET_OK;
+  }
+
+  const char * ros_secure_root_env = NULL;
+  if (rcutils_get_env(ROS_SECURITY_ROOT_DIRECTORY_VAR_NAME, &ros_secure_root_env)) {
+    RCL_SET_ERROR_MSG(
+      "Environment variable " RCUTILS_STRINGIFY(ROS_SECURITY_ROOT_DIRECTORY_VAR_NAME)
+      " could not be read");
+    return RCL_RET_ERROR;
+  }
+  if (NULL == ros_secure_root_env || '\0' == ros_secure_root_env[0]) {
+    return RCL_RET_OK;  // no node has a secure root directory
+  }
+  rcl_ret_t ret = _rcl_security_index_scan(index, ros_secure_root_env, "", 0);
+  if (RCL_RET_OK == ret) {
+    ret = _rcl_security_index_build_slots(index);
+  }
+  if (RCL_RET_OK != ret) {
+    rcl_security_index_fini(index);
+    return ret;  // error already set
+  }
+  RCUTILS_LOG_DEBUG_NAMED(
+    ROS_PACKAGE_NAME, "Indexed %zu secure root directories in '%s'",
+    index->count, ros_secure_root_env);
+  return RCL_RET_OK;
+}
+
+void
+rcl_security_index_fini(rcl_security_index_t * index)
+{
+  rcl_allocator_t * allocator = &index->allocator;
+  if (NULL != index->node_directory) {
+    allocator->deallocate(index->node_directory, allocator->state);
+  }
+  size_t i;
+  for (i = 0; i < index->count; ++i) {
+    allocator->deallocate(index->node_names[i], allocator->state);
+    allocator->deallocate(index->directories[i], allocator->state);
+  }
+  if (NULL != index->node_names) {
+    allocator->deallocate(index->node_names, allocator->state);
+  }
+  if (NULL != index->directories) {
+    allocator->deallocate(index->directories, allocator->state);
+  }
+  if (NULL != index->slots) {
+    allocator->deallocate(index->slots, allocator->state);
+  }
+  *index = rcl_get_zero_initialized_security_index();
+}
+
+const char *
+rcl_security_index_find(
+  const rcl_security_index_t * index,
+  const char * node_name,
+  const char * node_namespace)
+{
+  if (index->has_node_directory) {
+    return index->node_directory;
+  }
+  if (NULL == index->slots || NULL == node_name || NULL == node_namespace) {
+    return NULL;
+  }
+  size_t slot = (size_t)_rcl_security_index_hash_node(node_name, node_namespace) &
+    index->slot_mask;
+  while (0 != index->slots[slot]) {
+    size_t position = index->slots[slot] - 1;
+    if (_rcl_security_index_is_node(index->node_names[position], node_name, node_namespace)) {
+      return index->directories[position];
+    }
+    slot = (slot + 1) & index->slot_mask;
+  }
+  return NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
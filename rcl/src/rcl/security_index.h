@@ -0,0 +1,110 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__SECURITY_INDEX_H_
+#define RCL__SECURITY_INDEX_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rcl/allocator.h"
+#include "rcl/types.h"
+#include "rcl/visibility_control.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define ROS_SECURITY_NODE_DIRECTORY_VAR_NAME "ROS_SECURITY_NODE_DIRECTORY"
+#define ROS_SECURITY_ROOT_DIRECTORY_VAR_NAME "ROS_SECURITY_ROOT_DIRECTORY"
+
+/// Maximum depth of namespaces searched below the security root directory.
+#define RCL_SECURITY_INDEX_MAX_DEPTH 32
+
+/// Secure root directories of the nodes of a context, see rcl_security_index_init().
+typedef struct rcl_security_index_t
+{
+  /// ROS_SECURITY_NODE_DIRECTORY is set, it is used for every node.
+  bool has_node_directory;
+  /// The node directory, `NULL` if it is not a directory.
+  char * node_directory;
+  /// Fully qualified names of the directories below ROS_SECURITY_ROOT_DIRECTORY.
+  char ** node_names;
+  /// Native path of each directory, in the order of node_names.
+  char ** directories;
+  size_t count;
+  size_t capacity;
+  /// Position of the name plus one, 0 for an empty slot.
+  size_t * slots;
+  /// Number of slots minus one, the number of slots is a power of two.
+  size_t slot_mask;
+  rcl_allocator_t allocator;
+} rcl_security_index_t;
+
+/// Return a rcl_security_index_t struct with members set to `NULL` or 0.
+RCL_LOCAL
+rcl_security_index_t
+rcl_get_zero_initialized_security_index(void);
+
+/// Scan the security directories once, so finding the one of a node needs no file system access.
+/**
+ * If ROS_SECURITY_NODE_DIRECTORY is set and not empty, it is checked once and
+ * used for every node.
+ * Otherwise every directory below ROS_SECURITY_ROOT_DIRECTORY, up to
+ * RCL_SECURITY_INDEX_MAX_DEPTH levels deep, is indexed by the fully qualified
+ * node name it stands for, e.g. "a/b/c" as "/a/b/c".
+ * Entries starting with a dot are skipped, they cannot be node names.
+ * Directories which cannot be read are skipped as well, like a missing
+ * directory used to fail the lookup of the nodes within it.
+ *
+ * Directories created after the scan are not seen, the index lives as long
+ * as the context.
+ *
+ * \param[out] index a zero initialized index
+ * \param[in] allocator allocator used for the index
+ * \return `RCL_RET_OK` if the index was built, or
+ * \return `RCL_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCL_RET_ERROR` if the environment could not be read.
+ */
+RCL_LOCAL
+rcl_ret_t
+rcl_security_index_init(rcl_security_index_t * index, rcl_allocator_t allocator);
+
+/// Free the index, safe to call on a zero initialized index.
+RCL_LOCAL
+void
+rcl_security_index_fini(rcl_security_index_t * index);
+
+/// Find the secure root directory of a node.
+/**
+ * Returns the same directories as rcl_get_secure_root(), but without
+ * formatting a path or accessing the file system.
+ *
+ * \param[in] node_name validated node name
+ * \param[in] node_namespace validated, absolute namespace
+ * \return the directory owned by the index, or `NULL` if there is none.
+ */
+RCL_LOCAL
+const char *
+rcl_security_index_find(
+  const rcl_security_index_t * index,
+  const char * node_name,
+  const char * node_namespace);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__SECURITY_INDEX_H_
@@ -23,19 +23,28 @@ extern "C"
 #include <string.h>
 
 #include "rcl/error_handling.h"
-#include "rcl/expand_topic_name.h"
-#include "rcl/remap.h"
 #include "rcutils/logging_macros.h"
 #include "rmw/error_handling.h"
 #include "rmw/rmw.h"
-#include "rmw/validate_full_topic_name.h"
+
+#include "./allocation_audit_impl.h"
+#include "./entity_pool.h"
+#include "./entity_statistics_impl.h"
+#include "./graph_cache.h"
+#include "./name_resolver.h"
+#include "./tracing_impl.h"
 
 typedef struct rcl_service_impl_t
 {
   rcl_service_options_t options;
   rmw_service_t * rmw_handle;
+  rcl_entity_statistics_storage_t statistics;
+  /// The struct came from the service pool of the context.
+  bool is_pooled;
 } rcl_service_impl_t;
 
+const size_t rcl_service_impl_size = sizeof(rcl_service_impl_t);
+
 rcl_service_t
 rcl_get_zero_initialized_service()
 {
@@ -70,95 +79,33 @@ rcl_service_init(
     RCL_SET_ERROR_MSG("service already initialized, or memory was unintialized");
     return RCL_RET_ALREADY_INIT;
   }
-  // Expand the given service name.
-  rcutils_allocator_t rcutils_allocator = *allocator;  // implicit conversion to rcutils version
-  rcutils_string_map_t substitutions_map = rcutils_get_zero_initialized_string_map();
-  rcutils_ret_t rcutils_ret = rcutils_string_map_init(&substitutions_map, 0, rcutils_allocator);
-  if (rcutils_ret != RCUTILS_RET_OK) {
-    RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
-    if (RCUTILS_RET_BAD_ALLOC == rcutils_ret) {
-      return RCL_RET_BAD_ALLOC;
-    }
-    return RCL_RET_ERROR;
-  }
-  rcl_ret_t ret = rcl_get_default_topic_name_substitutions(&substitutions_map);
-  if (ret != RCL_RET_OK) {
-    rcutils_ret = rcutils_string_map_fini(&substitutions_map);
-    if (rcutils_ret != RCUTILS_RET_OK) {
-      RCUTILS_LOG_ERROR_NAMED(
-        ROS_PACKAGE_NAME,
-        "failed to fini string_map (%d) during error handling: %s",
-        rcutils_ret,
-        rcutils_get_error_string().str);
-    }
-    if (RCL_RET_BAD_ALLOC == ret) {
-      return ret;
-    }
-    return RCL_RET_ERROR;
-  }
-  char * expanded_service_name = NULL;
-  char * remapped_service_name = NULL;
-  ret = rcl_expand_topic_name(
-    service_name,
-    rcl_node_get_name(node),
-    rcl_node_get_namespace(node),
-    &substitutions_map,
-    *allocator,
-    &expanded_service_name);
-  rcutils_ret = rcutils_string_map_fini(&substitutions_map);
-  if (rcutils_ret != RCUTILS_RET_OK) {
-    RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
-    ret = RCL_RET_ERROR;
-    goto cleanup;
-    return RCL_RET_ERROR;
+  // Expand, remap and validate the given service name.
+  const rcl_name_resolver_t * name_resolver = rcl_node_get_name_resolver(node);
+  if (NULL == name_resolver) {
+    return RCL_RET_ERROR;  // error already set
   }
+  char remapped_service_name[RCL_RESOLVED_NAME_BUFFER_SIZE];
+  rcl_ret_t ret = rcl_name_resolver_resolve(
+    name_resolver, RCL_SERVICE_REMAP, service_name,
+    remapped_service_name, sizeof(remapped_service_name));
   if (ret != RCL_RET_OK) {
     if (ret == RCL_RET_TOPIC_NAME_INVALID || ret == RCL_RET_UNKNOWN_SUBSTITUTION) {
-      ret = RCL_RET_SERVICE_NAME_INVALID;
-    } else {
-      ret = RCL_RET_ERROR;
+      return RCL_RET_SERVICE_NAME_INVALID;
     }
-    goto cleanup;
-  }
-  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Expanded service name '%s'", expanded_service_name);
-
-  const rcl_node_options_t * node_options = rcl_node_get_options(node);
-  if (NULL == node_options) {
-    ret = RCL_RET_ERROR;
-    goto cleanup;
-  }
-  rcl_arguments_t * global_args = NULL;
-  if (node_options->use_global_arguments) {
-    global_args = &(node->context->global_arguments);
+    return RCL_RET_ERROR;
   }
-  ret = rcl_remap_service_name(
-    &(node_options->arguments), global_args, expanded_service_name,
-    rcl_node_get_name(node), rcl_node_get_namespace(node), *allocator, &remapped_service_name);
+  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Resolved service name '%s'", remapped_service_name);
+  // Allocate space for the implementation struct.
+  void * impl = NULL;
+  bool is_pooled = false;
+  ret = rcl_context_allocate_entity(
+    node->context, RCL_ENTITY_POOL_SERVICE, sizeof(rcl_service_impl_t), allocator, &impl,
+    &is_pooled);
   if (RCL_RET_OK != ret) {
-    goto fail;
-  } else if (NULL == remapped_service_name) {
-    remapped_service_name = expanded_service_name;
-    expanded_service_name = NULL;
+    goto cleanup;  // error message already set
   }
-
-  // Validate the expanded service name.
-  int validation_result;
-  rmw_ret_t rmw_ret = rmw_validate_full_topic_name(remapped_service_name, &validation_result, NULL);
-  if (rmw_ret != RMW_RET_OK) {
-    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
-    ret = RCL_RET_ERROR;
-    goto cleanup;
-  }
-  if (validation_result != RMW_TOPIC_VALID) {
-    RCL_SET_ERROR_MSG(rmw_full_topic_name_validation_result_string(validation_result));
-    ret = RCL_RET_SERVICE_NAME_INVALID;
-    goto cleanup;
-  }
-  // Allocate space for the implementation struct.
-  service->impl = (rcl_service_impl_t *)allocator->allocate(
-    sizeof(rcl_service_impl_t), allocator->state);
-  RCL_CHECK_FOR_NULL_WITH_MSG(
-    service->impl, "allocating memory failed", ret = RCL_RET_BAD_ALLOC; goto cleanup);
+  service->impl = (rcl_service_impl_t *)impl;
+  service->impl->is_pooled = is_pooled;
 
   if (RMW_QOS_POLICY_DURABILITY_TRANSIENT_LOCAL == options->qos.durability) {
     RCUTILS_LOG_WARN_NAMED(
@@ -180,22 +127,21 @@ rcl_service_init(
   }
   // options
   service->impl->options = *options;
+  rcl_entity_statistics_storage_init(&service->impl->statistics);
   RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Service initialized");
+  RCL_TRACEPOINT(RCL_TRACE_SERVICE_INIT, service, 0);
+  rcl_graph_cache_invalidate_for_node(node);
   ret = RCL_RET_OK;
   goto cleanup;
 fail:
   if (service->impl) {
-    allocator->deallocate(service->impl, allocator->state);
+    rcl_context_deallocate_entity(
+      node->context, RCL_ENTITY_POOL_SERVICE, service->impl,
+      sizeof(rcl_service_impl_t), allocator, service->impl->is_pooled);
   }
   ret = fail_ret;
   // Fall through to clean up
 cleanup:
-  if (NULL != expanded_service_name) {
-    allocator->deallocate(expanded_service_name, allocator->state);
-  }
-  if (NULL != remapped_service_name) {
-    allocator->deallocate(remapped_service_name, allocator->state);
-  }
   return ret;
 }
 
@@ -220,7 +166,10 @@ rcl_service_fini(rcl_service_t * service, rcl_node_t * node)
       RCL_SET_ERROR_MSG(rmw_get_error_string().str);
       result = RCL_RET_ERROR;
     }
-    allocator.deallocate(service->impl, allocator.state);
+    rcl_context_deallocate_entity(
+      node->context, RCL_ENTITY_POOL_SERVICE, service->impl,
+      sizeof(rcl_service_impl_t), &allocator, service->impl->is_pooled);
+    rcl_graph_cache_invalidate_for_node(node);
   }
   RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Service finalized");
   return result;
@@ -274,7 +223,7 @@ rcl_take_request(
   rmw_request_id_t * request_header,
   void * ros_request)
 {
-  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Service server taking service request");
+  RCL_HOT_PATH_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Service server taking service request");
   if (!rcl_service_is_valid(service)) {
     return RCL_RET_SERVICE_INVALID;  // error already set
   }
@@ -293,21 +242,25 @@ rcl_take_request(
     }
     return RCL_RET_ERROR;
   }
-  RCUTILS_LOG_DEBUG_NAMED(
+  RCL_HOT_PATH_LOG_DEBUG_NAMED(
     ROS_PACKAGE_NAME, "Service take request succeeded: %s", taken ? "true" : "false");
+  RCL_TRACEPOINT(
+    RCL_TRACE_TAKE_REQUEST, service, taken ? request_header->sequence_number : -1);
   if (!taken) {
+    RCL_ENTITY_STATISTICS_RECORD_FAILURE(&service->impl->statistics);
     return RCL_RET_SERVICE_TAKE_FAILED;
   }
+  RCL_ENTITY_STATISTICS_RECORD_MESSAGE(&service->impl->statistics, 0);
   return RCL_RET_OK;
 }
 
-rcl_ret_t
-rcl_send_response(
+static rcl_ret_t
+_rcl_send_response(
   const rcl_service_t * service,
   rmw_request_id_t * request_header,
   void * ros_response)
 {
-  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Sending service response");
+  RCL_HOT_PATH_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Sending service response");
   if (!rcl_service_is_valid(service)) {
     return RCL_RET_SERVICE_INVALID;  // error already set
   }
@@ -322,6 +275,104 @@ rcl_send_response(
     RCL_SET_ERROR_MSG(rmw_get_error_string().str);
     return RCL_RET_ERROR;
   }
+  RCL_TRACEPOINT(RCL_TRACE_SEND_RESPONSE, service, request_header->sequence_number);
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_send_response(
+  const rcl_service_t * service,
+  rmw_request_id_t * request_header,
+  void * ros_response)
+{
+  rcl_allocation_audit_api_t previous_api =
+    RCL_ALLOCATION_AUDIT_ENTER(RCL_ALLOCATION_AUDIT_SEND_RESPONSE);
+  rcl_ret_t ret = _rcl_send_response(service, request_header, ros_response);
+  RCL_ALLOCATION_AUDIT_EXIT(previous_api);
+  return ret;
+}
+
+rcl_ret_t
+rcl_take_request_batch(
+  const rcl_service_t * service,
+  rmw_request_id_t * request_headers,
+  void * const * ros_requests,
+  size_t capacity,
+  size_t * taken_count)
+{
+  RCL_HOT_PATH_LOG_DEBUG_NAMED(
+    ROS_PACKAGE_NAME, "Service server taking up to %zu service requests", capacity);
+  if (!rcl_service_is_valid(service)) {
+    return RCL_RET_SERVICE_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(request_headers, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(ros_requests, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(taken_count, RCL_RET_INVALID_ARGUMENT);
+  *taken_count = 0;
+  size_t i;
+  for (i = 0; i < capacity; ++i) {
+    RCL_CHECK_ARGUMENT_FOR_NULL(ros_requests[i], RCL_RET_INVALID_ARGUMENT);
+  }
+
+  // Everything is validated once above, the loop only crosses into the middleware.
+  rmw_service_t * rmw_handle = service->impl->rmw_handle;
+  for (i = 0; i < capacity; ++i) {
+    bool taken = false;
+    rmw_ret_t ret = rmw_take_request(rmw_handle, &request_headers[i], ros_requests[i], &taken);
+    if (RMW_RET_OK != ret) {
+      RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+      if (RMW_RET_BAD_ALLOC == ret) {
+        return RCL_RET_BAD_ALLOC;
+      }
+      return RCL_RET_ERROR;
+    }
+    if (!taken) {
+      break;
+    }
+    RCL_TRACEPOINT(RCL_TRACE_TAKE_REQUEST, service, request_headers[i].sequence_number);
+    RCL_ENTITY_STATISTICS_RECORD_MESSAGE(&service->impl->statistics, 0);
+    ++(*taken_count);
+  }
+  RCL_HOT_PATH_LOG_DEBUG_NAMED(
+    ROS_PACKAGE_NAME, "Service take request batch took %zu requests", *taken_count);
+  if (0 == *taken_count) {
+    RCL_TRACEPOINT(RCL_TRACE_TAKE_REQUEST, service, -1);
+    RCL_ENTITY_STATISTICS_RECORD_FAILURE(&service->impl->statistics);
+    return RCL_RET_SERVICE_TAKE_FAILED;
+  }
+  return RCL_RET_OK;
+}
+
+rcl_ret_t
+rcl_send_response_batch(
+  const rcl_service_t * service,
+  rmw_request_id_t * response_headers,
+  void * const * ros_responses,
+  size_t count,
+  size_t * sent_count)
+{
+  RCL_HOT_PATH_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Sending %zu service responses", count);
+  if (!rcl_service_is_valid(service)) {
+    return RCL_RET_SERVICE_INVALID;  // error already set
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(response_headers, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(ros_responses, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(sent_count, RCL_RET_INVALID_ARGUMENT);
+  *sent_count = 0;
+  size_t i;
+  for (i = 0; i < count; ++i) {
+    RCL_CHECK_ARGUMENT_FOR_NULL(ros_responses[i], RCL_RET_INVALID_ARGUMENT);
+  }
+
+  rmw_service_t * rmw_handle = service->impl->rmw_handle;
+  for (i = 0; i < count; ++i) {
+    if (rmw_send_response(rmw_handle, &response_headers[i], ros_responses[i]) != RMW_RET_OK) {
+      RCL_SET_ERROR_MSG(rmw_get_error_string().str);
+      return RCL_RET_ERROR;
+    }
+    RCL_TRACEPOINT(RCL_TRACE_SEND_RESPONSE, service, response_headers[i].sequence_number);
+    ++(*sent_count);
+  }
   return RCL_RET_OK;
 }
 
@@ -336,6 +387,17 @@ rcl_service_is_valid(const rcl_service_t * service)
   return true;
 }
 
+rcl_ret_t
+rcl_service_get_statistics(
+  const rcl_service_t * service,
+  rcl_entity_statistics_t * statistics)
+{
+  if (!rcl_service_is_valid(service)) {
+    return RCL_RET_SERVICE_INVALID;  // error already set
+  }
+  return rcl_entity_statistics_storage_get(&service->impl->statistics, statistics);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -21,21 +21,29 @@ extern "C"
 
 #include <stdio.h>
 
+#include "./allocation_audit_impl.h"
 #include "./common.h"
+#include "./entity_pool.h"
+#include "./entity_statistics_impl.h"
+#include "./graph_cache.h"
+#include "./name_resolver.h"
+#include "./tracing_impl.h"
 #include "rcl/error_handling.h"
-#include "rcl/expand_topic_name.h"
-#include "rcl/remap.h"
 #include "rcutils/logging_macros.h"
 #include "rmw/error_handling.h"
 #include "rmw/rmw.h"
-#include "rmw/validate_full_topic_name.h"
 
 typedef struct rcl_subscription_impl_t
 {
   rcl_subscription_options_t options;
   rmw_subscription_t * rmw_handle;
+  rcl_entity_statistics_storage_t statistics;
+  /// The struct came from the subscription pool of the context.
+  bool is_pooled;
 } rcl_subscription_impl_t;
 
+const size_t rcl_subscription_impl_size = sizeof(rcl_subscription_impl_t);
+
 rcl_subscription_t
 rcl_get_zero_initialized_subscription()
 {
@@ -69,94 +77,32 @@ rcl_subscription_init(
     RCL_SET_ERROR_MSG("subscription already initialized, or memory was uninitialized");
     return RCL_RET_ALREADY_INIT;
   }
-  // Expand the given topic name.
-  rcutils_allocator_t rcutils_allocator = *allocator;  // implicit conversion to rcutils version
-  rcutils_string_map_t substitutions_map = rcutils_get_zero_initialized_string_map();
-  rcutils_ret_t rcutils_ret = rcutils_string_map_init(&substitutions_map, 0, rcutils_allocator);
-  if (rcutils_ret != RCUTILS_RET_OK) {
-    RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
-    if (RCUTILS_RET_BAD_ALLOC == rcutils_ret) {
-      return RCL_RET_BAD_ALLOC;
-    }
-    return RCL_RET_ERROR;
-  }
-  rcl_ret_t ret = rcl_get_default_topic_name_substitutions(&substitutions_map);
-  if (ret != RCL_RET_OK) {
-    rcutils_ret = rcutils_string_map_fini(&substitutions_map);
-    if (rcutils_ret != RCUTILS_RET_OK) {
-      RCUTILS_LOG_ERROR_NAMED(
-        ROS_PACKAGE_NAME,
-        "failed to fini string_map (%d) during error handling: %s",
-        rcutils_ret,
-        rcutils_get_error_string().str);
-    }
-    if (RCL_RET_BAD_ALLOC == ret) {
-      return ret;
-    }
-    return RCL_RET_ERROR;
-  }
-  char * expanded_topic_name = NULL;
-  char * remapped_topic_name = NULL;
-  ret = rcl_expand_topic_name(
-    topic_name,
-    rcl_node_get_name(node),
-    rcl_node_get_namespace(node),
-    &substitutions_map,
-    *allocator,
-    &expanded_topic_name);
-  rcutils_ret = rcutils_string_map_fini(&substitutions_map);
-  if (rcutils_ret != RCUTILS_RET_OK) {
-    RCL_SET_ERROR_MSG(rcutils_get_error_string().str);
-    ret = RCL_RET_ERROR;
-    goto cleanup;
+  // Expand, remap and validate the given topic name.
+  const rcl_name_resolver_t * name_resolver = rcl_node_get_name_resolver(node);
+  if (NULL == name_resolver) {
+    return RCL_RET_ERROR;  // error already set
   }
+  char remapped_topic_name[RCL_RESOLVED_NAME_BUFFER_SIZE];
+  rcl_ret_t ret = rcl_name_resolver_resolve(
+    name_resolver, RCL_TOPIC_REMAP, topic_name, remapped_topic_name, sizeof(remapped_topic_name));
   if (ret != RCL_RET_OK) {
     if (ret == RCL_RET_TOPIC_NAME_INVALID || ret == RCL_RET_UNKNOWN_SUBSTITUTION) {
-      ret = RCL_RET_TOPIC_NAME_INVALID;
-    } else {
-      ret = RCL_RET_ERROR;
+      return RCL_RET_TOPIC_NAME_INVALID;
     }
-    goto cleanup;
-  }
-  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Expanded topic name '%s'", expanded_topic_name);
-
-  const rcl_node_options_t * node_options = rcl_node_get_options(node);
-  if (NULL == node_options) {
-    ret = RCL_RET_ERROR;
-    goto cleanup;
-  }
-  rcl_arguments_t * global_args = NULL;
-  if (node_options->use_global_arguments) {
-    global_args = &(node->context->global_arguments);
+    return RCL_RET_ERROR;
   }
-  ret = rcl_remap_topic_name(
-    &(node_options->arguments), global_args, expanded_topic_name,
-    rcl_node_get_name(node), rcl_node_get_namespace(node), *allocator, &remapped_topic_name);
+  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Resolved topic name '%s'", remapped_topic_name);
+  // Allocate memory for the implementation struct.
+  void * impl = NULL;
+  bool is_pooled = false;
+  ret = rcl_context_allocate_entity(
+    node->context, RCL_ENTITY_POOL_SUBSCRIPTION, sizeof(rcl_subscription_impl_t), allocator,
+    &impl, &is_pooled);
   if (RCL_RET_OK != ret) {
-    goto fail;
-  } else if (NULL == remapped_topic_name) {
-    remapped_topic_name = expanded_topic_name;
-    expanded_topic_name = NULL;
+    goto cleanup;  // error message already set
   }
-
-  // Validate the expanded topic name.
-  int validation_result;
-  rmw_ret_t rmw_ret = rmw_validate_full_topic_name(remapped_topic_name, &validation_result, NULL);
-  if (rmw_ret != RMW_RET_OK) {
-    RCL_SET_ERROR_MSG(rmw_get_error_string().str);
-    ret = RCL_RET_ERROR;
-    goto cleanup;
-  }
-  if (validation_result != RMW_TOPIC_VALID) {
-    RCL_SET_ERROR_MSG(rmw_full_topic_name_validation_result_string(validation_result));
-    ret = RCL_RET_TOPIC_NAME_INVALID;
-    goto cleanup;
-  }
-  // Allocate memory for the implementation struct.
-  subscription->impl = (rcl_subscription_impl_t *)allocator->allocate(
-    sizeof(rcl_subscription_impl_t), allocator->state);
-  RCL_CHECK_FOR_NULL_WITH_MSG(
-    subscription->impl, "allocating memory failed", ret = RCL_RET_BAD_ALLOC; goto cleanup);
+  subscription->impl = (rcl_subscription_impl_t *)impl;
+  subscription->impl->is_pooled = is_pooled;
   // Fill out the implemenation struct.
   // rmw_handle
   // TODO(wjwwood): pass allocator once supported in rmw api.
@@ -172,22 +118,21 @@ rcl_subscription_init(
   }
   // options
   subscription->impl->options = *options;
+  rcl_entity_statistics_storage_init(&subscription->impl->statistics);
   RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Subscription initialized");
+  RCL_TRACEPOINT(RCL_TRACE_SUBSCRIPTION_INIT, subscription, 0);
+  rcl_graph_cache_invalidate_for_node(node);
   ret = RCL_RET_OK;
   goto cleanup;
 fail:
   if (subscription->impl) {
-    allocator->deallocate(subscription->impl, allocator->state);
+    rcl_context_deallocate_entity(
+      node->context, RCL_ENTITY_POOL_SUBSCRIPTION, subscription->impl,
+      sizeof(rcl_subscription_impl_t), allocator, subscription->impl->is_pooled);
   }
   ret = fail_ret;
   // Fall through to cleanup
 cleanup:
-  if (NULL != expanded_topic_name) {
-    allocator->deallocate(expanded_topic_name, allocator->state);
-  }
-  if (NULL != remapped_topic_name) {
-    allocator->deallocate(remapped_topic_name, allocator->state);
-  }
   return ret;
 }
 
@@ -212,7 +157,10 @@ rcl_subscription_fini(rcl_subscription_t * subscription, rcl_node_t * node)
       RCL_SET_ERROR_MSG(rmw_get_error_string().str);
       result = RCL_RET_ERROR;
     }
-    allocator.deallocate(subscription->impl, allocator.state);
+    rcl_context_deallocate_entity(
+      node->context, RCL_ENTITY_POOL_SUBSCRIPTION, subscription->impl,
+      sizeof(rcl_subscription_impl_t), &allocator, subscription->impl->is_pooled);
+    rcl_graph_cache_invalidate_for_node(node);
   }
   RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Subscription finalized");
   return result;
@@ -231,13 +179,13 @@ rcl_subscription_get_default_options()
   return default_options;
 }
 
-rcl_ret_t
-rcl_take(
+static rcl_ret_t
+_rcl_take(
   const rcl_subscription_t * subscription,
   void * ros_message,
   rmw_message_info_t * message_info)
 {
-  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Subscription taking message");
+  RCL_HOT_PATH_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Subscription taking message");
   if (!rcl_subscription_is_valid(subscription)) {
     return RCL_RET_SUBSCRIPTION_INVALID;  // error message already set
   }
@@ -257,21 +205,37 @@ rcl_take(
     }
     return RCL_RET_ERROR;
   }
-  RCUTILS_LOG_DEBUG_NAMED(
+  RCL_HOT_PATH_LOG_DEBUG_NAMED(
     ROS_PACKAGE_NAME, "Subscription take succeeded: %s", taken ? "true" : "false");
+  RCL_TRACEPOINT(RCL_TRACE_TAKE, subscription, taken);
   if (!taken) {
+    RCL_ENTITY_STATISTICS_RECORD_FAILURE(&subscription->impl->statistics);
     return RCL_RET_SUBSCRIPTION_TAKE_FAILED;
   }
+  RCL_ENTITY_STATISTICS_RECORD_MESSAGE(&subscription->impl->statistics, 0);
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_take(
+  const rcl_subscription_t * subscription,
+  void * ros_message,
+  rmw_message_info_t * message_info)
+{
+  rcl_allocation_audit_api_t previous_api =
+    RCL_ALLOCATION_AUDIT_ENTER(RCL_ALLOCATION_AUDIT_TAKE);
+  rcl_ret_t ret = _rcl_take(subscription, ros_message, message_info);
+  RCL_ALLOCATION_AUDIT_EXIT(previous_api);
+  return ret;
+}
+
 rcl_ret_t
 rcl_take_serialized_message(
   const rcl_subscription_t * subscription,
   rcl_serialized_message_t * serialized_message,
   rmw_message_info_t * message_info)
 {
-  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Subscription taking serialized message");
+  RCL_HOT_PATH_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Subscription taking serialized message");
   if (!rcl_subscription_is_valid(subscription)) {
     return RCL_RET_SUBSCRIPTION_INVALID;  // error already set
   }
@@ -290,11 +254,15 @@ rcl_take_serialized_message(
     }
     return RCL_RET_ERROR;
   }
-  RCUTILS_LOG_DEBUG_NAMED(
+  RCL_HOT_PATH_LOG_DEBUG_NAMED(
     ROS_PACKAGE_NAME, "Subscription serialized take succeeded: %s", taken ? "true" : "false");
+  RCL_TRACEPOINT(RCL_TRACE_TAKE, subscription, taken);
   if (!taken) {
+    RCL_ENTITY_STATISTICS_RECORD_FAILURE(&subscription->impl->statistics);
     return RCL_RET_SUBSCRIPTION_TAKE_FAILED;
   }
+  RCL_ENTITY_STATISTICS_RECORD_MESSAGE(
+    &subscription->impl->statistics, serialized_message->buffer_length);
   return RCL_RET_OK;
 }
 
@@ -357,6 +325,17 @@ rcl_subscription_get_publisher_count(
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_subscription_get_statistics(
+  const rcl_subscription_t * subscription,
+  rcl_entity_statistics_t * statistics)
+{
+  if (!rcl_subscription_is_valid(subscription)) {
+    return RCL_RET_SUBSCRIPTION_INVALID;  // error already set
+  }
+  return rcl_entity_statistics_storage_get(&subscription->impl->statistics, statistics);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -26,6 +26,10 @@ extern "C"
 #include "rcutils/stdatomic_helper.h"
 #include "rcutils/time.h"
 
+#include "./allocation_audit_impl.h"
+#include "./entity_pool.h"
+#include "./tracing_impl.h"
+
 typedef struct rcl_timer_impl_t
 {
   // The clock providing time.
@@ -48,8 +52,12 @@ typedef struct rcl_timer_impl_t
   atomic_bool canceled;
   // The user supplied allocator.
   rcl_allocator_t allocator;
+  // The struct came from the timer pool of the context.
+  bool is_pooled;
 } rcl_timer_impl_t;
 
+const size_t rcl_timer_impl_size = sizeof(rcl_timer_impl_t);
+
 rcl_timer_t
 rcl_get_zero_initialized_timer()
 {
@@ -179,21 +187,27 @@ rcl_timer_init(
   atomic_init(&impl.next_call_time, now + period);
   atomic_init(&impl.canceled, false);
   impl.allocator = allocator;
-  timer->impl = (rcl_timer_impl_t *)allocator.allocate(sizeof(rcl_timer_impl_t), allocator.state);
-  if (NULL == timer->impl) {
+  void * timer_impl = NULL;
+  rcl_ret_t ret = rcl_context_allocate_entity(
+    context, RCL_ENTITY_POOL_TIMER, sizeof(rcl_timer_impl_t), &allocator, &timer_impl,
+    &impl.is_pooled);
+  if (RCL_RET_OK != ret) {
     if (RCL_RET_OK != rcl_guard_condition_fini(&(impl.guard_condition))) {
       // Should be impossible
       RCUTILS_LOG_ERROR_NAMED(ROS_PACKAGE_NAME, "Failed to fini guard condition after bad alloc");
     }
-    if (RCL_RET_OK != rcl_clock_remove_jump_callback(clock, _rcl_timer_time_jump, timer)) {
+    if (
+      RCL_ROS_TIME == clock->type &&
+      RCL_RET_OK != rcl_clock_remove_jump_callback(clock, _rcl_timer_time_jump, timer))
+    {
       // Should be impossible
       RCUTILS_LOG_ERROR_NAMED(ROS_PACKAGE_NAME, "Failed to remove callback after bad alloc");
     }
-
-    RCL_SET_ERROR_MSG("allocating memory failed");
-    return RCL_RET_BAD_ALLOC;
+    return ret;  // error message already set
   }
+  timer->impl = (rcl_timer_impl_t *)timer_impl;
   *timer->impl = impl;
+  RCL_TRACEPOINT(RCL_TRACE_TIMER_INIT, timer, period);
   return RCL_RET_OK;
 }
 
@@ -216,7 +230,9 @@ rcl_timer_fini(rcl_timer_t * timer)
       RCUTILS_LOG_ERROR_NAMED(ROS_PACKAGE_NAME, "Failed to remove timer jump callback");
     }
   }
-  allocator.deallocate(timer->impl, allocator.state);
+  rcl_context_deallocate_entity(
+    timer->impl->context, RCL_ENTITY_POOL_TIMER, timer->impl, sizeof(rcl_timer_impl_t),
+    &allocator, timer->impl->is_pooled);
   timer->impl = NULL;
   return result;
 }
@@ -233,10 +249,10 @@ rcl_timer_clock(rcl_timer_t * timer, rcl_clock_t ** clock)
   return RCL_RET_OK;
 }
 
-rcl_ret_t
-rcl_timer_call(rcl_timer_t * timer)
+static rcl_ret_t
+_rcl_timer_call(rcl_timer_t * timer)
 {
-  RCUTILS_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Calling timer");
+  RCL_HOT_PATH_LOG_DEBUG_NAMED(ROS_PACKAGE_NAME, "Calling timer");
   RCL_CHECK_ARGUMENT_FOR_NULL(timer, RCL_RET_INVALID_ARGUMENT);
   if (rcutils_atomic_load_bool(&timer->impl->canceled)) {
     RCL_SET_ERROR_MSG("timer is canceled");
@@ -253,6 +269,7 @@ rcl_timer_call(rcl_timer_t * timer)
   }
   rcl_time_point_value_t previous_ns =
     rcutils_atomic_exchange_int64_t(&timer->impl->last_call_time, now);
+  RCL_TRACEPOINT(RCL_TRACE_TIMER_CALL, timer, now - previous_ns);
   rcl_timer_callback_t typed_callback =
     (rcl_timer_callback_t)rcutils_atomic_load_uintptr_t(&timer->impl->callback);
 
@@ -284,6 +301,16 @@ rcl_timer_call(rcl_timer_t * timer)
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_timer_call(rcl_timer_t * timer)
+{
+  rcl_allocation_audit_api_t previous_api =
+    RCL_ALLOCATION_AUDIT_ENTER(RCL_ALLOCATION_AUDIT_TIMER_CALL);
+  rcl_ret_t ret = _rcl_timer_call(timer);
+  RCL_ALLOCATION_AUDIT_EXIT(previous_api);
+  return ret;
+}
+
 rcl_ret_t
 rcl_timer_is_ready(const rcl_timer_t * timer, bool * is_ready)
 {
@@ -0,0 +1,300 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./tracing_impl.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "rcl/allocator.h"
+#include "rcl/error_handling.h"
+#include "rcutils/macros.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/time.h"
+
+#ifdef RCL_ENABLE_TRACING
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/// Ring buffer of the most recent events of one thread.
+/**
+ * Only the owning thread writes into a buffer, so advancing `head` needs no
+ * read-modify-write, other threads only read it when dumping.
+ * Before overwriting the slot of event `n` the owner sets `reserved` to
+ * `n + 1`, so a dump can tell whether a slot changed while it was copied.
+ *
+ * Buffers are never freed, so that the list can be walked without a lock.
+ * When its thread exits a buffer is handed to the next thread which starts
+ * recording, which bounds the memory by the number of threads recording at
+ * the same time, and until then the events of the exited thread can still
+ * be dumped.
+ */
+typedef struct rcl_trace_buffer_t
+{
+  struct rcl_trace_buffer_t * next;
+  /// Whether a running thread owns the buffer.
+  atomic_bool in_use;
+  uint32_t thread_index;
+  /// Number of events the owner started to write.
+  atomic_uint_least64_t reserved;
+  /// Total number of events written, the next one goes to head % capacity.
+  atomic_uint_least64_t head;
+  rcl_trace_event_t events[RCL_TRACE_BUFFER_CAPACITY];
+} rcl_trace_buffer_t;
+
+static atomic_bool __rcl_tracing_enabled = ATOMIC_VAR_INIT(true);
+/// Head of the singly linked list of all thread buffers.
+static atomic_uintptr_t __rcl_trace_buffers = ATOMIC_VAR_INIT(0);
+static atomic_uint_least64_t __rcl_trace_thread_count = ATOMIC_VAR_INIT(0);
+static RCUTILS_THREAD_LOCAL rcl_trace_buffer_t * __rcl_trace_thread_buffer = NULL;
+
+static void
+_rcl_tracing_release_thread_buffer(void * buffer)
+{
+  rcutils_atomic_store(&((rcl_trace_buffer_t *)buffer)->in_use, false);
+}
+
+#if defined(_WIN32)
+static INIT_ONCE __rcl_trace_key_once = INIT_ONCE_STATIC_INIT;
+static DWORD __rcl_trace_key = FLS_OUT_OF_INDEXES;
+
+static VOID WINAPI
+_rcl_tracing_fls_callback(PVOID buffer)
+{
+  if (NULL != buffer) {
+    _rcl_tracing_release_thread_buffer(buffer);
+  }
+}
+
+static BOOL CALLBACK
+_rcl_tracing_create_key(PINIT_ONCE once, PVOID parameter, PVOID * context)
+{
+  (void)once;
+  (void)parameter;
+  (void)context;
+  __rcl_trace_key = FlsAlloc(_rcl_tracing_fls_callback);
+  return TRUE;
+}
+
+/// Release the buffer when the calling thread exits, return false if that is not possible.
+static bool
+_rcl_tracing_release_at_thread_exit(rcl_trace_buffer_t * buffer)
+{
+  InitOnceExecuteOnce(&__rcl_trace_key_once, _rcl_tracing_create_key, NULL, NULL);
+  return FLS_OUT_OF_INDEXES != __rcl_trace_key && FlsSetValue(__rcl_trace_key, buffer);
+}
+#else
+static pthread_once_t __rcl_trace_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t __rcl_trace_key;
+static bool __rcl_trace_key_created = false;
+
+static void
+_rcl_tracing_create_key(void)
+{
+  __rcl_trace_key_created =
+    0 == pthread_key_create(&__rcl_trace_key, _rcl_tracing_release_thread_buffer);
+}
+
+/// Release the buffer when the calling thread exits, return false if that is not possible.
+static bool
+_rcl_tracing_release_at_thread_exit(rcl_trace_buffer_t * buffer)
+{
+  return 0 == pthread_once(&__rcl_trace_key_once, _rcl_tracing_create_key) &&
+         __rcl_trace_key_created &&
+         0 == pthread_setspecific(__rcl_trace_key, buffer);
+}
+#endif
+
+/// Take the buffer of a thread which exited, or `NULL` if there is none.
+static rcl_trace_buffer_t *
+_rcl_tracing_reuse_buffer(void)
+{
+  rcl_trace_buffer_t * buffer =
+    (rcl_trace_buffer_t *)rcutils_atomic_load_uintptr_t(&__rcl_trace_buffers);
+  for (; NULL != buffer; buffer = buffer->next) {
+    bool expected = false;
+    bool claimed = false;
+    rcutils_atomic_compare_exchange_strong(&buffer->in_use, claimed, &expected, true);
+    if (claimed) {
+      return buffer;
+    }
+  }
+  return NULL;
+}
+
+static rcl_trace_buffer_t *
+_rcl_tracing_get_thread_buffer(void)
+{
+  if (NULL != __rcl_trace_thread_buffer) {
+    return __rcl_trace_thread_buffer;
+  }
+  rcl_trace_buffer_t * buffer = _rcl_tracing_reuse_buffer();
+  if (NULL == buffer) {
+    rcl_allocator_t allocator = rcl_get_default_allocator();
+    buffer = (rcl_trace_buffer_t *)allocator.zero_allocate(
+      1, sizeof(rcl_trace_buffer_t), allocator.state);
+    if (NULL == buffer) {
+      return NULL;
+    }
+    atomic_init(&buffer->in_use, true);
+    atomic_init(&buffer->reserved, 0);
+    atomic_init(&buffer->head, 0);
+    // Push the buffer onto the global list.
+    uintptr_t old_head = rcutils_atomic_load_uintptr_t(&__rcl_trace_buffers);
+    bool pushed = false;
+    do {
+      buffer->next = (rcl_trace_buffer_t *)old_head;
+      rcutils_atomic_compare_exchange_strong(
+        &__rcl_trace_buffers, pushed, &old_head, (uintptr_t)buffer);
+    } while (!pushed);
+  }
+  buffer->thread_index =
+    (uint32_t)rcutils_atomic_fetch_add_uint64_t(&__rcl_trace_thread_count, 1);
+  // If this fails the buffer stays with this thread for good, like before it exited.
+  (void)_rcl_tracing_release_at_thread_exit(buffer);
+  __rcl_trace_thread_buffer = buffer;
+  return buffer;
+}
+
+void
+rcl_tracing_record(rcl_trace_event_type_t type, const void * handle, int64_t argument)
+{
+  if (!rcutils_atomic_load_bool(&__rcl_tracing_enabled)) {
+    return;
+  }
+  rcl_trace_buffer_t * buffer = _rcl_tracing_get_thread_buffer();
+  if (NULL == buffer) {
+    return;
+  }
+  rcutils_time_point_value_t now = 0;
+  if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+    rcutils_reset_error();
+  }
+  uint64_t head = rcutils_atomic_load_uint64_t(&buffer->head);
+  // Announce the overwrite before touching the slot, see rcl_tracing_dump().
+  rcutils_atomic_store(&buffer->reserved, head + 1);
+  atomic_thread_fence(memory_order_release);
+  rcl_trace_event_t * event = &buffer->events[head % RCL_TRACE_BUFFER_CAPACITY];
+  event->timestamp = now;
+  event->type = (uint32_t)type;
+  event->thread_index = buffer->thread_index;
+  event->handle = (uint64_t)(uintptr_t)handle;
+  event->argument = argument;
+  // Publish the event only once it is complete.
+  rcutils_atomic_store(&buffer->head, head + 1);
+}
+
+bool
+rcl_tracing_is_available(void)
+{
+  return true;
+}
+
+void
+rcl_tracing_set_enabled(bool enabled)
+{
+  rcutils_atomic_store(&__rcl_tracing_enabled, enabled);
+}
+
+rcl_ret_t
+rcl_tracing_dump(const char * file_path)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(file_path, RCL_RET_INVALID_ARGUMENT);
+  FILE * file = fopen(file_path, "wb");
+  if (NULL == file) {
+    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("failed to open trace file '%s'", file_path);
+    return RCL_RET_ERROR;
+  }
+  rcl_trace_file_header_t header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, RCL_TRACE_FILE_MAGIC, sizeof(header.magic));
+  header.version = RCL_TRACE_FILE_VERSION;
+  header.event_size = sizeof(rcl_trace_event_t);
+  // The header is written again once the number of events is known.
+  bool ok = 1 == fwrite(&header, sizeof(header), 1, file);
+
+  rcl_trace_buffer_t * buffer =
+    (rcl_trace_buffer_t *)rcutils_atomic_load_uintptr_t(&__rcl_trace_buffers);
+  for (; ok && NULL != buffer; buffer = buffer->next) {
+    uint64_t head = rcutils_atomic_load_uint64_t(&buffer->head);
+    uint64_t count = head < RCL_TRACE_BUFFER_CAPACITY ? head : RCL_TRACE_BUFFER_CAPACITY;
+    uint64_t i;
+    for (i = head - count; ok && i < head; ++i) {
+      rcl_trace_event_t event = buffer->events[i % RCL_TRACE_BUFFER_CAPACITY];
+      atomic_thread_fence(memory_order_acquire);
+      // Skip the event if the owner started to overwrite its slot while it was copied.
+      if (rcutils_atomic_load_uint64_t(&buffer->reserved) > i + RCL_TRACE_BUFFER_CAPACITY) {
+        continue;
+      }
+      ok = 1 == fwrite(&event, sizeof(event), 1, file);
+      ++header.event_count;
+    }
+  }
+  if (ok) {
+    ok = 0 == fseek(file, 0, SEEK_SET) && 1 == fwrite(&header, sizeof(header), 1, file);
+  }
+  if (0 != fclose(file)) {
+    ok = false;
+  }
+  if (!ok) {
+    RCL_SET_ERROR_MSG_WITH_FORMAT_STRING("failed to write trace file '%s'", file_path);
+    return RCL_RET_ERROR;
+  }
+  return RCL_RET_OK;
+}
+
+#else  // RCL_ENABLE_TRACING
+
+void
+rcl_tracing_record(rcl_trace_event_type_t type, const void * handle, int64_t argument)
+{
+  (void)type;
+  (void)handle;
+  (void)argument;
+}
+
+bool
+rcl_tracing_is_available(void)
+{
+  return false;
+}
+
+void
+rcl_tracing_set_enabled(bool enabled)
+{
+  (void)enabled;
+}
+
+rcl_ret_t
+rcl_tracing_dump(const char * file_path)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(file_path, RCL_RET_INVALID_ARGUMENT);
+  RCL_SET_ERROR_MSG("rcl was built without tracing");
+  return RCL_RET_ERROR;
+}
+
+#endif  // RCL_ENABLE_TRACING
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,54 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RCL__TRACING_IMPL_H_
+#define RCL__TRACING_IMPL_H_
+
+#include "rcl/tracing.h"
+#include "rcl/visibility_control.h"
+#include "rcutils/logging_macros.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// Record one event into the calling thread's ring buffer.
+RCL_LOCAL
+void
+rcl_tracing_record(rcl_trace_event_type_t type, const void * handle, int64_t argument);
+
+#ifdef RCL_ENABLE_TRACING
+# define RCL_TRACEPOINT(type, handle, argument) \
+  rcl_tracing_record(type, handle, (int64_t)(argument))
+#else
+# define RCL_TRACEPOINT(type, handle, argument) ((void)0)
+#endif
+
+// Debug logging on per message and per wait paths, which can be compiled out
+// because even filtered log calls cost a logger level lookup.
+#ifndef RCL_DISABLE_HOT_PATH_DEBUG_LOGGING
+# define RCL_HOT_PATH_LOG_DEBUG_NAMED(...) RCUTILS_LOG_DEBUG_NAMED(__VA_ARGS__)
+# define RCL_HOT_PATH_LOG_DEBUG_EXPRESSION_NAMED(...) \
+  RCUTILS_LOG_DEBUG_EXPRESSION_NAMED(__VA_ARGS__)
+#else
+# define RCL_HOT_PATH_LOG_DEBUG_NAMED(...)
+# define RCL_HOT_PATH_LOG_DEBUG_EXPRESSION_NAMED(...)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCL__TRACING_IMPL_H_
@@ -19,9 +19,17 @@ extern "C"
 
 #include "rcl/validate_topic_name.h"
 
-#include <ctype.h>
+#include <stdbool.h>
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define RCL_VALIDATE_TOPIC_NAME_USE_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define RCL_VALIDATE_TOPIC_NAME_USE_NEON
+#endif
+
 #include "rcl/allocator.h"
 #include "rcl/error_handling.h"
 #include "rcutils/isalnum_no_locale.h"
@@ -37,6 +45,79 @@ rcl_validate_topic_name(
     topic_name, strlen(topic_name), validation_result, invalid_index);
 }
 
+/// Return true if the character is alphanumeric or an underscore, the characters of a token.
+static inline bool
+_rcl_is_token_character(char c)
+{
+  return rcutils_isalnum_no_locale(c) || '_' == c;
+}
+
+/// Return true if the character is a decimal digit.
+/**
+ * Unlike isdigit(), this is defined for negative chars, which names that have
+ * not been validated yet may hold.
+ */
+static inline bool
+_rcl_is_digit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+/// Return the index of the first character from i on which is not a token character.
+/**
+ * Tokens make up most of a topic name, so they are skipped 16 characters at a
+ * time where SSE2 or NEON is available.
+ * Only the special characters in between are classified one at a time.
+ */
+static size_t
+_rcl_skip_token_characters(const char * topic_name, size_t i, size_t topic_name_length)
+{
+#if defined(RCL_VALIDATE_TOPIC_NAME_USE_SSE2)
+  const __m128i case_bit = _mm_set1_epi8(0x20);
+  const __m128i before_a = _mm_set1_epi8('a' - 1);
+  const __m128i after_z = _mm_set1_epi8('z' + 1);
+  const __m128i before_0 = _mm_set1_epi8('0' - 1);
+  const __m128i after_9 = _mm_set1_epi8('9' + 1);
+  const __m128i underscore = _mm_set1_epi8('_');
+  while (topic_name_length - i >= 16) {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)(topic_name + i));
+    // Bytes outside of ASCII are negative, so they fail both ranges.
+    __m128i lower = _mm_or_si128(chunk, case_bit);
+    __m128i is_alpha = _mm_and_si128(
+      _mm_cmpgt_epi8(lower, before_a), _mm_cmplt_epi8(lower, after_z));
+    __m128i is_digit = _mm_and_si128(
+      _mm_cmpgt_epi8(chunk, before_0), _mm_cmplt_epi8(chunk, after_9));
+    __m128i is_token = _mm_or_si128(
+      _mm_or_si128(is_alpha, is_digit), _mm_cmpeq_epi8(chunk, underscore));
+    if (0xFFFF != _mm_movemask_epi8(is_token)) {
+      break;
+    }
+    i += 16;
+  }
+#elif defined(RCL_VALIDATE_TOPIC_NAME_USE_NEON)
+  const uint8x16_t case_bit = vdupq_n_u8(0x20);
+  while (topic_name_length - i >= 16) {
+    uint8x16_t chunk = vld1q_u8((const uint8_t *)(topic_name + i));
+    uint8x16_t lower = vorrq_u8(chunk, case_bit);
+    uint8x16_t is_alpha = vandq_u8(
+      vcgeq_u8(lower, vdupq_n_u8('a')), vcleq_u8(lower, vdupq_n_u8('z')));
+    uint8x16_t is_digit = vandq_u8(
+      vcgeq_u8(chunk, vdupq_n_u8('0')), vcleq_u8(chunk, vdupq_n_u8('9')));
+    uint8x16_t is_token = vorrq_u8(
+      vorrq_u8(is_alpha, is_digit), vceqq_u8(chunk, vdupq_n_u8('_')));
+    if (0xFF != vminvq_u8(is_token)) {
+      break;
+    }
+    i += 16;
+  }
+#endif
+  // The remaining characters, or the chunk with the first special character.
+  while (i < topic_name_length && _rcl_is_token_character(topic_name[i])) {
+    ++i;
+  }
+  return i;
+}
+
 rcl_ret_t
 rcl_validate_topic_name_with_size(
   const char * topic_name,
@@ -55,7 +136,7 @@ rcl_validate_topic_name_with_size(
     return RCL_RET_OK;
   }
   // check that the first character is not a number
-  if (isdigit(topic_name[0]) != 0) {
+  if (_rcl_is_digit(topic_name[0])) {
     // this is the case where the topic is relative and the first token starts with a number
     // e.g. 7foo/bar is invalid
     *validation_result = RCL_TOPIC_NAME_INVALID_NAME_TOKEN_STARTS_WITH_NUMBER;
@@ -76,28 +157,11 @@ rcl_validate_topic_name_with_size(
   // check for unallowed characters, nested and unmatched {} too
   bool in_open_curly_brace = false;
   size_t opening_curly_brace_index = 0;
-  for (size_t i = 0; i < topic_name_length; ++i) {
-    if (rcutils_isalnum_no_locale(topic_name[i])) {
-      // if within curly braces and the first character is a number, error
-      // e.g. foo/{4bar} is invalid
-      if (
-        isdigit(topic_name[i]) != 0 &&
-        in_open_curly_brace &&
-        i > 0 &&
-        (i - 1 == opening_curly_brace_index))
-      {
-        *validation_result = RCL_TOPIC_NAME_INVALID_SUBSTITUTION_STARTS_WITH_NUMBER;
-        if (invalid_index) {
-          *invalid_index = i;
-        }
-        return RCL_RET_OK;
-      }
-      // if it is an alpha numeric character, i.e. [0-9|A-Z|a-z], continue
-      continue;
-    } else if (topic_name[i] == '_') {
-      // if it is an underscore, continue
-      continue;
-    } else if (topic_name[i] == '/') {
+  // the first token (other than the first one) that starts with a number, reported last
+  size_t number_token_index = 0;
+  size_t i = _rcl_skip_token_characters(topic_name, 0, topic_name_length);
+  for (; i < topic_name_length; i = _rcl_skip_token_characters(topic_name, i, topic_name_length)) {
+    if (topic_name[i] == '/') {
       // if it is a forward slash within {}, error
       if (in_open_curly_brace) {
         *validation_result = RCL_TOPIC_NAME_INVALID_SUBSTITUTION_CONTAINS_UNALLOWED_CHARACTERS;
@@ -106,8 +170,12 @@ rcl_validate_topic_name_with_size(
         }
         return RCL_RET_OK;
       }
-      // if it is a forward slash outside of {}, continue
-      continue;
+      // if it is followed by a number, remember it, e.g. foo/123bar is invalid
+      if (
+        0 == number_token_index && i + 1 < topic_name_length && _rcl_is_digit(topic_name[i + 1]))
+      {
+        number_token_index = i + 1;
+      }
     } else if (topic_name[i] == '~') {
       // if it is a tilde not in the first position, validation fails
       if (i != 0) {
@@ -117,8 +185,6 @@ rcl_validate_topic_name_with_size(
         }
         return RCL_RET_OK;
       }
-      // if it is a tilde in the first position, continue
-      continue;
     } else if (topic_name[i] == '{') {
       opening_curly_brace_index = i;
       // if starting a nested curly brace, error
@@ -132,8 +198,15 @@ rcl_validate_topic_name_with_size(
         return RCL_RET_OK;
       }
       in_open_curly_brace = true;
-      // if it is a new, open curly brace, continue
-      continue;
+      // if the first character within the curly braces is a number, error
+      // e.g. foo/{4bar} is invalid
+      if (i + 1 < topic_name_length && _rcl_is_digit(topic_name[i + 1])) {
+        *validation_result = RCL_TOPIC_NAME_INVALID_SUBSTITUTION_STARTS_WITH_NUMBER;
+        if (invalid_index) {
+          *invalid_index = i + 1;
+        }
+        return RCL_RET_OK;
+      }
     } else if (topic_name[i] == '}') {
       // if not preceded by a {, error
       if (!in_open_curly_brace) {
@@ -144,8 +217,6 @@ rcl_validate_topic_name_with_size(
         return RCL_RET_OK;
       }
       in_open_curly_brace = false;
-      // if it is a closing curly brace, continue
-      continue;
     } else {
       // if it is none of these, then it is an unallowed character in a topic name
       if (in_open_curly_brace) {
@@ -158,6 +229,7 @@ rcl_validate_topic_name_with_size(
       }
       return RCL_RET_OK;
     }
+    ++i;
   }
   // check to make sure substitutions were properly closed
   if (in_open_curly_brace) {
@@ -168,37 +240,50 @@ rcl_validate_topic_name_with_size(
     }
     return RCL_RET_OK;
   }
-  // check for tokens (other than the first) that start with a number
-  for (size_t i = 0; i < topic_name_length; ++i) {
-    if (i == topic_name_length - 1) {
-      // if this is the last character, then nothing to check
-      continue;
+  if (topic_name_length > 2 && topic_name[0] == '~' && topic_name[1] != '/') {
+    // special case where first character is ~ but second character is not /
+    // e.g. ~foo is invalid
+    *validation_result = RCL_TOPIC_NAME_INVALID_TILDE_NOT_FOLLOWED_BY_FORWARD_SLASH;
+    if (invalid_index) {
+      *invalid_index = 1;
     }
-    // past this point, assuming i+1 is a valid index
-    if (topic_name[i] == '/') {
-      if (isdigit(topic_name[i + 1]) != 0) {
-        // this is the case where a '/' if followed by a number, i.e. [0-9]
-        *validation_result = RCL_TOPIC_NAME_INVALID_NAME_TOKEN_STARTS_WITH_NUMBER;
-        if (invalid_index) {
-          *invalid_index = i + 1;
-        }
-        return RCL_RET_OK;
-      }
-    } else if (i == 1 && topic_name[0] == '~') {
-      // special case where first character is ~ but second character is not /
-      // e.g. ~foo is invalid
-      *validation_result = RCL_TOPIC_NAME_INVALID_TILDE_NOT_FOLLOWED_BY_FORWARD_SLASH;
-      if (invalid_index) {
-        *invalid_index = 1;
-      }
-      return RCL_RET_OK;
+    return RCL_RET_OK;
+  }
+  if (0 != number_token_index) {
+    // this is the case where a '/' if followed by a number, i.e. [0-9]
+    *validation_result = RCL_TOPIC_NAME_INVALID_NAME_TOKEN_STARTS_WITH_NUMBER;
+    if (invalid_index) {
+      *invalid_index = number_token_index;
     }
+    return RCL_RET_OK;
   }
   // everything was ok, set result to valid topic, avoid setting invalid_index, and return
   *validation_result = RCL_TOPIC_NAME_VALID;
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_validate_topic_names(
+  const char * const * topic_names,
+  size_t topic_name_count,
+  int * validation_results,
+  size_t * invalid_indices)
+{
+  if (0 == topic_name_count) {
+    return RCL_RET_OK;
+  }
+  RCL_CHECK_ARGUMENT_FOR_NULL(topic_names, RCL_RET_INVALID_ARGUMENT);
+  RCL_CHECK_ARGUMENT_FOR_NULL(validation_results, RCL_RET_INVALID_ARGUMENT);
+  for (size_t i = 0; i < topic_name_count; ++i) {
+    rcl_ret_t ret = rcl_validate_topic_name(
+      topic_names[i], &validation_results[i], invalid_indices ? &invalid_indices[i] : NULL);
+    if (RCL_RET_OK != ret) {
+      return ret;  // error already set
+    }
+  }
+  return RCL_RET_OK;
+}
+
 const char *
 rcl_topic_name_validation_result_string(int validation_result)
 {
@@ -30,6 +30,13 @@ extern "C"
 #include "rmw/error_handling.h"
 #include "rmw/rmw.h"
 
+#include "./allocation_audit_impl.h"
+#include "./context_impl.h"
+#include "./entity_pool.h"
+#include "./graph_cache.h"
+#include "./guard_condition_impl.h"
+#include "./tracing_impl.h"
+
 typedef struct rcl_wait_set_impl_t
 {
   // number of subscriptions that have been added to the wait set
@@ -48,8 +55,24 @@ typedef struct rcl_wait_set_impl_t
   // number of timers that have been added to the wait set
   size_t timer_index;
   rcl_allocator_t allocator;
+  // context whose pools the wait set was allocated from, NULL if initialized without one
+  rcl_context_t * context;
+  // the struct came from the wait set pool of the context
+  bool is_pooled;
+  // storage of the arrays in the pool slot of a pooled wait set, NULL otherwise
+  void ** pool_entries;
+  // number of entities of all kinds which fit in the pool slot
+  size_t pool_entity_count;
+  // guard conditions passed to rmw_wait() if a context's graph guard condition is waited on,
+  // the rmw guard conditions followed by the graph guard conditions of the context's nodes
+  void ** graph_wait_guard_conditions;
+  // index of the context's graph guard condition each node's graph guard condition stands for
+  size_t * graph_wait_owners;
+  size_t graph_wait_capacity;
 } rcl_wait_set_impl_t;
 
+const size_t rcl_wait_set_impl_size = sizeof(rcl_wait_set_impl_t);
+
 rcl_wait_set_t
 rcl_get_zero_initialized_wait_set()
 {
@@ -78,25 +101,32 @@ __wait_set_is_valid(const rcl_wait_set_t * wait_set)
 static void
 __wait_set_clean_up(rcl_wait_set_t * wait_set, rcl_allocator_t allocator)
 {
-  if (wait_set->subscriptions) {
+  if (wait_set->subscriptions || (wait_set->impl && wait_set->impl->pool_entries)) {
     rcl_ret_t ret = rcl_wait_set_resize(wait_set, 0, 0, 0, 0, 0);
     (void)ret;  // NO LINT
     assert(RCL_RET_OK == ret);  // Defensive, shouldn't fail with size 0.
   }
   if (wait_set->impl) {
-    allocator.deallocate(wait_set->impl, allocator.state);
+    if (NULL != wait_set->impl->graph_wait_guard_conditions) {
+      allocator.deallocate((void *)wait_set->impl->graph_wait_guard_conditions, allocator.state);
+      allocator.deallocate(wait_set->impl->graph_wait_owners, allocator.state);
+    }
+    rcl_context_deallocate_entity(
+      wait_set->impl->context, RCL_ENTITY_POOL_WAIT_SET, wait_set->impl,
+      sizeof(rcl_wait_set_impl_t), &allocator, wait_set->impl->is_pooled);
     wait_set->impl = NULL;
   }
 }
 
-rcl_ret_t
-rcl_wait_set_init(
+static rcl_ret_t
+__wait_set_init(
   rcl_wait_set_t * wait_set,
   size_t number_of_subscriptions,
   size_t number_of_guard_conditions,
   size_t number_of_timers,
   size_t number_of_clients,
   size_t number_of_services,
+  rcl_context_t * context,
   rcl_allocator_t allocator)
 {
   RCUTILS_LOG_DEBUG_NAMED(
@@ -112,12 +142,25 @@ rcl_wait_set_init(
     RCL_SET_ERROR_MSG("wait_set already initialized, or memory was uninitialized.");
     return RCL_RET_ALREADY_INIT;
   }
-  // Allocate space for the implementation struct.
-  wait_set->impl = (rcl_wait_set_impl_t *)allocator.allocate(
-    sizeof(rcl_wait_set_impl_t), allocator.state);
-  RCL_CHECK_FOR_NULL_WITH_MSG(
-    wait_set->impl, "allocating memory failed", return RCL_RET_BAD_ALLOC);
+  // Allocate space for the implementation struct, from the pool of the context if any.
+  void * impl = NULL;
+  bool is_pooled = false;
+  rcl_ret_t ret = rcl_context_allocate_entity(
+    context, RCL_ENTITY_POOL_WAIT_SET, sizeof(rcl_wait_set_impl_t), &allocator, &impl,
+    &is_pooled);
+  if (RCL_RET_OK != ret) {
+    return ret;  // error message already set
+  }
+  wait_set->impl = (rcl_wait_set_impl_t *)impl;
   memset(wait_set->impl, 0, sizeof(rcl_wait_set_impl_t));
+  wait_set->impl->context = context;
+  wait_set->impl->is_pooled = is_pooled;
+  wait_set->impl->pool_entity_count = rcl_context_get_wait_set_pool_entries(context);
+  if (wait_set->impl->pool_entity_count > 0) {
+    // The arrays follow the implementation struct in its slot.
+    wait_set->impl->pool_entries =
+      (void **)((char *)impl + RCL_ENTITY_POOL_ROUND_UP(sizeof(rcl_wait_set_impl_t)));
+  }
   wait_set->impl->rmw_subscriptions.subscribers = NULL;
   wait_set->impl->rmw_subscriptions.subscriber_count = 0;
   wait_set->impl->rmw_guard_conditions.guard_conditions = NULL;
@@ -137,7 +180,7 @@ rcl_wait_set_init(
   // Set allocator.
   wait_set->impl->allocator = allocator;
   // Initialize subscription space.
-  rcl_ret_t ret = rcl_wait_set_resize(
+  ret = rcl_wait_set_resize(
     wait_set, number_of_subscriptions, number_of_guard_conditions, number_of_timers,
     number_of_clients, number_of_services);
   if (RCL_RET_OK != ret) {
@@ -156,6 +199,44 @@ fail:
   return fail_ret;
 }
 
+rcl_ret_t
+rcl_wait_set_init(
+  rcl_wait_set_t * wait_set,
+  size_t number_of_subscriptions,
+  size_t number_of_guard_conditions,
+  size_t number_of_timers,
+  size_t number_of_clients,
+  size_t number_of_services,
+  rcl_allocator_t allocator)
+{
+  return __wait_set_init(
+    wait_set, number_of_subscriptions, number_of_guard_conditions, number_of_timers,
+    number_of_clients, number_of_services, NULL, allocator);
+}
+
+rcl_ret_t
+rcl_wait_set_init_with_context(
+  rcl_wait_set_t * wait_set,
+  size_t number_of_subscriptions,
+  size_t number_of_guard_conditions,
+  size_t number_of_timers,
+  size_t number_of_clients,
+  size_t number_of_services,
+  rcl_context_t * context,
+  rcl_allocator_t allocator)
+{
+  RCL_CHECK_ARGUMENT_FOR_NULL(context, RCL_RET_INVALID_ARGUMENT);
+  if (!rcl_context_is_valid(context)) {
+    RCL_SET_ERROR_MSG(
+      "the given context is not valid, "
+      "either rcl_init() was not called or rcl_shutdown() was called.");
+    return RCL_RET_NOT_INIT;
+  }
+  return __wait_set_init(
+    wait_set, number_of_subscriptions, number_of_guard_conditions, number_of_timers,
+    number_of_clients, number_of_services, context, allocator);
+}
+
 rcl_ret_t
 rcl_wait_set_fini(rcl_wait_set_t * wait_set)
 {
@@ -332,8 +413,79 @@ rcl_wait_set_clear(rcl_wait_set_t * wait_set)
   return RCL_RET_OK;
 }
 
+/// Hand out the next `count` entries of a pool slot, or `NULL` if `count` is 0.
+static void **
+__wait_set_take_pool_entries(void *** next, size_t count)
+{
+  if (0 == count) {
+    return NULL;
+  }
+  void ** entries = *next;
+  *next += count;
+  return entries;
+}
+
+/// Lay the arrays of a pooled wait set out in its slot, which never allocates.
+static rcl_ret_t
+__wait_set_resize_in_pool(
+  rcl_wait_set_t * wait_set,
+  size_t subscriptions_size,
+  size_t guard_conditions_size,
+  size_t timers_size,
+  size_t clients_size,
+  size_t services_size)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  const size_t sizes[] = {
+    subscriptions_size, guard_conditions_size, timers_size, clients_size, services_size
+  };
+  size_t entity_count = 0;
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+    if (sizes[i] > impl->pool_entity_count - entity_count) {
+      RCL_SET_ERROR_MSG_WITH_FORMAT_STRING(
+        "the wait set pool of the context only fits %zu entities in a wait set",
+        impl->pool_entity_count);
+      return RCL_RET_ENTITY_POOL_EXHAUSTED;
+    }
+    entity_count += sizes[i];
+  }
+  // Each entity has one rcl and one rmw pointer.
+  memset(impl->pool_entries, 0, 2 * entity_count * sizeof(void *));
+  void ** next = impl->pool_entries;
+  wait_set->subscriptions =
+    (const rcl_subscription_t **)__wait_set_take_pool_entries(&next, subscriptions_size);
+  wait_set->size_of_subscriptions = subscriptions_size;
+  impl->subscription_index = 0;
+  wait_set->guard_conditions =
+    (const rcl_guard_condition_t **)__wait_set_take_pool_entries(&next, guard_conditions_size);
+  wait_set->size_of_guard_conditions = guard_conditions_size;
+  impl->guard_condition_index = 0;
+  wait_set->timers = (const rcl_timer_t **)__wait_set_take_pool_entries(&next, timers_size);
+  wait_set->size_of_timers = timers_size;
+  impl->timer_index = 0;
+  wait_set->clients = (const rcl_client_t **)__wait_set_take_pool_entries(&next, clients_size);
+  wait_set->size_of_clients = clients_size;
+  impl->client_index = 0;
+  wait_set->services =
+    (const rcl_service_t **)__wait_set_take_pool_entries(&next, services_size);
+  wait_set->size_of_services = services_size;
+  impl->service_index = 0;
+  impl->rmw_subscriptions.subscribers = __wait_set_take_pool_entries(&next, subscriptions_size);
+  impl->rmw_subscriptions.subscriber_count = 0;
+  // Guard condition RMW size needs to be guard conditions + timers
+  impl->rmw_guard_conditions.guard_conditions =
+    __wait_set_take_pool_entries(&next, guard_conditions_size + timers_size);
+  impl->rmw_guard_conditions.guard_condition_count = 0;
+  impl->rmw_clients.clients = __wait_set_take_pool_entries(&next, clients_size);
+  impl->rmw_clients.client_count = 0;
+  impl->rmw_services.services = __wait_set_take_pool_entries(&next, services_size);
+  impl->rmw_services.service_count = 0;
+  return RCL_RET_OK;
+}
+
 /* Implementation-specific notes:
  *
+ * A pooled wait set keeps its arrays in its pool slot instead.
  * Similarly, the underlying rmw representation is reallocated and reset:
  * all entries are set to null and the count is set to zero.
  */
@@ -348,6 +500,11 @@ rcl_wait_set_resize(
 {
   RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
   RCL_CHECK_ARGUMENT_FOR_NULL(wait_set->impl, RCL_RET_WAIT_SET_INVALID);
+  if (NULL != wait_set->impl->pool_entries) {
+    return __wait_set_resize_in_pool(
+      wait_set, subscriptions_size, guard_conditions_size, timers_size, clients_size,
+      services_size);
+  }
   SET_RESIZE(
     subscription,
     SET_RESIZE_RMW_DEALLOC(
@@ -459,8 +616,155 @@ rcl_wait_set_add_service(
   return RCL_RET_OK;
 }
 
-rcl_ret_t
-rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
+/// Invalidate the context's graph cache if a node's graph guard condition is ready.
+static void
+_rcl_wait_notify_graph_cache(const rcl_guard_condition_t * guard_condition)
+{
+  // The middleware offers no other way to learn that the graph changed,
+  // checking its graph guard condition outside of rmw_wait() would consume it.
+  if (guard_condition->impl->is_graph_guard_condition &&
+    NULL != guard_condition->context && NULL != guard_condition->context->impl)
+  {
+    rcl_graph_cache_invalidate(&guard_condition->context->impl->graph_cache);
+  }
+}
+
+/// Grow the guard conditions passed to rmw_wait() for graph waits, keeping their contents.
+static rcl_ret_t
+_rcl_wait_grow_graph_wait(rcl_wait_set_impl_t * impl, size_t capacity)
+{
+  void ** guard_conditions = (void **)impl->allocator.reallocate(
+    (void *)impl->graph_wait_guard_conditions, sizeof(void *) * capacity, impl->allocator.state);
+  if (NULL == guard_conditions) {
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    return RCL_RET_BAD_ALLOC;
+  }
+  impl->graph_wait_guard_conditions = guard_conditions;
+  size_t * owners = (size_t *)impl->allocator.reallocate(
+    impl->graph_wait_owners, sizeof(size_t) * capacity, impl->allocator.state);
+  if (NULL == owners) {
+    RCL_SET_ERROR_MSG("allocating memory failed");
+    return RCL_RET_BAD_ALLOC;
+  }
+  impl->graph_wait_owners = owners;
+  impl->graph_wait_capacity = capacity;
+  return RCL_RET_OK;
+}
+
+/// Return true if the guard condition at `index` is the first one of a context's graph.
+/**
+ * A context is only waited on once, a second reference on its nodes from
+ * the same thread would block the finalization of a node forever.
+ */
+static bool
+_rcl_wait_is_graph_wait(const rcl_wait_set_t * wait_set, size_t index)
+{
+  const rcl_guard_condition_t * guard_condition = wait_set->guard_conditions[index];
+  if (NULL == guard_condition || !guard_condition->impl->is_context_graph_guard_condition) {
+    return false;
+  }
+  size_t i;
+  for (i = 0; i < index; ++i) {
+    if (wait_set->guard_conditions[i] == guard_condition) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Stop the graph waits of the first `count` guard conditions of the wait set.
+static void
+_rcl_wait_end_graph_waits(rcl_wait_set_t * wait_set, size_t count)
+{
+  size_t i;
+  for (i = 0; i < count; ++i) {
+    if (_rcl_wait_is_graph_wait(wait_set, i)) {
+      rcl_context_end_graph_wait(wait_set->guard_conditions[i]->context);
+    }
+  }
+}
+
+/// Add the graph guard conditions of the nodes of each context graph guard condition.
+/**
+ * The context's own guard condition stays in the wait set, it is triggered
+ * by rcl and wakes up the wait when a node is finalized.
+ * If the wait set has no context graph guard condition, `guard_conditions`
+ * is the wait set's own array.
+ */
+static rcl_ret_t
+_rcl_wait_begin_graph_waits(rcl_wait_set_t * wait_set, rmw_guard_conditions_t * guard_conditions)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  *guard_conditions = impl->rmw_guard_conditions;
+  size_t base_count = impl->rmw_guard_conditions.guard_condition_count;
+  size_t count = base_count;
+  bool has_graph_wait = false;
+  size_t i;
+  for (i = 0; i < impl->guard_condition_index; ++i) {
+    if (!_rcl_wait_is_graph_wait(wait_set, i)) {
+      continue;
+    }
+    const rcl_guard_condition_t * guard_condition = wait_set->guard_conditions[i];
+    size_t node_count = 0;
+    while (!rcl_context_begin_graph_wait(
+        guard_condition->context,
+        impl->graph_wait_capacity > count ? &impl->graph_wait_guard_conditions[count] : NULL,
+        impl->graph_wait_capacity > count ? impl->graph_wait_capacity - count : 0,
+        &node_count))
+    {
+      rcl_ret_t ret = _rcl_wait_grow_graph_wait(impl, count + node_count);
+      if (RCL_RET_OK != ret) {
+        _rcl_wait_end_graph_waits(wait_set, i);
+        return ret;
+      }
+    }
+    size_t j;
+    for (j = count; j < count + node_count; ++j) {
+      impl->graph_wait_owners[j] = i;
+    }
+    count += node_count;
+    has_graph_wait = true;
+  }
+  if (has_graph_wait && count > base_count) {
+    if (0 != base_count) {
+      memcpy(
+        (void *)impl->graph_wait_guard_conditions, (void *)guard_conditions->guard_conditions,
+        sizeof(void *) * base_count);
+    }
+    guard_conditions->guard_conditions = impl->graph_wait_guard_conditions;
+    guard_conditions->guard_condition_count = count;
+  }
+  return RCL_RET_OK;
+}
+
+/// Report the result of the graph waits in the wait set's own array and stop them.
+static void
+_rcl_wait_finish_graph_waits(
+  rcl_wait_set_t * wait_set,
+  const rmw_guard_conditions_t * guard_conditions)
+{
+  rcl_wait_set_impl_t * impl = wait_set->impl;
+  rmw_guard_conditions_t * own_guard_conditions = &impl->rmw_guard_conditions;
+  if (guard_conditions->guard_conditions != own_guard_conditions->guard_conditions) {
+    size_t base_count = own_guard_conditions->guard_condition_count;
+    size_t i;
+    for (i = 0; i < base_count; ++i) {
+      own_guard_conditions->guard_conditions[i] = guard_conditions->guard_conditions[i];
+    }
+    // A ready node graph guard condition makes its context's graph guard condition ready.
+    for (i = base_count; i < guard_conditions->guard_condition_count; ++i) {
+      if (NULL != guard_conditions->guard_conditions[i]) {
+        size_t owner = impl->graph_wait_owners[i];
+        own_guard_conditions->guard_conditions[owner] =
+          wait_set->guard_conditions[owner]->impl->rmw_handle->data;
+      }
+    }
+  }
+  _rcl_wait_end_graph_waits(wait_set, impl->guard_condition_index);
+}
+
+static rcl_ret_t
+_rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
 {
   RCL_CHECK_ARGUMENT_FOR_NULL(wait_set, RCL_RET_INVALID_ARGUMENT);
   if (!__wait_set_is_valid(wait_set)) {
@@ -520,13 +824,33 @@ rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
       }
     }
   }
+  // Pending request deadlines of the clients bound the timeout like timers do.
+  bool is_deadline_timeout = false;
+  {
+    size_t i = 0;
+    for (i = 0; i < wait_set->impl->client_index; ++i) {
+      if (!wait_set->clients[i]) {
+        continue;  // Skip NULL clients.
+      }
+      int64_t deadline_timeout = INT64_MAX;
+      rcl_ret_t ret = rcl_client_get_time_until_next_request_deadline(
+        wait_set->clients[i], &deadline_timeout);
+      if (ret != RCL_RET_OK) {
+        return ret;  // The rcl error state should already be set.
+      }
+      if (deadline_timeout < min_timeout) {
+        is_deadline_timeout = true;
+        min_timeout = deadline_timeout;
+      }
+    }
+  }
 
   if (timeout == 0) {
     // Then it is non-blocking, so set the temporary storage to 0, 0 and pass it.
     temporary_timeout_storage.sec = 0;
     temporary_timeout_storage.nsec = 0;
     timeout_argument = &temporary_timeout_storage;
-  } else if (timeout > 0 || is_timer_timeout) {
+  } else if (timeout > 0 || is_timer_timeout || is_deadline_timeout) {
     // If min_timeout was negative, we need to wake up immediately.
     if (min_timeout < 0) {
       min_timeout = 0;
@@ -535,24 +859,38 @@ rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
     temporary_timeout_storage.nsec = min_timeout % 1000000000;
     timeout_argument = &temporary_timeout_storage;
   }
-  RCUTILS_LOG_DEBUG_EXPRESSION_NAMED(
+  RCL_HOT_PATH_LOG_DEBUG_EXPRESSION_NAMED(
     !timeout_argument, ROS_PACKAGE_NAME, "Waiting without timeout");
-  RCUTILS_LOG_DEBUG_EXPRESSION_NAMED(
+  RCL_HOT_PATH_LOG_DEBUG_EXPRESSION_NAMED(
     timeout_argument, ROS_PACKAGE_NAME,
     "Waiting with timeout: %" PRIu64 "s + %" PRIu64 "ns",
     temporary_timeout_storage.sec, temporary_timeout_storage.nsec);
-  RCUTILS_LOG_DEBUG_NAMED(
+  RCL_HOT_PATH_LOG_DEBUG_NAMED(
     ROS_PACKAGE_NAME, "Timeout calculated based on next scheduled timer: %s",
     is_timer_timeout ? "true" : "false");
+  RCL_HOT_PATH_LOG_DEBUG_NAMED(
+    ROS_PACKAGE_NAME, "Timeout calculated based on next request deadline: %s",
+    is_deadline_timeout ? "true" : "false");
 
   // Wait.
+  // A context's graph guard condition also waits on the graph guard conditions of its nodes.
+  rmw_guard_conditions_t guard_conditions;
+  rcl_ret_t graph_wait_ret = _rcl_wait_begin_graph_waits(wait_set, &guard_conditions);
+  if (RCL_RET_OK != graph_wait_ret) {
+    return graph_wait_ret;  // error already set
+  }
+  RCL_TRACEPOINT(
+    RCL_TRACE_WAIT_ENTER, wait_set, timeout_argument ?
+    (int64_t)(RCL_S_TO_NS(temporary_timeout_storage.sec) + temporary_timeout_storage.nsec) : -1);
   rmw_ret_t ret = rmw_wait(
     &wait_set->impl->rmw_subscriptions,
-    &wait_set->impl->rmw_guard_conditions,
+    &guard_conditions,
     &wait_set->impl->rmw_services,
     &wait_set->impl->rmw_clients,
     wait_set->impl->rmw_wait_set,
     timeout_argument);
+  _rcl_wait_finish_graph_waits(wait_set, &guard_conditions);
+  RCL_TRACEPOINT(RCL_TRACE_WAIT_EXIT, wait_set, ret);
 
   // Items that are not ready will have been set to NULL by rmw_wait.
   // We now update our handles accordingly.
@@ -569,7 +907,8 @@ rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
     if (ret != RCL_RET_OK) {
       return ret;  // The rcl error state should already be set.
     }
-    RCUTILS_LOG_DEBUG_EXPRESSION_NAMED(is_ready, ROS_PACKAGE_NAME, "Timer in wait set is ready");
+    RCL_HOT_PATH_LOG_DEBUG_EXPRESSION_NAMED(
+      is_ready, ROS_PACKAGE_NAME, "Timer in wait set is ready");
     if (!is_ready) {
       wait_set->timers[i] = NULL;
     }
@@ -582,7 +921,7 @@ rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
   // Set corresponding rcl subscription handles NULL.
   for (i = 0; i < wait_set->size_of_subscriptions; ++i) {
     bool is_ready = wait_set->impl->rmw_subscriptions.subscribers[i] != NULL;
-    RCUTILS_LOG_DEBUG_EXPRESSION_NAMED(
+    RCL_HOT_PATH_LOG_DEBUG_EXPRESSION_NAMED(
       is_ready, ROS_PACKAGE_NAME, "Subscription in wait set is ready");
     if (!is_ready) {
       wait_set->subscriptions[i] = NULL;
@@ -591,16 +930,29 @@ rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
   // Set corresponding rcl guard_condition handles NULL.
   for (i = 0; i < wait_set->size_of_guard_conditions; ++i) {
     bool is_ready = wait_set->impl->rmw_guard_conditions.guard_conditions[i] != NULL;
-    RCUTILS_LOG_DEBUG_EXPRESSION_NAMED(
+    RCL_HOT_PATH_LOG_DEBUG_EXPRESSION_NAMED(
       is_ready, ROS_PACKAGE_NAME, "Guard condition in wait set is ready");
     if (!is_ready) {
       wait_set->guard_conditions[i] = NULL;
+    } else {
+      _rcl_wait_notify_graph_cache(wait_set->guard_conditions[i]);
     }
   }
-  // Set corresponding rcl client handles NULL.
+  // Set corresponding rcl client handles NULL,
+  // unless one of the client's pending requests expired.
   for (i = 0; i < wait_set->size_of_clients; ++i) {
     bool is_ready = wait_set->impl->rmw_clients.clients[i] != NULL;
-    RCUTILS_LOG_DEBUG_EXPRESSION_NAMED(is_ready, ROS_PACKAGE_NAME, "Client in wait set is ready");
+    if (!is_ready && wait_set->clients[i]) {
+      int64_t deadline_timeout = INT64_MAX;
+      rcl_ret_t ret = rcl_client_get_time_until_next_request_deadline(
+        wait_set->clients[i], &deadline_timeout);
+      if (ret != RCL_RET_OK) {
+        return ret;  // The rcl error state should already be set.
+      }
+      is_ready = deadline_timeout <= 0;
+    }
+    RCL_HOT_PATH_LOG_DEBUG_EXPRESSION_NAMED(
+      is_ready, ROS_PACKAGE_NAME, "Client in wait set is ready");
     if (!is_ready) {
       wait_set->clients[i] = NULL;
     }
@@ -608,18 +960,29 @@ rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
   // Set corresponding rcl service handles NULL.
   for (i = 0; i < wait_set->size_of_services; ++i) {
     bool is_ready = wait_set->impl->rmw_services.services[i] != NULL;
-    RCUTILS_LOG_DEBUG_EXPRESSION_NAMED(is_ready, ROS_PACKAGE_NAME, "Service in wait set is ready");
+    RCL_HOT_PATH_LOG_DEBUG_EXPRESSION_NAMED(
+      is_ready, ROS_PACKAGE_NAME, "Service in wait set is ready");
     if (!is_ready) {
       wait_set->services[i] = NULL;
     }
   }
 
-  if (RMW_RET_TIMEOUT == ret && !is_timer_timeout) {
+  if (RMW_RET_TIMEOUT == ret && !is_timer_timeout && !is_deadline_timeout) {
     return RCL_RET_TIMEOUT;
   }
   return RCL_RET_OK;
 }
 
+rcl_ret_t
+rcl_wait(rcl_wait_set_t * wait_set, int64_t timeout)
+{
+  rcl_allocation_audit_api_t previous_api =
+    RCL_ALLOCATION_AUDIT_ENTER(RCL_ALLOCATION_AUDIT_WAIT);
+  rcl_ret_t ret = _rcl_wait(wait_set, timeout);
+  RCL_ALLOCATION_AUDIT_EXIT(previous_api);
+  return ret;
+}
+
 #ifdef __cplusplus
 }
 #endif
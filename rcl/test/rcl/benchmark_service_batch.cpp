@@ -0,0 +1,199 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Reports how long a service takes to answer a request, taking and answering the requests
+// one by one and in batches with rcl_take_request_batch() and rcl_send_response_batch().
+// Usage: benchmark_service_batch [request_count] [batch_size]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "rcl/rcl.h"
+
+#include "test_msgs/srv/primitives.h"
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+#include "rcl/error_handling.h"
+
+/// Send request_count requests and give the middleware time to deliver them.
+static bool
+send_requests(
+  rcl_client_t * client, const test_msgs__srv__Primitives_Request * request, size_t request_count)
+{
+  for (size_t i = 0; i < request_count; ++i) {
+    int64_t sequence_number;
+    if (RCL_RET_OK != rcl_send_request(client, request, &sequence_number)) {
+      fprintf(stderr, "sending a request failed: %s\n", rcl_get_error_string().str);
+      return false;
+    }
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+  return true;
+}
+
+static void
+report(
+  const char * label, size_t batch_size, std::chrono::steady_clock::duration duration,
+  size_t count)
+{
+  std::chrono::duration<double> elapsed = duration;
+  double ns_per_request =
+    count ? std::chrono::duration<double, std::nano>(duration).count() / count : 0.0;
+  printf(
+    "%s (batch size %zu): answered %zu requests in %.3f s: %.0f ns per request\n",
+    label, batch_size, count, elapsed.count(), ns_per_request);
+}
+
+int main(int argc, char ** argv)
+{
+  size_t request_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500;
+  size_t batch_size = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 32;
+  if (0 == request_count || 0 == batch_size) {
+    fprintf(stderr, "usage: %s [request_count] [batch_size]\n", argv[0]);
+    return 1;
+  }
+
+  int main_ret = 0;
+  {
+    rcl_init_options_t init_options = rcl_get_zero_initialized_init_options();
+    if (RCL_RET_OK != rcl_init_options_init(&init_options, rcl_get_default_allocator())) {
+      fprintf(stderr, "init options init failed: %s\n", rcl_get_error_string().str);
+      return 1;
+    }
+    rcl_context_t context = rcl_get_zero_initialized_context();
+    rcl_ret_t ret = rcl_init(0, nullptr, &init_options, &context);
+    rcl_init_options_fini(&init_options);
+    if (RCL_RET_OK != ret) {
+      fprintf(stderr, "init failed: %s\n", rcl_get_error_string().str);
+      return 1;
+    }
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+      if (RCL_RET_OK != rcl_shutdown(&context) || RCL_RET_OK != rcl_context_fini(&context)) {
+        fprintf(stderr, "shutdown failed: %s\n", rcl_get_error_string().str);
+        main_ret = 1;
+      }
+    });
+    rcl_node_t node = rcl_get_zero_initialized_node();
+    rcl_node_options_t node_options = rcl_node_get_default_options();
+    ret = rcl_node_init(&node, "benchmark_service_batch", "", &context, &node_options);
+    if (RCL_RET_OK != ret) {
+      fprintf(stderr, "node init failed: %s\n", rcl_get_error_string().str);
+      return 1;
+    }
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+      if (RCL_RET_OK != rcl_node_fini(&node)) {
+        fprintf(stderr, "node fini failed: %s\n", rcl_get_error_string().str);
+        main_ret = 1;
+      }
+    });
+
+    const rosidl_service_type_support_t * ts = ROSIDL_GET_SRV_TYPE_SUPPORT(
+      test_msgs, srv, Primitives);
+    const char * service_name = "benchmark_service_batch";
+    // Deep enough queues that no request is dropped while they are queued up.
+    rcl_service_t service = rcl_get_zero_initialized_service();
+    rcl_service_options_t service_options = rcl_service_get_default_options();
+    service_options.qos.depth = request_count;
+    if (RCL_RET_OK != rcl_service_init(&service, &node, ts, service_name, &service_options)) {
+      fprintf(stderr, "service init failed: %s\n", rcl_get_error_string().str);
+      return 1;
+    }
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+      if (RCL_RET_OK != rcl_service_fini(&service, &node)) {
+        fprintf(stderr, "service fini failed: %s\n", rcl_get_error_string().str);
+        main_ret = 1;
+      }
+    });
+    rcl_client_t client = rcl_get_zero_initialized_client();
+    rcl_client_options_t client_options = rcl_client_get_default_options();
+    client_options.qos.depth = request_count;
+    if (RCL_RET_OK != rcl_client_init(&client, &node, ts, service_name, &client_options)) {
+      fprintf(stderr, "client init failed: %s\n", rcl_get_error_string().str);
+      return 1;
+    }
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+      if (RCL_RET_OK != rcl_client_fini(&client, &node)) {
+        fprintf(stderr, "client fini failed: %s\n", rcl_get_error_string().str);
+        main_ret = 1;
+      }
+    });
+    // Give discovery time to match the client with the service.
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+
+    std::vector<test_msgs__srv__Primitives_Request> requests(batch_size);
+    std::vector<test_msgs__srv__Primitives_Response> responses(batch_size);
+    std::vector<void *> request_ptrs;
+    std::vector<void *> response_ptrs;
+    for (size_t i = 0; i < batch_size; ++i) {
+      test_msgs__srv__Primitives_Request__init(&requests[i]);
+      test_msgs__srv__Primitives_Response__init(&responses[i]);
+      request_ptrs.push_back(&requests[i]);
+      response_ptrs.push_back(&responses[i]);
+    }
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+      for (size_t i = 0; i < batch_size; ++i) {
+        test_msgs__srv__Primitives_Request__fini(&requests[i]);
+        test_msgs__srv__Primitives_Response__fini(&responses[i]);
+      }
+    });
+    std::vector<rmw_request_id_t> headers(batch_size);
+
+    // Queue up the requests first, so only the server side take and send is timed.
+    if (!send_requests(&client, &requests[0], request_count)) {
+      return 1;
+    }
+    size_t handled = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (RCL_RET_OK == (ret = rcl_take_request(&service, &headers[0], &requests[0]))) {
+      if (RCL_RET_OK != rcl_send_response(&service, &headers[0], &responses[0])) {
+        fprintf(stderr, "sending a response failed: %s\n", rcl_get_error_string().str);
+        return 1;
+      }
+      ++handled;
+    }
+    report("single", 1, std::chrono::steady_clock::now() - start, handled);
+    if (RCL_RET_SERVICE_TAKE_FAILED != ret) {
+      fprintf(stderr, "taking a request failed: %s\n", rcl_get_error_string().str);
+      return 1;
+    }
+
+    if (!send_requests(&client, &requests[0], request_count)) {
+      return 1;
+    }
+    handled = 0;
+    start = std::chrono::steady_clock::now();
+    size_t taken_count = 0;
+    while (RCL_RET_OK == (ret = rcl_take_request_batch(
+        &service, headers.data(), request_ptrs.data(), batch_size, &taken_count)))
+    {
+      size_t sent_count = 0;
+      if (RCL_RET_OK != rcl_send_response_batch(
+          &service, headers.data(), response_ptrs.data(), taken_count, &sent_count))
+      {
+        fprintf(stderr, "sending a response batch failed: %s\n", rcl_get_error_string().str);
+        return 1;
+      }
+      handled += sent_count;
+    }
+    report("batch", batch_size, std::chrono::steady_clock::now() - start, handled);
+    if (RCL_RET_SERVICE_TAKE_FAILED != ret) {
+      fprintf(stderr, "taking a request batch failed: %s\n", rcl_get_error_string().str);
+      return 1;
+    }
+  }
+  return main_ret;
+}
@@ -0,0 +1,83 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Reports how many topic names per second rcl_validate_topic_names() validates.
+// Usage: benchmark_validate_topic_name [name_count] [rounds]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "rcl/error_handling.h"
+#include "rcl/validate_topic_name.h"
+
+int main(int argc, char ** argv)
+{
+  size_t name_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000;
+  size_t rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20;
+  if (0 == name_count || 0 == rounds) {
+    fprintf(stderr, "usage: %s [name_count] [rounds]\n", argv[0]);
+    return 1;
+  }
+
+  // Names like the ones of a recorded graph, with a few invalid ones.
+  const char * patterns[] = {
+    "/robot_%zu/sensors/lidar_front/points",
+    "/robot_%zu/camera/image_raw/compressed",
+    "~/diagnostics_%zu",
+    "/{robot_name}/navigation/global_costmap/costmap_updates_%zu",
+    "/fleet/robot_%zu/joint_states",
+    "parameter_events_%zu",
+    "/robot_%zu/tf static",
+  };
+  const size_t pattern_count = sizeof(patterns) / sizeof(patterns[0]);
+  std::vector<std::string> names;
+  names.reserve(name_count);
+  char buffer[256];
+  for (size_t i = 0; i < name_count; ++i) {
+    snprintf(buffer, sizeof(buffer), patterns[i % pattern_count], i);
+    names.push_back(buffer);
+  }
+  std::vector<const char *> topic_names;
+  for (const auto & name : names) {
+    topic_names.push_back(name.c_str());
+  }
+  std::vector<int> validation_results(name_count);
+  std::vector<size_t> invalid_indices(name_count);
+
+  size_t invalid_count = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t round = 0; round < rounds; ++round) {
+    rcl_ret_t ret = rcl_validate_topic_names(
+      topic_names.data(), name_count, validation_results.data(), invalid_indices.data());
+    if (RCL_RET_OK != ret) {
+      fprintf(stderr, "validation failed: %s\n", rcl_get_error_string().str);
+      return 1;
+    }
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  for (int validation_result : validation_results) {
+    if (RCL_TOPIC_NAME_VALID != validation_result) {
+      ++invalid_count;
+    }
+  }
+
+  double names_per_second = static_cast<double>(name_count * rounds) / elapsed.count();
+  printf(
+    "validated %zu names (%zu invalid) %zu times in %.3f s: %.0f names/sec\n",
+    name_count, invalid_count, rounds, elapsed.count(), names_per_second);
+  return 0;
+}
@@ -13,10 +13,14 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
 #include <sstream>
+#include <string>
 
 #include "rcl/rcl.h"
 #include "rcl/arguments.h"
+#include "rcl/remap.h"
 
 #include "rcl/error_handling.h"
 
@@ -101,6 +105,11 @@ TEST_F(CLASSNAME(TestArgumentsFixture, RMW_IMPLEMENTATION), check_valid_vs_inval
   EXPECT_TRUE(is_valid_arg("rostopic:///rosservice:=rostopic"));
   EXPECT_TRUE(is_valid_arg("rostopic:///foo/bar:=baz"));
   EXPECT_TRUE(is_valid_arg("__params:=file_name.yaml"));
+  EXPECT_TRUE(is_valid_arg("/foo/*:=/bar/\\1"));
+  EXPECT_TRUE(is_valid_arg("**/foo:=/bar"));
+  EXPECT_TRUE(is_valid_arg("/foo/**/baz:=\\1/bar"));
+  EXPECT_TRUE(is_valid_arg("/*/*:=/\\2/\\1"));
+  EXPECT_TRUE(is_valid_arg("rostopic://~/*:=/foo/\\1"));
 
   EXPECT_FALSE(is_valid_arg(":="));
   EXPECT_FALSE(is_valid_arg("foo:="));
@@ -119,6 +128,9 @@ TEST_F(CLASSNAME(TestArgumentsFixture, RMW_IMPLEMENTATION), check_valid_vs_inval
   EXPECT_FALSE(is_valid_arg("rostopic://:=rosservice"));
   EXPECT_FALSE(is_valid_arg("rostopic::=rosservice"));
   EXPECT_FALSE(is_valid_arg("__param:=file_name.yaml"));
+  EXPECT_FALSE(is_valid_arg("/foo:=/bar/\\1"));
+  EXPECT_FALSE(is_valid_arg("/foo/*:=/bar/\\2"));
+  EXPECT_FALSE(is_valid_arg("/foo:=/bar/*"));
 
   // Setting logger level
   EXPECT_TRUE(is_valid_arg("__log_level:=UNSET"));
@@ -134,6 +146,14 @@ TEST_F(CLASSNAME(TestArgumentsFixture, RMW_IMPLEMENTATION), check_valid_vs_inval
   EXPECT_FALSE(is_valid_arg("__loglevel:=foo"));
   EXPECT_FALSE(is_valid_arg("__log_level:="));
   EXPECT_FALSE(is_valid_arg("__log_level:=foo"));
+
+  // Arguments which are not rules, or end in the middle of a lexeme
+  EXPECT_FALSE(is_valid_arg("__"));
+  EXPECT_FALSE(is_valid_arg("__:=foo"));
+  EXPECT_FALSE(is_valid_arg("foo:=\\"));
+  EXPECT_FALSE(is_valid_arg("foo:=~"));
+  EXPECT_FALSE(is_valid_arg("foo:=__no"));
+  EXPECT_FALSE(is_valid_arg("--foo"));
 }
 
 TEST_F(CLASSNAME(TestArgumentsFixture, RMW_IMPLEMENTATION), test_no_args) {
@@ -202,6 +222,35 @@ TEST_F(CLASSNAME(TestArgumentsFixture, RMW_IMPLEMENTATION), test_copy) {
   EXPECT_EQ(RCL_RET_OK, rcl_arguments_fini(&copied_args));
 }
 
+TEST_F(CLASSNAME(TestArgumentsFixture, RMW_IMPLEMENTATION), test_shared_copies) {
+  const char * argv[] = {"process_name", "/foo/bar:=", "bar:=/fiz/buz", "__params:=a.yaml"};
+  int argc = sizeof(argv) / sizeof(const char *);
+  rcl_arguments_t parsed_args = rcl_get_zero_initialized_arguments();
+  rcl_ret_t ret;
+
+  ret = rcl_parse_arguments(argc, argv, rcl_get_default_allocator(), &parsed_args);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  // Copies of copies share the same arguments, each of them stays valid until finalized.
+  rcl_arguments_t copied_args = rcl_get_zero_initialized_arguments();
+  ret = rcl_arguments_copy(&parsed_args, &copied_args);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  rcl_arguments_t copied_copy = rcl_get_zero_initialized_arguments();
+  ret = rcl_arguments_copy(&copied_args, &copied_copy);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  EXPECT_EQ(RCL_RET_OK, rcl_arguments_fini(&copied_args));
+  EXPECT_EQ(RCL_RET_ERROR, rcl_arguments_fini(&copied_args));
+  rcl_reset_error();
+  EXPECT_UNPARSED(parsed_args, 0, 1);
+  EXPECT_EQ(1, rcl_arguments_get_param_files_count(&copied_copy));
+  EXPECT_EQ(RCL_RET_OK, rcl_arguments_fini(&parsed_args));
+
+  EXPECT_UNPARSED(copied_copy, 0, 1);
+  EXPECT_EQ(1, rcl_arguments_get_param_files_count(&copied_copy));
+  EXPECT_EQ(RCL_RET_OK, rcl_arguments_fini(&copied_copy));
+}
+
 TEST_F(CLASSNAME(TestArgumentsFixture, RMW_IMPLEMENTATION), test_two_namespace) {
   const char * argv[] = {"process_name", "__ns:=/foo/bar", "__ns:=/fiz/buz"};
   int argc = sizeof(argv) / sizeof(const char *);
@@ -387,3 +436,93 @@ TEST_F(CLASSNAME(TestArgumentsFixture, RMW_IMPLEMENTATION), test_param_argument_
   alloc.deallocate(parameter_files, alloc.state);
   EXPECT_EQ(RCL_RET_OK, rcl_arguments_fini(&parsed_args));
 }
+
+/// Remap a topic of node `/node` with only the given arguments, "" if no rule matched.
+static std::string
+remap_topic(const rcl_arguments_t * args, const char * topic_name)
+{
+  rcl_allocator_t alloc = rcl_get_default_allocator();
+  char * output = NULL;
+  rcl_ret_t ret = rcl_remap_topic_name(args, NULL, topic_name, "node", "/", alloc, &output);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  std::string remapped = NULL == output ? "" : output;
+  if (NULL != output) {
+    alloc.deallocate(output, alloc.state);
+  }
+  return remapped;
+}
+
+TEST_F(CLASSNAME(TestArgumentsFixture, RMW_IMPLEMENTATION), test_remap_file) {
+  const char * text_path = "test_remap_file_rules.txt";
+  const char * compiled_path = "test_remap_file_rules.bin";
+  {
+    std::ofstream text_file(text_path);
+    text_file << "# rules for the test\n  /foo:=/bar  \n\nother:/foo:=/nope\r\n/fiz:=/buz";
+  }
+  const char * argv[] = {
+    "process_name", "/foo:=/first", "__remap_file:=test_remap_file_rules.txt", "/baz:=/last"
+  };
+  int argc = sizeof(argv) / sizeof(const char *);
+  rcl_arguments_t parsed_args = rcl_get_zero_initialized_arguments();
+  rcl_ret_t ret = rcl_parse_arguments(argc, argv, rcl_get_default_allocator(), &parsed_args);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_UNPARSED(parsed_args, 0);
+  EXPECT_EQ("/first", remap_topic(&parsed_args, "/foo"));
+  EXPECT_EQ("/buz", remap_topic(&parsed_args, "/fiz"));
+  EXPECT_EQ("/last", remap_topic(&parsed_args, "/baz"));
+  ret = rcl_arguments_write_remap_file(&parsed_args, compiled_path);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_OK, rcl_arguments_fini(&parsed_args));
+
+  // The compiled rules keep their order, and a copy outlives the mapped file.
+  const char * compiled_argv[] = {
+    "process_name", "/fiz:=/before", "__remap_file:=test_remap_file_rules.bin"
+  };
+  int compiled_argc = sizeof(compiled_argv) / sizeof(const char *);
+  rcl_arguments_t compiled_args = rcl_get_zero_initialized_arguments();
+  ret = rcl_parse_arguments(
+    compiled_argc, compiled_argv, rcl_get_default_allocator(), &compiled_args);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_UNPARSED(compiled_args, 0);
+  EXPECT_EQ("/first", remap_topic(&compiled_args, "/foo"));
+  EXPECT_EQ("/before", remap_topic(&compiled_args, "/fiz"));
+  EXPECT_EQ("/last", remap_topic(&compiled_args, "/baz"));
+  EXPECT_EQ("", remap_topic(&compiled_args, "/other"));
+  rcl_arguments_t copied_args = rcl_get_zero_initialized_arguments();
+  ret = rcl_arguments_copy(&compiled_args, &copied_args);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_OK, rcl_arguments_fini(&compiled_args));
+  EXPECT_EQ("/last", remap_topic(&copied_args, "/baz"));
+  EXPECT_EQ(RCL_RET_OK, rcl_arguments_fini(&copied_args));
+
+  std::remove(text_path);
+  std::remove(compiled_path);
+}
+
+TEST_F(CLASSNAME(TestArgumentsFixture, RMW_IMPLEMENTATION), test_remap_file_invalid) {
+  const char * invalid_path = "test_remap_file_invalid.txt";
+  const char * corrupted_path = "test_remap_file_corrupted.bin";
+  {
+    std::ofstream invalid_file(invalid_path);
+    invalid_file << "/foo:=/bar\nnot a rule\n";
+    // Starts like a compiled file, but is truncated.
+    std::ofstream corrupted_file(corrupted_path, std::ios::binary);
+    corrupted_file << "\177rclrmap";
+  }
+  const char * argv[] = {
+    "process_name", "__remap_file:=test_remap_file_invalid.txt",
+    "__remap_file:=test_remap_file_corrupted.bin", "__remap_file:=test_remap_file_missing.txt",
+    "__remap_file:="
+  };
+  int argc = sizeof(argv) / sizeof(const char *);
+  rcl_arguments_t parsed_args = rcl_get_zero_initialized_arguments();
+  rcl_ret_t ret = rcl_parse_arguments(argc, argv, rcl_get_default_allocator(), &parsed_args);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  // None of the rules of an invalid file are used.
+  EXPECT_UNPARSED(parsed_args, 0, 1, 2, 3, 4);
+  EXPECT_EQ("", remap_topic(&parsed_args, "/foo"));
+  EXPECT_EQ(RCL_RET_OK, rcl_arguments_fini(&parsed_args));
+
+  std::remove(invalid_path);
+  std::remove(corrupted_path);
+}
@@ -14,6 +14,11 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <set>
+#include <thread>
+#include <vector>
+
 #include "rcl/client.h"
 
 #include "rcl/rcl.h"
@@ -102,6 +107,123 @@ TEST_F(TestClientFixture, test_client_nominal) {
 }
 
 
+/* Test that concurrent senders on one client each get their own sequence number.
+ */
+TEST_F(TestClientFixture, test_client_concurrent_send_request) {
+  rcl_ret_t ret;
+  rcl_client_t client = rcl_get_zero_initialized_client();
+  const char * topic_name = "add_two_ints_concurrent";
+  rcl_client_options_t client_options = rcl_client_get_default_options();
+  const rosidl_service_type_support_t * ts = ROSIDL_GET_SRV_TYPE_SUPPORT(
+    test_msgs, srv, Primitives);
+  ret = rcl_client_init(&client, this->node_ptr, ts, topic_name, &client_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    rcl_ret_t ret = rcl_client_fini(&client, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  const size_t number_of_threads = 4;
+  const size_t requests_per_thread = 25;
+  std::vector<std::vector<int64_t>> sequence_numbers(number_of_threads);
+  std::vector<rcl_ret_t> results(number_of_threads, RCL_RET_OK);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < number_of_threads; ++t) {
+    threads.emplace_back([&client, &sequence_numbers, &results, requests_per_thread, t]() {
+        test_msgs__srv__Primitives_Request req;
+        test_msgs__srv__Primitives_Request__init(&req);
+        req.uint8_value = static_cast<uint8_t>(t);
+        for (size_t i = 0; i < requests_per_thread; ++i) {
+          int64_t sequence_number = 0;
+          rcl_ret_t ret = rcl_send_request(&client, &req, &sequence_number);
+          if (RCL_RET_OK != ret) {
+            results[t] = ret;
+            break;
+          }
+          sequence_numbers[t].push_back(sequence_number);
+        }
+        test_msgs__srv__Primitives_Request__fini(&req);
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  std::set<int64_t> unique_sequence_numbers;
+  for (size_t t = 0; t < number_of_threads; ++t) {
+    EXPECT_EQ(RCL_RET_OK, results[t]);
+    unique_sequence_numbers.insert(sequence_numbers[t].begin(), sequence_numbers[t].end());
+  }
+  EXPECT_EQ(number_of_threads * requests_per_thread, unique_sequence_numbers.size());
+}
+
+/* Test that requests with deadlines are tracked, expire and wake up a wait set.
+ */
+TEST_F(TestClientFixture, test_client_pending_request_deadline) {
+  rcl_ret_t ret;
+  const rosidl_service_type_support_t * ts = ROSIDL_GET_SRV_TYPE_SUPPORT(
+    test_msgs, srv, Primitives);
+  rcl_client_options_t client_options = rcl_client_get_default_options();
+  EXPECT_EQ(0u, client_options.pending_request_capacity);
+  client_options.pending_request_capacity = 2;
+  rcl_client_t client = rcl_get_zero_initialized_client();
+  ret = rcl_client_init(&client, this->node_ptr, ts, "pending_request_deadline", &client_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    rcl_ret_t ret = rcl_client_fini(&client, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  test_msgs__srv__Primitives_Request req;
+  test_msgs__srv__Primitives_Request__init(&req);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    test_msgs__srv__Primitives_Request__fini(&req);
+  });
+  int user_data_marker = 0;
+  int64_t expiring_sequence_number = 0;
+  ret = rcl_send_request_with_timeout(
+    &client, &req, 0, &user_data_marker, &expiring_sequence_number);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  int64_t sequence_number = 0;
+  ret = rcl_send_request(&client, &req, &sequence_number);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  size_t count = 0;
+  ret = rcl_client_get_pending_request_count(&client, &count);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(2u, count);
+  ret = rcl_send_request(&client, &req, &sequence_number);
+  EXPECT_EQ(RCL_RET_CLIENT_PENDING_REQUESTS_FULL, ret);
+  rcl_reset_error();
+
+  // The expired request makes the client ready long before the wait times out.
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  ret = rcl_wait_set_init(&wait_set, 0, 0, 0, 1, 0, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    rcl_ret_t ret = rcl_wait_set_fini(&wait_set);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  ret = rcl_wait_set_add_client(&wait_set, &client, NULL);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  auto before = std::chrono::steady_clock::now();
+  ret = rcl_wait(&wait_set, RCL_S_TO_NS(10));
+  auto elapsed = std::chrono::steady_clock::now() - before;
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_LT(elapsed, std::chrono::seconds(5));
+  EXPECT_EQ(&client, wait_set.clients[0]);
+
+  int64_t expired_sequence_number = 0;
+  void * user_data = nullptr;
+  ret = rcl_client_take_expired_request(&client, &expired_sequence_number, &user_data);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(expiring_sequence_number, expired_sequence_number);
+  EXPECT_EQ(&user_data_marker, user_data);
+  ret = rcl_client_take_expired_request(&client, &expired_sequence_number, &user_data);
+  EXPECT_EQ(RCL_RET_CLIENT_TAKE_FAILED, ret);
+  ret = rcl_client_get_pending_request_count(&client, &count);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(1u, count);
+}
+
 /* Testing the client init and fini functions.
  */
 TEST_F(TestClientFixture, test_client_init_fini) {
@@ -30,6 +30,7 @@
 
 #include "rcl/error_handling.h"
 #include "rcl/graph.h"
+#include "rcl/graph_export.h"
 #include "rcl/rcl.h"
 
 #include "rcutils/logging_macros.h"
@@ -872,3 +873,417 @@ TEST_F(CLASSNAME(TestGraphFixture, RMW_IMPLEMENTATION), test_rcl_service_server_
   wait_for_service_state_to_change(false, is_available);
   ASSERT_FALSE(is_available);
 }
+
+/* Test the graph queries with the graph cache enabled in the init options.
+ */
+TEST_F(CLASSNAME(TestGraphFixture, RMW_IMPLEMENTATION), test_graph_cache) {
+  rcl_ret_t ret;
+  rcl_init_options_t init_options = rcl_get_zero_initialized_init_options();
+  ret = rcl_init_options_init(&init_options, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_init_options_fini(&init_options)) << rcl_get_error_string().str;
+  });
+  int64_t max_age = -1;
+  ret = rcl_init_options_get_graph_cache_max_age(&init_options, &max_age);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(0, max_age);
+  ret = rcl_init_options_set_graph_cache_max_age(&init_options, -1);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, ret);
+  rcl_reset_error();
+  // Long enough that only graph changes can invalidate the snapshot during the test.
+  const int64_t long_max_age = std::chrono::nanoseconds(std::chrono::minutes(1)).count();
+  ret = rcl_init_options_set_graph_cache_max_age(&init_options, long_max_age);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  rcl_context_t context = rcl_get_zero_initialized_context();
+  ret = rcl_init(0, nullptr, &init_options, &context);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_shutdown(&context)) << rcl_get_error_string().str;
+    EXPECT_EQ(RCL_RET_OK, rcl_context_fini(&context)) << rcl_get_error_string().str;
+  });
+  ret = rcl_init_options_get_graph_cache_max_age(
+    rcl_context_get_init_options(&context), &max_age);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(long_max_age, max_age);
+  rcl_node_t node = rcl_get_zero_initialized_node();
+  rcl_node_options_t node_options = rcl_node_get_default_options();
+  ret = rcl_node_init(&node, "test_graph_cache_node", "", &context, &node_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_node_fini(&node)) << rcl_get_error_string().str;
+  });
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  ret = rcl_wait_set_init(&wait_set, 0, 1, 0, 0, 0, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_set)) << rcl_get_error_string().str;
+  });
+  const char * topic_name = "/chatter_test_graph_cache";
+  size_t count = 1;
+  ret = rcl_count_publishers(&node, topic_name, &count);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(0u, count);
+  rcl_publisher_t pub = rcl_get_zero_initialized_publisher();
+  rcl_publisher_options_t pub_ops = rcl_publisher_get_default_options();
+  ret = rcl_publisher_init(
+    &pub, &node, ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Primitives), topic_name, &pub_ops);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_publisher_fini(&pub, &node)) << rcl_get_error_string().str;
+  });
+  // Waiting on the graph guard condition lets the cache see the publisher once discovered.
+  const rcl_guard_condition_t * graph_guard_condition = rcl_node_get_graph_guard_condition(&node);
+  ASSERT_NE(nullptr, graph_guard_condition) << rcl_get_error_string().str;
+  auto end = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  do {
+    ret = rcl_count_publishers(&node, topic_name, &count);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    if (1u == count) {
+      break;
+    }
+    ret = rcl_wait_set_clear(&wait_set);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ret = rcl_wait_set_add_guard_condition(&wait_set, graph_guard_condition, NULL);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ret = rcl_wait(&wait_set, RCL_MS_TO_NS(200));
+    ASSERT_TRUE(RCL_RET_OK == ret || RCL_RET_TIMEOUT == ret) << rcl_get_error_string().str;
+  } while (std::chrono::steady_clock::now() < end);
+  EXPECT_EQ(1u, count);
+  // The other queries are answered from the same snapshot.
+  ret = rcl_count_subscribers(&node, topic_name, &count);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(0u, count);
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_names_and_types_t tnat = rcl_get_zero_initialized_names_and_types();
+  ret = rcl_get_topic_names_and_types(&node, &allocator, false, &tnat);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  bool topic_found = false;
+  for (size_t i = 0; i < tnat.names.size; ++i) {
+    topic_found = topic_found || std::string(topic_name) == tnat.names.data[i];
+  }
+  EXPECT_TRUE(topic_found);
+  ret = rcl_names_and_types_fini(&tnat);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  rcutils_string_array_t node_names = rcutils_get_zero_initialized_string_array();
+  rcutils_string_array_t node_namespaces = rcutils_get_zero_initialized_string_array();
+  ret = rcl_get_node_names(&node, allocator, &node_names, &node_namespaces);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  bool node_found = false;
+  for (size_t i = 0; i < node_names.size; ++i) {
+    node_found = node_found || std::string("test_graph_cache_node") == node_names.data[i];
+  }
+  EXPECT_TRUE(node_found);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_string_array_fini(&node_names));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_string_array_fini(&node_namespaces));
+}
+
+/* Test the rcl_get_graph_changes function.
+ */
+TEST_F(CLASSNAME(TestGraphFixture, RMW_IMPLEMENTATION), test_rcl_get_graph_changes) {
+  rcl_ret_t ret;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_graph_cursor_t cursor = RCL_GRAPH_CURSOR_INITIAL;
+  rcl_graph_changes_t changes = rcl_get_zero_initialized_graph_changes();
+  ret = rcl_get_graph_changes(nullptr, &cursor, &allocator, &changes);
+  EXPECT_EQ(RCL_RET_NODE_INVALID, ret);
+  rcl_reset_error();
+  ret = rcl_get_graph_changes(this->node_ptr, nullptr, &allocator, &changes);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, ret);
+  rcl_reset_error();
+  // The first call lists the whole graph, including this node.
+  ret = rcl_get_graph_changes(this->node_ptr, &cursor, &allocator, &changes);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_TRUE(changes.is_full_state);
+  EXPECT_NE(RCL_GRAPH_CURSOR_INITIAL, cursor);
+  bool node_found = false;
+  for (size_t i = 0; i < changes.size; ++i) {
+    const rcl_graph_entity_t & entity = changes.changes[i].entity;
+    EXPECT_TRUE(changes.changes[i].added);
+    node_found = node_found || (RCL_GRAPH_ENTITY_NODE == entity.kind &&
+      std::string(this->test_graph_node_name) == entity.node_name);
+  }
+  EXPECT_TRUE(node_found);
+  ret = rcl_graph_changes_fini(&changes);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  const char * topic_name = "/chatter_test_rcl_get_graph_changes";
+  const rcl_guard_condition_t * graph_guard_condition =
+    rcl_node_get_graph_guard_condition(this->node_ptr);
+  ASSERT_NE(nullptr, graph_guard_condition) << rcl_get_error_string().str;
+  // Wait for the publisher on the topic to be added or removed.
+  auto wait_for_publisher_change = [&](bool expect_added) -> bool {
+      auto end = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+      while (std::chrono::steady_clock::now() < end) {
+        rcl_graph_changes_t changes = rcl_get_zero_initialized_graph_changes();
+        rcl_ret_t ret = rcl_get_graph_changes(this->node_ptr, &cursor, &allocator, &changes);
+        EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+        EXPECT_FALSE(changes.is_full_state);
+        bool found = false;
+        for (size_t i = 0; i < changes.size; ++i) {
+          const rcl_graph_entity_t & entity = changes.changes[i].entity;
+          found = found || (RCL_GRAPH_ENTITY_PUBLISHER == entity.kind &&
+            changes.changes[i].added == expect_added && std::string(topic_name) == entity.name);
+        }
+        EXPECT_EQ(RCL_RET_OK, rcl_graph_changes_fini(&changes)) << rcl_get_error_string().str;
+        if (found) {
+          return true;
+        }
+        EXPECT_EQ(RCL_RET_OK, rcl_wait_set_clear(this->wait_set_ptr));
+        EXPECT_EQ(RCL_RET_OK, rcl_wait_set_add_guard_condition(
+            this->wait_set_ptr, graph_guard_condition, NULL));
+        ret = rcl_wait(this->wait_set_ptr, RCL_MS_TO_NS(200));
+        EXPECT_TRUE(RCL_RET_OK == ret || RCL_RET_TIMEOUT == ret) << rcl_get_error_string().str;
+      }
+      return false;
+    };
+  rcl_publisher_t pub = rcl_get_zero_initialized_publisher();
+  rcl_publisher_options_t pub_ops = rcl_publisher_get_default_options();
+  ret = rcl_publisher_init(
+    &pub, this->node_ptr, ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Primitives), topic_name,
+    &pub_ops);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_TRUE(wait_for_publisher_change(true));
+  ret = rcl_publisher_fini(&pub, this->node_ptr);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_TRUE(wait_for_publisher_change(false));
+}
+
+/* Test the rcl_wait_for_service, rcl_wait_for_publishers and rcl_wait_for_subscribers functions.
+ */
+TEST_F(CLASSNAME(TestGraphFixture, RMW_IMPLEMENTATION), test_rcl_wait_for_graph_entities) {
+  rcl_ret_t ret;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  const char * topic_name = "/chatter_test_rcl_wait_for_graph_entities";
+  const char * service_name = "/service_test_rcl_wait_for_graph_entities";
+  auto ts = ROSIDL_GET_SRV_TYPE_SUPPORT(test_msgs, srv, Primitives);
+  rcl_client_t client = rcl_get_zero_initialized_client();
+  rcl_client_options_t client_options = rcl_client_get_default_options();
+  ret = rcl_client_init(&client, this->node_ptr, ts, service_name, &client_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_client_fini(&client, this->node_ptr)) << rcl_get_error_string().str;
+  });
+  bool success = true;
+  ret = rcl_wait_for_publishers(nullptr, &allocator, topic_name, 1, 0, &success);
+  EXPECT_EQ(RCL_RET_NODE_INVALID, ret);
+  rcl_reset_error();
+  ret = rcl_wait_for_publishers(this->node_ptr, &allocator, nullptr, 1, 0, &success);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, ret);
+  rcl_reset_error();
+  // Nothing exists yet, so short waits time out.
+  ret = rcl_wait_for_publishers(this->node_ptr, &allocator, topic_name, 1, 0, &success);
+  EXPECT_EQ(RCL_RET_TIMEOUT, ret);
+  EXPECT_FALSE(success);
+  ret = rcl_wait_for_service(this->node_ptr, &allocator, &client, RCL_MS_TO_NS(100), &success);
+  EXPECT_EQ(RCL_RET_TIMEOUT, ret);
+  EXPECT_FALSE(success);
+  // Zero publishers are always reached.
+  ret = rcl_wait_for_publishers(this->node_ptr, &allocator, topic_name, 0, 0, &success);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_TRUE(success);
+
+  // Create the entities from another thread while waiting for them.
+  // A node of the context is created and finalized first, which the wait must let go of.
+  rcl_publisher_t pub = rcl_get_zero_initialized_publisher();
+  rcl_subscription_t sub = rcl_get_zero_initialized_subscription();
+  rcl_service_t service = rcl_get_zero_initialized_service();
+  std::thread create_thread(
+    [&]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      rcl_node_t other_node = rcl_get_zero_initialized_node();
+      rcl_node_options_t node_options = rcl_node_get_default_options();
+      EXPECT_EQ(RCL_RET_OK, rcl_node_init(
+          &other_node, "test_rcl_wait_for_graph_entities_other", "", this->context_ptr,
+          &node_options)) << rcl_get_error_string().str;
+      EXPECT_EQ(RCL_RET_OK, rcl_node_fini(&other_node)) << rcl_get_error_string().str;
+      rcl_publisher_options_t pub_ops = rcl_publisher_get_default_options();
+      EXPECT_EQ(RCL_RET_OK, rcl_publisher_init(
+          &pub, this->node_ptr, ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Primitives),
+          topic_name, &pub_ops)) << rcl_get_error_string().str;
+      rcl_subscription_options_t sub_ops = rcl_subscription_get_default_options();
+      EXPECT_EQ(RCL_RET_OK, rcl_subscription_init(
+          &sub, this->node_ptr, ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Primitives),
+          topic_name, &sub_ops)) << rcl_get_error_string().str;
+      rcl_service_options_t service_options = rcl_service_get_default_options();
+      EXPECT_EQ(RCL_RET_OK, rcl_service_init(
+          &service, this->node_ptr, ts, service_name, &service_options)) <<
+        rcl_get_error_string().str;
+    });
+  const rcl_duration_value_t timeout = RCL_S_TO_NS(10);
+  ret = rcl_wait_for_publishers(this->node_ptr, &allocator, topic_name, 1, timeout, &success);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_TRUE(success);
+  create_thread.join();
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_publisher_fini(&pub, this->node_ptr)) << rcl_get_error_string().str;
+    EXPECT_EQ(RCL_RET_OK, rcl_subscription_fini(&sub, this->node_ptr)) <<
+      rcl_get_error_string().str;
+    EXPECT_EQ(RCL_RET_OK, rcl_service_fini(&service, this->node_ptr)) <<
+      rcl_get_error_string().str;
+  });
+  ret = rcl_wait_for_subscribers(this->node_ptr, &allocator, topic_name, 1, timeout, &success);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_TRUE(success);
+  ret = rcl_wait_for_service(this->node_ptr, &allocator, &client, timeout, &success);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_TRUE(success);
+}
+
+/* Test the rcl_graph_export function and reading its buffer with rcl_graph_reader_t.
+ */
+TEST_F(CLASSNAME(TestGraphFixture, RMW_IMPLEMENTATION), test_rcl_graph_export) {
+  rcl_ret_t ret;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  rcl_graph_export_t graph_export = rcl_get_zero_initialized_graph_export();
+  ret = rcl_graph_export(nullptr, &allocator, &graph_export);
+  EXPECT_EQ(RCL_RET_NODE_INVALID, ret);
+  rcl_reset_error();
+  ret = rcl_graph_export(this->node_ptr, nullptr, &graph_export);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, ret);
+  rcl_reset_error();
+
+  const char * topic_name = "/chatter_test_rcl_graph_export";
+  rcl_publisher_t pub = rcl_get_zero_initialized_publisher();
+  rcl_publisher_options_t pub_ops = rcl_publisher_get_default_options();
+  ret = rcl_publisher_init(
+    &pub, this->node_ptr, ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Primitives), topic_name,
+    &pub_ops);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_publisher_fini(&pub, this->node_ptr)) << rcl_get_error_string().str;
+  });
+  bool success = false;
+  ret = rcl_wait_for_publishers(
+    this->node_ptr, &allocator, topic_name, 1, RCL_S_TO_NS(10), &success);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ASSERT_TRUE(success);
+
+  ret = rcl_graph_export(this->node_ptr, &allocator, &graph_export);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_graph_export_fini(&graph_export)) << rcl_get_error_string().str;
+  });
+  // Read a copy, the reader needs no alignment and no allocation.
+  std::vector<uint8_t> buffer(graph_export.buffer, graph_export.buffer + graph_export.size);
+  rcl_graph_reader_t reader;
+  ret = rcl_graph_reader_init(&reader, buffer.data(), buffer.size());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  bool publisher_found = false;
+  size_t node_count = rcl_graph_reader_get_node_count(&reader);
+  EXPECT_GE(node_count, 1u);
+  for (size_t i = 0; i < node_count; ++i) {
+    rcl_graph_export_node_t node;
+    ret = rcl_graph_reader_get_node(&reader, i, &node);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    if (std::string(this->test_graph_node_name) != node.name) {
+      continue;
+    }
+    for (size_t j = node.first_endpoint; j < node.first_endpoint + node.endpoint_count; ++j) {
+      rcl_graph_export_endpoint_t endpoint;
+      ret = rcl_graph_reader_get_endpoint(&reader, j, &endpoint);
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+      EXPECT_EQ(i, endpoint.node_index);
+      publisher_found = publisher_found || (RCL_GRAPH_ENTITY_PUBLISHER == endpoint.kind &&
+        std::string(topic_name) == endpoint.name);
+    }
+  }
+  EXPECT_TRUE(publisher_found);
+  rcl_graph_export_endpoint_t endpoint;
+  ret = rcl_graph_reader_get_endpoint(
+    &reader, rcl_graph_reader_get_endpoint_count(&reader), &endpoint);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, ret);
+  rcl_reset_error();
+
+  // Truncated or corrupted buffers are rejected.
+  ret = rcl_graph_reader_init(&reader, buffer.data(), buffer.size() - 1);
+  EXPECT_EQ(RCL_RET_ERROR, ret);
+  rcl_reset_error();
+  EXPECT_EQ(0u, rcl_graph_reader_get_node_count(&reader));
+  buffer[0] = 'X';
+  ret = rcl_graph_reader_init(&reader, buffer.data(), buffer.size());
+  EXPECT_EQ(RCL_RET_ERROR, ret);
+  rcl_reset_error();
+}
+
+/* Test the rcl_context_get_graph_guard_condition function.
+ */
+TEST_F(CLASSNAME(TestGraphFixture, RMW_IMPLEMENTATION), test_context_graph_guard_condition) {
+  rcl_ret_t ret;
+  EXPECT_EQ(nullptr, rcl_context_get_graph_guard_condition(nullptr));
+  rcl_reset_error();
+  rcl_context_t zero_context = rcl_get_zero_initialized_context();
+  EXPECT_EQ(nullptr, rcl_context_get_graph_guard_condition(&zero_context));
+  rcl_reset_error();
+  const rcl_guard_condition_t * graph_guard_condition =
+    rcl_context_get_graph_guard_condition(this->context_ptr);
+  ASSERT_NE(nullptr, graph_guard_condition) << rcl_get_error_string().str;
+
+  // Wait until the guard condition is ready, after draining earlier changes.
+  auto wait_for_graph_change = [&](std::chrono::nanoseconds timeout) -> bool {
+      auto end = std::chrono::steady_clock::now() + timeout;
+      while (true) {
+        EXPECT_EQ(RCL_RET_OK, rcl_wait_set_clear(this->wait_set_ptr));
+        EXPECT_EQ(RCL_RET_OK, rcl_wait_set_add_guard_condition(
+            this->wait_set_ptr, graph_guard_condition, NULL));
+        auto remaining = end - std::chrono::steady_clock::now();
+        rcl_ret_t ret = rcl_wait(
+          this->wait_set_ptr, std::max<int64_t>(0, remaining.count()));
+        EXPECT_TRUE(RCL_RET_OK == ret || RCL_RET_TIMEOUT == ret) << rcl_get_error_string().str;
+        if (RCL_RET_OK == ret) {
+          EXPECT_EQ(graph_guard_condition, this->wait_set_ptr->guard_conditions[0]);
+          return true;
+        }
+        if (std::chrono::steady_clock::now() >= end) {
+          return false;
+        }
+      }
+    };
+  // Drain the changes from setting up the fixture, bounded in case other processes keep going.
+  auto drain_graph_changes = [&]() {
+      for (size_t i = 0; i < 50 && wait_for_graph_change(std::chrono::milliseconds(200)); ++i) {
+      }
+    };
+  drain_graph_changes();
+
+  // A new node of the context makes it ready, without adding that node's guard condition.
+  rcl_node_t node = rcl_get_zero_initialized_node();
+  rcl_node_options_t node_options = rcl_node_get_default_options();
+  ret = rcl_node_init(
+    &node, "test_context_graph_guard_condition", "", this->context_ptr, &node_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_TRUE(wait_for_graph_change(std::chrono::seconds(10)));
+  drain_graph_changes();
+
+  // So does a publisher of the new node, which only triggers the node graph guard conditions.
+  rcl_publisher_t pub = rcl_get_zero_initialized_publisher();
+  rcl_publisher_options_t pub_ops = rcl_publisher_get_default_options();
+  ret = rcl_publisher_init(
+    &pub, &node, ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Primitives),
+    "/chatter_test_context_graph_guard_condition", &pub_ops);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_TRUE(wait_for_graph_change(std::chrono::seconds(10)));
+  ret = rcl_publisher_fini(&pub, &node);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_node_fini(&node);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_TRUE(wait_for_graph_change(std::chrono::seconds(10)));
+  drain_graph_changes();
+
+  // Finalizing a node wakes up a wait in another thread, which may use its guard condition.
+  node = rcl_get_zero_initialized_node();
+  ret = rcl_node_init(
+    &node, "test_context_graph_guard_condition", "", this->context_ptr, &node_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  drain_graph_changes();
+  std::promise<void> waiting;
+  auto woken_up = std::async(std::launch::async, [&]() {
+        waiting.set_value();
+        return wait_for_graph_change(std::chrono::seconds(10));
+      });
+  waiting.get_future().wait();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ret = rcl_node_fini(&node);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_TRUE(woken_up.get());
+}
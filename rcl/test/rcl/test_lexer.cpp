@@ -118,6 +118,10 @@ TEST_F(CLASSNAME(TestLexerFixture, RMW_IMPLEMENTATION), test_token)
   EXPECT_LEX(RCL_LEXEME_NONE, "`", "`");
   EXPECT_LEX(RCL_LEXEME_NONE, "{", "{");
 
+  // Characters outside of ASCII are banned, and end tokens
+  EXPECT_LEX(RCL_LEXEME_NONE, "\xc3", "\xc3\xa9");
+  EXPECT_LEX(RCL_LEXEME_TOKEN, "caf", "caf\xc3\xa9");
+
   // Tokens cannot start with digits
   EXPECT_LEX(RCL_LEXEME_NONE, "0", "0");
   EXPECT_LEX(RCL_LEXEME_NONE, "1", "1");
@@ -685,3 +685,81 @@ TEST_F(CLASSNAME(TestNodeFixture, RMW_IMPLEMENTATION), test_rcl_node_logger_name
     EXPECT_EQ(RCL_RET_OK, ret);
   }
 }
+
+/* Tests the rcl_node_init_many() function.
+ */
+TEST_F(CLASSNAME(TestNodeFixture, RMW_IMPLEMENTATION), test_rcl_node_init_many) {
+  rcl_ret_t ret;
+  rcl_init_options_t init_options = rcl_get_zero_initialized_init_options();
+  ret = rcl_init_options_init(&init_options, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_init_options_fini(&init_options)) << rcl_get_error_string().str;
+  });
+  rcl_context_t context = rcl_get_zero_initialized_context();
+  const char * names[] = {"node_a", "node_b", "node_c"};
+  const char * namespaces[] = {"ns", "ns", "/other"};
+  rcl_node_t nodes[3];
+  for (rcl_node_t & node : nodes) {
+    node = rcl_get_zero_initialized_node();
+  }
+  rcl_node_options_t default_options = rcl_node_get_default_options();
+  // Trying to init before rcl_init() should fail.
+  ret = rcl_node_init_many(nodes, 3, names, namespaces, &context, &default_options);
+  EXPECT_EQ(RCL_RET_NOT_INIT, ret);
+  rcl_reset_error();
+  ret = rcl_init(0, nullptr, &init_options, &context);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    ASSERT_EQ(RCL_RET_OK, rcl_shutdown(&context));
+    ASSERT_EQ(RCL_RET_OK, rcl_context_fini(&context));
+  });
+  ret = rcl_node_init_many(nodes, 3, nullptr, namespaces, &context, &default_options);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, ret);
+  rcl_reset_error();
+
+  // An invalid name fails all nodes, including those initialized before it.
+  const char * invalid_names[] = {"node_a", "node_b", "invalid/name"};
+  ret = rcl_node_init_many(nodes, 3, invalid_names, namespaces, &context, &default_options);
+  EXPECT_EQ(RCL_RET_NODE_INVALID_NAME, ret);
+  rcl_reset_error();
+  for (const rcl_node_t & node : nodes) {
+    EXPECT_EQ(nullptr, node.impl);
+  }
+  // So does an invalid namespace, even after a valid one.
+  const char * invalid_namespaces[] = {"ns", "ns", "/invalid//ns"};
+  ret = rcl_node_init_many(nodes, 3, names, invalid_namespaces, &context, &default_options);
+  EXPECT_EQ(RCL_RET_NODE_INVALID_NAMESPACE, ret);
+  rcl_reset_error();
+  for (const rcl_node_t & node : nodes) {
+    EXPECT_EQ(nullptr, node.impl);
+  }
+
+  ret = rcl_node_init_many(nodes, 3, names, namespaces, &context, &default_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  const char * expected_namespaces[] = {"/ns", "/ns", "/other"};
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_TRUE(rcl_node_is_valid(&nodes[i]));
+    EXPECT_STREQ(names[i], rcl_node_get_name(&nodes[i]));
+    EXPECT_STREQ(expected_namespaces[i], rcl_node_get_namespace(&nodes[i]));
+    ret = rcl_node_fini(&nodes[i]);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+
+  // Node name and namespace remap rules still apply.
+  const char * remap_argv[] = {"process_name", "__node:=remapped", "__ns:=/remapped_ns"};
+  rcl_node_options_t remap_options = rcl_node_get_default_options();
+  ret = rcl_parse_arguments(
+    3, remap_argv, rcl_get_default_allocator(), &remap_options.arguments);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_arguments_fini(&remap_options.arguments)) <<
+      rcl_get_error_string().str;
+  });
+  ret = rcl_node_init_many(nodes, 1, names, namespaces, &context, &remap_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_STREQ("remapped", rcl_node_get_name(&nodes[0]));
+  EXPECT_STREQ("/remapped_ns", rcl_node_get_namespace(&nodes[0]));
+  ret = rcl_node_fini(&nodes[0]);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+}
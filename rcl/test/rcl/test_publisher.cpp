@@ -14,6 +14,10 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #include "rcl/publisher.h"
 
 #include "rcl/rcl.h"
@@ -170,6 +174,37 @@ TEST_F(CLASSNAME(TestPublisherFixture, RMW_IMPLEMENTATION), test_publishers_diff
   ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
 }
 
+/* Test that topic names are expanded, substituted and validated like rcl_expand_topic_name().
+ */
+TEST_F(CLASSNAME(TestPublisherFixture, RMW_IMPLEMENTATION), test_publisher_topic_name_resolution) {
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Primitives);
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  const char * topic_names[][2] = {
+    {"~/private", "/test_publisher_node/private"},
+    {"{node}/sub", "/test_publisher_node/sub"},
+    {"{namespace}relative", "/relative"},
+  };
+  for (size_t i = 0; i < sizeof(topic_names) / sizeof(topic_names[0]); ++i) {
+    rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+    rcl_ret_t ret = rcl_publisher_init(
+      &publisher, this->node_ptr, ts, topic_names[i][0], &publisher_options);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_STREQ(topic_names[i][1], rcl_publisher_get_topic_name(&publisher));
+    ret = rcl_publisher_fini(&publisher, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+
+  const char * invalid_topic_names[] = {"{unknown}", "foo bar", "/foo//bar", "~foo"};
+  for (size_t i = 0; i < sizeof(invalid_topic_names) / sizeof(invalid_topic_names[0]); ++i) {
+    rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+    rcl_ret_t ret = rcl_publisher_init(
+      &publisher, this->node_ptr, ts, invalid_topic_names[i], &publisher_options);
+    EXPECT_EQ(RCL_RET_TOPIC_NAME_INVALID, ret) << invalid_topic_names[i];
+    rcl_reset_error();
+  }
+}
+
 /* Testing the publisher init and fini functions.
  */
 TEST_F(CLASSNAME(TestPublisherFixture, RMW_IMPLEMENTATION), test_publisher_init_fini) {
@@ -266,4 +301,182 @@ TEST_F(CLASSNAME(TestPublisherFixture, RMW_IMPLEMENTATION), test_publisher_init_
     &publisher, this->node_ptr, ts, topic_name, &publisher_options_with_failing_allocator);
   EXPECT_EQ(RCL_RET_BAD_ALLOC, ret) << rcl_get_error_string().str;
   rcl_reset_error();
+
+  // Try passing options with a negative maximum publish rate with init.
+  publisher = rcl_get_zero_initialized_publisher();
+  rcl_publisher_options_t publisher_options_with_negative_rate;
+  publisher_options_with_negative_rate = rcl_publisher_get_default_options();
+  publisher_options_with_negative_rate.max_publish_rate = -1.0;
+  ret = rcl_publisher_init(
+    &publisher, this->node_ptr, ts, topic_name, &publisher_options_with_negative_rate);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, ret) << rcl_get_error_string().str;
+  rcl_reset_error();
+}
+
+/* Take the int64_value of every message which arrives within max_tries waits of period_ms.
+ */
+void
+take_int64_values(
+  rcl_subscription_t * subscription,
+  size_t max_tries,
+  int64_t period_ms,
+  std::vector<int64_t> & values)
+{
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  rcl_ret_t ret = rcl_wait_set_init(&wait_set, 1, 0, 0, 0, 0, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    rcl_ret_t ret = rcl_wait_set_fini(&wait_set);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  for (size_t iteration = 0; iteration < max_tries; ++iteration) {
+    ret = rcl_wait_set_clear(&wait_set);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ret = rcl_wait_set_add_subscription(&wait_set, subscription, NULL);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ret = rcl_wait(&wait_set, RCL_MS_TO_NS(period_ms));
+    if (ret == RCL_RET_TIMEOUT) {
+      continue;
+    }
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    while (true) {
+      test_msgs__msg__Primitives msg;
+      test_msgs__msg__Primitives__init(&msg);
+      ret = rcl_take(subscription, &msg, nullptr);
+      int64_t value = msg.int64_value;
+      test_msgs__msg__Primitives__fini(&msg);
+      if (RCL_RET_SUBSCRIPTION_TAKE_FAILED == ret) {
+        break;
+      }
+      ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+      values.push_back(value);
+    }
+  }
+}
+
+/* Test that a rate limited and decimated publisher drops the messages exceeding either limit.
+ */
+TEST_F(CLASSNAME(TestPublisherFixture, RMW_IMPLEMENTATION), test_publisher_rate_limited) {
+  rcl_ret_t ret;
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Primitives);
+  const char * topic_name = "rcl_test_publisher_rate_limited_chatter";
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  EXPECT_EQ(0.0, publisher_options.max_publish_rate);
+  EXPECT_EQ(0u, publisher_options.publish_decimation);
+  publisher_options.max_publish_rate = 1.0;
+  publisher_options.publish_decimation = 4;
+  ret = rcl_publisher_init(&publisher, this->node_ptr, ts, topic_name, &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    rcl_ret_t ret = rcl_publisher_fini(&publisher, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  const rcl_publisher_options_t * actual_options = rcl_publisher_get_options(&publisher);
+  ASSERT_NE(nullptr, actual_options) << rcl_get_error_string().str;
+  EXPECT_EQ(1.0, actual_options->max_publish_rate);
+  EXPECT_EQ(4u, actual_options->publish_decimation);
+  rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+  rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+  ret = rcl_subscription_init(
+    &subscription, this->node_ptr, ts, topic_name, &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    rcl_ret_t ret = rcl_subscription_fini(&subscription, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  // TODO(wjwwood): add logic to wait for the connection to be established
+  //                probably using the count_subscriptions busy wait mechanism
+  //                until then we will sleep for a short period of time
+  std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+  test_msgs__msg__Primitives msg;
+  test_msgs__msg__Primitives__init(&msg);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    test_msgs__msg__Primitives__fini(&msg);
+  });
+  // Decimation keeps 0, 4, 8, 12 and 16, of which the rate limit only lets 0 through.
+  for (int64_t i = 0; i < 20; ++i) {
+    msg.int64_value = i;
+    ret = rcl_publish(&publisher, &msg);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  // Once the period is over, the next message kept by the decimation is let through again.
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  for (int64_t i = 20; i < 24; ++i) {
+    msg.int64_value = i;
+    ret = rcl_publish(&publisher, &msg);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  std::vector<int64_t> received;
+  take_int64_values(&subscription, 10, 100, received);
+  EXPECT_EQ(std::vector<int64_t>({0, 20}), received);
+}
+
+/* Test publishers whose implementation structs come from the entity arena of their context.
+ */
+TEST_F(CLASSNAME(TestPublisherFixture, RMW_IMPLEMENTATION), test_publisher_entity_arena) {
+  rcl_ret_t ret;
+  rcl_init_options_t init_options = rcl_get_zero_initialized_init_options();
+  ret = rcl_init_options_init(&init_options, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_init_options_fini(&init_options)) << rcl_get_error_string().str;
+  });
+  size_t block_size = 1;
+  ret = rcl_init_options_get_entity_arena_block_size(&init_options, &block_size);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(0u, block_size);
+  ret = rcl_init_options_set_entity_arena_block_size(&init_options, 16 * 1024);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  rcl_context_t context = rcl_get_zero_initialized_context();
+  ret = rcl_init(0, nullptr, &init_options, &context);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_shutdown(&context)) << rcl_get_error_string().str;
+    EXPECT_EQ(RCL_RET_OK, rcl_context_fini(&context)) << rcl_get_error_string().str;
+  });
+  ret = rcl_init_options_get_entity_arena_block_size(
+    rcl_context_get_init_options(&context), &block_size);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(16u * 1024u, block_size);
+  rcl_node_t node = rcl_get_zero_initialized_node();
+  rcl_node_options_t node_options = rcl_node_get_default_options();
+  ret = rcl_node_init(&node, "test_publisher_entity_arena_node", "", &context, &node_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_node_fini(&node)) << rcl_get_error_string().str;
+  });
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Primitives);
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  rcl_publisher_t publishers[3];
+  for (rcl_publisher_t & publisher : publishers) {
+    publisher = rcl_get_zero_initialized_publisher();
+    ret = rcl_publisher_init(&publisher, &node, ts, "chatter", &publisher_options);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    for (rcl_publisher_t & publisher : publishers) {
+      EXPECT_EQ(RCL_RET_OK, rcl_publisher_fini(&publisher, &node)) << rcl_get_error_string().str;
+    }
+  });
+  // The struct of a finalized publisher is reused by the next one.
+  void * finalized_impl = publishers[1].impl;
+  ret = rcl_publisher_fini(&publishers[1], &node);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  publishers[1] = rcl_get_zero_initialized_publisher();
+  ret = rcl_publisher_init(&publishers[1], &node, ts, "chatter", &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(finalized_impl, publishers[1].impl);
+  test_msgs__msg__Primitives msg;
+  test_msgs__msg__Primitives__init(&msg);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    test_msgs__msg__Primitives__fini(&msg);
+  });
+  for (rcl_publisher_t & publisher : publishers) {
+    EXPECT_TRUE(rcl_publisher_is_valid(&publisher));
+    ret = rcl_publish(&publisher, &msg);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
 }
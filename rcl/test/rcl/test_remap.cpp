@@ -501,3 +501,73 @@ TEST_F(CLASSNAME(TestRemapFixture, RMW_IMPLEMENTATION), url_scheme_rostopic) {
   EXPECT_EQ(RCL_RET_OK, ret);
   EXPECT_EQ(NULL, output);
 }
+
+TEST_F(CLASSNAME(TestRemapFixture, RMW_IMPLEMENTATION), wildcard_topic_remap) {
+  rcl_ret_t ret;
+  rcl_arguments_t global_arguments;
+  SCOPE_ARGS(
+    global_arguments, "process_name", "/foo/*/baz:=/bar/\\1", "/deep/**:=/shallow/\\1",
+    "/foo/exact:=/literal", "/foo/*:=/single");
+
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  {
+    char * output = NULL;
+    ret = rcl_remap_topic_name(
+      NULL, &global_arguments, "/foo/qux/baz", "NodeName", "/", allocator, &output);
+    EXPECT_EQ(RCL_RET_OK, ret);
+    EXPECT_STREQ("/bar/qux", output);
+    allocator.deallocate(output, allocator.state);
+  }
+  {
+    char * output = NULL;
+    ret = rcl_remap_topic_name(
+      NULL, &global_arguments, "/deep/a/b/c", "NodeName", "/", allocator, &output);
+    EXPECT_EQ(RCL_RET_OK, ret);
+    EXPECT_STREQ("/shallow/a/b/c", output);
+    allocator.deallocate(output, allocator.state);
+  }
+  {
+    // A wildcard matching nothing leaves no empty token behind.
+    char * output = NULL;
+    ret = rcl_remap_topic_name(
+      NULL, &global_arguments, "/deep", "NodeName", "/", allocator, &output);
+    EXPECT_EQ(RCL_RET_OK, ret);
+    EXPECT_STREQ("/shallow", output);
+    allocator.deallocate(output, allocator.state);
+  }
+  {
+    // The first rule which matches wins, whether it has wildcards or not.
+    char * output = NULL;
+    ret = rcl_remap_topic_name(
+      NULL, &global_arguments, "/foo/exact", "NodeName", "/", allocator, &output);
+    EXPECT_EQ(RCL_RET_OK, ret);
+    EXPECT_STREQ("/literal", output);
+    allocator.deallocate(output, allocator.state);
+  }
+  {
+    char * output = NULL;
+    ret = rcl_remap_topic_name(
+      NULL, &global_arguments, "/foo/other/name", "NodeName", "/", allocator, &output);
+    EXPECT_EQ(RCL_RET_OK, ret);
+    EXPECT_EQ(NULL, output);
+  }
+}
+
+TEST_F(CLASSNAME(TestRemapFixture, RMW_IMPLEMENTATION), wildcard_relative_service_remap) {
+  rcl_ret_t ret;
+  rcl_arguments_t global_arguments;
+  SCOPE_ARGS(global_arguments, "process_name", "rosservice://*/set:=\\1/put");
+
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  char * output = NULL;
+  ret = rcl_remap_service_name(
+    NULL, &global_arguments, "/ns/param/set", "NodeName", "/ns", allocator, &output);
+  EXPECT_EQ(RCL_RET_OK, ret);
+  EXPECT_STREQ("/ns/param/put", output);
+  allocator.deallocate(output, allocator.state);
+
+  ret = rcl_remap_topic_name(
+    NULL, &global_arguments, "/ns/param/set", "NodeName", "/ns", allocator, &output);
+  EXPECT_EQ(RCL_RET_OK, ret);
+  EXPECT_EQ(NULL, output);
+}
@@ -14,6 +14,9 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <vector>
+
 #include "rcl/rcl.h"
 #include "rcl/remap.h"
 #include "rcl/error_handling.h"
@@ -42,6 +45,44 @@ public:
   }
 };
 
+/// Get the topic name of a publisher, remapped by the node's remap table.
+static std::string
+get_remapped_topic_name(rcl_node_t * node, const char * topic_name)
+{
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Primitives);
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  rcl_ret_t ret = rcl_publisher_init(&publisher, node, ts, topic_name, &publisher_options);
+  if (RCL_RET_OK != ret) {
+    ADD_FAILURE() << "publisher init failed: " << rcl_get_error_string().str;
+    rcl_reset_error();
+    return "";
+  }
+  std::string remapped_name = rcl_publisher_get_topic_name(&publisher);
+  EXPECT_EQ(RCL_RET_OK, rcl_publisher_fini(&publisher, node)) << rcl_get_error_string().str;
+  return remapped_name;
+}
+
+/// Get the service name of a client, remapped by the node's remap table.
+static std::string
+get_remapped_service_name(rcl_node_t * node, const char * service_name)
+{
+  const rosidl_service_type_support_t * ts = ROSIDL_GET_SRV_TYPE_SUPPORT(
+    test_msgs, srv, Primitives);
+  rcl_client_options_t client_options = rcl_client_get_default_options();
+  rcl_client_t client = rcl_get_zero_initialized_client();
+  rcl_ret_t ret = rcl_client_init(&client, node, ts, service_name, &client_options);
+  if (RCL_RET_OK != ret) {
+    ADD_FAILURE() << "client init failed: " << rcl_get_error_string().str;
+    rcl_reset_error();
+    return "";
+  }
+  std::string remapped_name = rcl_client_get_service_name(&client);
+  EXPECT_EQ(RCL_RET_OK, rcl_client_fini(&client, node)) << rcl_get_error_string().str;
+  return remapped_name;
+}
+
 TEST_F(CLASSNAME(TestRemapIntegrationFixture, RMW_IMPLEMENTATION), remap_using_global_rule) {
   int argc;
   char ** argv;
@@ -314,3 +355,171 @@ TEST_F(CLASSNAME(TestRemapIntegrationFixture, RMW_IMPLEMENTATION), remap_using_n
   }
   EXPECT_EQ(RCL_RET_OK, rcl_node_fini(&node));
 }
+
+/* Tests that the remap table of a node tries the node's rules before the global ones.
+ */
+TEST_F(CLASSNAME(TestRemapIntegrationFixture, RMW_IMPLEMENTATION), table_local_before_global) {
+  int argc;
+  char ** argv;
+  SCOPE_GLOBAL_ARGS(
+    argc, argv, "process_name", "/foo:=/global_foo", "/bar:=/global_bar",
+    "rosservice:///baz:=/global_baz", "/qux/quux:=/global_quux");
+  rcl_arguments_t local_arguments;
+  SCOPE_ARGS(
+    local_arguments, "process_name", "/foo:=/local_foo", "rosservice:///baz:=/local_baz",
+    "/qux/*:=/local_qux");
+
+  rcl_node_t node = rcl_get_zero_initialized_node();
+  rcl_node_options_t options = rcl_node_get_default_options();
+  options.arguments = local_arguments;
+  ASSERT_EQ(RCL_RET_OK, rcl_node_init(&node, "original_name", "/", &context, &options));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_node_fini(&node)) << rcl_get_error_string().str;
+  });
+
+  EXPECT_EQ("/local_foo", get_remapped_topic_name(&node, "/foo"));
+  EXPECT_EQ("/local_foo", get_remapped_service_name(&node, "/foo"));
+  // Global rules still apply to names no local rule matches.
+  EXPECT_EQ("/global_bar", get_remapped_topic_name(&node, "/bar"));
+  EXPECT_EQ("/local_baz", get_remapped_service_name(&node, "/baz"));
+  EXPECT_EQ("/baz", get_remapped_topic_name(&node, "/baz"));
+  // A local rule with wildcards beats a global rule without.
+  EXPECT_EQ("/local_qux", get_remapped_topic_name(&node, "/qux/quux"));
+
+  rcl_node_t isolated_node = rcl_get_zero_initialized_node();
+  options.use_global_arguments = false;
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_node_init(&isolated_node, "isolated_name", "/", &context, &options));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_node_fini(&isolated_node)) << rcl_get_error_string().str;
+  });
+  EXPECT_EQ("/local_foo", get_remapped_topic_name(&isolated_node, "/foo"));
+  EXPECT_EQ("/bar", get_remapped_topic_name(&isolated_node, "/bar"));
+}
+
+/* Tests that the remap table of a node uses the first rule matching a name.
+ */
+TEST_F(CLASSNAME(TestRemapIntegrationFixture, RMW_IMPLEMENTATION), table_first_rule_wins) {
+  int argc;
+  char ** argv;
+  SCOPE_GLOBAL_ARGS(
+    argc, argv, "process_name", "/foo:=/first", "/foo:=/second",
+    "/a/*:=/pattern", "/a/b:=/exact", "/c/d:=/exact", "/c/*:=/pattern",
+    "rosservice:///s:=/service_rule", "/s:=/any_rule",
+    "other_name:/e:=/other_node", "original_name:/e:=/this_node", "/e:=/any_node");
+
+  rcl_node_t node = rcl_get_zero_initialized_node();
+  rcl_node_options_t options = rcl_node_get_default_options();
+  ASSERT_EQ(RCL_RET_OK, rcl_node_init(&node, "original_name", "/", &context, &options));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_node_fini(&node)) << rcl_get_error_string().str;
+  });
+
+  EXPECT_EQ("/first", get_remapped_topic_name(&node, "/foo"));
+  EXPECT_EQ("/first", get_remapped_service_name(&node, "/foo"));
+  // Whether the first rule has wildcards or not.
+  EXPECT_EQ("/pattern", get_remapped_topic_name(&node, "/a/b"));
+  EXPECT_EQ("/exact", get_remapped_topic_name(&node, "/c/d"));
+  EXPECT_EQ("/pattern", get_remapped_topic_name(&node, "/c/e"));
+  // Rules for one kind of name do not hide later rules for the other.
+  EXPECT_EQ("/service_rule", get_remapped_service_name(&node, "/s"));
+  EXPECT_EQ("/any_rule", get_remapped_topic_name(&node, "/s"));
+  // Rules for other nodes are skipped.
+  EXPECT_EQ("/this_node", get_remapped_topic_name(&node, "/e"));
+}
+
+/* Tests that the remap table of a node remaps names like searching the rules in order does.
+ */
+TEST_F(CLASSNAME(TestRemapIntegrationFixture, RMW_IMPLEMENTATION), table_matches_linear_remap) {
+  int argc;
+  char ** argv;
+  SCOPE_GLOBAL_ARGS(
+    argc, argv, "process_name", "/foo/*/baz:=/bar/\\1", "/deep/**:=/shallow/\\1",
+    "/foo/exact:=/literal", "/foo/*:=/single", "/**/tail:=/tails/\\1", "/*/*/mid:=/\\2/\\1",
+    "rosservice://*/set:=\\1/put", "rostopic://ns/**:=/topics/\\1", "/ns/plain:=/plain");
+  rcl_arguments_t local_arguments;
+  SCOPE_ARGS(
+    local_arguments, "process_name", "/deep/local/**:=/local/\\1", "/foo/local:=/local",
+    "original_name:/ns/*:=/this_node/\\1", "other_name:/ns/**:=/other_node");
+
+  rcl_node_t node = rcl_get_zero_initialized_node();
+  rcl_node_options_t options = rcl_node_get_default_options();
+  options.arguments = local_arguments;
+  ASSERT_EQ(RCL_RET_OK, rcl_node_init(&node, "original_name", "/ns", &context, &options));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_node_fini(&node)) << rcl_get_error_string().str;
+  });
+
+  const char * names[] = {
+    "/foo/qux/baz", "/foo/qux/baz/more", "/deep", "/deep/a/b/c", "/deep/local",
+    "/deep/local/a/b", "/foo/exact", "/foo/local", "/foo/other", "/foo/other/name",
+    "/tail", "/a/b/tail", "/tail/not", "/a/b/mid", "/a/mid", "/ns/param/set", "/set",
+    "/ns/plain", "/ns/a/b", "/ns/a", "/unmatched",
+  };
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  for (const char * name : names) {
+    char * output = NULL;
+    ASSERT_EQ(
+      RCL_RET_OK, rcl_remap_topic_name(
+        &local_arguments, &(context.global_arguments), name, "original_name", "/ns",
+        allocator, &output)) << rcl_get_error_string().str;
+    std::string expected = NULL == output ? name : output;
+    allocator.deallocate(output, allocator.state);
+    EXPECT_EQ(expected, get_remapped_topic_name(&node, name)) << "topic " << name;
+
+    output = NULL;
+    ASSERT_EQ(
+      RCL_RET_OK, rcl_remap_service_name(
+        &local_arguments, &(context.global_arguments), name, "original_name", "/ns",
+        allocator, &output)) << rcl_get_error_string().str;
+    expected = NULL == output ? name : output;
+    allocator.deallocate(output, allocator.state);
+    EXPECT_EQ(expected, get_remapped_service_name(&node, name)) << "service " << name;
+  }
+}
+
+/* Tests remapping through a table whose automaton has many states.
+ */
+TEST_F(CLASSNAME(TestRemapIntegrationFixture, RMW_IMPLEMENTATION), table_with_many_patterns) {
+  int argc;
+  char ** argv;
+  SCOPE_GLOBAL_ARGS(argc, argv, "process_name");
+  // Each rule adds three states, far more than fit in a fixed size set.
+  std::vector<std::string> rules;
+  for (int i = 0; i < 100; ++i) {
+    std::string index = std::to_string(i);
+    rules.push_back("/p" + index + "/*/x" + index + ":=/r" + index + "/\\1");
+  }
+  rules.push_back("/p7/exact/x7:=/exact");
+  rules.push_back("/deep/**:=/shallow/\\1");
+  std::vector<const char *> local_argv = {"process_name"};
+  for (const std::string & rule : rules) {
+    local_argv.push_back(rule.c_str());
+  }
+  rcl_arguments_t local_arguments = rcl_get_zero_initialized_arguments();
+  ASSERT_EQ(
+    RCL_RET_OK, rcl_parse_arguments(
+      static_cast<int>(local_argv.size()), local_argv.data(), rcl_get_default_allocator(),
+      &local_arguments)) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_arguments_fini(&local_arguments)) << rcl_get_error_string().str;
+  });
+
+  rcl_node_t node = rcl_get_zero_initialized_node();
+  rcl_node_options_t options = rcl_node_get_default_options();
+  options.arguments = local_arguments;
+  ASSERT_EQ(RCL_RET_OK, rcl_node_init(&node, "original_name", "/", &context, &options));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_node_fini(&node)) << rcl_get_error_string().str;
+  });
+
+  EXPECT_EQ("/r0/a", get_remapped_topic_name(&node, "/p0/a/x0"));
+  EXPECT_EQ("/r99/b", get_remapped_topic_name(&node, "/p99/b/x99"));
+  EXPECT_EQ("/r42/c", get_remapped_service_name(&node, "/p42/c/x42"));
+  // The earlier rule with a wildcard wins over the later exact one.
+  EXPECT_EQ("/r7/exact", get_remapped_topic_name(&node, "/p7/exact/x7"));
+  EXPECT_EQ("/shallow/a/b", get_remapped_topic_name(&node, "/deep/a/b"));
+  EXPECT_EQ("/p1/a/x2", get_remapped_topic_name(&node, "/p1/a/x2"));
+  EXPECT_EQ("/p1/x1", get_remapped_topic_name(&node, "/p1/x1"));
+  EXPECT_EQ("/p100/a/x100", get_remapped_topic_name(&node, "/p100/a/x100"));
+}
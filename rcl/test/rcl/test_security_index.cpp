@@ -0,0 +1,196 @@
+// Copyright 2018 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <string>
+#include <vector>
+
+#include "../../src/rcl/security_index.h"
+#include "../../src/rcl/security_index.c"
+
+#include "rcl/error_handling.h"
+
+#ifdef RMW_IMPLEMENTATION
+# define CLASSNAME_(NAME, SUFFIX) NAME ## __ ## SUFFIX
+# define CLASSNAME(NAME, SUFFIX) CLASSNAME_(NAME, SUFFIX)
+#else
+# define CLASSNAME(NAME, SUFFIX) NAME
+#endif
+
+#define TEST_KEYSTORE "test_security_index_keystore"
+
+static bool
+make_directory(const std::string & path)
+{
+#if defined(_WIN32)
+  return 0 == _mkdir(path.c_str());
+#else
+  return 0 == mkdir(path.c_str(), 0700);
+#endif
+}
+
+static void
+remove_directory(const std::string & path)
+{
+#if defined(_WIN32)
+  _rmdir(path.c_str());
+#else
+  rmdir(path.c_str());
+#endif
+}
+
+/// Join paths the way the index does, with the separator of the platform.
+static std::string
+join_path(const std::string & directory, const char * entry)
+{
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  char * path = rcutils_join_path(directory.c_str(), entry, allocator);
+  std::string joined(path);
+  allocator.deallocate(path, allocator.state);
+  return joined;
+}
+
+/// Set an environment variable, an empty value unsets it.
+static void
+set_env(const char * name, const char * value)
+{
+#if defined(_WIN32)
+  _putenv_s(name, value);
+#else
+  if ('\0' == value[0]) {
+    unsetenv(name);
+  } else {
+    setenv(name, value, 1);
+  }
+#endif
+}
+
+class CLASSNAME (TestSecurityIndexFixture, RMW_IMPLEMENTATION) : public ::testing::Test
+{
+public:
+  rcl_security_index_t index;
+  // Every directory of the keystore, parents before children.
+  std::vector<std::string> directories;
+
+  void SetUp()
+  {
+    index = rcl_get_zero_initialized_security_index();
+    directories = {
+      TEST_KEYSTORE,
+      join_path(TEST_KEYSTORE, "talker"),
+      join_path(TEST_KEYSTORE, "talk"),
+      join_path(TEST_KEYSTORE, "a"),
+      join_path(join_path(TEST_KEYSTORE, "a"), "b"),
+    };
+    // Left over by an interrupted run.
+    TearDownKeystore();
+    for (const std::string & directory : directories) {
+      ASSERT_TRUE(make_directory(directory)) << directory;
+    }
+    set_env(ROS_SECURITY_NODE_DIRECTORY_VAR_NAME, "");
+    set_env(ROS_SECURITY_ROOT_DIRECTORY_VAR_NAME, TEST_KEYSTORE);
+  }
+
+  void TearDown()
+  {
+    rcl_security_index_fini(&index);
+    set_env(ROS_SECURITY_NODE_DIRECTORY_VAR_NAME, "");
+    set_env(ROS_SECURITY_ROOT_DIRECTORY_VAR_NAME, "");
+    TearDownKeystore();
+  }
+
+  void TearDownKeystore()
+  {
+    for (auto it = directories.rbegin(); it != directories.rend(); ++it) {
+      remove_directory(*it);
+    }
+  }
+};
+
+/* Tests that a node finds the directory named after it in the secure root directory.
+ */
+TEST_F(CLASSNAME(TestSecurityIndexFixture, RMW_IMPLEMENTATION), test_exact_match) {
+  ASSERT_EQ(RCL_RET_OK, rcl_security_index_init(&index, rcl_get_default_allocator())) <<
+    rcl_get_error_string().str;
+  EXPECT_FALSE(index.has_node_directory);
+  const char * directory = rcl_security_index_find(&index, "talker", "/");
+  ASSERT_NE(nullptr, directory);
+  EXPECT_EQ(directories[1], directory);
+  directory = rcl_security_index_find(&index, "talk", "/");
+  ASSERT_NE(nullptr, directory);
+  EXPECT_EQ(directories[2], directory);
+  directory = rcl_security_index_find(&index, "b", "/a");
+  ASSERT_NE(nullptr, directory);
+  EXPECT_EQ(directories[4], directory);
+  // A namespace directory is a node directory too.
+  directory = rcl_security_index_find(&index, "a", "/");
+  ASSERT_NE(nullptr, directory);
+  EXPECT_EQ(directories[3], directory);
+}
+
+/* Tests that only the full name of a node matches, not a prefix of it or a name it prefixes.
+ */
+TEST_F(CLASSNAME(TestSecurityIndexFixture, RMW_IMPLEMENTATION), test_prefix_does_not_match) {
+  ASSERT_EQ(RCL_RET_OK, rcl_security_index_init(&index, rcl_get_default_allocator())) <<
+    rcl_get_error_string().str;
+  EXPECT_EQ(nullptr, rcl_security_index_find(&index, "tal", "/"));
+  EXPECT_EQ(nullptr, rcl_security_index_find(&index, "talkers", "/"));
+  EXPECT_EQ(nullptr, rcl_security_index_find(&index, "talker", "/a"));
+  EXPECT_EQ(nullptr, rcl_security_index_find(&index, "b", "/"));
+  EXPECT_EQ(nullptr, rcl_security_index_find(&index, "c", "/a/b"));
+  EXPECT_EQ(nullptr, rcl_security_index_find(&index, "ab", "/"));
+}
+
+/* Tests that a missing secure root directory indexes no node, without failing.
+ */
+TEST_F(CLASSNAME(TestSecurityIndexFixture, RMW_IMPLEMENTATION), test_missing_root_directory) {
+  set_env(ROS_SECURITY_ROOT_DIRECTORY_VAR_NAME, join_path(TEST_KEYSTORE, "missing").c_str());
+  ASSERT_EQ(RCL_RET_OK, rcl_security_index_init(&index, rcl_get_default_allocator())) <<
+    rcl_get_error_string().str;
+  EXPECT_EQ(0u, index.count);
+  EXPECT_EQ(nullptr, rcl_security_index_find(&index, "talker", "/"));
+}
+
+/* Tests that the node directory is used for every node, and for none if it is missing.
+ */
+TEST_F(CLASSNAME(TestSecurityIndexFixture, RMW_IMPLEMENTATION), test_node_directory) {
+  set_env(ROS_SECURITY_NODE_DIRECTORY_VAR_NAME, directories[4].c_str());
+  ASSERT_EQ(RCL_RET_OK, rcl_security_index_init(&index, rcl_get_default_allocator())) <<
+    rcl_get_error_string().str;
+  EXPECT_TRUE(index.has_node_directory);
+  const char * directory = rcl_security_index_find(&index, "talker", "/");
+  ASSERT_NE(nullptr, directory);
+  EXPECT_EQ(directories[4], directory);
+  directory = rcl_security_index_find(&index, "c", "/d");
+  ASSERT_NE(nullptr, directory);
+  EXPECT_EQ(directories[4], directory);
+  rcl_security_index_fini(&index);
+
+  set_env(ROS_SECURITY_NODE_DIRECTORY_VAR_NAME, join_path(TEST_KEYSTORE, "missing").c_str());
+  ASSERT_EQ(RCL_RET_OK, rcl_security_index_init(&index, rcl_get_default_allocator())) <<
+    rcl_get_error_string().str;
+  // The secure root directory is not used as a fallback.
+  EXPECT_TRUE(index.has_node_directory);
+  EXPECT_EQ(nullptr, rcl_security_index_find(&index, "talker", "/"));
+}
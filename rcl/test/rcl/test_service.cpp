@@ -14,9 +14,11 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <chrono>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "rcl/service.h"
 
@@ -212,4 +214,452 @@ TEST_F(CLASSNAME(TestServiceFixture, RMW_IMPLEMENTATION), test_service_nominal)
   ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
   EXPECT_EQ(client_response.uint64_value, 3ULL);
   EXPECT_EQ(header.sequence_number, 1);
+
+  rcl_entity_statistics_t statistics;
+  ret = rcl_client_get_statistics(&client, nullptr);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, ret);
+  rcl_reset_error();
+  if (!rcl_entity_statistics_is_available()) {
+    ret = rcl_service_get_statistics(&service, &statistics);
+    EXPECT_EQ(RCL_RET_ERROR, ret);
+    rcl_reset_error();
+    return;
+  }
+  // Both ends should have counted exactly one message.
+  ret = rcl_service_get_statistics(&service, &statistics);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(1u, statistics.message_count);
+  EXPECT_EQ(0, statistics.inter_arrival_max);
+  ret = rcl_client_get_statistics(&client, &statistics);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(1u, statistics.message_count);
+}
+
+/* Take and answer several requests per call with the batch functions.
+ */
+TEST_F(CLASSNAME(TestServiceFixture, RMW_IMPLEMENTATION), test_service_batch) {
+  rcl_ret_t ret;
+  const rosidl_service_type_support_t * ts = ROSIDL_GET_SRV_TYPE_SUPPORT(
+    test_msgs, srv, Primitives);
+  const char * topic = "primitives_batch";
+
+  rcl_service_t service = rcl_get_zero_initialized_service();
+  rcl_service_options_t service_options = rcl_service_get_default_options();
+  ret = rcl_service_init(&service, this->node_ptr, ts, topic, &service_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    rcl_ret_t ret = rcl_service_fini(&service, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_client_t client = rcl_get_zero_initialized_client();
+  rcl_client_options_t client_options = rcl_client_get_default_options();
+  ret = rcl_client_init(&client, this->node_ptr, ts, topic, &client_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    rcl_ret_t ret = rcl_client_fini(&client, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  // TODO(wjwwood): replace with count_services busy wait, see test_service_nominal
+  std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+
+  const size_t number_of_requests = 8;
+  test_msgs__srv__Primitives_Request client_request;
+  test_msgs__srv__Primitives_Request__init(&client_request);
+  for (size_t i = 0; i < number_of_requests; ++i) {
+    client_request.uint32_value = static_cast<uint32_t>(i);
+    int64_t sequence_number;
+    ret = rcl_send_request(&client, &client_request, &sequence_number);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  test_msgs__srv__Primitives_Request__fini(&client_request);
+
+  // Take with a larger capacity than needed, the requests may arrive over several waits.
+  const size_t capacity = 2 * number_of_requests;
+  std::vector<test_msgs__srv__Primitives_Request> requests(capacity);
+  std::vector<test_msgs__srv__Primitives_Response> responses(capacity);
+  std::vector<void *> request_ptrs;
+  std::vector<void *> response_ptrs;
+  for (size_t i = 0; i < capacity; ++i) {
+    test_msgs__srv__Primitives_Request__init(&requests[i]);
+    test_msgs__srv__Primitives_Response__init(&responses[i]);
+    request_ptrs.push_back(&requests[i]);
+    response_ptrs.push_back(&responses[i]);
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    for (size_t i = 0; i < capacity; ++i) {
+      test_msgs__srv__Primitives_Request__fini(&requests[i]);
+      test_msgs__srv__Primitives_Response__fini(&responses[i]);
+    }
+  });
+  std::vector<rmw_request_id_t> headers(capacity);
+  size_t total_taken = 0;
+  for (size_t tries = 0; tries < 10 && total_taken < number_of_requests; ++tries) {
+    bool success;
+    wait_for_service_to_be_ready(&service, 10, 100, success);
+    ASSERT_TRUE(success);
+    size_t taken_count = 0;
+    ret = rcl_take_request_batch(
+      &service, &headers[total_taken], &request_ptrs[total_taken], capacity - total_taken,
+      &taken_count);
+    if (RCL_RET_SERVICE_TAKE_FAILED == ret) {
+      continue;
+    }
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    total_taken += taken_count;
+  }
+  ASSERT_EQ(number_of_requests, total_taken);
+  for (size_t i = 0; i < total_taken; ++i) {
+    responses[i].uint64_value = requests[i].uint32_value + 1;
+  }
+  size_t sent_count = 0;
+  ret = rcl_send_response_batch(
+    &service, headers.data(), response_ptrs.data(), total_taken, &sent_count);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(total_taken, sent_count);
+
+  // Every response carries its request's value plus one.
+  std::vector<bool> answered(number_of_requests, false);
+  test_msgs__srv__Primitives_Response client_response;
+  test_msgs__srv__Primitives_Response__init(&client_response);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    test_msgs__srv__Primitives_Response__fini(&client_response);
+  });
+  size_t received = 0;
+  for (size_t tries = 0; tries < 100 && received < number_of_requests; ++tries) {
+    rmw_request_id_t header;
+    ret = rcl_take_response(&client, &header, &client_response);
+    if (RCL_RET_CLIENT_TAKE_FAILED == ret) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      continue;
+    }
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ASSERT_GE(client_response.uint64_value, 1u);
+    ASSERT_LE(client_response.uint64_value, number_of_requests);
+    answered[client_response.uint64_value - 1] = true;
+    ++received;
+  }
+  EXPECT_EQ(number_of_requests, received);
+  for (size_t i = 0; i < number_of_requests; ++i) {
+    EXPECT_TRUE(answered[i]) << "no response to request " << i;
+  }
+
+  ret = rcl_take_request_batch(&service, headers.data(), request_ptrs.data(), capacity, nullptr);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, ret);
+  rcl_reset_error();
+}
+
+/* Drain a deep queue of requests in batches, every request is taken and answered once.
+ *
+ * The timing of the batch path is reported by benchmark_service_batch instead.
+ */
+TEST_F(CLASSNAME(TestServiceFixture, RMW_IMPLEMENTATION), test_service_batch_drain) {
+  rcl_ret_t ret;
+  const rosidl_service_type_support_t * ts = ROSIDL_GET_SRV_TYPE_SUPPORT(
+    test_msgs, srv, Primitives);
+  const char * topic = "primitives_batch_drain";
+
+  rcl_service_t service = rcl_get_zero_initialized_service();
+  rcl_service_options_t service_options = rcl_service_get_default_options();
+  service_options.qos.depth = 1000;
+  ret = rcl_service_init(&service, this->node_ptr, ts, topic, &service_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    rcl_ret_t ret = rcl_service_fini(&service, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_client_t client = rcl_get_zero_initialized_client();
+  rcl_client_options_t client_options = rcl_client_get_default_options();
+  client_options.qos.depth = 1000;
+  ret = rcl_client_init(&client, this->node_ptr, ts, topic, &client_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    rcl_ret_t ret = rcl_client_fini(&client, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+
+  const size_t number_of_requests = 200;
+  const size_t batch_size = 32;
+  test_msgs__srv__Primitives_Request client_request;
+  test_msgs__srv__Primitives_Request__init(&client_request);
+  std::vector<int64_t> sent_sequence_numbers;
+  for (size_t i = 0; i < number_of_requests; ++i) {
+    int64_t sequence_number;
+    ret = rcl_send_request(&client, &client_request, &sequence_number);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    sent_sequence_numbers.push_back(sequence_number);
+  }
+  test_msgs__srv__Primitives_Request__fini(&client_request);
+  std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+
+  std::vector<test_msgs__srv__Primitives_Request> requests(batch_size);
+  std::vector<test_msgs__srv__Primitives_Response> responses(batch_size);
+  std::vector<void *> request_ptrs;
+  std::vector<void *> response_ptrs;
+  for (size_t i = 0; i < batch_size; ++i) {
+    test_msgs__srv__Primitives_Request__init(&requests[i]);
+    test_msgs__srv__Primitives_Response__init(&responses[i]);
+    request_ptrs.push_back(&requests[i]);
+    response_ptrs.push_back(&responses[i]);
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    for (size_t i = 0; i < batch_size; ++i) {
+      test_msgs__srv__Primitives_Request__fini(&requests[i]);
+      test_msgs__srv__Primitives_Response__fini(&responses[i]);
+    }
+  });
+  std::vector<rmw_request_id_t> headers(batch_size);
+  std::vector<int64_t> taken_sequence_numbers;
+  while (true) {
+    size_t taken_count = 0;
+    ret = rcl_take_request_batch(
+      &service, headers.data(), request_ptrs.data(), batch_size, &taken_count);
+    if (RCL_RET_SERVICE_TAKE_FAILED == ret) {
+      EXPECT_EQ(0u, taken_count);
+      break;
+    }
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ASSERT_GT(taken_count, 0u);
+    ASSERT_LE(taken_count, batch_size);
+    for (size_t i = 0; i < taken_count; ++i) {
+      taken_sequence_numbers.push_back(headers[i].sequence_number);
+    }
+    size_t sent_count = 0;
+    ret = rcl_send_response_batch(
+      &service, headers.data(), response_ptrs.data(), taken_count, &sent_count);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_EQ(taken_count, sent_count);
+  }
+  std::sort(taken_sequence_numbers.begin(), taken_sequence_numbers.end());
+  std::sort(sent_sequence_numbers.begin(), sent_sequence_numbers.end());
+  EXPECT_EQ(sent_sequence_numbers, taken_sequence_numbers);
+}
+
+/* Identical requests in flight are sent once and the response fans out to all of them.
+ */
+TEST_F(CLASSNAME(TestServiceFixture, RMW_IMPLEMENTATION), test_service_coalesced_requests) {
+  rcl_ret_t ret;
+  const rosidl_service_type_support_t * ts = ROSIDL_GET_SRV_TYPE_SUPPORT(
+    test_msgs, srv, Primitives);
+  const char * topic = "primitives_coalesced";
+
+  rcl_service_t service = rcl_get_zero_initialized_service();
+  rcl_service_options_t service_options = rcl_service_get_default_options();
+  ret = rcl_service_init(&service, this->node_ptr, ts, topic, &service_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    rcl_ret_t ret = rcl_service_fini(&service, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+
+  rcl_client_t client = rcl_get_zero_initialized_client();
+  rcl_client_options_t client_options = rcl_client_get_default_options();
+  client_options.coalescing_type_support = ROSIDL_GET_MSG_TYPE_SUPPORT(
+    test_msgs, srv, Primitives_Request);
+  ret = rcl_client_init(&client, this->node_ptr, ts, topic, &client_options);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, ret) << "coalescing needs a pending_request_capacity";
+  rcl_reset_error();
+  client_options.pending_request_capacity = 4;
+  ret = rcl_client_init(&client, this->node_ptr, ts, topic, &client_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    rcl_ret_t ret = rcl_client_fini(&client, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  // TODO(wjwwood): replace with count_services busy wait, see test_service_nominal
+  std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+
+  // Three identical requests and a different one.
+  int waiters[4] = {0, 1, 2, 3};
+  int64_t sequence_numbers[4];
+  test_msgs__srv__Primitives_Request client_request;
+  test_msgs__srv__Primitives_Request__init(&client_request);
+  client_request.uint32_value = 7;
+  for (size_t i = 0; i < 3; ++i) {
+    ret = rcl_send_request_with_timeout(
+      &client, &client_request, -1, &waiters[i], &sequence_numbers[i]);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  client_request.uint32_value = 8;
+  ret = rcl_send_request_with_timeout(
+    &client, &client_request, -1, &waiters[3], &sequence_numbers[3]);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  test_msgs__srv__Primitives_Request__fini(&client_request);
+  EXPECT_EQ(sequence_numbers[0], sequence_numbers[1]);
+  EXPECT_EQ(sequence_numbers[0], sequence_numbers[2]);
+  EXPECT_NE(sequence_numbers[0], sequence_numbers[3]);
+  size_t count = 0;
+  ret = rcl_client_get_pending_request_count(&client, &count);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(2u, count);
+
+  // The service only sees the two distinct requests.
+  {
+    test_msgs__srv__Primitives_Request service_request;
+    test_msgs__srv__Primitives_Request__init(&service_request);
+    test_msgs__srv__Primitives_Response service_response;
+    test_msgs__srv__Primitives_Response__init(&service_response);
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+      test_msgs__srv__Primitives_Request__fini(&service_request);
+      test_msgs__srv__Primitives_Response__fini(&service_response);
+    });
+    size_t served = 0;
+    for (size_t tries = 0; tries < 10 && served < 2; ++tries) {
+      bool success;
+      wait_for_service_to_be_ready(&service, 10, 100, success);
+      ASSERT_TRUE(success);
+      rmw_request_id_t header;
+      while (RCL_RET_OK == rcl_take_request(&service, &header, &service_request)) {
+        service_response.uint64_value = service_request.uint32_value;
+        ret = rcl_send_response(&service, &header, &service_response);
+        ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+        ++served;
+      }
+      rcl_reset_error();
+    }
+    EXPECT_EQ(2u, served);
+  }
+
+  // Each response reaches the request that was sent and the ones coalesced with it.
+  std::vector<int> answered;
+  test_msgs__srv__Primitives_Response client_response;
+  test_msgs__srv__Primitives_Response__init(&client_response);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    test_msgs__srv__Primitives_Response__fini(&client_response);
+  });
+  size_t responses = 0;
+  for (size_t tries = 0; tries < 100 && responses < 2; ++tries) {
+    rmw_request_id_t header;
+    void * user_data = nullptr;
+    ret = rcl_take_response_with_user_data(&client, &header, &client_response, &user_data);
+    if (RCL_RET_CLIENT_TAKE_FAILED == ret) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      continue;
+    }
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    ++responses;
+    uint64_t expected_value = header.sequence_number == sequence_numbers[0] ? 7u : 8u;
+    EXPECT_EQ(expected_value, client_response.uint64_value);
+    do {
+      answered.push_back(*static_cast<int *>(user_data));
+    } while (RCL_RET_OK ==
+      rcl_client_take_coalesced_waiter(&client, header.sequence_number, &user_data));
+  }
+  EXPECT_EQ(2u, responses);
+  std::sort(answered.begin(), answered.end());
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3}), answered);
+}
+
+/* The requests coalesced with a completed request are kept until they are taken, also
+ * while other responses are taken, and a completed request is not attached to anymore.
+ */
+TEST_F(CLASSNAME(TestServiceFixture, RMW_IMPLEMENTATION), test_service_coalesced_fan_out_kept) {
+  rcl_ret_t ret;
+  const rosidl_service_type_support_t * ts = ROSIDL_GET_SRV_TYPE_SUPPORT(
+    test_msgs, srv, Primitives);
+  const char * topic = "primitives_coalesced_kept";
+
+  rcl_service_t service = rcl_get_zero_initialized_service();
+  rcl_service_options_t service_options = rcl_service_get_default_options();
+  ret = rcl_service_init(&service, this->node_ptr, ts, topic, &service_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    rcl_ret_t ret = rcl_service_fini(&service, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_client_t client = rcl_get_zero_initialized_client();
+  rcl_client_options_t client_options = rcl_client_get_default_options();
+  client_options.pending_request_capacity = 4;
+  client_options.coalescing_type_support = ROSIDL_GET_MSG_TYPE_SUPPORT(
+    test_msgs, srv, Primitives_Request);
+  ret = rcl_client_init(&client, this->node_ptr, ts, topic, &client_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    rcl_ret_t ret = rcl_client_fini(&client, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  // TODO(wjwwood): replace with count_services busy wait, see test_service_nominal
+  std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+
+  // Two pairs of identical requests.
+  int waiters[4] = {0, 1, 2, 3};
+  int64_t sequence_numbers[4];
+  test_msgs__srv__Primitives_Request client_request;
+  test_msgs__srv__Primitives_Request__init(&client_request);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    test_msgs__srv__Primitives_Request__fini(&client_request);
+  });
+  for (size_t i = 0; i < 4; ++i) {
+    client_request.uint32_value = i < 2 ? 7 : 8;
+    ret = rcl_send_request_with_timeout(
+      &client, &client_request, -1, &waiters[i], &sequence_numbers[i]);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  EXPECT_EQ(sequence_numbers[0], sequence_numbers[1]);
+  EXPECT_EQ(sequence_numbers[2], sequence_numbers[3]);
+
+  {
+    test_msgs__srv__Primitives_Request service_request;
+    test_msgs__srv__Primitives_Request__init(&service_request);
+    test_msgs__srv__Primitives_Response service_response;
+    test_msgs__srv__Primitives_Response__init(&service_response);
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+      test_msgs__srv__Primitives_Request__fini(&service_request);
+      test_msgs__srv__Primitives_Response__fini(&service_response);
+    });
+    size_t served = 0;
+    for (size_t tries = 0; tries < 10 && served < 2; ++tries) {
+      bool success;
+      wait_for_service_to_be_ready(&service, 10, 100, success);
+      ASSERT_TRUE(success);
+      rmw_request_id_t header;
+      while (RCL_RET_OK == rcl_take_request(&service, &header, &service_request)) {
+        service_response.uint64_value = service_request.uint32_value;
+        ret = rcl_send_response(&service, &header, &service_response);
+        ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+        ++served;
+      }
+      rcl_reset_error();
+    }
+    EXPECT_EQ(2u, served);
+  }
+
+  // Take both responses before any of the coalesced requests.
+  test_msgs__srv__Primitives_Response client_response;
+  test_msgs__srv__Primitives_Response__init(&client_response);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    test_msgs__srv__Primitives_Response__fini(&client_response);
+  });
+  std::vector<int64_t> completed;
+  for (size_t tries = 0; tries < 100 && completed.size() < 2; ++tries) {
+    rmw_request_id_t header;
+    void * user_data = nullptr;
+    ret = rcl_take_response_with_user_data(&client, &header, &client_response, &user_data);
+    if (RCL_RET_CLIENT_TAKE_FAILED == ret) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      continue;
+    }
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_EQ(header.sequence_number == sequence_numbers[0] ? &waiters[0] : &waiters[2], user_data);
+    completed.push_back(header.sequence_number);
+  }
+  ASSERT_EQ(2u, completed.size());
+
+  // A request identical to a completed one is sent again.
+  client_request.uint32_value = 7;
+  int64_t resent_sequence_number;
+  ret = rcl_send_request(&client, &client_request, &resent_sequence_number);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_NE(sequence_numbers[0], resent_sequence_number);
+
+  // The coalesced request of each completed request is still there, exactly once.
+  for (int64_t sequence_number : completed) {
+    void * user_data = nullptr;
+    ret = rcl_client_take_coalesced_waiter(&client, sequence_number, &user_data);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_EQ(sequence_number == sequence_numbers[0] ? &waiters[1] : &waiters[3], user_data);
+    ret = rcl_client_take_coalesced_waiter(&client, sequence_number, &user_data);
+    EXPECT_EQ(RCL_RET_CLIENT_TAKE_FAILED, ret);
+    rcl_reset_error();
+  }
 }
@@ -17,6 +17,7 @@
 #include <chrono>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "rcl/subscription.h"
 
@@ -178,6 +179,75 @@ TEST_F(CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION), test_subscription
     ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
     ASSERT_EQ(42, msg.int64_value);
   }
+  if (rcl_entity_statistics_is_available()) {
+    rcl_entity_statistics_t statistics;
+    ret = rcl_publisher_get_statistics(&publisher, &statistics);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_EQ(1u, statistics.message_count);
+    EXPECT_EQ(0u, statistics.failure_count);
+    ret = rcl_subscription_get_statistics(&subscription, &statistics);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_EQ(1u, statistics.message_count);
+    EXPECT_EQ(0u, statistics.byte_count);
+  }
+}
+
+/* Test that a decimated publisher only delivers every Nth message.
+ */
+TEST_F(CLASSNAME(TestSubscriptionFixture, RMW_IMPLEMENTATION), test_subscription_decimated) {
+  rcl_ret_t ret;
+  rcl_publisher_t publisher = rcl_get_zero_initialized_publisher();
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Primitives);
+  const char * topic = "rcl_test_subscription_decimated_chatter";
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  publisher_options.publish_decimation = 3;
+  ret = rcl_publisher_init(&publisher, this->node_ptr, ts, topic, &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    rcl_ret_t ret = rcl_publisher_fini(&publisher, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+  rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+  ret = rcl_subscription_init(&subscription, this->node_ptr, ts, topic, &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    rcl_ret_t ret = rcl_subscription_fini(&subscription, this->node_ptr);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  });
+  // TODO(wjwwood): add logic to wait for the connection to be established
+  //                probably using the count_subscriptions busy wait mechanism
+  //                until then we will sleep for a short period of time
+  std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+  for (int64_t i = 0; i < 6; ++i) {
+    test_msgs__msg__Primitives msg;
+    test_msgs__msg__Primitives__init(&msg);
+    msg.int64_value = i;
+    ret = rcl_publish(&publisher, &msg);
+    test_msgs__msg__Primitives__fini(&msg);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  }
+  std::vector<int64_t> received;
+  for (size_t attempt = 0; attempt < 10 && received.size() < 2; ++attempt) {
+    bool success;
+    wait_for_subscription_to_be_ready(&subscription, 10, 100, success);
+    ASSERT_TRUE(success);
+    test_msgs__msg__Primitives msg;
+    test_msgs__msg__Primitives__init(&msg);
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+      test_msgs__msg__Primitives__fini(&msg);
+    });
+    ret = rcl_take(&subscription, &msg, nullptr);
+    if (RCL_RET_SUBSCRIPTION_TAKE_FAILED == ret) {
+      continue;
+    }
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    received.push_back(msg.int64_value);
+  }
+  ASSERT_EQ(2u, received.size());
+  EXPECT_EQ(0, received[0]);
+  EXPECT_EQ(3, received[1]);
 }
 
 /* Basic nominal test of a publisher with a string.
@@ -14,11 +14,15 @@
 
 #include <gtest/gtest.h>
 #include <chrono>
+#include <cstdio>
+#include <cstring>
 #include <thread>
 
 #include "rcl/timer.h"
 
+#include "rcl/allocation_audit.h"
 #include "rcl/rcl.h"
+#include "rcl/tracing.h"
 
 #include "osrf_testing_tools_cpp/scope_exit.hpp"
 #include "rcl/error_handling.h"
@@ -493,3 +497,103 @@ TEST_F(TestTimerFixture, test_ros_time_wakes_wait) {
   EXPECT_TRUE(timer_was_ready);
   EXPECT_LT(finish - start, std::chrono::milliseconds(100));
 }
+
+TEST_F(TestTimerFixture, test_timer_call_tracepoint) {
+  rcl_ret_t ret;
+  const char * trace_file = "test_timer_call_tracepoint.rcltrace";
+  if (!rcl_tracing_is_available()) {
+    ret = rcl_tracing_dump(trace_file);
+    EXPECT_EQ(RCL_RET_ERROR, ret);
+    rcl_reset_error();
+    return;
+  }
+  rcl_tracing_set_enabled(true);
+
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  ret = rcl_clock_init(RCL_STEADY_TIME, &clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&clock)) << rcl_get_error_string().str;
+  });
+  rcl_timer_t timer = rcl_get_zero_initialized_timer();
+  ret = rcl_timer_init(
+    &timer, &clock, this->context_ptr, RCL_MS_TO_NS(1), nullptr, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&timer)) << rcl_get_error_string().str;
+  });
+  ret = rcl_timer_call(&timer);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  ret = rcl_tracing_dump(trace_file);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  FILE * file = fopen(trace_file, "rb");
+  ASSERT_NE(nullptr, file);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    fclose(file);
+    std::remove(trace_file);
+  });
+  rcl_trace_file_header_t header;
+  ASSERT_EQ(1u, fread(&header, sizeof(header), 1, file));
+  EXPECT_EQ(0, memcmp(header.magic, RCL_TRACE_FILE_MAGIC, sizeof(header.magic)));
+  EXPECT_EQ(static_cast<uint32_t>(RCL_TRACE_FILE_VERSION), header.version);
+  ASSERT_EQ(sizeof(rcl_trace_event_t), header.event_size);
+  bool found_init = false;
+  bool found_call = false;
+  rcl_trace_event_t event;
+  for (uint64_t i = 0; i < header.event_count; ++i) {
+    ASSERT_EQ(1u, fread(&event, sizeof(event), 1, file));
+    if (event.handle != reinterpret_cast<uint64_t>(&timer)) {
+      continue;
+    }
+    found_init |= RCL_TRACE_TIMER_INIT == event.type;
+    found_call |= RCL_TRACE_TIMER_CALL == event.type;
+  }
+  EXPECT_TRUE(found_init);
+  EXPECT_TRUE(found_call);
+}
+
+TEST_F(TestTimerFixture, test_timer_call_allocation_audit) {
+  rcl_ret_t ret;
+  rcl_allocator_t default_allocator = rcl_get_default_allocator();
+  rcl_allocator_t allocator = rcl_allocation_audit_get_allocator(&default_allocator);
+  rcl_clock_t clock;
+  ret = rcl_clock_init(RCL_STEADY_TIME, &clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&clock)) << rcl_get_error_string().str;
+  });
+  rcl_timer_t timer = rcl_get_zero_initialized_timer();
+  ret = rcl_timer_init(&timer, &clock, this->context_ptr, RCL_MS_TO_NS(1), nullptr, allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&timer)) << rcl_get_error_string().str;
+  });
+  ret = rcl_timer_call(&timer);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  // In steady state calling the timer must not allocate.
+  rcl_allocation_audit_reset_counts();
+  rcl_allocation_audit_enter_real_time_section();
+  ret = rcl_timer_call(&timer);
+  rcl_allocation_audit_exit_real_time_section();
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(0u, rcl_allocation_audit_get_count(RCL_ALLOCATION_AUDIT_TIMER_CALL));
+  EXPECT_EQ(0u, rcl_allocation_audit_get_real_time_count());
+
+  // Allocations inside a real-time section are counted, outside of it they are not.
+  rcl_allocation_audit_enter_real_time_section();
+  void * pointer = allocator.allocate(8, allocator.state);
+  rcl_allocation_audit_exit_real_time_section();
+  ASSERT_NE(nullptr, pointer);
+  allocator.deallocate(pointer, allocator.state);
+  pointer = allocator.allocate(8, allocator.state);
+  ASSERT_NE(nullptr, pointer);
+  allocator.deallocate(pointer, allocator.state);
+  EXPECT_EQ(1u, rcl_allocation_audit_get_real_time_count());
+  EXPECT_EQ(2u, rcl_allocation_audit_get_count(RCL_ALLOCATION_AUDIT_OTHER));
+  EXPECT_STREQ(
+    "rcl_timer_call", rcl_allocation_audit_get_api_name(RCL_ALLOCATION_AUDIT_TIMER_CALL));
+  rcl_allocation_audit_reset_counts();
+}
@@ -154,6 +154,10 @@ TEST(test_validate_topic_name, various_invalid_topics) {
     {"{{bar}_baz}", RCL_TOPIC_NAME_INVALID_SUBSTITUTION_CONTAINS_UNALLOWED_CHARACTERS, 1},
     {"foo/{bar/baz}", RCL_TOPIC_NAME_INVALID_SUBSTITUTION_CONTAINS_UNALLOWED_CHARACTERS, 8},
     {"{1foo}", RCL_TOPIC_NAME_INVALID_SUBSTITUTION_STARTS_WITH_NUMBER, 1},
+    // bytes outside of ASCII, which are negative chars on most platforms
+    {"\xe9" "foo", RCL_TOPIC_NAME_INVALID_CONTAINS_UNALLOWED_CHARACTERS, 0},
+    {"foo/\xe9" "bar", RCL_TOPIC_NAME_INVALID_CONTAINS_UNALLOWED_CHARACTERS, 4},
+    {"{\xe9" "foo}", RCL_TOPIC_NAME_INVALID_SUBSTITUTION_CONTAINS_UNALLOWED_CHARACTERS, 1},
   };
   for (const auto & case_tuple : topic_cases_that_should_fail) {
     std::string topic = case_tuple.topic;
@@ -172,3 +176,74 @@ TEST(test_validate_topic_name, various_invalid_topics) {
     EXPECT_NE(nullptr, rcl_topic_name_validation_result_string(validation_result)) << topic;
   }
 }
+
+TEST(test_validate_topic_name, long_topics) {
+  // Violations before, inside, and after runs of more than 16 token characters
+  const std::string token(40, 'a');
+  struct topic_case
+  {
+    std::string topic;
+    int expected_validation_result;
+    size_t expected_invalid_index;
+  };
+  std::vector<topic_case> topic_cases = {
+    {"/" + token + "/" + token, RCL_TOPIC_NAME_VALID, 0},
+    {"/" + token + "/{" + token + "}", RCL_TOPIC_NAME_VALID, 0},
+    {token + " " + token, RCL_TOPIC_NAME_INVALID_CONTAINS_UNALLOWED_CHARACTERS, 40},
+    {token + "\xc3\xa9", RCL_TOPIC_NAME_INVALID_CONTAINS_UNALLOWED_CHARACTERS, 40},
+    {token + "~" + token, RCL_TOPIC_NAME_INVALID_MISPLACED_TILDE, 40},
+    {token + "/1" + token, RCL_TOPIC_NAME_INVALID_NAME_TOKEN_STARTS_WITH_NUMBER, 41},
+    {"/1" + token + "/{" + token, RCL_TOPIC_NAME_INVALID_UNMATCHED_CURLY_BRACE, 43},
+    {
+      "{" + token + "/" + token + "}",
+      RCL_TOPIC_NAME_INVALID_SUBSTITUTION_CONTAINS_UNALLOWED_CHARACTERS, 41
+    },
+  };
+  for (const auto & topic_case : topic_cases) {
+    int validation_result;
+    size_t invalid_index = 0;
+    rcl_ret_t ret = rcl_validate_topic_name(
+      topic_case.topic.c_str(), &validation_result, &invalid_index);
+    EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_EQ(topic_case.expected_validation_result, validation_result) << topic_case.topic;
+    EXPECT_EQ(topic_case.expected_invalid_index, invalid_index) << topic_case.topic;
+  }
+}
+
+TEST(test_validate_topic_name, batch) {
+  const char * topics[] = {"foo", "foo bar", "/foo/{bar}", "~foo"};
+  int validation_results[4];
+  size_t invalid_indices[4] = {42, 42, 42, 42};
+  rcl_ret_t ret = rcl_validate_topic_names(topics, 4, validation_results, invalid_indices);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_TOPIC_NAME_VALID, validation_results[0]);
+  EXPECT_EQ(42u, invalid_indices[0]);
+  EXPECT_EQ(RCL_TOPIC_NAME_INVALID_CONTAINS_UNALLOWED_CHARACTERS, validation_results[1]);
+  EXPECT_EQ(3u, invalid_indices[1]);
+  EXPECT_EQ(RCL_TOPIC_NAME_VALID, validation_results[2]);
+  EXPECT_EQ(42u, invalid_indices[2]);
+  EXPECT_EQ(RCL_TOPIC_NAME_INVALID_TILDE_NOT_FOLLOWED_BY_FORWARD_SLASH, validation_results[3]);
+  EXPECT_EQ(1u, invalid_indices[3]);
+
+  // invalid indices are optional
+  ret = rcl_validate_topic_names(topics, 4, validation_results, nullptr);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_TOPIC_NAME_INVALID_CONTAINS_UNALLOWED_CHARACTERS, validation_results[1]);
+
+  // nothing to validate
+  ret = rcl_validate_topic_names(nullptr, 0, nullptr, nullptr);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  // invalid arguments
+  ret = rcl_validate_topic_names(nullptr, 4, validation_results, nullptr);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, ret);
+  rcl_reset_error();
+  ret = rcl_validate_topic_names(topics, 4, nullptr, nullptr);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, ret);
+  rcl_reset_error();
+  const char * topics_with_null[] = {"foo", nullptr};
+  ret = rcl_validate_topic_names(topics_with_null, 2, validation_results, nullptr);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, ret);
+  EXPECT_EQ(RCL_TOPIC_NAME_VALID, validation_results[0]);
+  rcl_reset_error();
+}
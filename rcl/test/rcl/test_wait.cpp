@@ -15,7 +15,10 @@
 #include <algorithm>  // for std::max
 #include <atomic>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <future>
+#include <set>
 #include <sstream>
 #include <thread>
 #include <vector>
@@ -29,6 +32,9 @@
 
 #include "rcutils/logging_macros.h"
 
+#include "test_msgs/msg/primitives.h"
+#include "test_msgs/srv/primitives.h"
+
 #ifdef RMW_IMPLEMENTATION
 # define CLASSNAME_(NAME, SUFFIX) NAME ## __ ## SUFFIX
 # define CLASSNAME(NAME, SUFFIX) CLASSNAME_(NAME, SUFFIX)
@@ -38,6 +44,79 @@
 
 #define TOLERANCE RCL_MS_TO_NS(6)
 
+// State of an allocator which fills new memory with a byte and catches frees of foreign memory.
+struct TrackingAllocatorState
+{
+  std::set<void *> live;
+  size_t foreign_frees;
+  unsigned char fill;
+};
+
+static void *
+tracking_allocate(size_t size, void * state)
+{
+  TrackingAllocatorState * tracking = static_cast<TrackingAllocatorState *>(state);
+  void * memory = std::malloc(size);
+  if (memory) {
+    std::memset(memory, tracking->fill, size);
+    tracking->live.insert(memory);
+  }
+  return memory;
+}
+
+static void
+tracking_deallocate(void * pointer, void * state)
+{
+  TrackingAllocatorState * tracking = static_cast<TrackingAllocatorState *>(state);
+  if (!pointer) {
+    return;
+  }
+  if (0 == tracking->live.erase(pointer)) {
+    // Not ours, freeing it would be invalid.
+    ++tracking->foreign_frees;
+    return;
+  }
+  std::free(pointer);
+}
+
+static void *
+tracking_reallocate(void * pointer, size_t size, void * state)
+{
+  TrackingAllocatorState * tracking = static_cast<TrackingAllocatorState *>(state);
+  if (pointer && 0 == tracking->live.erase(pointer)) {
+    ++tracking->foreign_frees;
+    return nullptr;
+  }
+  void * memory = std::realloc(pointer, size);
+  if (memory) {
+    tracking->live.insert(memory);
+  }
+  return memory;
+}
+
+static void *
+tracking_zero_allocate(size_t number_of_elements, size_t size_of_element, void * state)
+{
+  TrackingAllocatorState * tracking = static_cast<TrackingAllocatorState *>(state);
+  void * memory = std::calloc(number_of_elements, size_of_element);
+  if (memory) {
+    tracking->live.insert(memory);
+  }
+  return memory;
+}
+
+static rcl_allocator_t
+get_tracking_allocator(TrackingAllocatorState * state)
+{
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  allocator.allocate = tracking_allocate;
+  allocator.deallocate = tracking_deallocate;
+  allocator.reallocate = tracking_reallocate;
+  allocator.zero_allocate = tracking_zero_allocate;
+  allocator.state = state;
+  return allocator;
+}
+
 class CLASSNAME (WaitSetTestFixture, RMW_IMPLEMENTATION) : public ::testing::Test
 {
 public:
@@ -477,3 +556,302 @@ TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), add_with_index) {
     EXPECT_EQ(&guard_conditions[i], wait_set.guard_conditions[i]);
   }
 }
+
+// Check that wait sets and guard conditions are drawn from the entity pools of their context
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), entity_pools) {
+  rcl_ret_t ret;
+  rcl_init_options_t init_options = rcl_get_zero_initialized_init_options();
+  ret = rcl_init_options_init(&init_options, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_init_options_fini(&init_options)) << rcl_get_error_string().str;
+  });
+  rcl_entity_pool_capacities_t capacities = rcl_entity_pool_capacities_t();
+  capacities.wait_sets = 1;
+  ret = rcl_init_options_set_entity_pool_capacities(&init_options, &capacities);
+  EXPECT_EQ(RCL_RET_INVALID_ARGUMENT, ret);
+  rcl_reset_error();
+  // The graph guard condition of the context takes one of the slots.
+  capacities.guard_conditions = 2;
+  capacities.wait_set_entries = 3;
+  ret = rcl_init_options_set_entity_pool_capacities(&init_options, &capacities);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  rcl_context_t context = rcl_get_zero_initialized_context();
+  ret = rcl_init(0, nullptr, &init_options, &context);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_shutdown(&context)) << rcl_get_error_string().str;
+    EXPECT_EQ(RCL_RET_OK, rcl_context_fini(&context)) << rcl_get_error_string().str;
+  });
+
+  rcl_guard_condition_t guard_conditions[2];
+  guard_conditions[0] = rcl_get_zero_initialized_guard_condition();
+  ret = rcl_guard_condition_init(
+    &guard_conditions[0], &context, rcl_guard_condition_get_default_options());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_guard_condition_fini(&guard_conditions[0]));
+  });
+  guard_conditions[1] = rcl_get_zero_initialized_guard_condition();
+  ret = rcl_guard_condition_init(
+    &guard_conditions[1], &context, rcl_guard_condition_get_default_options());
+  EXPECT_EQ(RCL_RET_ENTITY_POOL_EXHAUSTED, ret);
+  EXPECT_EQ(nullptr, guard_conditions[1].impl);
+  rcl_reset_error();
+
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  ret = rcl_wait_set_init_with_context(
+    &wait_set, 0, 1, 0, 0, 0, &context, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_set)) << rcl_get_error_string().str;
+  });
+  rcl_wait_set_t other_wait_set = rcl_get_zero_initialized_wait_set();
+  ret = rcl_wait_set_init_with_context(
+    &other_wait_set, 0, 1, 0, 0, 0, &context, rcl_get_default_allocator());
+  EXPECT_EQ(RCL_RET_ENTITY_POOL_EXHAUSTED, ret);
+  rcl_reset_error();
+
+  // Resizing within the slot works, beyond it fails and leaves the wait set as it was.
+  ret = rcl_wait_set_resize(&wait_set, 0, 4, 0, 0, 0);
+  EXPECT_EQ(RCL_RET_ENTITY_POOL_EXHAUSTED, ret);
+  rcl_reset_error();
+  EXPECT_EQ(1u, wait_set.size_of_guard_conditions);
+  ret = rcl_wait_set_resize(&wait_set, 0, 3, 0, 0, 0);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(3u, wait_set.size_of_guard_conditions);
+
+  ret = rcl_wait_set_add_guard_condition(&wait_set, &guard_conditions[0], NULL);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_trigger_guard_condition(&guard_conditions[0]);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_wait(&wait_set, RCL_MS_TO_NS(100));
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(&guard_conditions[0], wait_set.guard_conditions[0]);
+}
+
+// Check that the other kinds of entities are drawn from the entity pools of their context too
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), entity_pools_of_other_kinds) {
+  rcl_ret_t ret;
+  rcl_init_options_t init_options = rcl_get_zero_initialized_init_options();
+  ret = rcl_init_options_init(&init_options, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_init_options_fini(&init_options)) << rcl_get_error_string().str;
+  });
+  rcl_entity_pool_capacities_t capacities = rcl_entity_pool_capacities_t();
+  capacities.publishers = 1;
+  capacities.subscriptions = 1;
+  capacities.clients = 1;
+  capacities.services = 1;
+  capacities.timers = 1;
+  ret = rcl_init_options_set_entity_pool_capacities(&init_options, &capacities);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  rcl_context_t context = rcl_get_zero_initialized_context();
+  ret = rcl_init(0, nullptr, &init_options, &context);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_shutdown(&context)) << rcl_get_error_string().str;
+    EXPECT_EQ(RCL_RET_OK, rcl_context_fini(&context)) << rcl_get_error_string().str;
+  });
+  rcl_node_t node = rcl_get_zero_initialized_node();
+  rcl_node_options_t node_options = rcl_node_get_default_options();
+  ret = rcl_node_init(&node, "test_entity_pools_node", "", &context, &node_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_node_fini(&node)) << rcl_get_error_string().str;
+  });
+  const rosidl_message_type_support_t * msg_ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Primitives);
+  const rosidl_service_type_support_t * srv_ts =
+    ROSIDL_GET_SRV_TYPE_SUPPORT(test_msgs, srv, Primitives);
+
+  // Each pool has one slot, the second entity of a kind fails until the first is finalized.
+  rcl_publisher_options_t publisher_options = rcl_publisher_get_default_options();
+  rcl_publisher_t publishers[2];
+  for (rcl_publisher_t & publisher : publishers) {
+    publisher = rcl_get_zero_initialized_publisher();
+  }
+  ret = rcl_publisher_init(&publishers[0], &node, msg_ts, "chatter", &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_publisher_init(&publishers[1], &node, msg_ts, "chatter", &publisher_options);
+  EXPECT_EQ(RCL_RET_ENTITY_POOL_EXHAUSTED, ret);
+  EXPECT_EQ(nullptr, publishers[1].impl);
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_OK, rcl_publisher_fini(&publishers[0], &node)) << rcl_get_error_string().str;
+  ret = rcl_publisher_init(&publishers[1], &node, msg_ts, "chatter", &publisher_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_OK, rcl_publisher_fini(&publishers[1], &node)) << rcl_get_error_string().str;
+
+  rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+  rcl_subscription_t subscriptions[2];
+  for (rcl_subscription_t & subscription : subscriptions) {
+    subscription = rcl_get_zero_initialized_subscription();
+  }
+  ret = rcl_subscription_init(&subscriptions[0], &node, msg_ts, "chatter", &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_subscription_init(&subscriptions[1], &node, msg_ts, "chatter", &subscription_options);
+  EXPECT_EQ(RCL_RET_ENTITY_POOL_EXHAUSTED, ret);
+  EXPECT_EQ(nullptr, subscriptions[1].impl);
+  rcl_reset_error();
+  ret = rcl_subscription_fini(&subscriptions[0], &node);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_subscription_init(&subscriptions[1], &node, msg_ts, "chatter", &subscription_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_subscription_fini(&subscriptions[1], &node);
+  EXPECT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  rcl_client_options_t client_options = rcl_client_get_default_options();
+  rcl_client_t clients[2];
+  for (rcl_client_t & client : clients) {
+    client = rcl_get_zero_initialized_client();
+  }
+  ret = rcl_client_init(&clients[0], &node, srv_ts, "primitives", &client_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_client_init(&clients[1], &node, srv_ts, "primitives", &client_options);
+  EXPECT_EQ(RCL_RET_ENTITY_POOL_EXHAUSTED, ret);
+  EXPECT_EQ(nullptr, clients[1].impl);
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_OK, rcl_client_fini(&clients[0], &node)) << rcl_get_error_string().str;
+  ret = rcl_client_init(&clients[1], &node, srv_ts, "primitives", &client_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_OK, rcl_client_fini(&clients[1], &node)) << rcl_get_error_string().str;
+
+  rcl_service_options_t service_options = rcl_service_get_default_options();
+  rcl_service_t services[2];
+  for (rcl_service_t & service : services) {
+    service = rcl_get_zero_initialized_service();
+  }
+  ret = rcl_service_init(&services[0], &node, srv_ts, "primitives", &service_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_service_init(&services[1], &node, srv_ts, "other_primitives", &service_options);
+  EXPECT_EQ(RCL_RET_ENTITY_POOL_EXHAUSTED, ret);
+  EXPECT_EQ(nullptr, services[1].impl);
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_OK, rcl_service_fini(&services[0], &node)) << rcl_get_error_string().str;
+  ret = rcl_service_init(&services[1], &node, srv_ts, "other_primitives", &service_options);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_OK, rcl_service_fini(&services[1], &node)) << rcl_get_error_string().str;
+
+  // A steady clock, so the timers do not take a guard condition as well.
+  rcl_clock_t clock;
+  rcl_allocator_t allocator = rcl_get_default_allocator();
+  ret = rcl_clock_init(RCL_STEADY_TIME, &clock, &allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_clock_fini(&clock)) << rcl_get_error_string().str;
+  });
+  rcl_timer_t timers[2];
+  for (rcl_timer_t & timer : timers) {
+    timer = rcl_get_zero_initialized_timer();
+  }
+  ret = rcl_timer_init(&timers[0], &clock, &context, RCL_MS_TO_NS(10), nullptr, allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  ret = rcl_timer_init(&timers[1], &clock, &context, RCL_MS_TO_NS(10), nullptr, allocator);
+  EXPECT_EQ(RCL_RET_ENTITY_POOL_EXHAUSTED, ret);
+  EXPECT_EQ(nullptr, timers[1].impl);
+  rcl_reset_error();
+  EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&timers[0])) << rcl_get_error_string().str;
+  ret = rcl_timer_init(&timers[1], &clock, &context, RCL_MS_TO_NS(10), nullptr, allocator);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_OK, rcl_timer_fini(&timers[1])) << rcl_get_error_string().str;
+}
+
+// Check that guard conditions and wait sets which are not pooled outlive their context
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), finalized_after_context) {
+  rcl_ret_t ret;
+  rcl_init_options_t init_options = rcl_get_zero_initialized_init_options();
+  ret = rcl_init_options_init(&init_options, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+    EXPECT_EQ(RCL_RET_OK, rcl_init_options_fini(&init_options)) << rcl_get_error_string().str;
+  });
+  rcl_context_t context = rcl_get_zero_initialized_context();
+  ret = rcl_init(0, nullptr, &init_options, &context);
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  rcl_guard_condition_t guard_condition = rcl_get_zero_initialized_guard_condition();
+  ret = rcl_guard_condition_init(
+    &guard_condition, &context, rcl_guard_condition_get_default_options());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+  rcl_wait_set_t wait_set = rcl_get_zero_initialized_wait_set();
+  ret = rcl_wait_set_init_with_context(
+    &wait_set, 0, 1, 0, 0, 0, &context, rcl_get_default_allocator());
+  ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+
+  EXPECT_EQ(RCL_RET_OK, rcl_shutdown(&context)) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_OK, rcl_context_fini(&context)) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_OK, rcl_wait_set_fini(&wait_set)) << rcl_get_error_string().str;
+  EXPECT_EQ(RCL_RET_OK, rcl_guard_condition_fini(&guard_condition)) << rcl_get_error_string().str;
+}
+
+// Check that pooled and not pooled entities give their structs back to where they came from
+TEST_F(CLASSNAME(WaitSetTestFixture, RMW_IMPLEMENTATION), entity_pools_next_to_allocator) {
+  // The pool slots start out zeroed and the structs which are not pooled filled with ones, so
+  // an entity which does not record where its struct came from frees a slot or leaks its struct.
+  TrackingAllocatorState context_state = {std::set<void *>(), 0, 0x00};
+  TrackingAllocatorState entity_state = {std::set<void *>(), 0, 0x01};
+  rcl_allocator_t entity_allocator = get_tracking_allocator(&entity_state);
+  const rosidl_message_type_support_t * msg_ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Primitives);
+  const rosidl_service_type_support_t * srv_ts =
+    ROSIDL_GET_SRV_TYPE_SUPPORT(test_msgs, srv, Primitives);
+
+  for (bool pooled : {true, false}) {
+    rcl_ret_t ret;
+    rcl_init_options_t init_options = rcl_get_zero_initialized_init_options();
+    ret = rcl_init_options_init(&init_options, get_tracking_allocator(&context_state));
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+      EXPECT_EQ(RCL_RET_OK, rcl_init_options_fini(&init_options)) << rcl_get_error_string().str;
+    });
+    rcl_entity_pool_capacities_t capacities = rcl_entity_pool_capacities_t();
+    if (pooled) {
+      capacities.subscriptions = 1;
+      capacities.clients = 1;
+      capacities.services = 1;
+    }
+    ret = rcl_init_options_set_entity_pool_capacities(&init_options, &capacities);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    rcl_context_t context = rcl_get_zero_initialized_context();
+    ret = rcl_init(0, nullptr, &init_options, &context);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+      EXPECT_EQ(RCL_RET_OK, rcl_shutdown(&context)) << rcl_get_error_string().str;
+      EXPECT_EQ(RCL_RET_OK, rcl_context_fini(&context)) << rcl_get_error_string().str;
+    });
+    rcl_node_t node = rcl_get_zero_initialized_node();
+    rcl_node_options_t node_options = rcl_node_get_default_options();
+    ret = rcl_node_init(&node, "test_entity_pools_node", "", &context, &node_options);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT({
+      EXPECT_EQ(RCL_RET_OK, rcl_node_fini(&node)) << rcl_get_error_string().str;
+    });
+
+    rcl_subscription_t subscription = rcl_get_zero_initialized_subscription();
+    rcl_subscription_options_t subscription_options = rcl_subscription_get_default_options();
+    subscription_options.allocator = entity_allocator;
+    ret = rcl_subscription_init(&subscription, &node, msg_ts, "chatter", &subscription_options);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_EQ(RCL_RET_OK, rcl_subscription_fini(&subscription, &node)) <<
+      rcl_get_error_string().str;
+
+    rcl_client_t client = rcl_get_zero_initialized_client();
+    rcl_client_options_t client_options = rcl_client_get_default_options();
+    client_options.allocator = entity_allocator;
+    ret = rcl_client_init(&client, &node, srv_ts, "primitives", &client_options);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_EQ(RCL_RET_OK, rcl_client_fini(&client, &node)) << rcl_get_error_string().str;
+
+    rcl_service_t service = rcl_get_zero_initialized_service();
+    rcl_service_options_t service_options = rcl_service_get_default_options();
+    service_options.allocator = entity_allocator;
+    ret = rcl_service_init(&service, &node, srv_ts, "primitives", &service_options);
+    ASSERT_EQ(RCL_RET_OK, ret) << rcl_get_error_string().str;
+    EXPECT_EQ(RCL_RET_OK, rcl_service_fini(&service, &node)) << rcl_get_error_string().str;
+
+    EXPECT_EQ(0u, entity_state.foreign_frees) << (pooled ? "pooled" : "not pooled");
+    EXPECT_EQ(0u, entity_state.live.size()) << (pooled ? "pooled" : "not pooled");
+  }
+  EXPECT_EQ(0u, context_state.foreign_frees);
+}